@@ -0,0 +1,378 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "packed_read_batch.hpp"
+
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <numeric>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+// BAM 4-bit nucleotide encoding
+constexpr std::array<char, 16> nt16Bases {'=', 'A', 'C', 'M', 'G', 'R', 'S', 'V', 'T', 'W', 'Y', 'H', 'K', 'D', 'B', 'N'};
+
+constexpr std::uint8_t nonNt16Base {0xff};
+
+auto make_nt16_table() noexcept
+{
+    std::array<std::uint8_t, 256> result {};
+    result.fill(nonNt16Base);
+    for (std::uint8_t i {0}; i < nt16Bases.size(); ++i) {
+        result[static_cast<unsigned char>(nt16Bases[i])] = i;
+    }
+    return result;
+}
+
+const auto nt16Table = make_nt16_table();
+
+// BAM cigar operation encoding
+constexpr std::array<CigarOperation::Flag, 9> cigarFlags {
+    CigarOperation::Flag::alignmentMatch,
+    CigarOperation::Flag::insertion,
+    CigarOperation::Flag::deletion,
+    CigarOperation::Flag::skipped,
+    CigarOperation::Flag::softClipped,
+    CigarOperation::Flag::hardClipped,
+    CigarOperation::Flag::padding,
+    CigarOperation::Flag::sequenceMatch,
+    CigarOperation::Flag::substitution
+};
+
+std::uint32_t encode(const CigarOperation& op) noexcept
+{
+    const auto flag_itr = std::find(std::cbegin(cigarFlags), std::cend(cigarFlags), op.flag());
+    assert(flag_itr != std::cend(cigarFlags));
+    assert(op.size() < (1u << 28));
+    return static_cast<std::uint32_t>(op.size() << 4) | static_cast<std::uint32_t>(std::distance(std::cbegin(cigarFlags), flag_itr));
+}
+
+CigarOperation decode(const std::uint32_t op) noexcept
+{
+    return CigarOperation {op >> 4, cigarFlags[op & 0xf]};
+}
+
+std::uint16_t compress(const AlignedRead::Flags& flags) noexcept
+{
+    std::uint16_t result {0};
+    result |= flags.multiple_segment_template << 0;
+    result |= flags.all_segments_in_read_aligned << 1;
+    result |= flags.unmapped << 2;
+    result |= flags.reverse_mapped << 3;
+    result |= flags.secondary_alignment << 4;
+    result |= flags.qc_fail << 5;
+    result |= flags.duplicate << 6;
+    result |= flags.supplementary_alignment << 7;
+    result |= flags.first_template_segment << 8;
+    result |= flags.last_template_segment << 9;
+    return result;
+}
+
+AlignedRead::Flags decompress(const std::uint16_t flags) noexcept
+{
+    AlignedRead::Flags result {};
+    result.multiple_segment_template    = flags & (1u << 0);
+    result.all_segments_in_read_aligned = flags & (1u << 1);
+    result.unmapped                     = flags & (1u << 2);
+    result.reverse_mapped               = flags & (1u << 3);
+    result.secondary_alignment          = flags & (1u << 4);
+    result.qc_fail                      = flags & (1u << 5);
+    result.duplicate                    = flags & (1u << 6);
+    result.supplementary_alignment      = flags & (1u << 7);
+    result.first_template_segment       = flags & (1u << 8);
+    result.last_template_segment        = flags & (1u << 9);
+    return result;
+}
+
+template <typename T>
+std::size_t capacity_bytes(const std::vector<T>& v) noexcept
+{
+    return v.capacity() * sizeof(T);
+}
+
+} // namespace
+
+void PackedReadBatch::reserve(const size_type num_reads, const size_type num_bases)
+{
+    records_.reserve(num_reads);
+    bases_.reserve((num_bases + 1) / 2 + num_reads);
+    qualities_.reserve(num_bases);
+}
+
+void PackedReadBatch::push_back(const AlignedRead& read)
+{
+    ReadRecord record {};
+    const auto& region = read.mapped_region();
+    record.begin = region.begin();
+    record.end   = region.end();
+    record.contig = intern(region.contig_name());
+    record.read_group = intern(read.read_group());
+    record.mapping_quality = read.mapping_quality();
+    record.flags = compress(read.flags());
+    record.sequence_offset = qualities_.size();
+    record.sequence_length = static_cast<std::uint32_t>(read.sequence().size());
+    assert(read.base_qualities().size() == read.sequence().size());
+    pack_bases(read.sequence(), record);
+    qualities_.insert(std::cend(qualities_), std::cbegin(read.base_qualities()), std::cend(read.base_qualities()));
+    record.cigar_offset = static_cast<std::uint32_t>(cigars_.size());
+    record.cigar_length = static_cast<std::uint32_t>(read.cigar().size());
+    std::transform(std::cbegin(read.cigar()), std::cend(read.cigar()), std::back_inserter(cigars_),
+                   [] (const CigarOperation& op) { return encode(op); });
+    record.text_offset = text_.size();
+    record.name_length = static_cast<std::uint32_t>(read.name().size());
+    record.barcode_length = static_cast<std::uint32_t>(read.barcode().size());
+    text_.insert(std::cend(text_), std::cbegin(read.name()), std::cend(read.name()));
+    text_.insert(std::cend(text_), std::cbegin(read.barcode()), std::cend(read.barcode()));
+    if (read.has_other_segment()) {
+        const auto& segment = read.next_segment();
+        record.segment = static_cast<std::uint32_t>(segments_.size());
+        segments_.push_back({segment.begin(), segment.inferred_template_length(), intern(segment.contig_name()), segment.flags()});
+    } else {
+        record.segment = npos_;
+    }
+    record.supplementary_begin = static_cast<std::uint32_t>(supplementary_alignments_.size());
+    supplementary_alignments_.insert(std::cend(supplementary_alignments_),
+                                     std::cbegin(read.supplementary_alignments()),
+                                     std::cend(read.supplementary_alignments()));
+    record.supplementary_end = static_cast<std::uint32_t>(supplementary_alignments_.size());
+    if (!records_.empty() && is_sorted_) {
+        const auto& prev = records_.back();
+        is_sorted_ = prev.contig == record.contig
+                     && (prev.begin < record.begin || (prev.begin == record.begin && prev.end <= record.end));
+    }
+    max_read_size_ = std::max(max_read_size_, record.end - record.begin);
+    records_.push_back(record);
+}
+
+PackedReadBatch::size_type PackedReadBatch::size() const noexcept
+{
+    return records_.size();
+}
+
+bool PackedReadBatch::empty() const noexcept
+{
+    return records_.empty();
+}
+
+bool PackedReadBatch::is_sorted() const noexcept
+{
+    return is_sorted_;
+}
+
+AlignedRead PackedReadBatch::operator[](const size_type idx) const
+{
+    const auto& record = records_[idx];
+    GenomicRegion region {strings_[record.contig], record.begin, record.end};
+    std::string name {text_.data() + record.text_offset, record.name_length};
+    AlignedRead::NucleotideSequence barcode {text_.data() + record.text_offset + record.name_length, record.barcode_length};
+    const auto qualities_begin = std::next(std::cbegin(qualities_), record.sequence_offset);
+    AlignedRead::BaseQualityVector qualities {qualities_begin, std::next(qualities_begin, record.sequence_length)};
+    if (record.segment != npos_) {
+        const auto& segment = segments_[record.segment];
+        AlignedRead result {std::move(name), std::move(region), unpack_bases(record), std::move(qualities),
+                            unpack_cigar(record), record.mapping_quality, decompress(record.flags),
+                            strings_[record.read_group], std::move(barcode),
+                            strings_[segment.contig], segment.begin, segment.inferred_template_length, segment.flags};
+        for (auto i = record.supplementary_begin; i < record.supplementary_end; ++i) {
+            result.add_supplementary_alignment(supplementary_alignments_[i]);
+        }
+        return result;
+    } else {
+        AlignedRead result {std::move(name), std::move(region), unpack_bases(record), std::move(qualities),
+                            unpack_cigar(record), record.mapping_quality, decompress(record.flags),
+                            strings_[record.read_group], std::move(barcode)};
+        for (auto i = record.supplementary_begin; i < record.supplementary_end; ++i) {
+            result.add_supplementary_alignment(supplementary_alignments_[i]);
+        }
+        return result;
+    }
+}
+
+const GenomicRegion::ContigName& PackedReadBatch::contig_name(const size_type idx) const noexcept
+{
+    return strings_[records_[idx].contig];
+}
+
+ContigRegion PackedReadBatch::contig_region(const size_type idx) const
+{
+    return ContigRegion {records_[idx].begin, records_[idx].end};
+}
+
+std::vector<AlignedRead> PackedReadBatch::copy_overlapped(const GenomicRegion& region) const
+{
+    std::vector<AlignedRead> result {};
+    if (records_.empty()) return result;
+    const auto contig_itr = string_ids_.find(region.contig_name());
+    if (contig_itr == std::cend(string_ids_)) return result;
+    const auto contig = contig_itr->second;
+    const auto& request = region.contig_region();
+    auto first = std::cbegin(records_);
+    auto last  = std::cend(records_);
+    if (is_sorted_) {
+        if (records_.front().contig != contig) return result;
+        // No read overlapping region can begin before this
+        const auto min_begin = request.begin() > max_read_size_ ? request.begin() - max_read_size_ : 0;
+        first = std::lower_bound(first, last, min_begin, [] (const ReadRecord& record, auto pos) { return record.begin < pos; });
+        last  = std::upper_bound(first, last, request.end(), [] (auto pos, const ReadRecord& record) { return pos < record.begin; });
+    }
+    for (auto itr = first; itr != last; ++itr) {
+        if (itr->contig == contig && overlaps(ContigRegion {itr->begin, itr->end}, request)) {
+            result.push_back(operator[](std::distance(std::cbegin(records_), itr)));
+        }
+    }
+    return result;
+}
+
+void PackedReadBatch::clear() noexcept
+{
+    records_.clear();
+    bases_.clear();
+    raw_bases_.clear();
+    qualities_.clear();
+    cigars_.clear();
+    text_.clear();
+    segments_.clear();
+    supplementary_alignments_.clear();
+    strings_.clear();
+    string_ids_.clear();
+    max_read_size_ = 0;
+    is_sorted_ = true;
+}
+
+void PackedReadBatch::shrink_to_fit()
+{
+    records_.shrink_to_fit();
+    bases_.shrink_to_fit();
+    raw_bases_.shrink_to_fit();
+    qualities_.shrink_to_fit();
+    cigars_.shrink_to_fit();
+    text_.shrink_to_fit();
+    segments_.shrink_to_fit();
+    supplementary_alignments_.shrink_to_fit();
+}
+
+MemoryFootprint PackedReadBatch::footprint() const noexcept
+{
+    std::size_t result {sizeof(PackedReadBatch)};
+    result += capacity_bytes(records_) + capacity_bytes(bases_) + capacity_bytes(raw_bases_);
+    result += capacity_bytes(qualities_) + capacity_bytes(cigars_) + capacity_bytes(text_);
+    result += capacity_bytes(segments_) + capacity_bytes(supplementary_alignments_);
+    for (const auto& str : strings_) result += 2 * (sizeof(std::string) + str.capacity());
+    return result;
+}
+
+// private methods
+
+PackedReadBatch::StringId PackedReadBatch::intern(const std::string& str)
+{
+    const auto itr = string_ids_.find(str);
+    if (itr != std::cend(string_ids_)) return itr->second;
+    const auto id = static_cast<StringId>(strings_.size());
+    strings_.push_back(str);
+    string_ids_.emplace(str, id);
+    return id;
+}
+
+void PackedReadBatch::pack_bases(const AlignedRead::NucleotideSequence& sequence, ReadRecord& record)
+{
+    const bool is_nt16 {std::all_of(std::cbegin(sequence), std::cend(sequence),
+                                    [] (char base) { return nt16Table[static_cast<unsigned char>(base)] != nonNt16Base; })};
+    if (is_nt16) {
+        record.raw_bases = false;
+        record.base_offset = bases_.size();
+        const auto n = sequence.size();
+        for (std::size_t i {0}; i + 1 < n; i += 2) {
+            bases_.push_back((nt16Table[static_cast<unsigned char>(sequence[i])] << 4)
+                             | nt16Table[static_cast<unsigned char>(sequence[i + 1])]);
+        }
+        if (n % 2 == 1) {
+            bases_.push_back(nt16Table[static_cast<unsigned char>(sequence.back())] << 4);
+        }
+    } else {
+        // Keep the batch lossless for sequences outside the nt16 alphabet (e.g. soft-masked bases)
+        record.raw_bases = true;
+        record.base_offset = raw_bases_.size();
+        raw_bases_.insert(std::cend(raw_bases_), std::cbegin(sequence), std::cend(sequence));
+    }
+}
+
+AlignedRead::NucleotideSequence PackedReadBatch::unpack_bases(const ReadRecord& record) const
+{
+    if (record.raw_bases) {
+        const auto first = std::next(std::cbegin(raw_bases_), record.base_offset);
+        return AlignedRead::NucleotideSequence {first, std::next(first, record.sequence_length)};
+    }
+    AlignedRead::NucleotideSequence result(record.sequence_length, 'N');
+    const auto packed = bases_.data() + record.base_offset;
+    for (std::size_t i {0}; i < record.sequence_length; ++i) {
+        const auto code = packed[i / 2] >> (i % 2 == 0 ? 4 : 0);
+        result[i] = nt16Bases[code & 0xf];
+    }
+    return result;
+}
+
+CigarString PackedReadBatch::unpack_cigar(const ReadRecord& record) const
+{
+    CigarString result(record.cigar_length);
+    const auto first = std::next(std::cbegin(cigars_), record.cigar_offset);
+    std::transform(first, std::next(first, record.cigar_length), std::begin(result),
+                   [] (std::uint32_t op) { return decode(op); });
+    return result;
+}
+
+// non-member methods
+
+MemoryFootprint packed_footprint(const AlignedRead& read) noexcept
+{
+    using Record = PackedReadBatch::ReadRecord;
+    const auto& sequence = read.sequence();
+    const bool is_nt16 {std::all_of(std::cbegin(sequence), std::cend(sequence),
+                                    [] (char base) { return nt16Table[static_cast<unsigned char>(base)] != nonNt16Base; })};
+    std::size_t result {sizeof(Record)};
+    result += is_nt16 ? (sequence.size() + 1) / 2 : sequence.size();
+    result += read.base_qualities().size() * sizeof(AlignedRead::BaseQuality);
+    result += read.cigar().size() * sizeof(std::uint32_t);
+    result += read.name().size() + read.barcode().size();
+    if (read.has_other_segment()) result += sizeof(PackedReadBatch::SegmentRecord);
+    result += read.supplementary_alignments().size() * sizeof(AlignedRead::SupplementaryAlignment);
+    return result;
+}
+
+PackedReadMap pack(const ReadMap& reads)
+{
+    PackedReadMap result {};
+    result.reserve(reads.size());
+    for (const auto& p : reads) {
+        result.emplace(p.first, pack(p.second));
+    }
+    return result;
+}
+
+ReadMap copy_overlapped(const PackedReadMap& reads, const GenomicRegion& region)
+{
+    ReadMap result {};
+    result.reserve(reads.size());
+    for (const auto& p : reads) {
+        auto overlapped = p.second.copy_overlapped(region);
+        const auto first = std::make_move_iterator(std::begin(overlapped));
+        const auto last  = std::make_move_iterator(std::end(overlapped));
+        if (p.second.is_sorted()) {
+            result.emplace(p.first, ReadContainer {ForwardSortedTag {}, first, last});
+        } else {
+            result.emplace(p.first, ReadContainer {first, last});
+        }
+    }
+    return result;
+}
+
+std::size_t count_reads(const PackedReadMap& reads) noexcept
+{
+    return std::accumulate(std::cbegin(reads), std::cend(reads), std::size_t {0},
+                           [] (auto curr, const auto& p) noexcept { return curr + p.second.size(); });
+}
+
+} // namespace octopus
@@ -0,0 +1,138 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef packed_read_batch_hpp
+#define packed_read_batch_hpp
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <iterator>
+#include <algorithm>
+
+#include "config/common.hpp"
+#include "contig_region.hpp"
+#include "genomic_region.hpp"
+#include "aligned_read.hpp"
+#include "concepts/mappable_range.hpp"
+#include "utils/memory_footprint.hpp"
+
+namespace octopus {
+
+// A compact columnar store of AlignedReads. Bases are packed two per byte, contig and read group
+// names are interned, and qualities, cigars and names live in contiguous arenas rather than
+// per-read heap allocations. Reads are materialised on demand.
+class PackedReadBatch
+{
+public:
+    using size_type = std::size_t;
+
+    PackedReadBatch() = default;
+
+    template <typename ForwardIterator>
+    PackedReadBatch(ForwardIterator first, ForwardIterator last);
+
+    PackedReadBatch(const PackedReadBatch&)            = default;
+    PackedReadBatch& operator=(const PackedReadBatch&) = default;
+    PackedReadBatch(PackedReadBatch&&)                 = default;
+    PackedReadBatch& operator=(PackedReadBatch&&)      = default;
+
+    ~PackedReadBatch() = default;
+
+    void reserve(size_type num_reads, size_type num_bases);
+    void push_back(const AlignedRead& read);
+
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    // True if reads were pushed in mapped order on a single contig
+    bool is_sorted() const noexcept;
+
+    AlignedRead operator[](size_type idx) const;
+
+    const GenomicRegion::ContigName& contig_name(size_type idx) const noexcept;
+    ContigRegion contig_region(size_type idx) const;
+
+    // Materialises reads overlapping region in insertion order
+    std::vector<AlignedRead> copy_overlapped(const GenomicRegion& region) const;
+
+    void clear() noexcept;
+    void shrink_to_fit();
+
+    MemoryFootprint footprint() const noexcept;
+    
+    friend MemoryFootprint packed_footprint(const AlignedRead& read) noexcept;
+
+private:
+    using StringId = std::uint32_t;
+    using Offset   = std::uint64_t;
+
+    static constexpr std::uint32_t npos_ = -1;
+
+    struct ReadRecord
+    {
+        ContigRegion::Position begin, end;
+        Offset sequence_offset, base_offset, text_offset;
+        std::uint32_t sequence_length, cigar_offset, cigar_length;
+        std::uint32_t name_length, barcode_length;
+        StringId contig, read_group;
+        std::uint32_t segment, supplementary_begin, supplementary_end;
+        std::uint16_t flags;
+        AlignedRead::MappingQuality mapping_quality;
+        bool raw_bases;
+    };
+
+    struct SegmentRecord
+    {
+        GenomicRegion::Position begin;
+        GenomicRegion::Size inferred_template_length;
+        StringId contig;
+        AlignedRead::Segment::Flags flags;
+    };
+
+    std::vector<ReadRecord> records_ = {};
+    std::vector<std::uint8_t> bases_ = {}, raw_bases_ = {};
+    std::vector<AlignedRead::BaseQuality> qualities_ = {};
+    std::vector<std::uint32_t> cigars_ = {};
+    std::vector<char> text_ = {};
+    std::vector<SegmentRecord> segments_ = {};
+    std::vector<AlignedRead::SupplementaryAlignment> supplementary_alignments_ = {};
+    std::vector<std::string> strings_ = {};
+    std::unordered_map<std::string, StringId> string_ids_ = {};
+    ContigRegion::Size max_read_size_ = 0;
+    bool is_sorted_ = true;
+
+    StringId intern(const std::string& str);
+    void pack_bases(const AlignedRead::NucleotideSequence& sequence, ReadRecord& record);
+    AlignedRead::NucleotideSequence unpack_bases(const ReadRecord& record) const;
+    CigarString unpack_cigar(const ReadRecord& record) const;
+};
+
+template <typename ForwardIterator>
+PackedReadBatch::PackedReadBatch(ForwardIterator first, ForwardIterator last)
+{
+    records_.reserve(std::distance(first, last));
+    std::for_each(first, last, [this] (const AlignedRead& read) { push_back(read); });
+}
+
+template <typename Range>
+PackedReadBatch pack(const Range& reads)
+{
+    return PackedReadBatch {std::cbegin(reads), std::cend(reads)};
+}
+
+// The number of bytes read adds to a PackedReadBatch, not including interned strings
+MemoryFootprint packed_footprint(const AlignedRead& read) noexcept;
+
+using PackedReadMap = std::unordered_map<SampleName, PackedReadBatch>;
+
+PackedReadMap pack(const ReadMap& reads);
+
+ReadMap copy_overlapped(const PackedReadMap& reads, const GenomicRegion& region);
+
+std::size_t count_reads(const PackedReadMap& reads) noexcept;
+
+} // namespace octopus
+
+#endif
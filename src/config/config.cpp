@@ -12,6 +12,7 @@
 
 #include "version.hpp"
 #include "system.hpp"
+#include "core/models/pairhmm/simd_pair_hmm_kernel.hpp"
 
 namespace octopus { namespace config {
 
@@ -52,14 +53,14 @@ const VersionNumber Version {VERSION_MAJOR,
                              get_git_branch_name(),
                              get_git_commit()};
 
+// The extension is chosen at runtime from those this build supports
 static auto get_simd_extension()
 {
-    if (AVX512_AVAILABLE) {
-        return SystemInfo::SIMDExtension::avx512;
-    } else if (AVX2_AVAILABLE) {
-        return SystemInfo::SIMDExtension::avx2;
-    } else {
-        return SystemInfo::SIMDExtension::sse2;
+    using hmm::simd::PairHMMInstructionSet;
+    switch (hmm::simd::pair_hmm_instruction_set()) {
+        case PairHMMInstructionSet::avx512: return SystemInfo::SIMDExtension::avx512;
+        case PairHMMInstructionSet::avx2: return SystemInfo::SIMDExtension::avx2;
+        default: return SystemInfo::SIMDExtension::sse4_1;
     }
 }
 
@@ -94,7 +95,7 @@ std::ostream& operator<<(std::ostream& os, const SystemInfo::SIMDExtension simd)
 {
     using SIMD = SystemInfo::SIMDExtension;
     switch (simd) {
-        case SIMD::sse2: os << "SSE2"; break;
+        case SIMD::sse4_1: os << "SSE4.1"; break;
         case SIMD::avx2: os << "AVX2"; break;
         case SIMD::avx512: os << "AVX512"; break;
     }
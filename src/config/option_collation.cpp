@@ -281,6 +281,15 @@ boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options)
     }
 }
 
+boost::optional<fs::path> get_profile_trace_file_name(const OptionMap& options)
+{
+    if (is_set("profile-trace", options)) {
+        return resolve_path(options.at("profile-trace").as<fs::path>(), options);
+    } else {
+        return boost::none;
+    }
+}
+
 bool is_fast_mode(const OptionMap& options)
 {
     return options.at("fast").as<bool>() || options.at("very-fast").as<bool>();
@@ -726,7 +735,8 @@ ReadManager make_read_manager(const OptionMap& options)
 {
     auto read_paths = get_read_paths(options);
     const auto max_open_files = as_unsigned("max-open-read-files", options);
-    return ReadManager {std::move(read_paths), max_open_files};
+    const auto num_decompression_threads = as_unsigned("read-decompression-threads", options);
+    return ReadManager {std::move(read_paths), max_open_files, num_decompression_threads};
 }
 
 bool denovo_candidate_variant_discovery_enabled(const OptionMap& options)
@@ -1610,6 +1620,8 @@ make_calling_haplotype_likelihood_model(const OptionMap& options, const boost::o
 bool use_int_hmm_scores_for_realignment(const OptionMap& options, const boost::optional<const ReadSetProfile&> read_profile)
 {
     if (options.at("use-wide-hmm-scores").as<bool>()) return true;
+    // Long reads almost always saturate 16-bit scores, so recomputing them at 32 bits would only double the work.
+    // Short reads rarely do, and get 32-bit scores just when they saturate.
     if (options.at("split-long-reads").as<bool>()) return true;
     if (read_profile && read_profile->length_stats.median > 1'000) return true;
     return false;
@@ -1974,17 +1986,31 @@ auto get_normal_contamination_risk(const OptionMap& options)
     return result;
 }
 
+unsigned get_num_calling_threads(const OptionMap& options)
+{
+    auto result = get_num_threads(options);
+    if (!result) result = std::thread::hardware_concurrency();
+    return std::max(*result, 1u);
+}
+
+auto get_max_alignment_memo_footprint(const OptionMap& options)
+{
+    const auto total = options.at("max-alignment-memo-footprint").as<MemoryFootprint>();
+    return MemoryFootprint {total.bytes() / get_num_calling_threads(options)};
+}
+
 auto get_target_working_memory(const OptionMap& options)
 {
     boost::optional<MemoryFootprint> result {};
     if (is_set("target-working-memory", options)) {
         static const MemoryFootprint min_target_memory {*parse_footprint("100M")};
         result = options.at("target-working-memory").as<MemoryFootprint>();
-        auto num_threads = get_num_threads(options);
-        if (!num_threads) {
-            num_threads = std::thread::hardware_concurrency();
-        }
-        result = MemoryFootprint {std::max(result->bytes() / *num_threads, min_target_memory.bytes())};
+        const auto num_threads = get_num_calling_threads(options);
+        // The alignment memo is part of each calling thread's working memory
+        const auto memo_footprint = get_max_alignment_memo_footprint(options).bytes();
+        auto thread_target = result->bytes() / num_threads;
+        thread_target = thread_target > memo_footprint ? thread_target - memo_footprint : 0;
+        result = MemoryFootprint {std::max(thread_target, min_target_memory.bytes())};
     }
     return result;
 }
@@ -2184,7 +2210,10 @@ CallerFactory make_caller_factory(const ReferenceGenome& reference, ReadPipe& re
     }
     const auto target_working_memory = get_target_working_memory(options);
     if (target_working_memory) vc_builder.set_target_memory_footprint(*target_working_memory);
+    vc_builder.set_max_alignment_memo_footprint(get_max_alignment_memo_footprint(options));
     vc_builder.set_execution_policy(get_thread_execution_policy(options));
+    // Windows are already called in parallel, but workers left idle by a hard window can take its likelihood tiles
+    vc_builder.set_likelihood_execution_policy(is_threading_allowed(options) ? ExecutionPolicy::par : ExecutionPolicy::seq);
     auto bad_region_detector = make_bad_region_detector(options, read_profile);
     if (bad_region_detector) {
         vc_builder.set_bad_region_detector(std::move(*bad_region_detector));
@@ -2339,6 +2368,12 @@ bool keep_unfiltered_calls(const OptionMap& options) noexcept
     return options.at("keep-unfiltered-calls").as<bool>();
 }
 
+bool reuse_calling_read_assignments(const OptionMap& options) noexcept
+{
+    return is_call_filtering_requested(options) && !is_set("filter-vcf", options)
+           && options.at("reuse-calling-read-assignments").as<bool>();
+}
+
 ReadPipe make_default_filter_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples)
 {
     using std::make_unique;
@@ -2525,6 +2560,7 @@ unsigned estimate_max_open_files(const OptionMap& options)
     if (get_output_path(options)) result += 2;
     result += is_debug_mode(options);
     result += is_trace_mode(options);
+    result += is_set("profile-trace", options);
     result += is_call_filtering_requested(options);
     return result;
 }
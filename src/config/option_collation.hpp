@@ -34,6 +34,7 @@ bool is_trace_mode(const OptionMap& options);
 
 boost::optional<fs::path> get_debug_log_file_name(const OptionMap& options);
 boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options);
+boost::optional<fs::path> get_profile_trace_file_name(const OptionMap& options);
 
 boost::optional<unsigned> get_num_threads(const OptionMap& options);
 
@@ -84,6 +85,8 @@ bool use_calling_read_pipe_for_call_filtering(const OptionMap& options) noexcept
 
 bool keep_unfiltered_calls(const OptionMap& options) noexcept;
 
+bool reuse_calling_read_assignments(const OptionMap& options) noexcept;
+
 ReadPipe make_call_filter_read_pipe(ReadManager& read_manager, const ReferenceGenome& reference, std::vector<SampleName> samples, const OptionMap& options);
 
 boost::optional<fs::path> get_output_path(const OptionMap& options);
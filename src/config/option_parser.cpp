@@ -64,6 +64,10 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<fs::path>()->implicit_value("octopus_trace.log"),
      "Create very verbose log file for debugging")
     
+    ("profile-trace",
+     po::value<fs::path>()->implicit_value("octopus_profile.json"),
+     "Write a Chrome trace (JSON) of time spent in each calling stage, per window and active region")
+    
     ("working-directory,w",
      po::value<fs::path>(),
      "Sets the working directory")
@@ -78,7 +82,7 @@ OptionMap parse_options(const int argc, const char** argv)
     
     ("max-reference-cache-footprint,X",
      po::value<MemoryFootprint>()->default_value(*parse_footprint("500MB"), "500MB"),
-     "Maximum memory footprint for cached reference sequence")
+     "Maximum memory footprint for cached reference sequence. Multithreaded runs memory map the reference instead")
     
     ("target-read-buffer-footprint,B",
      po::value<MemoryFootprint>()->default_value(*parse_footprint("6GB"), "6GB"),
@@ -88,10 +92,18 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<int>()->default_value(250),
      "Limits the number of read files that are open simultaneously")
     
+    ("read-decompression-threads",
+     po::value<int>()->default_value(0),
+     "Number of threads, shared by all open read files, used for BAM/CRAM decompression. These are in addition to --threads")
+    
      ("target-working-memory",
      po::value<MemoryFootprint>(),
      "Target working memory footprint for analysis, not including read or reference buffers")
      
+     ("max-alignment-memo-footprint",
+     po::value<MemoryFootprint>()->default_value(*parse_footprint("400MB"), "400MB"),
+     "Maximum memory footprint of read alignment scores reused between active regions, shared by all calling threads and counted in --target-working-memory. Zero disables reuse")
+     
      ("temp-directory-prefix",
      po::value<fs::path>()->default_value("octopus-temp"),
      "File name prefix of temporary directory for calling")
@@ -578,7 +590,7 @@ OptionMap parse_options(const int argc, const char** argv)
     
     ("use-wide-hmm-scores",
      po::bool_switch()->default_value(false),
-     "Use 32-bits rather than 16-bits for HMM scores")
+     "Always use 32-bits rather than 16-bits for HMM scores (16-bit scores that saturate are recomputed with 32-bits regardless)")
 
     ("read-linkage",
      po::value<ReadLinkage>()->default_value(ReadLinkage::paired),
@@ -739,6 +751,10 @@ OptionMap parse_options(const int argc, const char** argv)
      po::bool_switch()->default_value(false),
      "Use preprocessed reads, as used for calling, for call filtering")
     
+    ("reuse-calling-read-assignments",
+     po::bool_switch()->default_value(false),
+     "Reuse the read assignments made during calling for call filtering, rather than realigning reads to called haplotypes")
+    
     ("keep-unfiltered-calls",
      po::bool_switch()->default_value(false),
      "Keep a copy of unfiltered calls")
@@ -1145,7 +1161,7 @@ po::parsed_options run(po::command_line_parser& parser)
 void validate(const OptionMap& vm)
 {
     const std::vector<std::string> positive_int_options {
-        "threads", "mask-low-quality-tails", "mask-tails", "soft-clip-mask-threshold", "mask-soft-clipped-boundary-bases",
+        "threads", "read-decompression-threads", "mask-low-quality-tails", "mask-tails", "soft-clip-mask-threshold", "mask-soft-clipped-boundary-bases",
         "min-mapping-quality", "good-base-quality", "min-good-bases", "min-read-length",
         "max-read-length", "min-base-quality", "max-variant-size",
         "num-fallback-kmers", "max-assemble-region-overlap", "assembler-mask-base-quality",
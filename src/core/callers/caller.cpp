@@ -28,6 +28,7 @@
 #include "utils/append.hpp"
 #include "utils/erase_if.hpp"
 #include "utils/map_utils.hpp"
+#include "logging/profiler.hpp"
 
 namespace octopus {
 
@@ -44,6 +45,7 @@ Caller::Caller(Components&& components, Parameters parameters)
 , likelihood_model_ {std::move(components.likelihood_model)}
 , phaser_ {std::move(components.phaser)}
 , bad_region_detector_ {std::move(components.bad_region_detector)}
+, read_assignment_spill_ {components.read_assignment_spill}
 , parameters_ {std::move(parameters)}
 {
     if (parameters_.max_haplotypes == 0) {
@@ -136,6 +138,7 @@ auto to_vector(std::deque<T>&& values)
 
 auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& factory, const GenomicRegion& call_region)
 {
+    profiling::StageTimer timer {profiling::Stage::vcf_record_construction};
     auto records = factory.make(to_vector(std::move(calls)));
     erase_calls_outside_region(records, call_region);
     std::deque<VcfRecord> result {};
@@ -147,10 +150,12 @@ auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& fac
 
 std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
 {
+    profiling::RegionTimer window_timer {profiling::RegionTimer::Kind::window, call_region};
     ReadPipe::Report reads_report {};
     ReadMap reads;
     if (candidate_generator_.requires_reads()) {
         reads = read_pipe_.get().fetch_reads(expand(call_region, 100), reads_report);
+        window_timer.set(profiling::Counter::reads, count_reads(reads));
         add_reads(reads, candidate_generator_);
         if (!refcalls_requested() && all_empty(reads)) {
             if (debug_log_) stream(*debug_log_) << "Stopping early as no reads found in call region " << call_region;
@@ -168,6 +173,7 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
     if (!candidate_generator_.requires_reads()) {
         // as we didn't fetch them earlier
         reads = read_pipe_.get().fetch_reads(call_region, reads_report);
+        window_timer.set(profiling::Counter::reads, count_reads(reads));
     }
     std::vector<GenomicRegion> likely_difficult_regions {};
     if (bad_region_detector_ && has_coverage(reads)) {
@@ -188,13 +194,16 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
     const auto read_templates = make_read_templates(reads);
     auto haplotype_generator = make_haplotype_generator(candidates, reads, read_templates);
     for (auto& region : likely_difficult_regions) haplotype_generator.add_lagging_exclusion_zone(region);
-    auto calls = call_variants(call_region, candidates, reads, read_templates, haplotype_generator, progress_meter);
+    ReadAssignmentBlocks read_assignments {};
+    auto calls = call_variants(call_region, candidates, reads, read_templates, haplotype_generator, progress_meter, read_assignments);
     candidates.clear();
     candidates.shrink_to_fit();
     progress_meter.log_completed(call_region);
     const auto record_factory = make_record_factory(reads);
     if (debug_log_) stream(*debug_log_) << "Converting " << calls.size() << " calls made in " << call_region << " to VCF";
-    return convert_to_vcf(std::move(calls), record_factory, call_region);
+    auto result = convert_to_vcf(std::move(calls), record_factory, call_region);
+    if (read_assignment_spill_) spill_read_assignments(result, read_assignments);
+    return result;
 }
 
 std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const
@@ -400,7 +409,8 @@ Caller::call_variants(const GenomicRegion& call_region,
                       const ReadMap& reads,
                       const boost::optional<TemplateMap>& read_templates,
                       HaplotypeGenerator& haplotype_generator,
-                      ProgressMeter& progress_meter) const
+                      ProgressMeter& progress_meter,
+                      ReadAssignmentBlocks& read_assignments) const
 {
     auto haplotype_likelihoods = make_haplotype_likelihood_cache();
     std::deque<CallWrapper> result {};
@@ -447,11 +457,13 @@ Caller::call_variants(const GenomicRegion& call_region,
             progress_meter.log_completed(active_region);
             continue;
         }
+        profiling::RegionTimer active_region_timer {profiling::RegionTimer::Kind::active_region, active_region};
         if (read_templates) {
             active_reads = copy_overlapped(*read_templates, active_region);
         } else {
             active_reads = copy_overlapped(reads, active_region);
         }
+        active_region_timer.set(profiling::Counter::reads, count_reads(active_reads));
         if (!refcalls_requested() && !has_coverage(active_reads)) {
             if (debug_log_) stream(*debug_log_) << "Skipping active region " << active_region << " as there are no active reads";
             continue;
@@ -476,7 +488,14 @@ Caller::call_variants(const GenomicRegion& call_region,
         }
         auto has_removal_impact = filter_haplotypes(haplotypes, haplotype_generator, haplotype_likelihoods, protected_haplotypes);
         if (haplotypes.empty()) continue;
-        const auto caller_latents = infer_latents(haplotypes, haplotype_likelihoods);
+        active_region_timer.set(profiling::Counter::haplotypes, haplotypes.size());
+        const auto caller_latents = [&] () {
+            profiling::StageTimer timer {profiling::Stage::latent_inference};
+            return infer_latents(haplotypes, haplotype_likelihoods);
+        }();
+        if (profiling::is_enabled()) {
+            active_region_timer.set(profiling::Counter::genotypes, caller_latents->genotype_posteriors()->size2());
+        }
         if (trace_log_) {
             debug::print_haplotype_posteriors(stream(*trace_log_), *caller_latents->haplotype_posteriors());
         } else if (debug_log_) {
@@ -507,8 +526,8 @@ Caller::call_variants(const GenomicRegion& call_region,
         if (status != GeneratorStatus::skipped) {
             if (have_callable_region(active_region, next_active_region, backtrack_region, call_region)) {
                 call_variants(active_region, call_region, next_active_region, backtrack_region,
-                              candidates, haplotypes, haplotype_likelihoods, reads, *caller_latents,
-                              result, prev_called_region, completed_region);
+                              candidates, haplotypes, haplotype_likelihoods, reads, active_reads, *caller_latents,
+                              result, prev_called_region, completed_region, read_assignments);
             }
         }
         haplotype_likelihoods.clear();
@@ -541,6 +560,7 @@ Caller::generate_active_haplotypes(const GenomicRegion& call_region,
                                    HaplotypeBlock& next_haplotypes,
                                    boost::optional<GenomicRegion> backtrack_region) const
 {
+    profiling::StageTimer timer {profiling::Stage::haplotype_generation};
     if (next_active_region) {
         haplotypes = std::move(next_haplotypes);
         active_region = std::move(*next_active_region);
@@ -630,6 +650,7 @@ Caller::generate_next_active_haplotypes(HaplotypeBlock& next_haplotypes,
                                         boost::optional<GenomicRegion>& backtrack_region,
                                         HaplotypeGenerator& haplotype_generator) const
 {
+    profiling::StageTimer timer {profiling::Stage::haplotype_generation};
     try {
         auto packet = haplotype_generator.generate();
         next_haplotypes = std::move(packet.haplotypes);
@@ -758,6 +779,7 @@ Caller::find_phased_head(const MappableBlock<Haplotype>& haplotypes,
                          const GenomicRegion& active_region,
                          const Latents& latents) const
 {
+    profiling::StageTimer timer {profiling::Stage::phasing};
     if (debug_log_) stream(*debug_log_) << "Trying to find complete phase regions in " << active_region;
     const auto active_candidates = contained_range(candidates, active_region);
     const auto viable_phase_regions = extract_regions(active_candidates);
@@ -893,10 +915,12 @@ void Caller::call_variants(const GenomicRegion& active_region,
                            const HaplotypeBlock& haplotypes,
                            const HaplotypeLikelihoodArray& haplotype_likelihoods,
                            const ReadMap& reads,
+                           const boost::variant<ReadMap, TemplateMap>& active_reads,
                            const Latents& latents,
                            std::deque<CallWrapper>& result,
                            boost::optional<GenomicRegion>& prev_called_region,
-                           GenomicRegion& completed_region) const
+                           GenomicRegion& completed_region,
+                           ReadAssignmentBlocks& read_assignments) const
 {
     const auto passed_region = get_passed_region(active_region, next_active_region, backtrack_region);
     const auto uncalled_region = get_uncalled_region(active_region, passed_region, completed_region);
@@ -919,11 +943,154 @@ void Caller::call_variants(const GenomicRegion& active_region,
         const auto itr = utils::append(std::move(reference_calls), calls);
         std::inplace_merge(std::begin(calls), itr, std::end(calls));
     }
+    if (read_assignment_spill_ && !calls.empty()) {
+        assign_reads(uncalled_region, haplotypes, haplotype_likelihoods, active_reads, latents, read_assignments);
+    }
     utils::append(std::move(calls), result);
     prev_called_region = uncalled_region;
     completed_region = encompassing_region(completed_region, passed_region);
 }
 
+namespace {
+
+template <typename UnaryFunction>
+void for_each_read(const ReadMap& reads, const SampleName& sample, UnaryFunction f)
+{
+    const auto sample_itr = reads.find(sample);
+    if (sample_itr == std::cend(reads)) return;
+    std::size_t read_idx {0};
+    for (const AlignedRead& read : sample_itr->second) f(read, read_idx++);
+}
+
+// Each template has a single likelihood so all reads in the template share an index
+template <typename UnaryFunction>
+void for_each_read(const TemplateMap& reads, const SampleName& sample, UnaryFunction f)
+{
+    const auto sample_itr = reads.find(sample);
+    if (sample_itr == std::cend(reads)) return;
+    std::size_t template_idx {0};
+    for (const AlignedTemplate& read_template : sample_itr->second) {
+        for (const AlignedRead& read : read_template) f(read, template_idx);
+        ++template_idx;
+    }
+}
+
+template <typename Container>
+std::size_t index_of(const Haplotype& haplotype, Container& haplotypes)
+{
+    const auto itr = std::find(std::cbegin(haplotypes), std::cend(haplotypes), haplotype);
+    if (itr != std::cend(haplotypes)) return std::distance(std::cbegin(haplotypes), itr);
+    haplotypes.push_back(haplotype);
+    return haplotypes.size() - 1;
+}
+
+boost::optional<ReadAssignmentSpill::AlleleIndex>
+find_allele_index(const Haplotype& haplotype, const VcfRecord& call)
+{
+    if (!contains(mapped_region(haplotype), mapped_region(call))) return boost::none;
+    const auto allele = haplotype.sequence(mapped_region(call));
+    if (allele == call.ref()) return 0;
+    const auto alt_itr = std::find(std::cbegin(call.alt()), std::cend(call.alt()), allele);
+    const auto alt_idx = static_cast<std::size_t>(std::distance(std::cbegin(call.alt()), alt_itr));
+    if (alt_itr == std::cend(call.alt()) || alt_idx >= std::numeric_limits<ReadAssignmentSpill::AlleleIndex>::max()) {
+        return boost::none;
+    }
+    return alt_idx + 1;
+}
+
+} // namespace
+
+void Caller::assign_reads(const GenomicRegion& region, const HaplotypeBlock& haplotypes,
+                          const HaplotypeLikelihoodArray& haplotype_likelihoods,
+                          const boost::variant<ReadMap, TemplateMap>& active_reads,
+                          const Latents& latents, ReadAssignmentBlocks& result) const
+{
+    // Each read is assigned to the called haplotype with the greatest likelihood, if there is a unique one
+    ReadAssignmentBlock block {region, {}, {}};
+    block.assignments.reserve(samples_.size());
+    for (const auto& sample : samples_) {
+        std::vector<Haplotype> sample_haplotypes {};
+        for (const auto& haplotype : call_genotype(latents, sample)) {
+            sample_haplotypes.push_back(haplotype.haplotype());
+        }
+        std::sort(std::begin(sample_haplotypes), std::end(sample_haplotypes));
+        sample_haplotypes.erase(std::unique(std::begin(sample_haplotypes), std::end(sample_haplotypes)), std::end(sample_haplotypes));
+        if (sample_haplotypes.size() == 1 && !is_reference(sample_haplotypes.front())) {
+            // Reads that do not support a homozygous call should be assigned to the reference
+            const auto reference_itr = find_reference(haplotypes);
+            if (reference_itr == std::cend(haplotypes)) return;
+            sample_haplotypes.push_back(*reference_itr);
+        }
+        const auto has_likelihoods = [&] (const Haplotype& haplotype) { return haplotype_likelihoods.contains(haplotype); };
+        if (!std::all_of(std::cbegin(sample_haplotypes), std::cend(sample_haplotypes), has_likelihoods)) return;
+        std::vector<std::size_t> haplotype_indices {};
+        std::vector<std::reference_wrapper<const HaplotypeLikelihoodArray::LikelihoodVector>> likelihoods {};
+        for (const auto& haplotype : sample_haplotypes) {
+            haplotype_indices.push_back(index_of(haplotype, block.haplotypes));
+            likelihoods.push_back(std::cref(haplotype_likelihoods(sample, haplotype)));
+        }
+        auto& sample_assignments = block.assignments[sample];
+        boost::apply_visitor([&] (const auto& reads) {
+            for_each_read(reads, sample, [&] (const AlignedRead& read, const std::size_t read_idx) {
+                boost::optional<std::size_t> best {};
+                bool is_tied {false};
+                for (std::size_t h {0}; h < likelihoods.size(); ++h) {
+                    const auto& likelihood = likelihoods[h].get()[read_idx];
+                    if (!best || likelihood > likelihoods[*best].get()[read_idx]) {
+                        best = h;
+                        is_tied = false;
+                    } else if (likelihood == likelihoods[*best].get()[read_idx]) {
+                        is_tied = true;
+                    }
+                }
+                if (best && (!is_tied || likelihoods.size() == 1)) {
+                    sample_assignments.push_back({make_read_key(read), contig_region(read), haplotype_indices[*best]});
+                }
+            });
+        }, active_reads);
+    }
+    result.push_back(std::move(block));
+}
+
+void Caller::spill_read_assignments(const std::deque<VcfRecord>& calls, const ReadAssignmentBlocks& read_assignments) const
+{
+    assert(read_assignment_spill_);
+    std::vector<boost::optional<ReadAssignmentSpill::RecordAssignments>> call_assignments(calls.size());
+    for (std::size_t call_idx {0}; call_idx < calls.size(); ++call_idx) {
+        const auto& call = calls[call_idx];
+        // Later blocks are called with more information, so prefer these
+        const auto block_itr = std::find_if(std::crbegin(read_assignments), std::crend(read_assignments),
+                                            [&] (const ReadAssignmentBlock& block) {
+                                                return !block.haplotypes.empty() && overlaps(block.region, mapped_region(call))
+                                                    && contains(mapped_region(block.haplotypes.front()), mapped_region(call));
+                                            });
+        if (block_itr == std::crend(read_assignments)) continue;
+        std::vector<boost::optional<ReadAssignmentSpill::AlleleIndex>> haplotype_alleles {};
+        haplotype_alleles.reserve(block_itr->haplotypes.size());
+        for (const auto& haplotype : block_itr->haplotypes) {
+            haplotype_alleles.push_back(find_allele_index(haplotype, call));
+        }
+        const auto call_region = contig_region(mapped_region(call));
+        ReadAssignmentSpill::RecordAssignments assignments {};
+        assignments.reserve(block_itr->assignments.size());
+        for (const auto& p : block_itr->assignments) {
+            auto& sample_assignments = assignments[p.first];
+            for (const auto& assignment : p.second) {
+                if (overlaps(assignment.region, call_region) && haplotype_alleles[assignment.haplotype]) {
+                    sample_assignments.push_back({assignment.read, *haplotype_alleles[assignment.haplotype]});
+                }
+            }
+            std::sort(std::begin(sample_assignments), std::end(sample_assignments),
+                      [] (const auto& lhs, const auto& rhs) { return lhs.read < rhs.read; });
+            const auto last = std::unique(std::begin(sample_assignments), std::end(sample_assignments),
+                                          [] (const auto& lhs, const auto& rhs) { return lhs.read == rhs.read; });
+            sample_assignments.erase(last, std::end(sample_assignments));
+        }
+        call_assignments[call_idx] = std::move(assignments);
+    }
+    read_assignment_spill_->get().write(calls, call_assignments);
+}
+
 Genotype<IndexedHaplotype<>> Caller::call_genotype(const Latents& latents, const SampleName& sample) const
 {
     const auto genotype_posteriors_ptr = latents.genotype_posteriors();
@@ -1033,6 +1200,7 @@ void Caller::set_phasing(std::vector<CallWrapper>& calls,
                          const HaplotypeBlock& haplotypes,
                          const GenomicRegion& call_region) const
 {
+    profiling::StageTimer timer {profiling::Stage::phasing};
     if (debug_log_) stream(*debug_log_) << "Phasing " << calls.size() << " calls in " << call_region;
     if (trace_log_) debug::print_genotype_posteriors(stream(*trace_log_), *latents.genotype_posteriors());
     const auto call_regions = extract_regions(calls);
@@ -1058,6 +1226,7 @@ bool check_reference(const std::vector<Variant>& variants, const ReferenceGenome
 
 MappableFlatSet<Variant> Caller::generate_candidate_variants(const GenomicRegion& region) const
 {
+    profiling::StageTimer timer {profiling::Stage::candidate_generation};
     if (debug_log_) stream(*debug_log_) << "Generating candidate variants in region " << region;
     auto raw_candidates = candidate_generator_.generate(region);
     if (debug_log_) debug::print_left_aligned_candidates(stream(*debug_log_), raw_candidates, reference_);
@@ -1082,7 +1251,8 @@ Caller::make_haplotype_generator(const MappableFlatSet<Variant>& candidates,
 
 HaplotypeLikelihoodArray Caller::make_haplotype_likelihood_cache() const
 {
-    return HaplotypeLikelihoodArray {likelihood_model_, parameters_.max_haplotypes, samples_};
+    return HaplotypeLikelihoodArray {likelihood_model_, parameters_.max_haplotypes, samples_, parameters_.likelihood_execution_policy,
+                                     parameters_.max_alignment_memo_footprint};
 }
 
 VcfRecordFactory Caller::make_record_factory(const ReadMap& reads) const
@@ -1135,6 +1305,7 @@ bool Caller::compute_haplotype_likelihoods(HaplotypeLikelihoodArray& haplotype_l
                                            const boost::variant<ReadMap, TemplateMap>& active_reads) const
 {
     assert(haplotype_likelihoods.is_empty());
+    profiling::StageTimer timer {profiling::Stage::haplotype_likelihoods};
     boost::optional<HaplotypeLikelihoodArray::FlankState> flank_state {};
     if (debug_log_) {
         stream(*debug_log_) << "Calculating likelihoods for " << haplotypes.size() << " haplotypes";
@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <deque>
+#include <unordered_map>
 #include <typeindex>
 #include <set>
 
@@ -16,6 +17,7 @@
 #include <boost/variant.hpp>
 
 #include "config/common.hpp"
+#include "basics/contig_region.hpp"
 #include "basics/genomic_region.hpp"
 #include "basics/read_pileup.hpp"
 #include "core/types/variant.hpp"
@@ -24,6 +26,7 @@
 #include "core/tools/coretools.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 #include "core/tools/vcf_record_factory.hpp"
+#include "core/tools/read_assignment_spill.hpp"
 #include "containers/mappable_flat_set.hpp"
 #include "containers/probability_matrix.hpp"
 #include "containers/mappable_block.hpp"
@@ -58,6 +61,7 @@ public:
         HaplotypeLikelihoodModel likelihood_model;
         Phaser phaser;
         boost::optional<BadRegionDetector> bad_region_detector = boost::none;
+        boost::optional<std::reference_wrapper<ReadAssignmentSpill>> read_assignment_spill = boost::none;
     };
     
     struct Parameters
@@ -70,7 +74,9 @@ public:
         ModelPosteriorPolicy model_posterior_policy;
         bool protect_reference_haplotype;
         boost::optional<MemoryFootprint> target_max_memory;
+        MemoryFootprint max_alignment_memo_footprint;
         ExecutionPolicy execution_policy;
+        ExecutionPolicy likelihood_execution_policy;
         ReadLinkageType read_linkage;
         bool try_early_phase_detection;
     };
@@ -128,12 +134,28 @@ private:
     
     using GenotypeCallMap = Phaser::GenotypeCallMap;
     
+    // The reads assigned to the called haplotypes of an active region
+    struct ReadAssignmentBlock
+    {
+        struct Assignment
+        {
+            ReadAssignmentSpill::ReadKey read;
+            ContigRegion region;
+            std::size_t haplotype;
+        };
+        GenomicRegion region;
+        std::vector<Haplotype> haplotypes;
+        std::unordered_map<SampleName, std::vector<Assignment>> assignments;
+    };
+    using ReadAssignmentBlocks = std::deque<ReadAssignmentBlock>;
+    
     std::reference_wrapper<const ReadPipe> read_pipe_;
     mutable VariantGenerator candidate_generator_;
     HaplotypeGenerator::Builder haplotype_generator_builder_;
     HaplotypeLikelihoodModel likelihood_model_;
     Phaser phaser_;
     boost::optional<BadRegionDetector> bad_region_detector_;
+    boost::optional<std::reference_wrapper<ReadAssignmentSpill>> read_assignment_spill_;
     Parameters parameters_;
     
     // virtual methods
@@ -179,7 +201,8 @@ private:
                   const ReadMap& reads,
                   const boost::optional<TemplateMap>& read_templates,
                   HaplotypeGenerator& haplotype_generator,
-                  ProgressMeter& progress_meter) const;
+                  ProgressMeter& progress_meter,
+                  ReadAssignmentBlocks& read_assignments) const;
     bool refcalls_requested() const noexcept;
     MappableFlatSet<Variant> generate_candidate_variants(const GenomicRegion& region) const;
     HaplotypeGenerator 
@@ -230,8 +253,15 @@ private:
                        const boost::optional<GenomicRegion>& backtrack_region,
                        const MappableFlatSet<Variant>& candidates, const HaplotypeBlock& haplotypes,
                        const HaplotypeLikelihoodArray& haplotype_likelihoods, const ReadMap& reads,
+                       const boost::variant<ReadMap, TemplateMap>& active_reads,
                        const Latents& latents, std::deque<CallWrapper>& result,
-                       boost::optional<GenomicRegion>& prev_called_region, GenomicRegion& completed_region) const;
+                       boost::optional<GenomicRegion>& prev_called_region, GenomicRegion& completed_region,
+                       ReadAssignmentBlocks& read_assignments) const;
+    void assign_reads(const GenomicRegion& region, const HaplotypeBlock& haplotypes,
+                      const HaplotypeLikelihoodArray& haplotype_likelihoods,
+                      const boost::variant<ReadMap, TemplateMap>& active_reads,
+                      const Latents& latents, ReadAssignmentBlocks& result) const;
+    void spill_read_assignments(const std::deque<VcfRecord>& calls, const ReadAssignmentBlocks& read_assignments) const;
     GenotypeCallMap get_genotype_calls(const Latents& latents) const;
     std::deque<Haplotype> get_called_haplotypes(const Latents& latents) const;
     void set_model_posteriors(std::vector<CallWrapper>& calls, const Latents& latents,
@@ -27,6 +27,7 @@ CallerBuilder::CallerBuilder(const ReferenceGenome& reference, const ReadPipe& r
     params_.general.haplotype_extension_threshold = 1e-10;
     params_.general.saturation_limit = 0.9;
     params_.general.max_haplotypes = 200;
+    params_.general.max_alignment_memo_footprint = MemoryFootprint {100'000'000};
     factory_ = generate_factory();
 }
 
@@ -129,12 +130,24 @@ CallerBuilder& CallerBuilder::set_target_memory_footprint(MemoryFootprint memory
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_max_alignment_memo_footprint(MemoryFootprint memory) noexcept
+{
+    params_.general.max_alignment_memo_footprint = memory;
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_execution_policy(ExecutionPolicy policy) noexcept
 {
     params_.general.execution_policy = policy;
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_likelihood_execution_policy(ExecutionPolicy policy) noexcept
+{
+    params_.general.likelihood_execution_policy = policy;
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_read_linkage(ReadLinkageType linkage) noexcept
 {
     params_.general.read_linkage = linkage;
@@ -147,6 +160,12 @@ CallerBuilder& CallerBuilder::set_bad_region_detector(BadRegionDetector detector
     return *this;
 }
 
+CallerBuilder& CallerBuilder::set_read_assignment_spill(ReadAssignmentSpill& spill) noexcept
+{
+    components_.read_assignment_spill = spill;
+    return *this;
+}
+
 CallerBuilder& CallerBuilder::set_min_variant_posterior(Phred<double> posterior) noexcept
 {
     params_.min_variant_posterior = posterior;
@@ -388,6 +407,7 @@ std::unique_ptr<Caller> CallerBuilder::build(const ContigName& contig) const
     if (factory_.count(caller_) == 0) {
         throw std::runtime_error {"CallerBuilder: unknown caller " + caller_};
     }
+    std::lock_guard<std::mutex> lock {build_mutex_};
     requested_contig_ = contig;
     return factory_.at(caller_)();
 }
@@ -403,7 +423,8 @@ Caller::Components CallerBuilder::make_components() const
         components_.haplotype_generator_builder,
         components_.likelihood_model,
         Phaser {Phaser::Config {Phaser::GenotypeMatchType::exact, params_.min_phase_score}},
-        components_.bad_region_detector
+        components_.bad_region_detector,
+        components_.read_assignment_spill
     };
 }
 
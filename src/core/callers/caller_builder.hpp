@@ -8,6 +8,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <mutex>
 
 #include <boost/optional.hpp>
 
@@ -54,9 +55,12 @@ public:
     CallerBuilder& set_sites_only() noexcept;
     CallerBuilder& set_reference_haplotype_protection(bool b) noexcept;
     CallerBuilder& set_target_memory_footprint(MemoryFootprint memory) noexcept;
+    CallerBuilder& set_max_alignment_memo_footprint(MemoryFootprint memory) noexcept;
     CallerBuilder& set_execution_policy(ExecutionPolicy policy) noexcept;
+    CallerBuilder& set_likelihood_execution_policy(ExecutionPolicy policy) noexcept;
     CallerBuilder& set_read_linkage(ReadLinkageType linkage) noexcept;
     CallerBuilder& set_bad_region_detector(BadRegionDetector detector) noexcept;
+    CallerBuilder& set_read_assignment_spill(ReadAssignmentSpill& spill) noexcept;
     
     CallerBuilder& set_min_variant_posterior(Phred<double> posterior) noexcept;
     CallerBuilder& set_min_refcall_posterior(Phred<double> posterior) noexcept;
@@ -121,6 +125,7 @@ private:
         HaplotypeLikelihoodModel likelihood_model;
         Phaser phaser;
         boost::optional<BadRegionDetector> bad_region_detector = boost::none;
+        boost::optional<std::reference_wrapper<ReadAssignmentSpill>> read_assignment_spill = boost::none;
     };
     
     struct Parameters
@@ -177,6 +182,7 @@ private:
     CallerFactoryMap factory_;
     
     mutable boost::optional<ContigName> requested_contig_;
+    mutable std::mutex build_mutex_; // calling windows build their callers concurrently
     
     Caller::Components make_components() const;
     CallerFactoryMap generate_factory() const;
@@ -26,6 +26,12 @@ CallerFactory& CallerFactory::set_read_pipe(ReadPipe& read_pipe) noexcept
     return *this;
 }
 
+CallerFactory& CallerFactory::set_read_assignment_spill(ReadAssignmentSpill& spill) noexcept
+{
+    template_builder_.set_read_assignment_spill(spill);
+    return *this;
+}
+
 std::unique_ptr<Caller> CallerFactory::make(const ContigName& contig) const
 {
     return template_builder_.build(contig);
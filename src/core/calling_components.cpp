@@ -9,9 +9,12 @@
 #include <algorithm>
 #include <functional>
 #include <exception>
+#include <memory>
+#include <cassert>
 
 #include "config/config.hpp"
 #include "config/option_collation.hpp"
+#include "basics/packed_read_batch.hpp"
 #include "utils/map_utils.hpp"
 #include "logging/logging.hpp"
 #include "exceptions/user_error.hpp"
@@ -100,6 +103,16 @@ std::size_t GenomeCallingComponents::read_buffer_size() const noexcept
     return components_.read_buffer_size;
 }
 
+std::size_t GenomeCallingComponents::packed_read_buffer_size() const noexcept
+{
+    return components_.packed_read_buffer_size;
+}
+
+std::size_t GenomeCallingComponents::prefetching_packed_read_buffer_size() const noexcept
+{
+    return components_.prefetching_packed_read_buffer_size;
+}
+
 const boost::optional<GenomeCallingComponents::Path>& GenomeCallingComponents::temp_directory() const noexcept
 {
     return components_.temp_directory;
@@ -392,7 +405,8 @@ bool require_temp_dir_for_filtering(const options::OptionMap& options)
 
 bool is_temp_directory_needed(const options::OptionMap& options)
 {
-    return is_multithreaded_run(options) || require_temp_dir_for_filtering(options);
+    return is_multithreaded_run(options) || require_temp_dir_for_filtering(options)
+           || options::reuse_calling_read_assignments(options);
 }
 
 boost::optional<fs::path> get_temp_directory(const options::OptionMap& options)
@@ -460,25 +474,47 @@ static const AlignedRead typical_illumina_read {
 
 } // namespace
 
+auto estimate_read_memory_footprint(const ReadSetProfile::ReadMemoryStats& stats,
+                                    const boost::optional<ReadSetProfile::ReadMemoryStats>& fragmented_stats) noexcept
+{
+    MemoryFootprint result {std::min(stats.mean + stats.stdev, stats.max)};
+    if (fragmented_stats) result += fragmented_stats->median;
+    return result;
+}
+
 auto estimate_read_memory_footprint(const boost::optional<ReadSetProfile>& profile) noexcept
 {
     MemoryFootprint result;
     if (profile) {
-        result = std::min(profile->memory_stats.mean + profile->memory_stats.stdev, profile->memory_stats.max);
-        if (profile->fragmented_memory_stats) {
-            result += profile->fragmented_memory_stats->median;
-        }
+        result = estimate_read_memory_footprint(profile->memory_stats, profile->fragmented_memory_stats);
     } else {
         result = footprint(typical_illumina_read);
-        logging::WarningLogger log {};
-        log << "Could not estimate read size from data, resorting to default";
+        static bool warned {false};
+        if (!warned) {
+            logging::WarningLogger log {};
+            log << "Could not estimate read size from data, resorting to default";
+            warned = true;
+        }
     }
     auto debug_log = logging::get_debug_log();
     if (debug_log) stream(*debug_log) << "Estimated read memory footprint is " << result;
     return result;
 }
 
-std::size_t calculate_max_num_reads(MemoryFootprint max_buffer_size, const boost::optional<ReadSetProfile>& profile) noexcept
+auto estimate_packed_read_memory_footprint(const boost::optional<ReadSetProfile>& profile) noexcept
+{
+    MemoryFootprint result;
+    if (profile) {
+        result = estimate_read_memory_footprint(profile->packed_memory_stats, profile->packed_fragmented_memory_stats);
+    } else {
+        result = packed_footprint(typical_illumina_read);
+    }
+    auto debug_log = logging::get_debug_log();
+    if (debug_log) stream(*debug_log) << "Estimated packed read memory footprint is " << result;
+    return result;
+}
+
+auto check_read_buffer_footprint(MemoryFootprint max_buffer_size) noexcept
 {
     static constexpr MemoryFootprint min_buffer_size {50'000'000}; // 50Mb
     if (max_buffer_size < min_buffer_size) {
@@ -492,10 +528,28 @@ std::size_t calculate_max_num_reads(MemoryFootprint max_buffer_size, const boost
         }
         max_buffer_size = min_buffer_size;
     }
-    auto estimated_read_footprint = estimate_read_memory_footprint(profile);
-    return max_buffer_size.bytes() / estimated_read_footprint.bytes();
+    return max_buffer_size;
+}
+
+} // namespace
+
+std::size_t calculate_max_num_reads(MemoryFootprint max_buffer_size, const boost::optional<ReadSetProfile>& profile) noexcept
+{
+    return check_read_buffer_footprint(max_buffer_size).bytes() / estimate_read_memory_footprint(profile).bytes();
 }
 
+std::size_t calculate_max_num_packed_reads(MemoryFootprint max_buffer_size, const boost::optional<ReadSetProfile>& profile,
+                                           const bool prefetch) noexcept
+{
+    // Buffers are fetched unpacked and packed sample by sample, so each read briefly costs both
+    const auto packed_read_footprint = estimate_packed_read_memory_footprint(profile);
+    auto read_footprint = estimate_read_memory_footprint(profile) + packed_read_footprint;
+    if (prefetch) read_footprint += packed_read_footprint; // the current buffer is held during the fetch
+    return check_read_buffer_footprint(max_buffer_size).bytes() / read_footprint.bytes();
+}
+
+namespace {
+
 auto add_identifier(const fs::path& base, const std::string& identifier)
 {
     const auto old_stem  = base.stem();
@@ -588,6 +642,8 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
 , num_threads {options::get_num_threads(options)}
 , read_buffer_footprint {options::get_target_read_buffer_size(options)}
 , read_buffer_size {}
+, packed_read_buffer_size {}
+, prefetching_packed_read_buffer_size {}
 , progress_meter {regions}
 , pedigree {options::get_pedigree(options, samples)}
 , sites_only {options::call_sites_only(options)}
@@ -608,6 +664,7 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
     temp_directory = get_temp_directory(options);
     try {
         call_filter_factory = options::make_call_filter_factory(this->reference, this->read_pipe, options, this->temp_directory);
+        setup_read_assignment_spill(options);
         setup_writers(options);
     } catch (...) {
         if (temp_directory) fs::remove_all(*temp_directory);
@@ -640,6 +697,8 @@ void GenomeCallingComponents::Components::set_read_buffer_size(const options::Op
 {
     if (!samples.empty() && !regions.empty() && read_manager.good()) {
         read_buffer_size = calculate_max_num_reads(options::get_target_read_buffer_size(options), reads_profile);
+        packed_read_buffer_size = calculate_max_num_packed_reads(options::get_target_read_buffer_size(options), reads_profile);
+        prefetching_packed_read_buffer_size = calculate_max_num_packed_reads(options::get_target_read_buffer_size(options), reads_profile, true);
     }
 }
 
@@ -664,6 +723,16 @@ void GenomeCallingComponents::Components::setup_writers(const options::OptionMap
     }
 }
 
+void GenomeCallingComponents::Components::setup_read_assignment_spill(const options::OptionMap& options)
+{
+    if (call_filter_factory && options::reuse_calling_read_assignments(options)) {
+        assert(temp_directory);
+        read_assignment_spill = std::make_unique<ReadAssignmentSpill>(*temp_directory / "read_assignments.bin", samples);
+        caller_factory.set_read_assignment_spill(*read_assignment_spill);
+        call_filter_factory->set_read_assignment_spill(*read_assignment_spill);
+    }
+}
+
 void GenomeCallingComponents::Components::setup_filter_read_pipe(const options::OptionMap& options)
 {
     if (!options::use_calling_read_pipe_for_call_filtering(options)) {
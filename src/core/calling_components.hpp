@@ -26,6 +26,7 @@
 #include "core/csr/filters/variant_call_filter_factory.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
+#include "core/tools/read_assignment_spill.hpp"
 #include "utils/memory_footprint.hpp"
 #include "utils/input_reads_profiler.hpp"
 #include "logging/progress_meter.hpp"
@@ -61,6 +62,8 @@ public:
     const VcfWriter& output() const noexcept;
     MemoryFootprint read_buffer_footprint() const noexcept;
     std::size_t read_buffer_size() const noexcept;
+    std::size_t packed_read_buffer_size() const noexcept;
+    std::size_t prefetching_packed_read_buffer_size() const noexcept;
     const boost::optional<Path>& temp_directory() const noexcept;
     boost::optional<unsigned> num_threads() const noexcept;
     const HaplotypeLikelihoodModel& haplotype_likelihood_model() const noexcept;
@@ -113,7 +116,7 @@ private:
         boost::optional<VcfWriter> filtered_output;
         boost::optional<unsigned> num_threads;
         MemoryFootprint read_buffer_footprint;
-        std::size_t read_buffer_size;
+        std::size_t read_buffer_size, packed_read_buffer_size, prefetching_packed_read_buffer_size;
         ProgressMeter progress_meter;
         boost::optional<Pedigree> pedigree;
         bool sites_only;
@@ -127,10 +130,12 @@ private:
         // exception handling easier.
         boost::optional<Path> temp_directory;
         std::unique_ptr<VariantCallFilterFactory> call_filter_factory;
+        std::unique_ptr<ReadAssignmentSpill> read_assignment_spill;
         
         void setup_progress_meter(const options::OptionMap& options);
         void set_read_buffer_size(const options::OptionMap& options);
         void setup_writers(const options::OptionMap& options);
+        void setup_read_assignment_spill(const options::OptionMap& options);
         void setup_filter_read_pipe(const options::OptionMap& options);
     };
     
@@ -141,6 +146,13 @@ private:
 
 GenomeCallingComponents collate_genome_calling_components(const options::OptionMap& options);
 
+// The number of reads that fit in a read buffer of the given footprint
+std::size_t calculate_max_num_reads(MemoryFootprint max_buffer_size, const boost::optional<ReadSetProfile>& profile) noexcept;
+// The number of reads that fit in a BufferedReadPipe of the given footprint, which holds reads packed
+// but fetches them unpacked. A prefetching pipe also holds its current buffer while fetching the next.
+std::size_t calculate_max_num_packed_reads(MemoryFootprint max_buffer_size, const boost::optional<ReadSetProfile>& profile,
+                                           bool prefetch = false) noexcept;
+
 bool validate(const GenomeCallingComponents& components);
 
 void cleanup(GenomeCallingComponents& components) noexcept;
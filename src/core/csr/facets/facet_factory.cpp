@@ -80,6 +80,7 @@ FacetFactory::FacetFactory(FacetFactory&& other)
 , ploidies_ {std::move(other.ploidies_)}
 , pedigree_ {std::move(other.pedigree_)}
 , likelihood_model_ {std::move(other.likelihood_model_)}
+, read_assignment_spill_ {std::move(other.read_assignment_spill_)}
 , facet_makers_ {}
 {
     setup_facet_makers();
@@ -95,10 +96,16 @@ FacetFactory& FacetFactory::operator=(FacetFactory&& other)
     swap(ploidies_, other.ploidies_);
     swap(pedigree_, other.pedigree_);
     swap(likelihood_model_, other.likelihood_model_);
+    swap(read_assignment_spill_, other.read_assignment_spill_);
     setup_facet_makers();
     return *this;
 }
 
+void FacetFactory::set_read_assignment_spill(const ReadAssignmentSpill& spill) noexcept
+{
+    read_assignment_spill_ = spill;
+}
+
 class UnknownFacet : public ProgramError
 {
     std::string do_where() const override { return "FacetFactory::make"; }
@@ -190,6 +197,16 @@ bool requires_pedigree(const std::vector<std::string>& facets) noexcept
     return std::any_of(std::cbegin(facets), std::cend(facets), [](const auto& facet) { return requires_pedigree(facet); });
 }
 
+// Reference calls may not have called assignments, but these are not needed to assign reads
+bool has_all_variant_calls(const std::vector<VcfRecord>& calls,
+                           const std::vector<boost::optional<ReadAssignmentSpill::RecordAssignments>>& assignments) noexcept
+{
+    for (std::size_t i {0}; i < calls.size(); ++i) {
+        if (!assignments[i] && !is_refcall(calls[i])) return false;
+    }
+    return true;
+}
+
 } // namespace
 
 class BadFacetFactoryRequest : public ProgramError
@@ -222,6 +239,7 @@ FacetFactory::make(const std::vector<std::string>& names,
         futures.reserve(blocks.size());
         const auto fetch_reads = requires_reads(names);
         const auto fetch_genotypes = requires_genotypes(names);
+        const auto fetch_read_assignments = can_reuse_read_assignments(names);
         for (const auto& block : blocks) {
             // It's faster to fetch reads serially from left to right, so do this outside the thread pool
             BlockData data {};
@@ -231,6 +249,9 @@ FacetFactory::make(const std::vector<std::string>& names,
                 if (fetch_reads) {
                     data.reads = read_pipe_->fetch_reads(*data.region);
                 }
+                if (fetch_read_assignments) {
+                    data.read_assignments = read_assignment_spill_->get().fetch(block);
+                }
             }
             futures.push_back(workers.push([this, &names, data {std::move(data)}, &block, fetch_genotypes] () mutable {
                 if (fetch_genotypes) {
@@ -268,6 +289,9 @@ void FacetFactory::setup_facet_makers()
     facet_makers_[name<ReadAssignments>()] = [this] (const BlockData& block) -> FacetWrapper
     {
         assert(block.reads && block.genotypes);
+        if (block.read_assignments && has_all_variant_calls(*block.calls, *block.read_assignments)) {
+            return {std::make_unique<ReadAssignments>(*reference_, *block.genotypes, *block.reads, *block.calls, *block.read_assignments)};
+        }
         if (likelihood_model_) {
             return {std::make_unique<ReadAssignments>(*reference_, *block.genotypes, *block.reads, *block.calls, *likelihood_model_)};
         } else {
@@ -390,9 +414,17 @@ FacetFactory::BlockData FacetFactory::make_block_data(const std::vector<std::str
         if (requires_genotypes(names)) {
             result.genotypes = extract_genotypes(block, samples_, *reference_);
         }
+        if (can_reuse_read_assignments(names)) {
+            result.read_assignments = read_assignment_spill_->get().fetch(block);
+        }
     }
     return result;
 }
 
+bool FacetFactory::can_reuse_read_assignments(const std::vector<std::string>& names) const noexcept
+{
+    return read_assignment_spill_ && std::find(std::cbegin(names), std::cend(names), name<ReadAssignments>()) != std::cend(names);
+}
+
 } // namespace csr
 } // namespace octopus
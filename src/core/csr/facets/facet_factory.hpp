@@ -19,6 +19,7 @@
 #include "io/variant/vcf_record.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
+#include "core/tools/read_assignment_spill.hpp"
 #include "utils/genotype_reader.hpp"
 #include "utils/thread_pool.hpp"
 #include "facet.hpp"
@@ -53,6 +54,9 @@ public:
     
     ~FacetFactory() = default;
     
+    // ReadAssignments reuses the caller's assignments for blocks where all calls have them
+    void set_read_assignment_spill(const ReadAssignmentSpill& spill) noexcept;
+    
     FacetWrapper make(const std::string& name, const CallBlock& block) const;
     FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
     std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks, ThreadPool& workers) const;
@@ -64,6 +68,7 @@ private:
         boost::optional<GenomicRegion> region;
         boost::optional<ReadMap> reads;
         boost::optional<GenotypeMap> genotypes;
+        boost::optional<std::vector<boost::optional<ReadAssignmentSpill::RecordAssignments>>> read_assignments;
     };
     
     VcfHeader input_header_;
@@ -73,6 +78,7 @@ private:
     boost::optional<PloidyMap> ploidies_;
     boost::optional<octopus::Pedigree> pedigree_;
     boost::optional<HaplotypeLikelihoodModel> likelihood_model_;
+    boost::optional<std::reference_wrapper<const ReadAssignmentSpill>> read_assignment_spill_;
     
     std::unordered_map<std::string, std::function<FacetWrapper(const BlockData& data)>> facet_makers_;
     
@@ -83,6 +89,7 @@ private:
     FacetBlock make(const std::vector<std::string>& names, const BlockData& block) const;
     FacetBlock make(const std::vector<std::string>& names, const BlockData& block, ThreadPool& workers) const;
     BlockData make_block_data(const std::vector<std::string>& names, const CallBlock& block) const;
+    bool can_reuse_read_assignments(const std::vector<std::string>& names) const noexcept;
 };
 
 } // namespace csr
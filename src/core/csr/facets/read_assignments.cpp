@@ -3,6 +3,11 @@
 
 #include "read_assignments.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <cassert>
+
 #include "core/tools/read_realigner.hpp"
 #include "utils/genotype_reader.hpp"
 
@@ -27,13 +32,36 @@ compute_allele_support(const std::vector<Allele>& alleles,
     return compute_allele_support(alleles, support.assigned_wrt_reference, support.ambiguous_wrt_reference);
 }
 
+boost::optional<ReadAssignmentSpill::AlleleIndex>
+find_called_allele(const ReadAssignmentSpill::RecordAssignments& assignments,
+                   const SampleName& sample, const ReadAssignmentSpill::ReadKey read)
+{
+    const auto sample_itr = assignments.find(sample);
+    if (sample_itr == std::cend(assignments)) return boost::none;
+    const auto& sample_assignments = sample_itr->second;
+    const auto itr = std::lower_bound(std::cbegin(sample_assignments), std::cend(sample_assignments), read,
+                                      [] (const auto& assignment, const auto& key) { return assignment.read < key; });
+    if (itr != std::cend(sample_assignments) && itr->read == read) {
+        return itr->allele;
+    } else {
+        return boost::none;
+    }
+}
+
+bool is_consistent(const Haplotype& haplotype, const VcfRecord& call, const ReadAssignmentSpill::AlleleIndex allele)
+{
+    if (!contains(mapped_region(haplotype), mapped_region(call))) return false;
+    const auto& called_allele = allele == 0 ? call.ref() : call.alt()[allele - 1];
+    return haplotype.sequence(mapped_region(call)) == called_allele;
+}
+
 } // namespace
 
 ReadAssignments::ReadAssignments(const ReferenceGenome& reference,
                                  const GenotypeMap& genotypes,
                                  const ReadMap& reads,
                                  const std::vector<VcfRecord>& calls)
-: ReadAssignments {reference, genotypes, reads, calls, {}} {}
+: ReadAssignments {reference, genotypes, reads, calls, HaplotypeLikelihoodModel {}} {}
 
 ReadAssignments::ReadAssignments(const ReferenceGenome& reference,
                                  const GenotypeMap& genotypes,
@@ -118,6 +146,96 @@ ReadAssignments::ReadAssignments(const ReferenceGenome& reference,
     }
 }
 
+ReadAssignments::ReadAssignments(const ReferenceGenome& reference,
+                                 const GenotypeMap& genotypes,
+                                 const ReadMap& reads,
+                                 const std::vector<VcfRecord>& calls,
+                                 const CalledAssignments& called_assignments)
+: result_ {}
+, likelihood_model_ {}
+{
+    assert(called_assignments.size() == calls.size());
+    const auto num_samples = genotypes.size();
+    result_.haplotypes.reserve(num_samples);
+    for (const auto& p : genotypes) {
+        const auto& sample = p.first;
+        const auto& sample_genotypes = p.second;
+        auto& sample_support = result_.haplotypes[sample];
+        sample_support.assigned_wrt_reference.reserve(sample_genotypes.size());
+        result_.alleles[sample] = {}; // make sure sample is present
+        for (const auto& genotype : sample_genotypes) {
+            auto local_reads = copy_overlapped_to_vector(reads.at(sample), genotype);
+            for (const auto& haplotype : genotype) {
+                // So every called haplotype appears in support map, even if no read support
+                sample_support.assigned_wrt_reference[haplotype] = {};
+            }
+            if (local_reads.empty()) continue;
+            HaplotypeSupportMap genotype_support {};
+            if (!is_heterozygous(genotype) && is_reference(genotype[0])) {
+                genotype_support[genotype[0]] = std::move(local_reads);
+            } else {
+                std::vector<Haplotype> haplotypes {std::cbegin(genotype), std::cend(genotype)};
+                std::sort(std::begin(haplotypes), std::end(haplotypes));
+                haplotypes.erase(std::unique(std::begin(haplotypes), std::end(haplotypes)), std::end(haplotypes));
+                if (haplotypes.size() == 1) {
+                    Haplotype ref {mapped_region(genotype), reference};
+                    sample_support.assigned_wrt_reference[ref] = {};
+                    haplotypes.push_back(std::move(ref));
+                }
+                std::vector<std::size_t> called_indices {};
+                for (std::size_t call_idx {0}; call_idx < calls.size(); ++call_idx) {
+                    if (called_assignments[call_idx] && overlaps(calls[call_idx], genotype)) {
+                        called_indices.push_back(call_idx);
+                    }
+                }
+                std::vector<bool> consistent(haplotypes.size());
+                for (auto& read : local_reads) {
+                    const auto read_key = make_read_key(read);
+                    std::fill(std::begin(consistent), std::end(consistent), true);
+                    bool has_called_allele {false};
+                    for (const auto call_idx : called_indices) {
+                        const auto& call = calls[call_idx];
+                        if (!overlaps(read, call)) continue;
+                        const auto allele = find_called_allele(*called_assignments[call_idx], sample, read_key);
+                        if (!allele || *allele > call.num_alt()) continue;
+                        has_called_allele = true;
+                        for (std::size_t h {0}; h < haplotypes.size(); ++h) {
+                            consistent[h] = consistent[h] && is_consistent(haplotypes[h], call, *allele);
+                        }
+                    }
+                    const auto num_consistent = std::count(std::cbegin(consistent), std::cend(consistent), true);
+                    if (!has_called_allele || num_consistent == 0) {
+                        sample_support.ambiguous_wrt_haplotype.emplace_back(std::move(read));
+                    } else if (num_consistent == 1) {
+                        const auto h = std::distance(std::cbegin(consistent), std::find(std::cbegin(consistent), std::cend(consistent), true));
+                        genotype_support[haplotypes[h]].push_back(std::move(read));
+                    } else {
+                        std::vector<std::shared_ptr<Haplotype>> possible_haplotypes {};
+                        for (std::size_t h {0}; h < haplotypes.size(); ++h) {
+                            if (consistent[h]) possible_haplotypes.push_back(std::make_shared<Haplotype>(haplotypes[h]));
+                        }
+                        sample_support.ambiguous_wrt_haplotype.emplace_back(std::move(read), std::move(possible_haplotypes));
+                    }
+                }
+            }
+            for (auto& s : genotype_support) {
+                auto& assigned_reads = s.second;
+                std::sort(std::begin(assigned_reads), std::end(assigned_reads));
+                sample_support.assigned_wrt_haplotype[s.first] = assigned_reads;
+                sample_support.assigned_wrt_reference[s.first] = std::move(assigned_reads);
+            }
+        }
+        sample_support.ambiguous_wrt_reference = sample_support.ambiguous_wrt_haplotype;
+        for (const auto& call : calls) {
+            auto alleles = get_called_alleles(call, sample).first;
+            auto allele_support = compute_allele_support(alleles, sample_support, sample);
+            for (auto& allele : alleles) {
+                result_.alleles[sample].emplace(std::move(allele), std::move(allele_support.at(allele)));
+            }
+        }
+    }
+}
+
 Facet::ResultType ReadAssignments::do_get() const
 {
     return std::cref(result_);
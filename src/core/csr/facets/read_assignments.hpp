@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <string>
 #include <functional>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -16,6 +17,7 @@
 #include "core/types/genotype.hpp"
 #include "core/models/haplotype_likelihood_model.hpp"
 #include "core/tools/read_assigner.hpp"
+#include "core/tools/read_assignment_spill.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "io/variant/vcf_record.hpp"
 
@@ -25,6 +27,8 @@ class ReadAssignments : public Facet
 {
 public:
     using ResultType = std::reference_wrapper<const SupportMaps>;
+    // The assignments made by the caller for each call, if available
+    using CalledAssignments = std::vector<boost::optional<ReadAssignmentSpill::RecordAssignments>>;
     
     ReadAssignments() = default;
     
@@ -37,6 +41,13 @@ public:
                     const ReadMap& reads,
                     const std::vector<VcfRecord>& calls,
                     HaplotypeLikelihoodModel model);
+    // Reads are assigned to the genotype haplotypes consistent with the alleles the caller assigned them to,
+    // and keep their input alignments.
+    ReadAssignments(const ReferenceGenome& reference,
+                    const GenotypeMap& genotypes,
+                    const ReadMap& reads,
+                    const std::vector<VcfRecord>& calls,
+                    const CalledAssignments& called_assignments);
     
 private:
     static const std::string name_;
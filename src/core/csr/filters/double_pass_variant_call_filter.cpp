@@ -7,6 +7,7 @@
 #include <iterator>
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 #include <boost/range/combine.hpp>
 
@@ -29,8 +30,11 @@ DoublePassVariantCallFilter::DoublePassVariantCallFilter(FacetFactory facet_fact
 , temp_directory_ {std::move(temp_directory)}
 {}
 
-void DoublePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const
+void DoublePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header,
+                                         const OptionalContig& contig) const
 {
+    // Classification needs state built from every call, so the whole file must be filtered at once
+    if (contig) throw std::logic_error {"DoublePassVariantCallFilter: cannot filter a single contig"};
     assert(dest.is_header_written());
     const auto samples = source.fetch_header().samples();
     const auto annotated_source_path = make_registration_pass(source, dest_header);
@@ -58,7 +58,7 @@ private:
     virtual void log_filter_pass_start(Log& log) const;
     virtual Classification classify(std::size_t call_idx, std::size_t sample_idx) const = 0;
     
-    void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const override;
+    void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header, const OptionalContig& contig) const override;
     
     boost::optional<Path> make_registration_pass(const VcfReader& source, const VcfHeader& filtered_header) const;
     void record(const VcfRecord& call, std::size_t record_idx, const VcfHeader& dest_header,
@@ -25,20 +25,21 @@ SinglePassVariantCallFilter::SinglePassVariantCallFilter(FacetFactory facet_fact
 , progress_ {progress}
 {}
 
-void SinglePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const
+void SinglePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header,
+                                         const OptionalContig& contig) const
 {
     assert(dest.is_header_written());
     if (progress_) progress_->start();
     const auto samples = source.fetch_header().samples();
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
+        for (auto p = iterate(source, contig); p.first != p.second;) {
             filter(read_next_blocks(p.first, p.second, samples), dest, dest_header, samples);
         }
     } else if (can_measure_single_call()) {
-        auto p = source.iterate();
+        auto p = iterate(source, contig);
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, dest, dest_header, samples); });
     } else {
-        for (auto p = source.iterate(); p.first != p.second;) {
+        for (auto p = iterate(source, contig); p.first != p.second;) {
             filter(read_next_block(p.first, p.second, samples), dest, dest_header, samples);
         }
     }
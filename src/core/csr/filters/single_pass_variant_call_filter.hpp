@@ -41,7 +41,7 @@ private:
     
     virtual Classification classify(const MeasureVector& call_measures) const = 0;
     
-    void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const override;
+    void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header, const OptionalContig& contig) const override;
     void filter(const VcfRecord& call, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const CallBlock& block, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
     void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest, const VcfHeader& dest_header, const SampleList& samples) const;
@@ -38,6 +38,7 @@ private:
     std::vector<MeasureWrapper> measures_;
     
     std::unique_ptr<VariantCallFilterFactory> do_clone() const override;
+    bool do_is_shardable() const noexcept override { return true; }
     std::unique_ptr<VariantCallFilter> do_make(FacetFactory facet_factory,
                                                VariantCallFilter::OutputOptions output_config,
                                                boost::optional<ProgressMeter&> progress,
@@ -105,11 +105,23 @@ void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest) const
 {
     if (dest.is_header_written()) {
         const auto header = read_header(dest);
-        filter(source, dest, header);
+        filter(source, dest, header, boost::none);
     } else {
         const auto header = make_header(source);
         dest << header;
-        filter(source, dest, header);
+        filter(source, dest, header, boost::none);
+    }
+}
+
+void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const GenomicRegion::ContigName& contig) const
+{
+    if (dest.is_header_written()) {
+        const auto header = read_header(dest);
+        filter(source, dest, header, contig);
+    } else {
+        const auto header = make_header(source);
+        dest << header;
+        filter(source, dest, header, contig);
     }
 }
 
@@ -151,6 +163,11 @@ VariantCallFilter::Classification VariantCallFilter::merge(const ClassificationL
     return this->merge(sample_classifications, {});
 }
 
+VcfReader::RecordIteratorPair VariantCallFilter::iterate(const VcfReader& source, const OptionalContig& contig) const
+{
+    return contig ? source.iterate(*contig) : source.iterate();
+}
+
 bool VariantCallFilter::can_measure_single_call() const noexcept
 {
     return facet_names_.empty();
@@ -68,6 +68,8 @@ public:
     std::string name() const;
     
     void filter(const VcfReader& source, VcfWriter& dest) const;
+    // Only filters calls on the given contig. Requires a shardable filter (see VariantCallFilterFactory)
+    void filter(const VcfReader& source, VcfWriter& dest, const GenomicRegion::ContigName& contig) const;
     
 protected:
     using SampleList    = std::vector<SampleName>;
@@ -75,6 +77,7 @@ protected:
     using VcfIterator   = VcfReader::RecordIterator;
     using CallBlock     = std::vector<VcfRecord>;
     using MeasureBlock  = std::vector<MeasureVector>;
+    using OptionalContig = boost::optional<GenomicRegion::ContigName>;
     
     struct Classification
     {
@@ -90,6 +93,7 @@ protected:
     virtual Classification merge(const ClassificationList& sample_classifications, const MeasureVector& measures) const;
     virtual Classification merge(const ClassificationList& sample_classifications) const;
     
+    VcfReader::RecordIteratorPair iterate(const VcfReader& source, const OptionalContig& contig) const;
     bool can_measure_single_call() const noexcept;
     bool can_measure_multiple_blocks() const noexcept;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
@@ -118,7 +122,7 @@ private:
     
     virtual std::string do_name() const = 0;
     virtual void annotate(VcfHeader::Builder& header) const = 0;
-    virtual void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header) const = 0;
+    virtual void filter(const VcfReader& source, VcfWriter& dest, const VcfHeader& dest_header, const OptionalContig& contig) const = 0;
     virtual boost::optional<std::string> call_quality_name() const { return boost::none; }
     virtual boost::optional<std::string> genotype_quality_name() const { return boost::none; }
     virtual boost::optional<Phred<double>> compute_joint_quality(const ClassificationList& sample_classifications, const MeasureVector& measures) const;
@@ -23,6 +23,16 @@ void VariantCallFilterFactory::set_output_options(VariantCallFilter::OutputOptio
     output_options_ = std::move(output_options);
 }
 
+void VariantCallFilterFactory::set_read_assignment_spill(const ReadAssignmentSpill& spill) noexcept
+{
+    read_assignment_spill_ = spill;
+}
+
+bool VariantCallFilterFactory::is_shardable() const noexcept
+{
+    return do_is_shardable();
+}
+
 std::unique_ptr<VariantCallFilter>
 VariantCallFilterFactory::make(const ReferenceGenome& reference,
                                BufferedReadPipe read_pipe,
@@ -36,9 +46,11 @@ VariantCallFilterFactory::make(const ReferenceGenome& reference,
 {
     if (pedigree) {
         FacetFactory facet_factory {std::move(input_header), reference, std::move(read_pipe), std::move(ploidies), std::move(likelihood_model), std::move(*pedigree)};
+        if (read_assignment_spill_) facet_factory.set_read_assignment_spill(*read_assignment_spill_);
         return do_make(std::move(facet_factory), output_config, progress, {max_threads});
     } else {
         FacetFactory facet_factory {std::move(input_header), reference, std::move(read_pipe), std::move(ploidies), std::move(likelihood_model)};
+        if (read_assignment_spill_) facet_factory.set_read_assignment_spill(*read_assignment_spill_);
         return do_make(std::move(facet_factory), output_config, progress, {max_threads});
     }
 }
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <utility>
+#include <functional>
 
 #include <boost/optional.hpp>
 
@@ -19,6 +20,7 @@ class ReferenceGenome;
 class BufferedReadPipe;
 class PloidyMap;
 class Pedigree;
+class ReadAssignmentSpill;
 
 namespace csr {
 
@@ -41,6 +43,10 @@ public:
     std::unique_ptr<VariantCallFilterFactory> clone() const;
     
     void set_output_options(VariantCallFilter::OutputOptions output_options);
+    void set_read_assignment_spill(const ReadAssignmentSpill& spill) noexcept;
+    
+    // True if calls on different contigs can be filtered by independent filters made by this factory
+    bool is_shardable() const noexcept;
     
     std::unique_ptr<VariantCallFilter>
     make(const ReferenceGenome& reference,
@@ -65,8 +71,10 @@ public:
     
 private:
     VariantCallFilter::OutputOptions output_options_;
+    boost::optional<std::reference_wrapper<const ReadAssignmentSpill>> read_assignment_spill_;
     
     virtual std::unique_ptr<VariantCallFilterFactory> do_clone() const = 0;
+    virtual bool do_is_shardable() const noexcept { return false; }
     virtual
     std::unique_ptr<VariantCallFilter>
     do_make(FacetFactory facet_factory,
@@ -34,14 +34,14 @@ Measure::ResultType BaseMismatchFraction::get_default_result() const
 
 Measure::ResultType BaseMismatchFraction::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
-    const auto depths = boost::get<std::vector<std::size_t>>(depth_.evaluate(call, facets));
+    const auto depths = boost::get<std::vector<boost::optional<std::size_t>>>(depth_.evaluate(call, facets));
     const auto mismatch_counts = boost::get<std::vector<int>>(BaseMismatchCount{}.evaluate(call, facets));
     const auto variant_lengths = boost::get<std::vector<int>>(VariantLength{}.evaluate(call, facets));
     assert(depths.size() == mismatch_counts.size());
     assert(mismatch_counts.size() == variant_lengths.size());
     std::vector<int> bases(depths.size());
     std::transform(std::cbegin(depths), std::cend(depths), std::cbegin(variant_lengths), std::begin(bases),
-                   [] (const auto& depth, const auto& allele_length) { return depth * allele_length; });
+                   [] (const auto& depth, const auto& allele_length) { return depth ? *depth * allele_length : 0; });
     std::vector<double> result(depths.size());
     std::transform(std::cbegin(mismatch_counts), std::cend(mismatch_counts), std::cbegin(bases), std::begin(result),
                    [] (auto mismatches, auto bases) { return bases > 0 ? static_cast<double>(mismatches) / bases : 0.0; });
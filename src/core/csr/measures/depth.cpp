@@ -14,6 +14,16 @@ namespace octopus { namespace csr {
 
 const std::string Depth::name_ = "DP";
 
+namespace {
+
+boost::optional<std::size_t> to_count(const boost::optional<VcfRecord::Values::IntegerType> depth) noexcept
+{
+    if (depth && *depth >= 0) return static_cast<std::size_t>(*depth);
+    return boost::none;
+}
+
+} // namespace
+
 Depth::Depth() : Depth {false, false} {}
 
 Depth::Depth(bool recalculate, bool aggregate_samples)
@@ -28,7 +38,7 @@ std::unique_ptr<Measure> Depth::do_clone() const
 
 Measure::ResultType Depth::get_default_result() const
 {
-    return std::vector<std::size_t> {};
+    return std::vector<boost::optional<std::size_t>> {};
 }
 
 Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
@@ -36,13 +46,13 @@ Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& fa
     if (aggregate_) {
         if (recalculate_) {
             const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-            return static_cast<std::size_t>(count_overlapped(reads, call));
+            return boost::optional<std::size_t> {count_overlapped(reads, call)};
         } else {
-            return static_cast<std::size_t>(std::stoull(call.info_value(vcfspec::info::combinedReadDepth).front()));
+            return to_count(get_info_integer(call, vcfspec::info::combinedReadDepth));
         }
     } else {
         const auto& samples = get_value<Samples>(facets.at("Samples"));
-        std::vector<std::size_t> result {};
+        std::vector<boost::optional<std::size_t>> result {};
         result.reserve(samples.size());
         if (recalculate_) {
             const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
@@ -51,7 +61,7 @@ Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& fa
             }
         } else {
             for (const auto& sample : samples) {
-                result.push_back(std::stoull(call.get_sample_value(sample, vcfspec::format::combinedReadDepth).front()));
+                result.push_back(to_count(get_integer(call.typed_sample_value(sample, vcfspec::format::combinedReadDepth))));
             }
         }
         return result;
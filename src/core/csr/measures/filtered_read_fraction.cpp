@@ -5,8 +5,10 @@
 
 #include <iterator>
 #include <algorithm>
+#include <cassert>
 
 #include <boost/variant.hpp>
+#include <boost/optional.hpp>
 
 namespace octopus { namespace csr {
 
@@ -30,19 +32,19 @@ Measure::ResultType FilteredReadFraction::get_default_result() const
 Measure::ResultType FilteredReadFraction::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     if (filtering_depth_.cardinality() == Measure::ResultCardinality::samples) {
-        const auto calling_depth   = boost::get<std::vector<std::size_t>>(calling_depth_.evaluate(call, facets));
-        const auto filtering_depth = boost::get<std::vector<std::size_t>>(filtering_depth_.evaluate(call, facets));
+        const auto calling_depth   = boost::get<std::vector<boost::optional<std::size_t>>>(calling_depth_.evaluate(call, facets));
+        const auto filtering_depth = boost::get<std::vector<boost::optional<std::size_t>>>(filtering_depth_.evaluate(call, facets));
         assert(calling_depth.size() == filtering_depth.size());
         std::vector<double> result(calling_depth.size());
         std::transform(std::cbegin(calling_depth), std::cend(calling_depth), std::cbegin(filtering_depth), std::begin(result),
-                       [] (auto cd, auto fd) { return fd > 0 ? 1.0 - (static_cast<double>(cd) / fd) : 0; });
+                       [] (auto cd, auto fd) { return cd && fd && *fd > 0 ? 1.0 - (static_cast<double>(*cd) / *fd) : 0; });
         return result;
     } else {
-        const auto filtering_depth = boost::get<std::size_t>(filtering_depth_.evaluate(call, facets));
+        const auto filtering_depth = boost::get<boost::optional<std::size_t>>(filtering_depth_.evaluate(call, facets));
         double result {0};
-        if (filtering_depth > 0) {
-            auto calling_depth = boost::get<std::size_t>(calling_depth_.evaluate(call, facets));
-            result = 1.0 - (static_cast<double>(calling_depth) / filtering_depth);
+        if (filtering_depth && *filtering_depth > 0) {
+            const auto calling_depth = boost::get<boost::optional<std::size_t>>(calling_depth_.evaluate(call, facets));
+            if (calling_depth) result = 1.0 - (static_cast<double>(*calling_depth) / *filtering_depth);
         }
         return result;
     }
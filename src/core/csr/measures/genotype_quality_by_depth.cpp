@@ -32,14 +32,14 @@ Measure::ResultType GenotypeQualityByDepth::get_default_result() const
 
 Measure::ResultType GenotypeQualityByDepth::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
-    const auto depths = boost::get<std::vector<std::size_t>>(depth_.evaluate(call, facets));
+    const auto depths = boost::get<std::vector<boost::optional<std::size_t>>>(depth_.evaluate(call, facets));
     const auto genotype_qualities = boost::get<std::vector<boost::optional<double>>>(GenotypeQuality().evaluate(call, facets));
     assert(depths.size() == genotype_qualities.size());
     std::vector<boost::optional<double>> result(genotype_qualities.size());
     std::transform(std::cbegin(genotype_qualities), std::cend(genotype_qualities), 
                    std::cbegin(depths), std::begin(result),
                    [] (auto gq, auto depth) -> boost::optional<double> {
-                        if (gq && depth > 0) { return *gq / depth; } else { return boost::none; } });
+                        if (gq && depth && *depth > 0) { return *gq / *depth; } else { return boost::none; } });
     return result;
 }
 
@@ -22,16 +22,19 @@ std::unique_ptr<Measure> MappingQualityZeroCount::do_clone() const
 
 Measure::ResultType MappingQualityZeroCount::get_default_result() const
 {
-    return std::size_t {};
+    return boost::optional<std::size_t> {};
 }
 
 Measure::ResultType MappingQualityZeroCount::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
     if (recalculate_) {
         const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
-        return count_mapq_zero(reads, mapped_region(call));
+        return boost::optional<std::size_t> {count_mapq_zero(reads, mapped_region(call))};
     } else {
-        return static_cast<std::size_t>(std::stoull(call.info_value("MQ0").front()));
+        boost::optional<std::size_t> result {};
+        const auto mq0 = get_info_integer(call, "MQ0");
+        if (mq0 && *mq0 >= 0) result = static_cast<std::size_t>(*mq0);
+        return result;
     }
 }
 
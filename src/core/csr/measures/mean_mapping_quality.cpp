@@ -25,7 +25,7 @@ std::unique_ptr<Measure> MeanMappingQuality::do_clone() const
 
 Measure::ResultType MeanMappingQuality::get_default_result() const
 {
-    return double {};
+    return boost::optional<double> {};
 }
 
 Measure::ResultType MeanMappingQuality::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
@@ -33,9 +33,11 @@ Measure::ResultType MeanMappingQuality::do_evaluate(const VcfRecord& call, const
     if (recalculate_) {
         const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
         assert(!reads.empty());
-        return rmq_mapping_quality(reads, mapped_region(call));
+        return boost::optional<double> {rmq_mapping_quality(reads, mapped_region(call))};
     } else {
-        return std::stod(call.info_value(vcfspec::info::rmsMappingQuality).front());
+        boost::optional<double> result {};
+        if (const auto mq = get_info_real(call, vcfspec::info::rmsMappingQuality)) result = *mq;
+        return result;
     }
 }
 
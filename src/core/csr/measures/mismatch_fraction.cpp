@@ -33,12 +33,12 @@ Measure::ResultType MismatchFraction::get_default_result() const
 
 Measure::ResultType MismatchFraction::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
-    const auto depths = boost::get<std::vector<std::size_t>>(depth_.evaluate(call, facets));
+    const auto depths = boost::get<std::vector<boost::optional<std::size_t>>>(depth_.evaluate(call, facets));
     const auto mismatch_counts = boost::get<std::vector<int>>(mismatch_count_.evaluate(call, facets));
     assert(depths.size() == mismatch_counts.size());
     std::vector<double> result(depths.size());
     std::transform(std::cbegin(mismatch_counts), std::cend(mismatch_counts), std::cbegin(depths), std::begin(result),
-                   [] (auto mismatches, auto depth) { return depth > 0 ? static_cast<double>(mismatches) / depth : 0.0; });
+                   [] (auto mismatches, auto depth) { return depth && *depth > 0 ? static_cast<double>(mismatches) / *depth : 0.0; });
     return result;
 }
 
@@ -24,9 +24,7 @@ Measure::ResultType ModelPosterior::do_evaluate(const VcfRecord& call, const Fac
 {
     namespace ovcf = octopus::vcf::spec;
     boost::optional<double> result {};
-    if (!is_info_missing(ovcf::info::modelPosterior, call)) {
-        result = std::stod(call.info_value(ovcf::info::modelPosterior).front());
-    }
+    if (const auto mp = get_info_real(call, ovcf::info::modelPosterior)) result = *mp;
     return result;
 }
 
@@ -24,9 +24,9 @@ Measure::ResultType PosteriorProbability::do_evaluate(const VcfRecord& call, con
 {
     boost::optional<double> result {};
     if (call.has_info("PP")) {
-        const auto& pp = call.info_value("PP");
-        if (pp.size() == 1 && pp.front() != vcfspec::missingValue) {
-            result = std::stod(pp.front());
+        const auto& pp = call.typed_info_value("PP");
+        if (pp.size() == 1 && !pp.is_missing(0)) {
+            result = pp.real(0);
         }
     }
     return result;
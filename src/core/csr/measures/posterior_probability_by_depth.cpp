@@ -30,9 +30,9 @@ Measure::ResultType PosteriorProbabilityByDepth::do_evaluate(const VcfRecord& ca
     boost::optional<double> result {};
     const auto posterior_probability = boost::get<boost::optional<double>>(PosteriorProbability().evaluate(call, facets));
     if (posterior_probability) {
-        auto depth = boost::get<std::size_t>(depth_.evaluate(call, facets));
-        if (depth > 0) {
-            result = *posterior_probability / depth;
+        const auto depth = boost::get<boost::optional<std::size_t>>(depth_.evaluate(call, facets));
+        if (depth && *depth > 0) {
+            result = *posterior_probability / *depth;
         }
     }
     return result;
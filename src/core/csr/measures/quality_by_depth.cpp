@@ -26,10 +26,10 @@ Measure::ResultType QualityByDepth::get_default_result() const
 
 Measure::ResultType QualityByDepth::do_evaluate(const VcfRecord& call, const FacetMap& facets) const
 {
-    auto depth = boost::get<std::size_t>(depth_.evaluate(call, facets));
+    const auto depth = boost::get<boost::optional<std::size_t>>(depth_.evaluate(call, facets));
     boost::optional<double> result {};
-    if (depth > 0) {
-        result = static_cast<double>(*call.qual()) / depth;
+    if (depth && *depth > 0) {
+        result = static_cast<double>(*call.qual()) / *depth;
     }
     return result;
 }
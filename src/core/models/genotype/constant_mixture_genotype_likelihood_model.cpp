@@ -11,12 +11,15 @@
 #include <limits>
 #include <cassert>
 
+#include "fmath.hpp"
+
 #include "utils/maths.hpp"
 
 namespace octopus { namespace model {
 
 ConstantMixtureGenotypeLikelihoodModel::ConstantMixtureGenotypeLikelihoodModel(const HaplotypeLikelihoodArray& likelihoods)
 : likelihoods_ {likelihoods}
+, read_maxima_sum_ {0}
 {}
 
 const HaplotypeLikelihoodArray& ConstantMixtureGenotypeLikelihoodModel::cache() const noexcept
@@ -83,6 +86,22 @@ ConstantMixtureGenotypeLikelihoodModel::evaluate(const Genotype<IndexedHaplotype
     }
 }
 
+void ConstantMixtureGenotypeLikelihoodModel::evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes,
+                                                      std::vector<LogProbability>& result) const
+{
+    assert(likelihoods_.is_primed());
+    result.resize(genotypes.size());
+    if (use_columns(genotypes)) {
+        fill_columns(genotypes);
+        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                       [this] (const auto& genotype) { return evaluate_columns(genotype); });
+        columns_.clear();
+    } else {
+        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                       [this] (const auto& genotype) { return evaluate(genotype); });
+    }
+}
+
 // private methods
 
 ConstantMixtureGenotypeLikelihoodModel::LogProbability
@@ -206,5 +225,118 @@ ConstantMixtureGenotypeLikelihoodModel::evaluate_polyploid(const Genotype<Indexe
     return result;
 }
 
+namespace {
+
+// Rescaled sums below this are recomputed exactly to avoid underflow
+constexpr double minColumnSum {1e-100};
+// Products are folded into the log sum before they can underflow or overflow. Each rescaled
+// sum is at most the ploidy, so the product can grow as well as shrink.
+constexpr double minColumnProduct {1e-200}, maxColumnProduct {1e200};
+
+void fast_exp_each(std::vector<double>& values) noexcept
+{
+    const auto n = values.size();
+    auto data = values.data();
+    std::size_t i {0};
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(data + i, fmath::exp_pd(_mm_loadu_pd(data + i)));
+    }
+    for (; i < n; ++i) {
+        data[i] = fmath::expd(data[i]);
+    }
+}
+
+} // namespace
+
+bool ConstantMixtureGenotypeLikelihoodModel::use_columns(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes) const
+{
+    // Columns cost one exp per haplotype and read, while direct evaluation costs up to one per
+    // genotype haplotype and read. Filling the columns also needs a pass for the read maxima, so
+    // only use them once there are more than twice as many genotypes as haplotypes.
+    std::size_t num_haplotypes {0};
+    for (const auto& genotype : genotypes) {
+        for (const auto& haplotype : genotype) {
+            num_haplotypes = std::max(num_haplotypes, static_cast<std::size_t>(index_of(haplotype)) + 1);
+        }
+    }
+    return genotypes.size() > 2 * num_haplotypes && likelihoods_.num_likelihoods() > 0;
+}
+
+void ConstantMixtureGenotypeLikelihoodModel::fill_columns(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes) const
+{
+    columns_.clear();
+    for (const auto& genotype : genotypes) {
+        for (const auto& haplotype : genotype) {
+            const auto idx = index_of(haplotype);
+            if (idx >= columns_.size()) columns_.resize(idx + 1);
+            if (!columns_[idx].log_likelihoods) columns_[idx].log_likelihoods = std::addressof(likelihoods_[haplotype]);
+        }
+    }
+    const auto num_reads = likelihoods_.num_likelihoods();
+    read_maxima_.assign(num_reads, std::numeric_limits<LogProbability>::lowest());
+    for (auto& column : columns_) {
+        if (column.log_likelihoods) {
+            const auto& log_likelihoods = *column.log_likelihoods;
+            std::transform(std::cbegin(log_likelihoods), std::cend(log_likelihoods), std::cbegin(read_maxima_),
+                           std::begin(read_maxima_), [] (auto a, auto b) { return std::max(a, b); });
+            column.log_likelihood_sum = std::accumulate(std::cbegin(log_likelihoods), std::cend(log_likelihoods), LogProbability {0});
+        }
+    }
+    read_maxima_sum_ = std::accumulate(std::cbegin(read_maxima_), std::cend(read_maxima_), LogProbability {0});
+    for (auto& column : columns_) {
+        if (column.log_likelihoods) {
+            const auto& log_likelihoods = *column.log_likelihoods;
+            column.scaled_likelihoods.resize(num_reads);
+            std::transform(std::cbegin(log_likelihoods), std::cend(log_likelihoods), std::cbegin(read_maxima_),
+                           std::begin(column.scaled_likelihoods), std::minus<> {});
+            fast_exp_each(column.scaled_likelihoods);
+        }
+    }
+}
+
+// ln p(reads | genotype) = sum {read} max(read) + ln sum {haplotype} p(read | haplotype) / exp(max(read)) - ln ploidy
+ConstantMixtureGenotypeLikelihoodModel::LogProbability
+ConstantMixtureGenotypeLikelihoodModel::evaluate_columns(const Genotype<IndexedHaplotype<>>& genotype) const
+{
+    const auto ploidy = genotype.ploidy();
+    if (ploidy == 0) return 0.0;
+    column_weights_.clear();
+    for (const auto& haplotype : genotype) {
+        const auto column = std::addressof(columns_[index_of(haplotype)]);
+        auto itr = std::find_if(std::begin(column_weights_), std::end(column_weights_),
+                                [column] (const auto& p) { return p.first == column; });
+        if (itr != std::end(column_weights_)) {
+            itr->second += 1;
+        } else {
+            column_weights_.emplace_back(column, 1);
+        }
+    }
+    if (column_weights_.size() == 1) {
+        return column_weights_.front().first->log_likelihood_sum;
+    }
+    const auto num_reads = read_maxima_.size();
+    LogProbability result {read_maxima_sum_ - num_reads * std::log(ploidy)}, product {1};
+    for (std::size_t read_idx {0}; read_idx < num_reads; ++read_idx) {
+        LogProbability sum {0};
+        for (const auto& p : column_weights_) {
+            sum += p.second * p.first->scaled_likelihoods[read_idx];
+        }
+        if (sum >= minColumnSum) {
+            product *= sum;
+            if (product < minColumnProduct || product > maxColumnProduct) {
+                result += std::log(product);
+                product = 1;
+            }
+        } else {
+            buffer_.clear();
+            for (const auto& p : column_weights_) {
+                buffer_.push_back(std::log(p.second) + (*p.first->log_likelihoods)[read_idx]);
+            }
+            result += maths::log_sum_exp(buffer_) - read_maxima_[read_idx];
+        }
+    }
+    return result + std::log(product);
+}
+
 } // namespace model
 } // namespace octopus
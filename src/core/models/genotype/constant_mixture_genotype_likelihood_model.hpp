@@ -5,10 +5,13 @@
 #define constant_mixture_genotype_likelihood_model_hpp
 
 #include <vector>
+#include <utility>
+#include <cstddef>
 
 #include "core/types/haplotype.hpp"
 #include "core/types/indexed_haplotype.hpp"
 #include "core/types/genotype.hpp"
+#include "containers/mappable_block.hpp"
 #include "core/models/haplotype_likelihood_array.hpp"
 
 namespace octopus { namespace model {
@@ -34,10 +37,28 @@ public:
     LogProbability evaluate(const Genotype<Haplotype>& genotype) const;
     LogProbability evaluate(const Genotype<IndexedHaplotype<>>& genotype) const;
     
+    // Evaluates all genotypes at once, sharing per-haplotype work between genotypes
+    void evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes, std::vector<LogProbability>& result) const;
+    
 private:
+    using LikelihoodVector = HaplotypeLikelihoodArray::LikelihoodVector;
+    
+    // Per-haplotype columns for batched evaluation: each read likelihood is rescaled by the maximum
+    // over all haplotypes for that read and exponentiated once, so genotypes need only sum columns.
+    struct HaplotypeColumn
+    {
+        const LikelihoodVector* log_likelihoods = nullptr;
+        std::vector<LogProbability> scaled_likelihoods = {};
+        LogProbability log_likelihood_sum = 0;
+    };
+    
     const HaplotypeLikelihoodArray& likelihoods_;
     mutable std::vector<HaplotypeLikelihoodArray::LogProbability> buffer_;
     mutable std::vector<HaplotypeLikelihoodArray::LikelihoodVectorRef> likelihood_refs_;
+    mutable std::vector<HaplotypeColumn> columns_;
+    mutable std::vector<LogProbability> read_maxima_;
+    mutable LogProbability read_maxima_sum_;
+    mutable std::vector<std::pair<const HaplotypeColumn*, LogProbability>> column_weights_;
     
     // These are just for optimisation
     LogProbability evaluate_haploid(const Genotype<Haplotype>& genotype) const;
@@ -47,8 +68,21 @@ private:
     LogProbability evaluate_haploid(const Genotype<IndexedHaplotype<>>& genotype) const;
     LogProbability evaluate_diploid(const Genotype<IndexedHaplotype<>>& genotype) const;
     LogProbability evaluate_polyploid(const Genotype<IndexedHaplotype<>>& genotype) const;
+    
+    bool use_columns(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes) const;
+    void fill_columns(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes) const;
+    LogProbability evaluate_columns(const Genotype<IndexedHaplotype<>>& genotype) const;
 };
 
+inline std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>&
+evaluate(const MappableBlock<Genotype<IndexedHaplotype<>>>& genotypes,
+         const ConstantMixtureGenotypeLikelihoodModel& model,
+         std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability>& result)
+{
+    model.evaluate(genotypes, result);
+    return result;
+}
+
 template <typename Container1, typename Container2>
 Container2&
 evaluate(const Container1& genotypes, const ConstantMixtureGenotypeLikelihoodModel& model, Container2& result)
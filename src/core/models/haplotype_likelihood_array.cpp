@@ -8,6 +8,7 @@
 #include <deque>
 
 #include "utils/erase_if.hpp"
+#include "utils/parallel_transform.hpp"
 
 namespace octopus {
 
@@ -19,21 +20,21 @@ HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(const unsigned num_haplotypes
 , haplotype_indices_ {num_haplotypes_hint}
 , sample_indices_ {samples.size()}
 , samples_ {samples}
-{
-    mapping_positions_.resize(maxMappingPositions);
-}
+{}
 
 HaplotypeLikelihoodArray::HaplotypeLikelihoodArray(HaplotypeLikelihoodModel likelihood_model,
                                                    unsigned num_haplotypes_hint,
-                                                   const std::vector<SampleName>& samples)
+                                                   const std::vector<SampleName>& samples,
+                                                   ExecutionPolicy execution_policy,
+                                                   MemoryFootprint max_alignment_memo_footprint)
 : likelihood_model_ {std::move(likelihood_model)}
+, execution_policy_ {execution_policy}
+, max_alignment_memo_footprint_ {max_alignment_memo_footprint}
 , likelihoods_ {}
 , haplotype_indices_ {num_haplotypes_hint}
 , sample_indices_ {samples.size()}
 , samples_ {samples}
-{
-    mapping_positions_.resize(maxMappingPositions);
-}
+{}
 
 HaplotypeLikelihoodArray::ReadPacket::ReadPacket(Iterator first, Iterator last)
 : first {first}
@@ -59,6 +60,8 @@ void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
     }
     set_read_iterators_and_sample_indices(reads);
     assert(reads.size() == read_iterators_.size());
+    alignment_memo_.evict_unused();
+    if (alignment_memo_.footprint() > max_alignment_memo_footprint_.bytes()) alignment_memo_.clear();
     const auto num_samples = reads.size();
     // Precompute all read hashes so we don't have to recompute for each haplotype
     std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
@@ -70,29 +73,36 @@ void HaplotypeLikelihoodArray::populate(const ReadMap& reads,
                        [] (const AlignedRead& read) { return compute_kmer_hashes<mapperKmerSize>(read.sequence()); });
         read_hashes.emplace_back(std::move(sample_read_hashes));
     }
-    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
-    const auto first_mapping_position = std::begin(mapping_positions_);
     likelihoods_.resize(haplotypes.size(), std::vector<LikelihoodVector>(num_samples));
+    std::size_t num_reads {0};
+    for (const auto& t : read_iterators_) num_reads += t.num_reads;
+    if (use_parallel_population(haplotypes.size(), num_reads)) {
+        populate_in_parallel(read_hashes, haplotypes, flank_state);
+        read_iterators_.clear();
+        haplotypes_ = haplotypes;
+        return;
+    }
+    auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    MappedIndexCounts haplotype_mapping_counts {};
+    ReadBatch batch {};
+    const auto memo = use_alignment_memo() ? std::addressof(alignment_memo_) : nullptr;
     for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
         const auto& haplotype = haplotypes[haplotype_idx];
         populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        init_mapping_counts(haplotype_hashes, haplotype_mapping_counts);
         likelihood_model_.reset(haplotype, flank_state);
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
             auto& likelihoods = likelihoods_[haplotype_idx][sample_idx];
             const auto& t = read_iterators_[sample_idx];
             likelihoods.resize(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(read_hashes[sample_idx]), std::begin(likelihoods),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
+            for (std::size_t first_read {0}; first_read < t.num_reads; first_read += maxTileReads) {
+                const auto last_read = std::min(first_read + maxTileReads, t.num_reads);
+                evaluate_reads(std::next(t.first, first_read), std::next(std::cbegin(read_hashes[sample_idx]), first_read),
+                               last_read - first_read, haplotype_hashes, haplotype_mapping_counts,
+                               likelihood_model_, memo, memo,
+                               batch, std::next(std::begin(likelihoods), first_read));
+            }
         }
-        clear_kmer_hash_table(haplotype_hashes);
         haplotype_indices_.emplace(haplotype, haplotype_idx);
     }
     likelihood_model_.clear();
@@ -125,13 +135,22 @@ void HaplotypeLikelihoodArray::populate(const TemplateMap& reads,
         });
         template_hashes.emplace_back(std::move(sample_read_hashes));
     }
+    likelihoods_.resize(haplotypes.size(), std::vector<LikelihoodVector>(num_samples));
+    std::size_t num_templates {0};
+    for (const auto& t : template_iterators_) num_templates += t.num_templates;
+    if (use_parallel_population(haplotypes.size(), num_templates)) {
+        populate_in_parallel(template_hashes, haplotypes, flank_state);
+        template_iterators_.clear();
+        haplotypes_ = haplotypes;
+        return;
+    }
     auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    MappedIndexCounts haplotype_mapping_counts {};
     thread_local std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions {};
-    likelihoods_.resize(haplotypes.size(), std::vector<LikelihoodVector>(num_samples));
     for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
         const auto& haplotype = haplotypes[haplotype_idx];
         populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        init_mapping_counts(haplotype_hashes, haplotype_mapping_counts);
         likelihood_model_.reset(haplotype, flank_state);
         for (std::size_t sample_idx {0}; sample_idx < num_samples; ++sample_idx) {
             auto& likelihoods = likelihoods_[haplotype_idx][sample_idx];
@@ -153,7 +172,6 @@ void HaplotypeLikelihoodArray::populate(const TemplateMap& reads,
                                return likelihood_model_.evaluate(read_template, mapping_positions);
                            });
         }
-        clear_kmer_hash_table(haplotype_hashes);
         haplotype_indices_.emplace(haplotype, haplotype_idx);
     }
     likelihood_model_.clear();
@@ -255,6 +273,177 @@ void HaplotypeLikelihoodArray::unprime() const noexcept
 
 // private methods
 
+namespace {
+
+// A block of reads from a single sample evaluated against a single haplotype
+struct LikelihoodTile
+{
+    std::size_t haplotype, sample, first_read, last_read;
+};
+
+std::vector<LikelihoodTile>
+make_likelihood_tiles(const std::size_t num_haplotypes, const std::vector<std::size_t>& sample_sizes,
+                      const std::size_t max_tile_reads)
+{
+    std::vector<LikelihoodTile> result {};
+    for (std::size_t haplotype_idx {0}; haplotype_idx < num_haplotypes; ++haplotype_idx) {
+        for (std::size_t sample_idx {0}; sample_idx < sample_sizes.size(); ++sample_idx) {
+            for (std::size_t first_read {0}; first_read < sample_sizes[sample_idx]; first_read += max_tile_reads) {
+                const auto last_read = std::min(first_read + max_tile_reads, sample_sizes[sample_idx]);
+                result.push_back({haplotype_idx, sample_idx, first_read, last_read});
+            }
+        }
+    }
+    return result;
+}
+
+template <unsigned char K>
+std::vector<KmerHashTable> make_kmer_hash_tables(const MappableBlock<Haplotype>& haplotypes)
+{
+    std::vector<KmerHashTable> result(haplotypes.size());
+    parallel_for(haplotypes.size(), [&] (const std::size_t i) {
+        result[i] = make_kmer_hash_table<K>(haplotypes[i].sequence());
+    });
+    return result;
+}
+
+template <typename Worker>
+void set_haplotype(Worker& worker, const std::size_t haplotype_idx,
+                   const MappableBlock<Haplotype>& haplotypes,
+                   const std::vector<KmerHashTable>& haplotype_hashes,
+                   const HaplotypeLikelihoodModel& likelihood_model,
+                   const boost::optional<HaplotypeLikelihoodModel::FlankState>& flank_state)
+{
+    if (worker.haplotype && *worker.haplotype == haplotype_idx) return;
+    if (!worker.likelihood_model) worker.likelihood_model = likelihood_model;
+    worker.likelihood_model->reset(haplotypes[haplotype_idx], flank_state);
+    init_mapping_counts(haplotype_hashes[haplotype_idx], worker.haplotype_mapping_counts);
+    worker.haplotype = haplotype_idx;
+}
+
+} // namespace
+
+void HaplotypeLikelihoodArray::evaluate_reads(ReadPacket::Iterator first_read,
+                                              std::vector<KmerPerfectHashes>::const_iterator first_read_hashes,
+                                              const std::size_t num_reads,
+                                              const KmerHashTable& haplotype_hashes,
+                                              MappedIndexCounts& haplotype_mapping_counts,
+                                              const HaplotypeLikelihoodModel& likelihood_model,
+                                              const HaplotypeLikelihoodModel::AlignmentMemo* alignment_memo,
+                                              HaplotypeLikelihoodModel::AlignmentMemo* new_alignments,
+                                              ReadBatch& batch,
+                                              LikelihoodVector::iterator result)
+{
+    batch.reads.assign(first_read, std::next(first_read, num_reads));
+    if (batch.mapping_positions.size() < num_reads) {
+        batch.mapping_positions.resize(num_reads);
+    }
+    for (std::size_t i {0}; i < num_reads; ++i, ++first_read_hashes) {
+        auto& mapping_positions = batch.mapping_positions[i];
+        mapping_positions.resize(maxMappingPositions);
+        mapping_positions.erase(map_query_to_target(*first_read_hashes, haplotype_hashes, haplotype_mapping_counts,
+                                                    std::begin(mapping_positions), maxMappingPositions),
+                                std::end(mapping_positions));
+        reset_mapping_counts(haplotype_mapping_counts);
+    }
+    if (alignment_memo) {
+        likelihood_model.evaluate(batch.reads, batch.mapping_positions, batch.likelihoods, *alignment_memo, *new_alignments);
+    } else {
+        likelihood_model.evaluate(batch.reads, batch.mapping_positions, batch.likelihoods);
+    }
+    std::copy(std::cbegin(batch.likelihoods), std::cend(batch.likelihoods), result);
+}
+
+bool HaplotypeLikelihoodArray::use_parallel_population(const std::size_t num_haplotypes, const std::size_t num_reads) const noexcept
+{
+    return execution_policy_ == ExecutionPolicy::par && num_haplotypes * num_reads >= minParallelLikelihoods;
+}
+
+bool HaplotypeLikelihoodArray::use_alignment_memo() const noexcept
+{
+    return max_alignment_memo_footprint_.bytes() > 0;
+}
+
+void HaplotypeLikelihoodArray::populate_in_parallel(const std::vector<std::vector<KmerPerfectHashes>>& read_hashes,
+                                                    const MappableBlock<Haplotype>& haplotypes,
+                                                    const boost::optional<FlankState>& flank_state)
+{
+    std::vector<std::size_t> sample_sizes(read_iterators_.size());
+    for (std::size_t sample_idx {0}; sample_idx < read_iterators_.size(); ++sample_idx) {
+        sample_sizes[sample_idx] = read_iterators_[sample_idx].num_reads;
+        for (auto& haplotype_likelihoods : likelihoods_) {
+            haplotype_likelihoods[sample_idx].resize(sample_sizes[sample_idx]);
+        }
+    }
+    const auto haplotype_hashes = make_kmer_hash_tables<mapperKmerSize>(haplotypes);
+    const auto tiles = make_likelihood_tiles(haplotypes.size(), sample_sizes, maxTileReads);
+    // The memo is only read during population; each tile records its alignments separately
+    std::vector<HaplotypeLikelihoodModel::AlignmentMemo> tile_alignments(use_alignment_memo() ? tiles.size() : 0);
+    // The model keeps per-haplotype state and HMM buffers, so each worker needs its own copy
+    std::vector<PopulationWorker> workers(parallel_for_max_workers());
+    parallel_for_each_worker(tiles.size(), [&] (const std::size_t worker_idx, const std::size_t tile_idx) {
+        const auto& tile = tiles[tile_idx];
+        auto& worker = workers[worker_idx];
+        set_haplotype(worker, tile.haplotype, haplotypes, haplotype_hashes, likelihood_model_, flank_state);
+        evaluate_reads(std::next(read_iterators_[tile.sample].first, tile.first_read),
+                       std::next(std::cbegin(read_hashes[tile.sample]), tile.first_read),
+                       tile.last_read - tile.first_read, haplotype_hashes[tile.haplotype],
+                       worker.haplotype_mapping_counts, *worker.likelihood_model,
+                       use_alignment_memo() ? std::addressof(alignment_memo_) : nullptr,
+                       use_alignment_memo() ? std::addressof(tile_alignments[tile_idx]) : nullptr, worker.batch,
+                       std::next(std::begin(likelihoods_[tile.haplotype][tile.sample]), tile.first_read));
+    });
+    for (auto& alignments : tile_alignments) {
+        alignment_memo_.merge(std::move(alignments));
+    }
+    for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
+        haplotype_indices_.emplace(haplotypes[haplotype_idx], haplotype_idx);
+    }
+}
+
+void HaplotypeLikelihoodArray::populate_in_parallel(const std::vector<std::vector<std::vector<KmerPerfectHashes>>>& template_hashes,
+                                                    const MappableBlock<Haplotype>& haplotypes,
+                                                    const boost::optional<FlankState>& flank_state)
+{
+    std::vector<std::size_t> sample_sizes(template_iterators_.size());
+    for (std::size_t sample_idx {0}; sample_idx < template_iterators_.size(); ++sample_idx) {
+        sample_sizes[sample_idx] = template_iterators_[sample_idx].num_templates;
+        for (auto& haplotype_likelihoods : likelihoods_) {
+            haplotype_likelihoods[sample_idx].resize(sample_sizes[sample_idx]);
+        }
+    }
+    const auto haplotype_hashes = make_kmer_hash_tables<mapperKmerSize>(haplotypes);
+    const auto tiles = make_likelihood_tiles(haplotypes.size(), sample_sizes, maxTileReads);
+    std::vector<PopulationWorker> workers(parallel_for_max_workers());
+    parallel_for_each_worker(tiles.size(), [&] (const std::size_t worker_idx, const std::size_t tile_idx) {
+        const auto& tile = tiles[tile_idx];
+        auto& worker = workers[worker_idx];
+        set_haplotype(worker, tile.haplotype, haplotypes, haplotype_hashes, likelihood_model_, flank_state);
+        const auto& hashes = haplotype_hashes[tile.haplotype];
+        auto& haplotype_mapping_counts = worker.haplotype_mapping_counts;
+        auto& mapping_positions = worker.batch.mapping_positions;
+        const auto& sample_template_hashes = template_hashes[tile.sample];
+        auto& likelihoods = likelihoods_[tile.haplotype][tile.sample];
+        auto template_itr = std::next(template_iterators_[tile.sample].first, tile.first_read);
+        for (auto template_idx = tile.first_read; template_idx < tile.last_read; ++template_idx, ++template_itr) {
+            const auto& read_hashes = sample_template_hashes[template_idx];
+            assert(template_itr->size() == read_hashes.size());
+            mapping_positions.resize(read_hashes.size());
+            for (std::size_t i {0}; i < read_hashes.size(); ++i) {
+                mapping_positions[i].resize(maxMappingPositions);
+                mapping_positions[i].erase(map_query_to_target(read_hashes[i], hashes, haplotype_mapping_counts,
+                                                               std::begin(mapping_positions[i]), maxMappingPositions),
+                                           std::end(mapping_positions[i]));
+                reset_mapping_counts(haplotype_mapping_counts);
+            }
+            likelihoods[template_idx] = worker.likelihood_model->evaluate(*template_itr, mapping_positions);
+        }
+    });
+    for (std::size_t haplotype_idx {0}; haplotype_idx < haplotypes.size(); ++haplotype_idx) {
+        haplotype_indices_.emplace(haplotypes[haplotype_idx], haplotype_idx);
+    }
+}
+
 void HaplotypeLikelihoodArray::set_read_iterators_and_sample_indices(const ReadMap& reads)
 {
     read_iterators_.clear();
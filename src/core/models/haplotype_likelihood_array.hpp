@@ -22,6 +22,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/types/indexed_haplotype.hpp"
 #include "utils/kmer_mapper.hpp"
+#include "utils/memory_footprint.hpp"
 #include "haplotype_likelihood_model.hpp"
 
 namespace octopus {
@@ -48,9 +49,13 @@ public:
     
     HaplotypeLikelihoodArray(unsigned num_haplotypes_hint, const std::vector<SampleName>& samples);
     
+    // Read alignment scores are memoised across calls to populate, up to max_alignment_memo_footprint.
+    // A zero footprint disables memoisation.
     HaplotypeLikelihoodArray(HaplotypeLikelihoodModel likelihood_model,
                              unsigned num_haplotypes_hint,
-                             const std::vector<SampleName>& samples);
+                             const std::vector<SampleName>& samples,
+                             ExecutionPolicy execution_policy = ExecutionPolicy::seq,
+                             MemoryFootprint max_alignment_memo_footprint = MemoryFootprint {defaultMaxAlignmentMemoBytes});
     
     HaplotypeLikelihoodArray(const HaplotypeLikelihoodArray&)            = default;
     HaplotypeLikelihoodArray& operator=(const HaplotypeLikelihoodArray&) = default;
@@ -97,8 +102,13 @@ public:
 private:
     static constexpr unsigned char mapperKmerSize {6};
     static constexpr std::size_t maxMappingPositions {10};
+    static constexpr std::size_t minParallelLikelihoods {4096};
+    static constexpr std::size_t maxTileReads {128};
+    static constexpr std::size_t defaultMaxAlignmentMemoBytes {100'000'000};
     
     HaplotypeLikelihoodModel likelihood_model_;
+    ExecutionPolicy execution_policy_ = ExecutionPolicy::seq;
+    MemoryFootprint max_alignment_memo_footprint_ = MemoryFootprint {defaultMaxAlignmentMemoBytes};
     
     struct ReadPacket
     {
@@ -126,10 +136,49 @@ private:
     // Just to optimise population
     std::vector<ReadPacket> read_iterators_;
     std::vector<TemplatePacket> template_iterators_;
-    std::vector<std::size_t> mapping_positions_;
+    // Read alignments kept between calls to populate, so haplotypes in overlapping active regions
+    // that share the sequence under a read don't need to realign it. Callers make one array per
+    // calling window, so the memo never outlives the window.
+    HaplotypeLikelihoodModel::AlignmentMemo alignment_memo_;
+    
+    // Buffers for reads evaluated together against one haplotype
+    struct ReadBatch
+    {
+        std::vector<std::reference_wrapper<const AlignedRead>> reads;
+        std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions;
+        std::vector<LogProbability> likelihoods;
+    };
+    
+    // Per-thread state for parallel population. Each worker owns a copy of the model, which is only
+    // reset when the worker moves on to a tile for a different haplotype.
+    struct PopulationWorker
+    {
+        boost::optional<HaplotypeLikelihoodModel> likelihood_model;
+        boost::optional<std::size_t> haplotype;
+        MappedIndexCounts haplotype_mapping_counts;
+        ReadBatch batch;
+    };
     
     void set_read_iterators_and_sample_indices(const ReadMap& reads);
     void set_template_iterators_and_sample_indices(const TemplateMap& reads);
+    bool use_parallel_population(std::size_t num_haplotypes, std::size_t num_reads) const noexcept;
+    bool use_alignment_memo() const noexcept;
+    static void evaluate_reads(ReadPacket::Iterator first_read,
+                               std::vector<KmerPerfectHashes>::const_iterator first_read_hashes,
+                               std::size_t num_reads,
+                               const KmerHashTable& haplotype_hashes,
+                               MappedIndexCounts& haplotype_mapping_counts,
+                               const HaplotypeLikelihoodModel& likelihood_model,
+                               const HaplotypeLikelihoodModel::AlignmentMemo* alignment_memo,
+                               HaplotypeLikelihoodModel::AlignmentMemo* new_alignments,
+                               ReadBatch& batch,
+                               LikelihoodVector::iterator result);
+    void populate_in_parallel(const std::vector<std::vector<KmerPerfectHashes>>& read_hashes,
+                              const MappableBlock<Haplotype>& haplotypes,
+                              const boost::optional<FlankState>& flank_state);
+    void populate_in_parallel(const std::vector<std::vector<std::vector<KmerPerfectHashes>>>& template_hashes,
+                              const MappableBlock<Haplotype>& haplotypes,
+                              const boost::optional<FlankState>& flank_state);
 };
 
 // non-member methods
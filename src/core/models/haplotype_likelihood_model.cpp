@@ -6,8 +6,13 @@
 #include <utility>
 #include <cmath>
 #include <limits>
+#include <iterator>
+#include <string>
+#include <unordered_map>
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
+
 #include "core/models/error/error_model_factory.hpp"
 #include "concepts/mappable.hpp"
 #include "utils/maths.hpp"
@@ -32,6 +37,137 @@ HaplotypeLikelihoodModel::ShortHaplotypeError::required_extension() const noexce
     return required_extension_;
 }
 
+std::size_t HaplotypeLikelihoodModel::AlignmentMemo::KeyHash::operator()(const Key& key) const noexcept
+{
+    std::size_t result {key.read};
+    boost::hash_combine(result, key.context);
+    return result;
+}
+
+bool HaplotypeLikelihoodModel::AlignmentMemo::KeyEqual::operator()(const Key& lhs, const Key& rhs) const noexcept
+{
+    return lhs.read == rhs.read && lhs.context == rhs.context;
+}
+
+std::size_t HaplotypeLikelihoodModel::AlignmentMemo::size() const noexcept
+{
+    return alignments_.size();
+}
+
+bool HaplotypeLikelihoodModel::AlignmentMemo::empty() const noexcept
+{
+    return alignments_.empty();
+}
+
+namespace {
+
+// Each value is a hash table node holding the value and a link, plus allocator overhead
+template <typename Map>
+std::size_t hash_table_footprint(const Map& map) noexcept
+{
+    using Node = typename Map::value_type;
+    return map.size() * (sizeof(Node) + 2 * sizeof(void*)) + map.bucket_count() * sizeof(void*);
+}
+
+} // namespace
+
+std::size_t HaplotypeLikelihoodModel::AlignmentMemo::footprint() const noexcept
+{
+    return hash_table_footprint(alignments_) + hash_table_footprint(reads_) + hash_table_footprint(contexts_) + interned_bytes_;
+}
+
+void HaplotypeLikelihoodModel::AlignmentMemo::merge(AlignmentMemo&& other)
+{
+    std::unordered_map<Id, Id> read_ids {}, context_ids {};
+    read_ids.reserve(other.reads_.size());
+    for (const auto& p : other.reads_) {
+        read_ids.emplace(p.second.id, intern(reads_, p.first));
+    }
+    context_ids.reserve(other.contexts_.size());
+    for (const auto& p : other.contexts_) {
+        context_ids.emplace(p.second.id, intern(contexts_, p.first));
+    }
+    for (const auto& p : other.alignments_) {
+        const Key key {read_ids.at(p.first.read), context_ids.at(p.first.context)};
+        alignments_[key] = {p.second.score, generation_};
+    }
+    other.clear();
+}
+
+void HaplotypeLikelihoodModel::AlignmentMemo::evict_unused()
+{
+    // Alignments are only used along with their read and context, so these are never evicted before
+    // an alignment that refers to them
+    for (auto itr = std::begin(alignments_); itr != std::end(alignments_);) {
+        if (itr->second.generation != generation_) {
+            itr = alignments_.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+    evict_unused(reads_);
+    evict_unused(contexts_);
+    ++generation_;
+}
+
+void HaplotypeLikelihoodModel::AlignmentMemo::clear() noexcept
+{
+    alignments_.clear();
+    reads_.clear();
+    contexts_.clear();
+    interned_bytes_ = 0;
+}
+
+boost::optional<HaplotypeLikelihoodModel::AlignmentMemo::Id>
+HaplotypeLikelihoodModel::AlignmentMemo::find_read(const std::string& read) const
+{
+    const auto itr = reads_.find(read);
+    if (itr == std::cend(reads_)) return boost::none;
+    return itr->second.id;
+}
+
+boost::optional<HaplotypeLikelihoodModel::LogProbability>
+HaplotypeLikelihoodModel::AlignmentMemo::find(const Id read, const std::string& context) const
+{
+    const auto context_itr = contexts_.find(context);
+    if (context_itr == std::cend(contexts_)) return boost::none;
+    const auto alignment_itr = alignments_.find({read, context_itr->second.id});
+    if (alignment_itr == std::cend(alignments_)) return boost::none;
+    return alignment_itr->second.score;
+}
+
+void HaplotypeLikelihoodModel::AlignmentMemo::insert(const std::string& read, const std::string& context, const LogProbability score)
+{
+    const Key key {intern(reads_, read), intern(contexts_, context)};
+    alignments_[key] = {score, generation_};
+}
+
+HaplotypeLikelihoodModel::AlignmentMemo::Id
+HaplotypeLikelihoodModel::AlignmentMemo::intern(InternTable& table, const std::string& bytes)
+{
+    const auto itr = table.find(bytes);
+    if (itr != std::end(table)) {
+        itr->second.generation = generation_;
+        return itr->second.id;
+    }
+    const auto id = next_id_++;
+    table.emplace(bytes, Interned {id, generation_});
+    interned_bytes_ += bytes.capacity();
+    return id;
+}
+
+void HaplotypeLikelihoodModel::AlignmentMemo::evict_unused(InternTable& table)
+{
+    for (auto itr = std::begin(table); itr != std::end(table);) {
+        if (itr->second.generation != generation_) {
+            interned_bytes_ -= itr->first.capacity();
+            itr = table.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
 // public methods
 
 const HaplotypeLikelihoodModel::Config& HaplotypeLikelihoodModel::config() const noexcept
@@ -208,34 +344,31 @@ bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, co
 
 } // namespace
 
+// The positions read should be evaluated at: the in-range mapping positions and the original
+// position, or if none of these are in range, the nearest position that is.
 template <typename InputIt, typename pHMM>
-HaplotypeLikelihoodModel::LogProbability
-max_score(const AlignedRead& read, const Haplotype& haplotype,
-          InputIt first_mapping_position, InputIt last_mapping_position,
-          const pHMM& hmm)
+void
+get_evaluation_positions(const AlignedRead& read, const Haplotype& haplotype,
+                         InputIt first_mapping_position, InputIt last_mapping_position,
+                         const pHMM& hmm, std::vector<std::size_t>& result)
 {
     assert(contains(haplotype, read));
-    using LogProbability = HaplotypeLikelihoodModel::LogProbability;
     using PositionType = typename std::iterator_traits<InputIt>::value_type;
     const auto original_mapping_position = static_cast<PositionType>(begin_distance(haplotype, read));
-    auto max_log_probability = std::numeric_limits<LogProbability>::lowest();
-    bool is_original_position_mapped {false}, has_in_range_mapping_position {false};
+    result.clear();
+    bool is_original_position_mapped {false};
     std::for_each(first_mapping_position, last_mapping_position, [&] (const auto position) {
         if (position == original_mapping_position) {
             is_original_position_mapped = true;
         }
         if (is_in_range(position, read, haplotype, hmm)) {
-            has_in_range_mapping_position = true;
-            auto p = hmm.evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position);
-            max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
+            result.push_back(position);
         }
     });
     if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype, hmm)) {
-        has_in_range_mapping_position = true;
-        auto p = hmm.evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), original_mapping_position);
-        max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
+        result.push_back(original_mapping_position);
     }
-    if (!has_in_range_mapping_position) {
+    if (result.empty()) {
         const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype, hmm);
         auto final_mapping_position = original_mapping_position;
         if (min_shift > 0) {
@@ -252,36 +385,50 @@ max_score(const AlignedRead& read, const Haplotype& haplotype,
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, required_extension};
             }
         }
-        max_log_probability = hmm.evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), final_mapping_position);
+        result.push_back(final_mapping_position);
     }
-    assert(max_log_probability > std::numeric_limits<LogProbability>::lowest() && max_log_probability <= 0);
-    return max_log_probability;
 }
 
+template <typename InputIt, typename pHMM>
 HaplotypeLikelihoodModel::LogProbability
-HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
-                                   MappingPositionItr first_mapping_position,
-                                   MappingPositionItr last_mapping_position) const
+max_score(const AlignedRead& read, const Haplotype& haplotype,
+          InputIt first_mapping_position, InputIt last_mapping_position,
+          const pHMM& hmm)
 {
-    if (haplotype_ == nullptr) {
-        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    using LogProbability = HaplotypeLikelihoodModel::LogProbability;
+    thread_local std::vector<std::size_t> positions {};
+    get_evaluation_positions(read, haplotype, first_mapping_position, last_mapping_position, hmm, positions);
+    auto max_log_probability = std::numeric_limits<LogProbability>::lowest();
+    for (const auto position : positions) {
+        auto p = hmm.evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position);
+        max_log_probability = std::max(static_cast<LogProbability>(p), max_log_probability);
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    HMM::ParameterType model {
+    assert(max_log_probability > std::numeric_limits<LogProbability>::lowest() && max_log_probability <= 0);
+    return max_log_probability;
+}
+
+HaplotypeLikelihoodModel::HMM::ParameterType
+HaplotypeLikelihoodModel::make_hmm_parameters(const bool is_forward) const noexcept
+{
+    HMM::ParameterType result {
         haplotype_gap_open_penalities_,
         haplotype_gap_extend_penalities_,
         is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
         is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_
     };
     if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
+        result.lhs_flank_size = haplotype_flank_state_->lhs_flank;
+        result.rhs_flank_size = haplotype_flank_state_->rhs_flank;
     } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
+        result.lhs_flank_size = 0;
+        result.rhs_flank_size = 0;
     }
-    hmm_.set(model);
-    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, hmm_);
+    return result;
+}
+
+HaplotypeLikelihoodModel::LogProbability
+HaplotypeLikelihoodModel::adjust_for_mapping_quality(const AlignedRead& read, const LogProbability ln_prob_given_mapped) const noexcept
+{
     if (config_.use_mapping_quality) {
         // This calculation is approximately
         // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
@@ -303,6 +450,154 @@ HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
     }
 }
 
+HaplotypeLikelihoodModel::LogProbability
+HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
+                                   MappingPositionItr first_mapping_position,
+                                   MappingPositionItr last_mapping_position) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    const auto model = make_hmm_parameters(!read.is_marked_reverse_mapped());
+    hmm_.set(model);
+    const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, hmm_);
+    return adjust_for_mapping_quality(read, ln_prob_given_mapped);
+}
+
+void
+HaplotypeLikelihoodModel::evaluate(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                                   const std::vector<MappingPositionVector>& mapping_positions,
+                                   std::vector<LogProbability>& result) const
+{
+    evaluate_helper(reads, mapping_positions, result, nullptr, nullptr);
+}
+
+void
+HaplotypeLikelihoodModel::evaluate(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                                   const std::vector<MappingPositionVector>& mapping_positions,
+                                   std::vector<LogProbability>& result,
+                                   const AlignmentMemo& memo,
+                                   AlignmentMemo& new_alignments) const
+{
+    evaluate_helper(reads, mapping_positions, result, std::addressof(memo), std::addressof(new_alignments));
+}
+
+namespace {
+
+template <typename T>
+void append_range(const std::vector<T>& values, const std::size_t first, const std::size_t last, std::string& result)
+{
+    static_assert(sizeof(T) == 1, "");
+    assert(first <= last && last <= values.size());
+    result.append(reinterpret_cast<const char*>(values.data()) + first, last - first);
+}
+
+// Everything the HMM sees of the read
+void make_memo_read(const AlignedRead& read, std::string& result)
+{
+    result.clear();
+    result.reserve(1 + 2 * sequence_size(read));
+    result.push_back(read.is_marked_reverse_mapped() ? '-' : '+');
+    result.append(read.sequence().data(), read.sequence().size());
+    append_range(read.base_qualities(), 0, read.base_qualities().size(), result);
+}
+
+// Everything the HMM sees of the haplotype when aligning a read of the given size at position
+template <typename HMM>
+void
+make_memo_context(const Haplotype& haplotype, const HMM& hmm, const typename HMM::ParameterType& model,
+                  const std::size_t position, const std::size_t read_size, std::string& result)
+{
+    const auto pad = static_cast<std::size_t>(hmm.band_size());
+    assert(position >= pad && position + read_size + pad - 1 <= sequence_size(haplotype));
+    const auto first = position - pad, last = position + read_size + pad - 1;
+    result.clear();
+    result.reserve(5 * (last - first));
+    result.append(haplotype.sequence().data() + first, last - first);
+    append_range(model.snv_mask, first, last, result);
+    append_range(model.snv_priors, first, last, result);
+    append_range(model.gap_open, first, last, result);
+    append_range(model.gap_extend, first, last, result);
+}
+
+} // namespace
+
+void
+HaplotypeLikelihoodModel::evaluate_helper(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                                          const std::vector<MappingPositionVector>& mapping_positions,
+                                          std::vector<LogProbability>& result,
+                                          const AlignmentMemo* memo,
+                                          AlignmentMemo* new_alignments) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    assert(reads.size() <= mapping_positions.size());
+    assert((memo == nullptr) == (new_alignments == nullptr));
+    const auto forward_model = make_hmm_parameters(true);
+    const auto reverse_model = make_hmm_parameters(false);
+    // Every (read, position) pair is scored in a single batch so the HMM can fill its SIMD lanes
+    std::vector<hmm::BatchTarget<AlignedRead::NucleotideSequence, HMM::ParameterType>> targets {};
+    std::vector<std::size_t> target_reads {}, positions {};
+    // Memo reads and contexts of the targets that are memoised once scored
+    std::vector<std::string> memo_reads {};
+    std::vector<boost::optional<std::string>> target_contexts {};
+    targets.reserve(reads.size());
+    target_reads.reserve(reads.size());
+    if (memo) {
+        memo_reads.resize(reads.size());
+        target_contexts.reserve(reads.size());
+    }
+    std::string context {};
+    result.assign(reads.size(), std::numeric_limits<LogProbability>::lowest());
+    for (std::size_t read_idx {0}; read_idx < reads.size(); ++read_idx) {
+        const AlignedRead& read {reads[read_idx].get()};
+        const auto& read_mapping_positions = mapping_positions[read_idx];
+        get_evaluation_positions(read, *haplotype_, std::cbegin(read_mapping_positions), std::cend(read_mapping_positions),
+                                 hmm_, positions);
+        const auto& model = read.is_marked_reverse_mapped() ? reverse_model : forward_model;
+        boost::optional<AlignmentMemo::Id> memo_read_id {};
+        for (const auto position : positions) {
+            if (memo) {
+                // Flank adjusted scores depend on where the flanks are, not just the local context
+                if (hmm::detail::use_adjusted_alignment_score(haplotype_->sequence(), read.sequence(), position, hmm_, model)) {
+                    target_contexts.push_back(boost::none);
+                } else {
+                    auto& memo_read = memo_reads[read_idx];
+                    if (memo_read.empty()) {
+                        make_memo_read(read, memo_read);
+                        memo_read_id = memo->find_read(memo_read);
+                    }
+                    make_memo_context(*haplotype_, hmm_, model, position, sequence_size(read), context);
+                    const auto score = memo_read_id ? memo->find(*memo_read_id, context) : boost::none;
+                    if (score) {
+                        result[read_idx] = std::max(*score, result[read_idx]);
+                        new_alignments->insert(memo_read, context, *score);
+                        continue;
+                    }
+                    target_contexts.push_back(context);
+                }
+            }
+            targets.push_back({read.sequence(), read.base_qualities(), position, model});
+            target_reads.push_back(read_idx);
+        }
+    }
+    std::vector<LogProbability> scores {};
+    hmm_.evaluate(targets, haplotype_->sequence(), scores);
+    for (std::size_t target_idx {0}; target_idx < targets.size(); ++target_idx) {
+        const auto read_idx = target_reads[target_idx];
+        auto& max_log_probability = result[read_idx];
+        max_log_probability = std::max(scores[target_idx], max_log_probability);
+        if (memo && target_contexts[target_idx]) {
+            new_alignments->insert(memo_reads[read_idx], *target_contexts[target_idx], scores[target_idx]);
+        }
+    }
+    for (std::size_t read_idx {0}; read_idx < reads.size(); ++read_idx) {
+        assert(result[read_idx] > std::numeric_limits<LogProbability>::lowest() && result[read_idx] <= 0);
+        result[read_idx] = adjust_for_mapping_quality(reads[read_idx], result[read_idx]);
+    }
+}
+
 HaplotypeLikelihoodModel::LogProbability
 HaplotypeLikelihoodModel::evaluate(const AlignedTemplate& reads) const
 {
@@ -12,6 +12,8 @@
 #include <functional>
 #include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <string>
 
 #include <boost/optional.hpp>
 
@@ -49,6 +51,7 @@ public:
     };
     
     class ShortHaplotypeError;
+    class AlignmentMemo;
     
     using MappingPosition       = std::size_t;
     using MappingPositionVector = std::vector<MappingPosition>;
@@ -93,6 +96,17 @@ public:
     LogProbability evaluate(const AlignedRead& read) const;
     LogProbability evaluate(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     LogProbability evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
+    // Evaluates reads together, using mapping_positions[i] for reads[i]. Faster than evaluating reads one at a time.
+    void evaluate(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                  const std::vector<MappingPositionVector>& mapping_positions,
+                  std::vector<LogProbability>& result) const;
+    // As above, but alignments found in memo are reused rather than recomputed. Alignments that are
+    // computed or reused are recorded in new_alignments, which may be the same object as memo.
+    void evaluate(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                  const std::vector<MappingPositionVector>& mapping_positions,
+                  std::vector<LogProbability>& result,
+                  const AlignmentMemo& memo,
+                  AlignmentMemo& new_alignments) const;
     
     // ln p(read template | haplotype, model)
     LogProbability evaluate(const AlignedTemplate& reads) const;
@@ -118,6 +132,89 @@ private:
     std::vector<Penalty> haplotype_gap_open_penalities_, haplotype_gap_extend_penalities_;
     Config config_;
     mutable HMM hmm_;
+    
+    HMM::ParameterType make_hmm_parameters(bool is_forward) const noexcept;
+    LogProbability adjust_for_mapping_quality(const AlignedRead& read, LogProbability ln_prob_given_mapped) const noexcept;
+    void evaluate_helper(const std::vector<std::reference_wrapper<const AlignedRead>>& reads,
+                         const std::vector<MappingPositionVector>& mapping_positions,
+                         std::vector<LogProbability>& result,
+                         const AlignmentMemo* memo,
+                         AlignmentMemo* new_alignments) const;
+};
+
+/*
+    The score of a read aligned at some position only depends on the read and on the haplotype
+    sequence and error model within the HMM band around that position. AlignmentMemo stores these
+    scores so that haplotypes sharing the local sequence under a read, either in the same active
+    region or in a later one, don't need to realign it.
+ 
+    Alignments are keyed on the exact bytes the HMM sees: the read (strand, bases and qualities) and
+    the alignment context (the haplotype bases and error model penalties in the band). Each distinct
+    read and context is stored once and alignments refer to them by id, so keys are compared exactly
+    without storing the sequences with every alignment.
+ */
+class HaplotypeLikelihoodModel::AlignmentMemo
+{
+public:
+    AlignmentMemo() = default;
+    
+    AlignmentMemo(const AlignmentMemo&)            = default;
+    AlignmentMemo& operator=(const AlignmentMemo&) = default;
+    AlignmentMemo(AlignmentMemo&&)                 = default;
+    AlignmentMemo& operator=(AlignmentMemo&&)      = default;
+    
+    ~AlignmentMemo() = default;
+    
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    // Approximate heap bytes used by the alignments and the reads and contexts they refer to
+    std::size_t footprint() const noexcept;
+    
+    // Adds the alignments in other, marking them as used since the last call to evict_unused
+    void merge(AlignmentMemo&& other);
+    // Removes alignments that have not been used since the last call to evict_unused
+    void evict_unused();
+    void clear() noexcept;
+    
+private:
+    using Id = std::uint64_t;
+    struct Interned
+    {
+        Id id;
+        unsigned generation;
+    };
+    using InternTable = std::unordered_map<std::string, Interned>;
+    struct Key
+    {
+        Id read, context;
+    };
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+    struct KeyEqual
+    {
+        bool operator()(const Key& lhs, const Key& rhs) const noexcept;
+    };
+    struct Entry
+    {
+        LogProbability score;
+        unsigned generation;
+    };
+    
+    InternTable reads_, contexts_;
+    std::unordered_map<Key, Entry, KeyHash, KeyEqual> alignments_;
+    std::size_t interned_bytes_ = 0;
+    Id next_id_ = 0; // ids are never reused, so evicted reads and contexts can't alias new ones
+    unsigned generation_ = 0;
+    
+    boost::optional<Id> find_read(const std::string& read) const;
+    boost::optional<LogProbability> find(Id read, const std::string& context) const;
+    void insert(const std::string& read, const std::string& context, LogProbability score);
+    Id intern(InternTable& table, const std::string& bytes);
+    void evict_unused(InternTable& table);
+    
+    friend HaplotypeLikelihoodModel;
 };
 
 class HaplotypeLikelihoodModel::ShortHaplotypeError : public std::runtime_error
@@ -9,23 +9,23 @@
 #endif
 
 #include <cstdint>
-#include <array>
-#include <tuple>
 #include <type_traits>
 #include <cassert>
 #include <immintrin.h>
 
-#include "utils/array_tricks.hpp"
-#include "system.hpp"
+#include "simd_aligned_storage.hpp"
 
 namespace octopus { namespace hmm { namespace simd {
 
-#if defined(__AVX2__) && AVX2_AVAILABLE
+#if defined(__AVX2__)
 
 #define AVX2_PHMM
 
 namespace detail {
 
+// Internal linkage, as each kernel translation unit compiles these for its own target
+namespace {
+
 // source: https://stackoverflow.com/a/25264853/2970186
 
 template <int n>
@@ -60,10 +60,14 @@ std::enable_if_t<(n > 16), __m256i> _shift_right(const __m256i& a) noexcept
     return _shift_right<n - 16>(_mm256_permute2x128_si256(a, a, _MM_SHUFFLE(2, 0, 0, 1)));
 }
 
+} // namespace
+
 } // namespace detail
 
+// Tag only distinguishes instantiations compiled with different target flags
 template <unsigned BandSize = 16,
-          typename ScoreTp = short>
+          typename ScoreTp = short,
+          typename Tag = void>
 class AVX2PairHMMInstructionSet
 {
     using BlockType = __m256i;
@@ -86,20 +90,36 @@ private:
     static_assert(BandSize % block_words_ == 0, "BandSize must be multiple of block words");
     
 protected:
-    using VectorType = std::array<BlockType, num_blocks_>;
+    using VectorType = BlockArray<BlockType, num_blocks_, Tag>;
     
     constexpr static int band_size = num_blocks_ * block_words_;
     
     static_assert(sizeof(VectorType) / word_size == band_size, "size error");
     
+private:
+    // As make_array in utils/array_tricks.hpp, for VectorType
+    template <std::size_t... Is>
+    static VectorType make_vector(const BlockType& first, const BlockType& rest, std::index_sequence<Is...>) noexcept
+    {
+        return {{first, (static_cast<void>(Is), rest)...}};
+    }
+    static VectorType make_vector(const BlockType& first, const BlockType& rest) noexcept
+    {
+        return make_vector(first, rest, std::make_index_sequence<num_blocks_ - 1>());
+    }
+    static VectorType make_vector(const BlockType& value) noexcept
+    {
+        return make_vector(value, value);
+    }
+    
 private:
     static VectorType do_vectorise(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm256_set1_epi16(x));
+        return make_vector(_mm256_set1_epi16(x));
     }
     static VectorType do_vectorise(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm256_set1_epi32(x));
+        return make_vector(_mm256_set1_epi32(x));
     }
 protected:
     static VectorType vectorise(ScoreType x) noexcept
@@ -152,11 +172,11 @@ protected:
 private:
     static VectorType do_vectorise_zero_set_last(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm256_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x), _mm256_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
+        return make_vector(_mm256_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x), _mm256_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
     }
     static VectorType do_vectorise_zero_set_last(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm256_set_epi32(0,0,0,0,0,0,0,x), _mm256_set_epi32(0,0,0,0,0,0,0,0));
+        return make_vector(_mm256_set_epi32(0,0,0,0,0,0,0,x), _mm256_set_epi32(0,0,0,0,0,0,0,0));
     }
 protected:
     static VectorType vectorise_zero_set_last(ScoreType x) noexcept
@@ -182,7 +202,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        return do_extract<word_index>(std::get<block_index>(a), ScoreType {});
+        return do_extract<word_index>(a[block_index], ScoreType {});
     }
 private:
     template <std::size_t... Is>
@@ -218,7 +238,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        std::get<block_index>(a) = do_insert<word_index>(std::get<block_index>(a), value, ScoreType {});
+        a[block_index] = do_insert<word_index>(a[block_index], value, ScoreType {});
         return a;
     }
 private:
@@ -296,7 +316,7 @@ protected:
         adjacent_apply_reverse([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm256_or_si256(_shift_left<word_size>(rhs), _shift_right<block_bytes_ - word_size>(lhs));
         }, a, a);
-        std::get<0>(a) = _shift_left<word_size>(std::get<0>(a));
+        a[0] = _shift_left<word_size>(a[0]);
         return a;
     }
     static VectorType _right_shift_word(VectorType a) noexcept
@@ -306,7 +326,7 @@ protected:
         adjacent_apply([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm256_or_si256(_shift_right<word_size>(lhs), _shift_left<block_bytes_ - word_size>(rhs));
         }, a, a);
-        std::get<num_blocks_ - 1>(a) = _shift_right<word_size>(std::get<num_blocks_ - 1>(a));
+        a[num_blocks_ - 1] = _shift_right<word_size>(a[num_blocks_ - 1]);
         return a;
     }
 private:
@@ -373,7 +393,7 @@ protected:
     }
 };
 
-#endif // defined(__AVX2__) && AVX2_AVAILABLE
+#endif // defined(__AVX2__)
 
 } // namespace simd
 } // namespace hmm
@@ -0,0 +1,47 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Compiled with -mavx2 when the compiler supports it
+
+#include "simd_pair_hmm_kernel_impl.hpp"
+#include "sse2_pair_hmm_impl.hpp"
+#include "avx2_pair_hmm_impl.hpp"
+
+namespace octopus { namespace hmm { namespace simd { namespace detail {
+
+#if defined(AVX2_PHMM)
+
+namespace {
+
+struct AVX2InstructionSets
+{
+    // Band sizes too small to fill an AVX2 register use SSE2 (VEX encoded) for the intra-sequence kernel
+    template <unsigned BandSize, typename ScoreType>
+    using Intra = std::conditional_t<is_viable_band_size<BandSize, ScoreType, 32>,
+                                     AVX2PairHMMInstructionSet<BandSize, ScoreType, AVX2InstructionSets>,
+                                     SSE2PairHMMInstructionSet<BandSize, ScoreType, AVX2InstructionSets>>;
+    
+    template <typename ScoreType>
+    using Inter = AVX2PairHMMInstructionSet<32 / sizeof(ScoreType), ScoreType, AVX2InstructionSets>;
+};
+
+} // namespace
+
+const PairHMMKernel* find_avx2_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    return find_kernel<AVX2InstructionSets>(min_band_size, precision);
+}
+
+#else
+
+const PairHMMKernel* find_avx2_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    return nullptr;
+}
+
+#endif // defined(AVX2_PHMM)
+
+} // namespace detail
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
@@ -9,18 +9,15 @@
 #endif
 
 #include <cstdint>
-#include <array>
-#include <tuple>
 #include <type_traits>
 #include <cassert>
 #include <immintrin.h>
 
-#include "utils/array_tricks.hpp"
-#include "system.hpp"
+#include "simd_aligned_storage.hpp"
 
 namespace octopus { namespace hmm { namespace simd {
 
-#if defined(__AVX512F__) && defined(__AVX512BW__) && AVX512_AVAILABLE
+#if defined(__AVX512F__) && defined(__AVX512BW__)
 
 #define AVX512_PHMM
 
@@ -43,6 +40,9 @@ static inline __m512i _mm512_insert_epi32(__m512i target, const std::int32_t x,
     return _mm512_mask_set1_epi32(target, 1UL << index, x);
 }
 
+// Internal linkage, as each kernel translation unit compiles these for its own target
+namespace {
+
 template <int index>
 int _mm512_extract_epi32(__m512i target)
 {
@@ -54,6 +54,8 @@ int  _mm512_extract_epi16(__m512i target)
     return (_mm512_extract_epi32<index / 2>(target) >> (index % 2 ? 16 : 0)) & 0xFFFF;
 }
 
+} // namespace
+
 static inline __m512i _mm512_cmpeq_epi16(__m512i a, __m512i b)
 {
     return _mm512_maskz_set1_epi16(_mm512_cmpeq_epi16_mask(a, b), 0xFFFF);
@@ -64,7 +66,9 @@ static inline __m512i _mm512_cmpeq_epi32(__m512i a, __m512i b)
 }
 
 namespace detail {
-    
+
+namespace {
+
 // See https://stackoverflow.com/questions/58322652/emulating-shifts-on-64-bytes-with-avx-512/58396344?noredirect=1#comment103208249_58396344
 
 template <int count>
@@ -96,10 +100,14 @@ __m512i _shift_left(__m512i a, __m512i carry = _mm512_setzero_si512())
   return _shift_right<64 - count>(carry, a);
 }
 
+} // namespace
+
 } // namespace detail
 
+// Tag only distinguishes instantiations compiled with different target flags
 template <unsigned BandSize = 32,
-          typename ScoreTp = short>
+          typename ScoreTp = short,
+          typename Tag = void>
 class AVX512PairHMMInstructionSet
 {
     using BlockType = __m512i;
@@ -122,20 +130,36 @@ private:
     static_assert(BandSize % block_words_ == 0, "BandSize must be multiple of block words");
     
 protected:
-    using VectorType = std::array<BlockType, num_blocks_>;
+    using VectorType = BlockArray<BlockType, num_blocks_, Tag>;
     
     constexpr static int band_size = num_blocks_ * block_words_;
     
     static_assert(sizeof(VectorType) / word_size == band_size, "size error");
     
+private:
+    // As make_array in utils/array_tricks.hpp, for VectorType
+    template <std::size_t... Is>
+    static VectorType make_vector(const BlockType& first, const BlockType& rest, std::index_sequence<Is...>) noexcept
+    {
+        return {{first, (static_cast<void>(Is), rest)...}};
+    }
+    static VectorType make_vector(const BlockType& first, const BlockType& rest) noexcept
+    {
+        return make_vector(first, rest, std::make_index_sequence<num_blocks_ - 1>());
+    }
+    static VectorType make_vector(const BlockType& value) noexcept
+    {
+        return make_vector(value, value);
+    }
+    
 private:
     static VectorType do_vectorise(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm512_set1_epi16(x));
+        return make_vector(_mm512_set1_epi16(x));
     }
     static VectorType do_vectorise(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm512_set1_epi32(x));
+        return make_vector(_mm512_set1_epi32(x));
     }
 protected:
     static VectorType vectorise(ScoreType x) noexcept
@@ -212,13 +236,13 @@ protected:
 private:
     static VectorType do_vectorise_zero_set_last(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm512_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x),
-                                       _mm512_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
+        return make_vector(_mm512_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x),
+                           _mm512_set_epi16(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
     }
     static VectorType do_vectorise_zero_set_last(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm512_set_epi32(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x),
-                                       _mm512_set_epi32(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
+        return make_vector(_mm512_set_epi32(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,x),
+                           _mm512_set_epi32(0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
     }
 protected:
     static VectorType vectorise_zero_set_last(ScoreType x) noexcept
@@ -244,7 +268,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        return do_extract<word_index>(std::get<block_index>(a), ScoreType {});
+        return do_extract<word_index>(a[block_index], ScoreType {});
     }
 private:
     template <std::size_t... Is>
@@ -280,7 +304,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        std::get<block_index>(a) = do_insert<word_index>(std::get<block_index>(a), value, ScoreType {});
+        a[block_index] = do_insert<word_index>(a[block_index], value, ScoreType {});
         return a;
     }
 private:
@@ -358,7 +382,7 @@ protected:
         adjacent_apply_reverse([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm512_or_si512(_shift_left<word_size>(rhs), _shift_right<block_bytes_ - word_size>(lhs));
         }, a, a);
-        std::get<0>(a) = _shift_left<word_size>(std::get<0>(a));
+        a[0] = _shift_left<word_size>(a[0]);
         return a;
     }
     static VectorType _right_shift_word(VectorType a) noexcept
@@ -368,7 +392,7 @@ protected:
         adjacent_apply([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm512_or_si512(_shift_right<word_size>(lhs), _shift_left<block_bytes_ - word_size>(rhs));
         }, a, a);
-        std::get<num_blocks_ - 1>(a) = _shift_right<word_size>(std::get<num_blocks_ - 1>(a));
+        a[num_blocks_ - 1] = _shift_right<word_size>(a[num_blocks_ - 1]);
         return a;
     }
 private:
@@ -435,7 +459,7 @@ protected:
     }
 };
 
-#endif // defined(__AVX512F__) && defined(__AVX512BW__) && AVX512_AVAILABLE
+#endif // defined(__AVX512F__) && defined(__AVX512BW__)
 
 } // namespace simd
 } // namespace hmm
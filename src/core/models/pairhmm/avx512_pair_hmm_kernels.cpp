@@ -0,0 +1,55 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// Compiled with -mavx512f -mavx512bw when the compiler supports them
+
+#if __GNUC__ >= 12 && !defined(__clang__)
+    // _mm512_undefined_epi32 in GCC's own headers trips this
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#include "simd_pair_hmm_kernel_impl.hpp"
+#include "sse2_pair_hmm_impl.hpp"
+#include "avx2_pair_hmm_impl.hpp"
+#include "avx512_pair_hmm_impl.hpp"
+
+namespace octopus { namespace hmm { namespace simd { namespace detail {
+
+#if defined(AVX512_PHMM) && defined(AVX2_PHMM)
+
+namespace {
+
+struct AVX512InstructionSets
+{
+    // Use the widest instruction set that the band size fills
+    template <unsigned BandSize, typename ScoreType>
+    using Intra = std::conditional_t<is_viable_band_size<BandSize, ScoreType, 64>,
+                                     AVX512PairHMMInstructionSet<BandSize, ScoreType, AVX512InstructionSets>,
+                                     std::conditional_t<is_viable_band_size<BandSize, ScoreType, 32>,
+                                                        AVX2PairHMMInstructionSet<BandSize, ScoreType, AVX512InstructionSets>,
+                                                        SSE2PairHMMInstructionSet<BandSize, ScoreType, AVX512InstructionSets>>>;
+    
+    template <typename ScoreType>
+    using Inter = AVX512PairHMMInstructionSet<64 / sizeof(ScoreType), ScoreType, AVX512InstructionSets>;
+};
+
+} // namespace
+
+const PairHMMKernel* find_avx512_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    return find_kernel<AVX512InstructionSets>(min_band_size, precision);
+}
+
+#else
+
+const PairHMMKernel* find_avx512_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    return nullptr;
+}
+
+#endif // defined(AVX512_PHMM) && defined(AVX2_PHMM)
+
+} // namespace detail
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
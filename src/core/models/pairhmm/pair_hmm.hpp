@@ -24,7 +24,6 @@
 #include "basics/cigar_string.hpp"
 #include "exceptions/program_error.hpp"
 #include "utils/maths.hpp"
-#include "simd_pair_hmm_factory.hpp"
 #include "simd_pair_hmm_wrapper.hpp"
 
 namespace octopus { namespace hmm {
@@ -91,9 +90,18 @@ using VariableGapExtendMutationModel = Parameters<const PenaltyVector&, const Pe
 using VariableGapOpenMutationModel   = Parameters<const PenaltyVector&, Penalty, NullType, NullType, Penalty>;
 using FlatGapMutationModel           = Parameters<Penalty, Penalty, NullType, NullType, Penalty>;
 
-using octopus::maths::constants::ln10Div10;
+// A target to be evaluated against a shared truth, with its own model parameters
+template <typename Sequence,
+          typename PairHMMParameters>
+struct BatchTarget
+{
+    const Sequence& sequence;
+    const std::vector<std::uint8_t>& base_qualities;
+    std::size_t offset;
+    const PairHMMParameters& params;
+};
 
-const static auto default_hmm = simd::make_simd_pair_hmm<16>();
+using octopus::maths::constants::ln10Div10;
 
 namespace detail {
 
@@ -822,6 +830,57 @@ simd_align(const Sequence1& truth,
     make_cigar(align1, align2, result.cigar);
 }
 
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMMParameters>
+void
+simd_evaluate(const Sequence1& truth,
+              const std::vector<BatchTarget<Sequence2, PairHMMParameters>>& targets,
+              const simd::PairHMMWrapper& hmm,
+              std::vector<double>& result)
+{
+    thread_local std::vector<simd::AlignmentTask> tasks {};
+    thread_local std::vector<std::size_t> task_indices {};
+    thread_local std::vector<int> scores {};
+    tasks.clear();
+    task_indices.clear();
+    const auto pad = hmm.band_size();
+    const auto truth_size = static_cast<int>(truth.size());
+    const auto nuc_prior = targets.front().params.nuc_prior;
+    for (std::size_t target_idx {0}; target_idx < targets.size(); ++target_idx) {
+        const auto& target = targets[target_idx];
+        const auto naive = try_naive_evaluate(truth, target.sequence, target.base_qualities, target.offset, target.params);
+        if (naive.second) {
+            result[target_idx] = naive.first;
+            continue;
+        }
+        const auto target_size = static_cast<int>(target.sequence.size());
+        const auto truth_alignment_size = static_cast<int>(target_size + 2 * pad - 1);
+        const auto alignment_offset = std::max(0, static_cast<int>(target.offset) - pad);
+        if (alignment_offset + truth_alignment_size > truth_size
+            || target.params.nuc_prior != nuc_prior
+            || use_adjusted_alignment_score(truth, target.sequence, target.offset, hmm, target.params)) {
+            // Flank adjustment needs a traceback, so these are left to the single target path
+            result[target_idx] = simd_evaluate(truth, target.sequence, target.base_qualities, target.offset, hmm, target.params);
+        } else {
+            tasks.push_back({truth.data() + alignment_offset,
+                             target.sequence.data(),
+                             reinterpret_cast<const std::int8_t*>(target.base_qualities.data()),
+                             target_size,
+                             data(target.params.snv_mask, alignment_offset),
+                             data(target.params.snv_priors, alignment_offset),
+                             data(target.params.gap_open, alignment_offset),
+                             data(target.params.gap_extend, alignment_offset)});
+            task_indices.push_back(target_idx);
+        }
+    }
+    if (tasks.empty()) return;
+    hmm.align(tasks, nuc_prior, scores);
+    for (std::size_t task_idx {0}; task_idx < tasks.size(); ++task_idx) {
+        result[task_indices[task_idx]] = -ln10Div10<> * static_cast<double>(scores[task_idx]);
+    }
+}
+
 } // namespace detail
 
 template <typename Sequence1,
@@ -855,6 +914,35 @@ evaluate(const Sequence1& truth,
     return evaluate(truth, target, target_base_qualities, hmm.band_size(), hmm, model_params);
 }
 
+template <typename Sequence1,
+          typename Sequence2,
+          typename PairHMM,
+          typename PairHMMParameters>
+void
+evaluate(const Sequence1& truth,
+         const std::vector<BatchTarget<Sequence2, PairHMMParameters>>& targets,
+         const PairHMM& hmm,
+         std::vector<double>& result)
+{
+    result.resize(targets.size());
+    std::transform(std::cbegin(targets), std::cend(targets), std::begin(result), [&] (const auto& target) {
+        return evaluate(truth, target.sequence, target.base_qualities, target.offset, hmm, target.params);
+    });
+}
+template <typename Sequence1,
+          typename Sequence2>
+void
+evaluate(const Sequence1& truth,
+         const std::vector<BatchTarget<Sequence2, MutationModel>>& targets,
+         const simd::PairHMMWrapper& hmm,
+         std::vector<double>& result)
+{
+    result.resize(targets.size());
+    if (!targets.empty()) {
+        detail::simd_evaluate(truth, targets, hmm, result);
+    }
+}
+
 template <typename Sequence1,
           typename Sequence2,
           typename PairHMM,
@@ -953,6 +1041,18 @@ public:
         return octopus::hmm::evaluate(truth, target, hmm_, *params_);
     }
     
+    // Evaluates many targets against the same truth. Each target supplies its own
+    // parameters, so set() is not needed.
+    template <typename Sequence1,
+              typename Sequence2>
+    void
+    evaluate(const std::vector<BatchTarget<Sequence1, Parameters>>& targets,
+             const Sequence2& truth,
+             std::vector<double>& result) const
+    {
+        octopus::hmm::evaluate(truth, targets, hmm_, result);
+    }
+    
     template <typename Sequence1,
               typename Sequence2>
     void
@@ -1000,11 +1100,11 @@ public:
     }
     
 private:
-    using SIMDHMM = std::conditional_t<(BandSize > 0), simd::SimdPairHMM<BandSize, Score>, simd::PairHMMWrapper>;
-    
+    // A BandSize and Score fix the kernel band and precision, but the instruction set is still chosen at runtime
     static constexpr bool is_static = BandSize > 0 && !std::is_same<Score, NullType>::value;
+    static constexpr int default_band_size = BandSize > 0 ? BandSize : 8;
     
-    SIMDHMM hmm_;
+    simd::PairHMMWrapper hmm_ {default_band_size, score_precision()};
     const Parameters* params_ = nullptr;
     
     void reset(unsigned min_band_size) { reset(min_band_size, std::conditional_t<is_static, std::true_type, std::false_type> {}); }
@@ -1013,19 +1113,19 @@ private:
     void reset(unsigned min_band_size, ScoreType score) { reset(min_band_size, score, std::conditional_t<is_static, std::true_type, std::false_type> {}); }
     void reset(unsigned min_band_size, ScoreType score, std::true_type) const noexcept {}
     void reset(unsigned min_band_size, ScoreType score, std::false_type) { hmm_.reset(min_band_size, score); }
-    simd::PairHMMWrapper::ScorePrecision score_precision(NullType) const noexcept
+    static constexpr simd::PairHMMWrapper::ScorePrecision score_precision(NullType) noexcept
     {
         return score_precision(short {});
     }
-    simd::PairHMMWrapper::ScorePrecision score_precision(short) const noexcept
+    static constexpr simd::PairHMMWrapper::ScorePrecision score_precision(short) noexcept
     {
         return simd::PairHMMWrapper::ScorePrecision::int16;
     }
-    simd::PairHMMWrapper::ScorePrecision score_precision(int) const noexcept
+    static constexpr simd::PairHMMWrapper::ScorePrecision score_precision(int) noexcept
     {
         return simd::PairHMMWrapper::ScorePrecision::int32;
     }
-    simd::PairHMMWrapper::ScorePrecision score_precision() const noexcept
+    static constexpr simd::PairHMMWrapper::ScorePrecision score_precision() noexcept
     {
         return score_precision(Score {});
     }
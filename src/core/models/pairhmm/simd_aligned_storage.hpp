@@ -0,0 +1,151 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_aligned_storage_hpp
+#define simd_aligned_storage_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace octopus { namespace hmm { namespace simd {
+
+/*
+    Storage for the instruction set policies and the pair HMMs built on them. Each kernel
+    translation unit compiles this code with its own target flags, so every type takes the
+    instruction set's Tag: with the tag in an anonymous namespace, no instantiation can be
+    merged by the linker with the copy from another unit. For the same reason, nothing here
+    uses standard library templates over untagged types.
+*/
+
+// A fixed number of SIMD blocks, used like std::array
+template <typename BlockType, std::size_t N, typename Tag>
+struct BlockArray
+{
+    BlockType blocks[N];
+
+    BlockType& operator[](const std::size_t idx) noexcept { return blocks[idx]; }
+    const BlockType& operator[](const std::size_t idx) const noexcept { return blocks[idx]; }
+    BlockType* data() noexcept { return blocks; }
+    const BlockType* data() const noexcept { return blocks; }
+    constexpr static std::size_t size() noexcept { return N; }
+};
+
+// As utils/array_tricks.hpp, for BlockArray
+
+namespace detail {
+template <typename UnaryOperation, typename T, std::size_t N, typename Tag, std::size_t...Is>
+auto transform(UnaryOperation&& op, const BlockArray<T, N, Tag>& values, std::index_sequence<Is...>)
+-> BlockArray<decltype(op(T{})), N, Tag>
+{
+    return {{op(values[Is])...}};
+}
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag, std::size_t...Is>
+auto transform(BinaryOperation&& op, const BlockArray<T, N, Tag>& lhs, const BlockArray<T, N, Tag>& rhs, std::index_sequence<Is...>)
+-> BlockArray<decltype(op(T{}, T{})), N, Tag>
+{
+    return {{op(lhs[Is], rhs[Is])...}};
+}
+} // namespace detail
+
+template <typename UnaryOperation, typename T, std::size_t N, typename Tag>
+auto transform(UnaryOperation&& op, const BlockArray<T, N, Tag>& values)
+{
+    return detail::transform(op, values, std::make_index_sequence<N>());
+}
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag>
+auto transform(BinaryOperation&& op, const BlockArray<T, N, Tag>& lhs, const BlockArray<T, N, Tag>& rhs)
+{
+    return detail::transform(op, lhs, rhs, std::make_index_sequence<N>());
+}
+
+// Braced initialisers are evaluated in order, so source and dest may be the same array
+namespace detail {
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag, std::size_t...Is>
+void adjacent_apply(BinaryOperation&& op, const BlockArray<T, N, Tag>& source, BlockArray<T, N, Tag>& dest,
+                    std::index_sequence<Is...>)
+{
+    int unused[] = {0, (dest[Is] = op(source[Is], source[Is + 1]), 0)...};
+    (void) unused;
+}
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag, std::size_t...Is>
+void adjacent_apply_reverse(BinaryOperation&& op, const BlockArray<T, N, Tag>& source, BlockArray<T, N, Tag>& dest,
+                            std::index_sequence<Is...>)
+{
+    int unused[] = {0, (dest[N - Is - 1] = op(source[N - Is - 2], source[N - Is - 1]), 0)...};
+    (void) unused;
+}
+} // namespace detail
+
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag>
+void adjacent_apply(BinaryOperation&& op, const BlockArray<T, N, Tag>& source, BlockArray<T, N, Tag>& dest)
+{
+    detail::adjacent_apply(op, source, dest, std::make_index_sequence<N - 1>());
+}
+template <typename BinaryOperation, typename T, std::size_t N, typename Tag>
+void adjacent_apply_reverse(BinaryOperation&& op, const BlockArray<T, N, Tag>& source, BlockArray<T, N, Tag>& dest)
+{
+    detail::adjacent_apply_reverse(op, source, dest, std::make_index_sequence<N - 1>());
+}
+
+// A growable buffer of trivial values, aligned for T. Like std::vector, resize keeps existing
+// values and zero-initialises new ones.
+template <typename T, typename Tag>
+class AlignedBuffer
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer only holds trivial values");
+
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(const std::size_t size) { resize(size); }
+
+    AlignedBuffer(const AlignedBuffer&)            = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+    AlignedBuffer(AlignedBuffer&& other) noexcept
+    : memory_ {other.memory_}, data_ {other.data_}, size_ {other.size_}, capacity_ {other.capacity_}
+    {
+        other.memory_ = nullptr; other.data_ = nullptr;
+        other.size_ = 0; other.capacity_ = 0;
+    }
+    AlignedBuffer& operator=(AlignedBuffer&&) = delete;
+
+    ~AlignedBuffer() noexcept { ::operator delete(memory_); }
+
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    T& operator[](const std::size_t idx) noexcept { return data_[idx]; }
+    const T& operator[](const std::size_t idx) const noexcept { return data_[idx]; }
+
+    void resize(const std::size_t new_size)
+    {
+        if (new_size > capacity_) {
+            const auto new_capacity = new_size > 2 * capacity_ ? new_size : 2 * capacity_;
+            // ::operator new throws std::bad_alloc itself, and only guarantees fundamental alignment
+            void* new_memory {::operator new(new_capacity * sizeof(T) + alignof(T))};
+            const auto address = reinterpret_cast<std::uintptr_t>(new_memory);
+            const auto new_data = reinterpret_cast<T*>((address + alignof(T) - 1) & ~(std::uintptr_t {alignof(T)} - 1));
+            if (size_ > 0) std::memcpy(new_data, data_, size_ * sizeof(T));
+            ::operator delete(memory_);
+            memory_ = new_memory;
+            data_ = new_data;
+            capacity_ = new_capacity;
+        }
+        if (new_size > size_) std::memset(data_ + size_, 0, (new_size - size_) * sizeof(T));
+        size_ = new_size;
+    }
+
+private:
+    void* memory_ = nullptr;
+    T* data_ = nullptr;
+    std::size_t size_ = 0, capacity_ = 0;
+};
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
@@ -0,0 +1,333 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_inter_pair_hmm_hpp
+#define simd_inter_pair_hmm_hpp
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <limits>
+#include <cassert>
+#include <cstring>
+
+#include "simd_aligned_storage.hpp"
+
+namespace octopus { namespace hmm { namespace simd {
+
+// A single banded alignment of target against truth, where truth is the window
+// of target_len + 2 * BandSize - 1 bases the target is aligned into. The penalty
+// and SNV arrays are indexed the same way as truth.
+struct AlignmentTask
+{
+    const char* truth;
+    const char* target;
+    const std::int8_t* qualities;
+    int target_len;
+    const char* snv_mask;
+    const std::int8_t* snv_prior;
+    const std::int8_t* gap_open;
+    const std::int8_t* gap_extend;
+};
+
+// Fills order with the indices of the tasks by decreasing target length
+inline void order_by_target_length(const AlignmentTask* tasks, const std::size_t num_tasks, std::vector<std::size_t>& order)
+{
+    order.resize(num_tasks);
+    std::iota(std::begin(order), std::end(order), 0);
+    std::sort(std::begin(order), std::end(order), [tasks] (auto lhs, auto rhs) {
+        return tasks[lhs].target_len > tasks[rhs].target_len;
+    });
+}
+
+/*
+    InterPairHMM computes the same banded alignment scores as PairHMM, but rather than
+    vectorising along the band of a single alignment, each SIMD lane holds a different
+    alignment. InstructionSet is instantiated so that its band_size is the number of lanes,
+    and the band itself is held as an array of lane vectors. This keeps every lane busy
+    for small bands, where a single alignment only fills part of a vector.
+
+    Only scores are computed (no traceback), so callers needing alignments or flank
+    adjustments must use PairHMM.
+ */
+template <typename InstructionSet, unsigned BandSize>
+class InterPairHMM : private InstructionSet
+{
+public:
+    using ScoreType = typename InstructionSet::ScoreType;
+
+private:
+    using VectorType = typename InstructionSet::VectorType;
+    using BandVector = std::array<VectorType, BandSize>;
+
+    using InstructionSet::vectorise;
+    using InstructionSet::_add;
+    using InstructionSet::_and;
+    using InstructionSet::_andnot;
+    using InstructionSet::_or;
+    using InstructionSet::_cmpeq;
+    using InstructionSet::_min;
+
+    constexpr static int num_lanes_ {InstructionSet::band_size};
+    constexpr static int band_size_ {BandSize};
+    constexpr static ScoreType infinity_tolerance_ {0x7FF};
+    constexpr static ScoreType infinity_ {std::numeric_limits<ScoreType>::max() - infinity_tolerance_};
+    constexpr static int trace_bits_ {2};
+    constexpr static ScoreType n_score_ {2 << trace_bits_};
+    constexpr static ScoreType max_quality_score_ {64};
+    constexpr static ScoreType null_score_ {std::numeric_limits<ScoreType>::min()};
+
+    // Lane-interleaved inputs: element [i * num_lanes_ + lane] is input i of that lane.
+    // The target streams are offset by band_size_ padding rows so that, like the truth
+    // streams, every band window is a contiguous run of rows and needs no shifting.
+    template <typename T>
+    using ScratchVector = AlignedBuffer<T, InstructionSet>;
+    
+    struct LaneBuffers
+    {
+        ScratchVector<ScoreType> target, qualities;
+        ScratchVector<ScoreType> truth, truth_nqual, snv_mask, snv_prior, gap_open, gap_extend;
+        int target_lens[num_lanes_];
+    };
+
+    // Rows are filled across lanes so that the writes are contiguous. Lanes are ordered
+    // by decreasing target length, so rows below the last lane's lengths need no padding.
+    static void
+    fill_lanes(const AlignmentTask* const (&lane_tasks)[num_lanes_], const int num_steps, LaneBuffers& buffers) noexcept
+    {
+        constexpr static ScoreType padded_quality_ = max_quality_score_ << trace_bits_;
+        constexpr static ScoreType padded_snv_prior_ = static_cast<ScoreType>(static_cast<unsigned>(infinity_) << trace_bits_);
+        for (int lane {0}; lane < num_lanes_; ++lane) {
+            buffers.target_lens[lane] = lane_tasks[lane]->target_len;
+        }
+        const auto min_target_len = lane_tasks[num_lanes_ - 1]->target_len;
+        const auto min_truth_len = min_target_len + 2 * band_size_ - 1;
+        const auto num_rows = num_steps + band_size_;
+        for (int row {0}; row < num_rows; ++row) {
+            const auto t = row - band_size_;
+            const auto offset = row * num_lanes_;
+            if (t < 0) {
+                for (int lane {0}; lane < num_lanes_; ++lane) {
+                    buffers.target[offset + lane]    = infinity_;
+                    buffers.qualities[offset + lane] = padded_quality_;
+                }
+            } else if (t < min_target_len) {
+                for (int lane {0}; lane < num_lanes_; ++lane) {
+                    buffers.target[offset + lane]    = lane_tasks[lane]->target[t];
+                    buffers.qualities[offset + lane] = lane_tasks[lane]->qualities[t] << trace_bits_;
+                }
+            } else {
+                for (int lane {0}; lane < num_lanes_; ++lane) {
+                    const AlignmentTask& task {*lane_tasks[lane]};
+                    const bool in_range {t < task.target_len};
+                    buffers.target[offset + lane]    = in_range ? task.target[t] : '0';
+                    buffers.qualities[offset + lane] = in_range ? task.qualities[t] << trace_bits_ : padded_quality_;
+                }
+            }
+            if (row < min_truth_len) {
+                for (int lane {0}; lane < num_lanes_; ++lane) {
+                    const AlignmentTask& task {*lane_tasks[lane]};
+                    buffers.truth[offset + lane]       = task.truth[row];
+                    buffers.truth_nqual[offset + lane] = task.truth[row] == 'N' ? n_score_ : infinity_;
+                    buffers.snv_mask[offset + lane]    = task.snv_mask[row];
+                    buffers.snv_prior[offset + lane]   = task.snv_prior[row] << trace_bits_;
+                    buffers.gap_open[offset + lane]    = task.gap_open[row] << trace_bits_;
+                    buffers.gap_extend[offset + lane]  = task.gap_extend[row] << trace_bits_;
+                }
+            } else {
+                for (int lane {0}; lane < num_lanes_; ++lane) {
+                    const AlignmentTask& task {*lane_tasks[lane]};
+                    const auto truth_len = task.target_len + 2 * band_size_ - 1;
+                    if (row < truth_len) {
+                        buffers.truth[offset + lane]       = task.truth[row];
+                        buffers.truth_nqual[offset + lane] = task.truth[row] == 'N' ? n_score_ : infinity_;
+                        buffers.snv_mask[offset + lane]    = task.snv_mask[row];
+                        buffers.snv_prior[offset + lane]   = task.snv_prior[row] << trace_bits_;
+                        buffers.gap_open[offset + lane]    = task.gap_open[row] << trace_bits_;
+                        buffers.gap_extend[offset + lane]  = task.gap_extend[row] << trace_bits_;
+                    } else {
+                        // Past the end of truth is padded with N, keeping the final gap penalties
+                        buffers.truth[offset + lane]       = 'N';
+                        buffers.truth_nqual[offset + lane] = n_score_;
+                        buffers.snv_mask[offset + lane]    = 'N';
+                        buffers.snv_prior[offset + lane]   = padded_snv_prior_;
+                        buffers.gap_open[offset + lane]    = task.gap_open[truth_len - 1] << trace_bits_;
+                        buffers.gap_extend[offset + lane]  = task.gap_extend[truth_len - 1] << trace_bits_;
+                    }
+                }
+            }
+        }
+    }
+
+    static VectorType load_row(const ScratchVector<ScoreType>& values, const int row) noexcept
+    {
+        VectorType result {};
+        std::memcpy(result.data(), values.data() + row * num_lanes_, sizeof(VectorType)); // unaligned load
+        return result;
+    }
+
+    static ScoreType get_lane(const VectorType& vec, const int lane) noexcept
+    {
+        ScoreType result;
+        std::memcpy(&result, reinterpret_cast<const char*>(vec.data()) + lane * sizeof(ScoreType), sizeof(ScoreType));
+        return result;
+    }
+
+    static void
+    update_min_scores(const BandVector& match, const int t, const int min_target_len,
+                      const LaneBuffers& buffers, ScoreType (&min_scores)[num_lanes_]) noexcept
+    {
+        if (t < min_target_len) return;
+        for (int lane {0}; lane < num_lanes_; ++lane) {
+            const auto band_idx = t - buffers.target_lens[lane];
+            if (band_idx >= 0 && band_idx < band_size_) {
+                const auto score = get_lane(match[band_idx], lane);
+                if (score < min_scores[lane]) min_scores[lane] = score;
+            }
+        }
+    }
+
+    // Band position k pairs target row target_row - k with truth row truth_row + k
+    void
+    update_match_state(BandVector& match, const LaneBuffers& buffers,
+                       const int target_row, const int truth_row) const noexcept
+    {
+        for (int k {0}; k < band_size_; ++k) {
+            const auto target    = load_row(buffers.target, target_row - k);
+            const auto qualities = load_row(buffers.qualities, target_row - k);
+            const auto snvmask   = _cmpeq(target, load_row(buffers.snv_mask, truth_row + k));
+            const auto mismatch_penalty = _min(qualities, _or(_and(snvmask, load_row(buffers.snv_prior, truth_row + k)), _andnot(snvmask, qualities)));
+            match[k] = _add(match[k], _min(_andnot(_cmpeq(target, load_row(buffers.truth, truth_row + k)), mismatch_penalty),
+                                           load_row(buffers.truth_nqual, truth_row + k)));
+        }
+    }
+
+    void
+    align_lanes(const LaneBuffers& buffers,
+                const int num_steps,
+                const int min_target_len,
+                const short nuc_prior,
+                ScoreType (&min_scores)[num_lanes_]) const noexcept
+    {
+        const auto _inf = vectorise(infinity_);
+        const auto _null = vectorise(null_score_);
+        const auto _nuc_prior = vectorise(static_cast<ScoreType>(static_cast<std::int8_t>(nuc_prior) << trace_bits_));
+        BandVector m1 {}, i1 {}, d1 {}, m2 {}, i2 {}, d2 {};
+        for (int k {0}; k < band_size_; ++k) {
+            m1[k] = i1[k] = d1[k] = m2[k] = i2[k] = d2[k] = _inf;
+        }
+        for (int lane {0}; lane < num_lanes_; ++lane) {
+            min_scores[lane] = infinity_;
+        }
+        for (int t {0}; t < num_steps; ++t) {
+            // Even diagonal. The truth window starts at row t
+            if (t < band_size_) {
+                m1[t] = _null;
+                m2[t] = _null;
+            }
+            for (int k {0}; k < band_size_; ++k) {
+                m1[k] = _min(m1[k], _min(i1[k], d1[k]));
+            }
+            update_min_scores(m1, t, min_target_len, buffers, min_scores);
+            update_match_state(m1, buffers, t + band_size_, t);
+            for (int k {band_size_ - 1}; k > 0; --k) {
+                d1[k] = _min(_add(d2[k - 1], load_row(buffers.gap_extend, t + k)),
+                             _add(_min(m2[k - 1], i2[k - 1]), load_row(buffers.gap_open, t + k))); // allow I->D
+            }
+            d1[0] = _inf;
+            for (int k {0}; k < band_size_; ++k) {
+                i1[k] = _add(_min(_add(i2[k], load_row(buffers.gap_extend, t + k)),
+                                  _add(m2[k], load_row(buffers.gap_open, t + k))), _nuc_prior);
+            }
+            // Odd diagonal. The truth window has moved on to row t + 1
+            for (int k {0}; k < band_size_; ++k) {
+                m2[k] = _min(m2[k], _min(i2[k], d2[k]));
+            }
+            update_min_scores(m2, t, min_target_len, buffers, min_scores);
+            update_match_state(m2, buffers, t + band_size_, t + 1);
+            for (int k {0}; k < band_size_; ++k) {
+                d2[k] = _min(_add(d1[k], load_row(buffers.gap_extend, t + 1 + k)),
+                             _add(_min(m1[k], i1[k]), load_row(buffers.gap_open, t + 1 + k))); // allow I->D
+            }
+            for (int k {0}; k < band_size_ - 1; ++k) {
+                i2[k] = _add(_min(_add(i1[k + 1], load_row(buffers.gap_extend, t + 1 + k)),
+                                  _add(m1[k + 1], load_row(buffers.gap_open, t + 1 + k))), _nuc_prior);
+            }
+            i2[band_size_ - 1] = _inf;
+        }
+    }
+
+public:
+    constexpr static int band_size() noexcept { return band_size_; }
+    constexpr static int num_lanes() noexcept { return num_lanes_; }
+
+    // Writes the score of each task to result, which must have space for num_tasks scores.
+    // Tasks are grouped by target length so lanes in the same group finish together.
+    void
+    align(const AlignmentTask* tasks,
+          const std::size_t num_tasks,
+          const short nuc_prior,
+          int* result) const
+    {
+        thread_local std::vector<std::size_t> order {};
+        order_by_target_length(tasks, num_tasks, order);
+        align(tasks, order.data(), num_tasks, nuc_prior, result);
+    }
+    // As above, with order from order_by_target_length. The kernels take this overload, as sorting
+    // would instantiate standard library code that is not specific to the instruction set.
+    void
+    align(const AlignmentTask* tasks,
+          const std::size_t* order,
+          const std::size_t num_tasks,
+          const short nuc_prior,
+          int* result) const
+    {
+        thread_local LaneBuffers buffers {};
+        ScoreType min_scores[num_lanes_];
+        for (std::size_t first {0}; first < num_tasks; first += num_lanes_) {
+            const auto last = first + num_lanes_ < num_tasks ? first + num_lanes_ : num_tasks;
+            const auto max_target_len = tasks[order[first]].target_len;
+            const auto min_target_len = tasks[order[last - 1]].target_len;
+            assert(min_target_len > 0);
+            const auto num_steps = max_target_len + band_size_;
+            const auto num_positions = static_cast<std::size_t>(num_steps + band_size_) * num_lanes_;
+            buffers.target.resize(num_positions);
+            buffers.qualities.resize(num_positions);
+            buffers.truth.resize(num_positions);
+            buffers.truth_nqual.resize(num_positions);
+            buffers.snv_mask.resize(num_positions);
+            buffers.snv_prior.resize(num_positions);
+            buffers.gap_open.resize(num_positions);
+            buffers.gap_extend.resize(num_positions);
+            const AlignmentTask* lane_tasks[num_lanes_];
+            for (int lane {0}; lane < num_lanes_; ++lane) {
+                // Spare lanes in the last group just repeat the final task
+                const auto task_idx = first + lane < last ? first + lane : last - 1;
+                lane_tasks[lane] = tasks + order[task_idx];
+            }
+            fill_lanes(lane_tasks, num_steps, buffers);
+            align_lanes(buffers, num_steps, min_target_len, nuc_prior, min_scores);
+            for (auto task_idx = first; task_idx < last; ++task_idx) {
+                result[order[task_idx]] = (min_scores[task_idx - first] - null_score_) >> trace_bits_;
+            }
+        }
+    }
+};
+
+// Needs a definition if odr-used
+template <typename InstructionSet, unsigned BandSize>
+constexpr typename InterPairHMM<InstructionSet, BandSize>::ScoreType InterPairHMM<InstructionSet, BandSize>::infinity_;
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
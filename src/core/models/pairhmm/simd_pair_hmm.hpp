@@ -9,15 +9,12 @@
 #endif
 
 #include <cstddef>
-#include <algorithm>
-#include <iterator>
 #include <cassert>
 #include <limits>
-#include <vector>
 #include <emmintrin.h>
 #include <immintrin.h>
 
-#include <boost/align/aligned_allocator.hpp>
+#include "simd_aligned_storage.hpp"
 
 namespace octopus { namespace hmm { namespace simd {
 
@@ -31,7 +28,7 @@ public:
 private:
     using VectorType  = typename InstructionSet::VectorType;
     using Initializer = InitializerType<InstructionSet>;
-    using SmallVector = std::vector<VectorType, boost::alignment::aligned_allocator<VectorType>>;
+    using SmallVector = AlignedBuffer<VectorType, InstructionSet>;
     
     struct NullType {};
     
@@ -334,10 +331,12 @@ private:
                          const char* snv_mask,
                          const std::int8_t* caps) const noexcept
     {
-        return (snv_mask[x] == target[y]) ? std::min(quals[y], caps[x]) : quals[y];
+        // Not std::min, which is not instantiated per instruction set
+        return (snv_mask[x] == target[y] && caps[x] < quals[y]) ? caps[x] : quals[y];
     }
+    template <typename CharArrayOrNull>
     auto
-    get_mismatch_quality(const char* target,
+    get_mismatch_quality(CharArrayOrNull target,
                          const std::int8_t* quals,
                          int x, int y,
                          NullType,
@@ -436,6 +435,13 @@ public:
     
     constexpr static const char* name() noexcept { return name_; }
     constexpr static int band_size() noexcept { return band_size_; }
+    // Scores at or above this may have saturated and should be recomputed at a wider precision
+    constexpr static int max_score() noexcept
+    {
+        constexpr long long max_unsaturated_score {(static_cast<long long>(infinity_) - null_score_) >> trace_bits_};
+        constexpr long long max_int {std::numeric_limits<int>::max()};
+        return max_unsaturated_score < max_int ? max_unsaturated_score : max_int;
+    }
     
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -4,9 +4,8 @@
 #ifndef simd_pair_hmm_factory_hpp
 #define simd_pair_hmm_factory_hpp
 
-#include <type_traits>
-
 #include "simd_pair_hmm.hpp"
+#include "simd_inter_pair_hmm.hpp"
 #include "sse2_pair_hmm_impl.hpp"
 #include "avx2_pair_hmm_impl.hpp"
 #include "avx512_pair_hmm_impl.hpp"
@@ -14,6 +13,10 @@
 
 namespace octopus { namespace hmm { namespace simd {
 
+// Pair HMMs for a fixed instruction set. These only use the instruction sets enabled for the
+// including translation unit, so are for kernel units and tests. Other code should use
+// PairHMMWrapper, which picks the kernel for the host CPU at runtime.
+
 template <unsigned BandSize,
           typename ScoreType = short,
           template <class> class InitializerType = InsertRollingInitializer>
@@ -39,69 +42,9 @@ using AVX2PairHMM = PairHMM<AVX2PairHMMInstructionSet<BandSize, ScoreType>, Init
 
 #endif // defined(AVX2_PHMM)
 
-namespace detail {
-
-#if defined(AVX512_PHMM)
-    
-template <unsigned BandSize, typename ScoreType>
-constexpr bool is_viable_avx2 = BandSize % (32 / sizeof(ScoreType)) == 0;
-
-template <unsigned BandSize, typename ScoreType>
-constexpr bool is_viable_avx512 = BandSize % (64 / sizeof(ScoreType)) == 0;
-
-template <unsigned BandSize,
-          typename ScoreType,
-          template <class> class InitializerType>
-struct PairHMMSelector :
-    public std::conditional<
-        is_viable_avx512<BandSize, ScoreType>,
-        AVX512PairHMM<BandSize, ScoreType, InitializerType>,
-        std::conditional_t<
-            is_viable_avx2<BandSize, ScoreType>,
-            AVX2PairHMM<BandSize, ScoreType, InitializerType>,
-            SSE2PairHMM<BandSize, ScoreType, InitializerType>>
-    > {};
-
-#elif defined(AVX2_PHMM)
-
-template <unsigned BandSize, typename ScoreType>
-constexpr bool is_viable_avx2 = BandSize % (32 / sizeof(ScoreType)) == 0;
-
-template <unsigned BandSize,
-          typename ScoreType,
-          template <class> class InitializerType>
-struct PairHMMSelector :
-    public std::conditional<
-        is_viable_avx2<BandSize, ScoreType>,
-        AVX2PairHMM<BandSize, ScoreType, InitializerType>,
-        SSE2PairHMM<BandSize, ScoreType, InitializerType>
-    > {};
-
-#else // defined(AVX2_PHMM)
-
-template <unsigned MinBandSize,
-typename ScoreType,
-template <class> class InitializerType>
-struct PairHMMSelector
-{
-    using type = SSE2PairHMM<MinBandSize, ScoreType, InitializerType>;
-};
-
-#endif // defined(AVX2_PHMM)
-
-} // namespace detail
-
-template <unsigned BandSize,
-          typename ScoreType = short,
-          template <class> class InitializerType = InsertRollingInitializer>
-using SimdPairHMM = typename detail::PairHMMSelector<BandSize, ScoreType, InitializerType>::type;
-
 template <unsigned BandSize,
-          typename ScoreType = short,
-          template <class> class InitializerType = InsertRollingInitializer>
-constexpr auto make_simd_pair_hmm() { return SimdPairHMM<BandSize, ScoreType, InitializerType> {}; }
-
-constexpr auto make_fastest_simd_pair_hmm() { return make_simd_pair_hmm<8, short, InsertRollingInitializer>(); }
+          typename ScoreType = short>
+using SSE2InterPairHMM = InterPairHMM<SSE2PairHMMInstructionSet<16 / sizeof(ScoreType), ScoreType>, BandSize>;
 
 } // namespace simd
 } // namespace hmm
@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "simd_pair_hmm_kernel.hpp"
+
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+#endif
+
+namespace octopus { namespace hmm { namespace simd {
+
+namespace {
+
+struct CPUFeatures
+{
+    bool sse4_1 = false, avx2 = false, avx512 = false;
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+std::uint64_t read_xcr0() noexcept
+{
+    std::uint32_t eax, edx;
+    __asm__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return (static_cast<std::uint64_t>(edx) << 32) | eax;
+}
+
+// The OS must also save the wider registers on context switches, which XCR0 reports
+CPUFeatures detect_cpu_features() noexcept
+{
+    CPUFeatures result {};
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return result;
+    result.sse4_1 = (ecx & (1u << 19)) != 0;
+    const bool has_osxsave {(ecx & (1u << 27)) != 0}, has_avx {(ecx & (1u << 28)) != 0};
+    if (!has_osxsave || !has_avx) return result;
+    const auto xcr0 = read_xcr0();
+    const bool os_saves_ymm {(xcr0 & 0x6) == 0x6}, os_saves_zmm {(xcr0 & 0xe6) == 0xe6};
+    if (!os_saves_ymm || __get_cpuid_max(0, nullptr) < 7) return result;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    const bool has_avx2 {(ebx & (1u << 5)) != 0};
+    const bool has_avx512f {(ebx & (1u << 16)) != 0}, has_avx512bw {(ebx & (1u << 30)) != 0};
+    result.avx2 = has_avx2;
+    result.avx512 = has_avx2 && has_avx512f && has_avx512bw && os_saves_zmm;
+    return result;
+}
+
+#else
+
+CPUFeatures detect_cpu_features() noexcept
+{
+    return {};
+}
+
+#endif
+
+PairHMMInstructionSet select_instruction_set() noexcept
+{
+    const auto features = detect_cpu_features();
+    if (features.avx512 && detail::find_avx512_pair_hmm_kernel(1, ScorePrecision::int16)) {
+        return PairHMMInstructionSet::avx512;
+    } else if (features.avx2 && detail::find_avx2_pair_hmm_kernel(1, ScorePrecision::int16)) {
+        return PairHMMInstructionSet::avx2;
+    } else {
+        return PairHMMInstructionSet::sse4_1;
+    }
+}
+
+} // namespace
+
+PairHMMKernel::~PairHMMKernel() = default;
+
+void PairHMMKernel::align(const std::vector<AlignmentTask>& tasks, const short nuc_prior, std::vector<int>& result) const
+{
+    thread_local std::vector<std::size_t> order {};
+    order_by_target_length(tasks.data(), tasks.size(), order);
+    result.resize(tasks.size());
+    do_align(tasks.data(), order.data(), tasks.size(), nuc_prior, result.data());
+}
+
+bool is_pair_hmm_supported() noexcept
+{
+    static const auto result = detect_cpu_features().sse4_1;
+    return result;
+}
+
+PairHMMInstructionSet pair_hmm_instruction_set() noexcept
+{
+    static const auto result = select_instruction_set();
+    return result;
+}
+
+const PairHMMKernel* find_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    switch (pair_hmm_instruction_set()) {
+        case PairHMMInstructionSet::avx512: return detail::find_avx512_pair_hmm_kernel(min_band_size, precision);
+        case PairHMMInstructionSet::avx2: return detail::find_avx2_pair_hmm_kernel(min_band_size, precision);
+        default: return detail::find_sse4_1_pair_hmm_kernel(min_band_size, precision);
+    }
+}
+
+int max_pair_hmm_band_size(const ScorePrecision precision) noexcept
+{
+    // All instruction sets provide the same band sizes
+    int result {0};
+    for (auto kernel = find_pair_hmm_kernel(1, precision); kernel; kernel = find_pair_hmm_kernel(result + 1, precision)) {
+        result = kernel->band_size();
+    }
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const PairHMMInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+        case PairHMMInstructionSet::sse4_1: os << "SSE4.1"; break;
+        case PairHMMInstructionSet::avx2: os << "AVX2"; break;
+        case PairHMMInstructionSet::avx512: os << "AVX512"; break;
+    }
+    return os;
+}
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
@@ -0,0 +1,154 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_pair_hmm_kernel_hpp
+#define simd_pair_hmm_kernel_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "simd_inter_pair_hmm.hpp"
+
+namespace octopus { namespace hmm { namespace simd {
+
+enum class ScorePrecision { int16, int32 };
+
+enum class PairHMMInstructionSet { sse4_1, avx2, avx512 };
+
+/*
+    PairHMMKernel is a banded pair HMM of fixed band size and score precision, compiled for a
+    single instruction set. Each instruction set is built in its own translation unit with its own
+    target flags, so one binary can carry all of them and choose between them at runtime.
+    Kernels are stateless singletons and may be shared freely between threads.
+    The destructor and batch align are defined out of line so that the kernel units, which are
+    compiled with wider target flags, never emit a copy of them for the linker to choose.
+*/
+class PairHMMKernel
+{
+public:
+    virtual ~PairHMMKernel();
+
+    const char* name() const noexcept { return do_name(); }
+    int band_size() const noexcept { return do_band_size(); }
+    // Scores at or above this may have saturated
+    int max_score() const noexcept { return do_max_score(); }
+
+    int align(const char* truth, const char* target, const std::int8_t* qualities,
+              int truth_len, int target_len,
+              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+              short nuc_prior) const noexcept
+    {
+        return do_align(truth, target, qualities, truth_len, target_len, nullptr, nullptr, gap_open, gap_extend, nuc_prior);
+    }
+    int align(const char* truth, const char* target, const std::int8_t* qualities,
+              int truth_len, int target_len,
+              const char* snv_mask, const std::int8_t* snv_prior,
+              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+              short nuc_prior) const noexcept
+    {
+        return do_align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
+    }
+    int align(const char* truth, const char* target, const std::int8_t* qualities,
+              int truth_len, int target_len,
+              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+              short nuc_prior,
+              int& first_pos, char* align1, char* align2) const noexcept
+    {
+        return do_align(truth, target, qualities, truth_len, target_len, nullptr, nullptr, gap_open, gap_extend, nuc_prior,
+                        first_pos, align1, align2);
+    }
+    int align(const char* truth, const char* target, const std::int8_t* qualities,
+              int truth_len, int target_len,
+              const char* snv_mask, const std::int8_t* snv_prior,
+              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+              short nuc_prior,
+              int& first_pos, char* align1, char* align2) const noexcept
+    {
+        return do_align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior,
+                        first_pos, align1, align2);
+    }
+
+    int calculate_flank_score(int truth_len, int lhs_flank_len, int rhs_flank_len,
+                              const std::int8_t* quals,
+                              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                              short nuc_prior, int first_pos,
+                              const char* aln1, const char* aln2,
+                              int& target_mask_size) const noexcept
+    {
+        return do_calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, nullptr, quals, nullptr, nullptr,
+                                        gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2, target_mask_size);
+    }
+    int calculate_flank_score(int truth_len, int lhs_flank_len, int rhs_flank_len,
+                              const char* target, const std::int8_t* quals,
+                              const char* snv_mask, const std::int8_t* snv_prior,
+                              const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                              short nuc_prior, int first_pos,
+                              const char* aln1, const char* aln2,
+                              int& target_mask_size) const noexcept
+    {
+        return do_calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, target, quals, snv_mask, snv_prior,
+                                        gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2, target_mask_size);
+    }
+
+    // Scores all tasks, whose truth windows must be sized for band_size()
+    void align(const std::vector<AlignmentTask>& tasks, short nuc_prior, std::vector<int>& result) const;
+
+private:
+    // A null snv_mask means the SNV error model is not used
+    virtual const char* do_name() const noexcept = 0;
+    virtual int do_band_size() const noexcept = 0;
+    virtual int do_max_score() const noexcept = 0;
+    virtual int do_align(const char* truth, const char* target, const std::int8_t* qualities,
+                         int truth_len, int target_len,
+                         const char* snv_mask, const std::int8_t* snv_prior,
+                         const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                         short nuc_prior) const noexcept = 0;
+    virtual int do_align(const char* truth, const char* target, const std::int8_t* qualities,
+                         int truth_len, int target_len,
+                         const char* snv_mask, const std::int8_t* snv_prior,
+                         const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                         short nuc_prior,
+                         int& first_pos, char* align1, char* align2) const noexcept = 0;
+    virtual int do_calculate_flank_score(int truth_len, int lhs_flank_len, int rhs_flank_len,
+                                         const char* target, const std::int8_t* quals,
+                                         const char* snv_mask, const std::int8_t* snv_prior,
+                                         const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                                         short nuc_prior, int first_pos,
+                                         const char* aln1, const char* aln2,
+                                         int& target_mask_size) const noexcept = 0;
+    // order is from order_by_target_length
+    virtual void do_align(const AlignmentTask* tasks, const std::size_t* order, std::size_t num_tasks,
+                          short nuc_prior, int* result) const = 0;
+};
+
+// The widest instruction set supported by both this build and the host CPU
+PairHMMInstructionSet pair_hmm_instruction_set() noexcept;
+
+// False if the CPU lacks SSE4.1, which even the baseline kernels need
+bool is_pair_hmm_supported() noexcept;
+
+// Returns the kernel for pair_hmm_instruction_set() with the smallest band size not less than
+// min_band_size, or nullptr if min_band_size exceeds max_pair_hmm_band_size()
+const PairHMMKernel* find_pair_hmm_kernel(int min_band_size, ScorePrecision precision) noexcept;
+
+int max_pair_hmm_band_size(ScorePrecision precision) noexcept;
+
+std::ostream& operator<<(std::ostream& os, PairHMMInstructionSet instruction_set);
+
+namespace detail {
+
+// Each is defined in the translation unit for its instruction set, and returns nullptr
+// if the compiler could not target that instruction set
+const PairHMMKernel* find_sse4_1_pair_hmm_kernel(int min_band_size, ScorePrecision precision) noexcept;
+const PairHMMKernel* find_avx2_pair_hmm_kernel(int min_band_size, ScorePrecision precision) noexcept;
+const PairHMMKernel* find_avx512_pair_hmm_kernel(int min_band_size, ScorePrecision precision) noexcept;
+
+} // namespace detail
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
@@ -0,0 +1,174 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_pair_hmm_kernel_impl_hpp
+#define simd_pair_hmm_kernel_impl_hpp
+
+#include <cstddef>
+#include <utility>
+#include <tuple>
+#include <memory>
+#include <type_traits>
+
+#include "simd_pair_hmm_kernel.hpp"
+#include "simd_pair_hmm.hpp"
+#include "simd_inter_pair_hmm.hpp"
+#include "rolling_initializer.hpp"
+
+/*
+    Only for inclusion by the per-instruction set kernel translation units. Each unit supplies an
+    InstructionSets type in an anonymous namespace, with member templates Intra<BandSize, ScoreType>
+    and Inter<ScoreType>, and uses that type as the Tag of its instruction sets. Every function the
+    unit emits then depends on the tag and has internal linkage, so the linker can never pick a
+    copy compiled with one unit's target flags for the others. Keeping it that way means code
+    here and in the HMMs must not instantiate templates over untagged types, or call inline
+    members of PairHMMKernel; the standard library is only used with tagged types.
+*/
+
+namespace octopus { namespace hmm { namespace simd { namespace detail {
+
+constexpr std::size_t num_kernel_band_sizes {6};
+
+namespace {
+
+constexpr unsigned kernel_band_size(const std::size_t idx) noexcept
+{
+    return 8u << idx;
+}
+
+} // namespace
+
+template <unsigned BandSize, typename ScoreType, unsigned VectorBytes>
+constexpr bool is_viable_band_size = BandSize % (VectorBytes / sizeof(ScoreType)) == 0;
+
+template <typename InstructionSets,
+          unsigned BandSize,
+          typename ScoreType>
+class PairHMMKernelImpl : public PairHMMKernel
+{
+public:
+    PairHMMKernelImpl() = default;
+
+    PairHMMKernelImpl(const PairHMMKernelImpl&)            = default;
+    PairHMMKernelImpl& operator=(const PairHMMKernelImpl&) = default;
+    PairHMMKernelImpl(PairHMMKernelImpl&&)                 = default;
+    PairHMMKernelImpl& operator=(PairHMMKernelImpl&&)      = default;
+
+    virtual ~PairHMMKernelImpl() override = default;
+
+private:
+    using HMM = PairHMM<typename InstructionSets::template Intra<BandSize, ScoreType>, InsertRollingInitializer>;
+
+    // Larger bands already fill the vectors of the intra-sequence kernel
+    constexpr static unsigned max_inter_band_size_ {32};
+
+    HMM hmm_;
+
+    const char* do_name() const noexcept override { return hmm_.name(); }
+    int do_band_size() const noexcept override { return hmm_.band_size(); }
+    int do_max_score() const noexcept override { return hmm_.max_score(); }
+
+    int do_align(const char* truth, const char* target, const std::int8_t* qualities,
+                 const int truth_len, const int target_len,
+                 const char* snv_mask, const std::int8_t* snv_prior,
+                 const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                 const short nuc_prior) const noexcept override
+    {
+        if (snv_mask) {
+            return hmm_.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
+        } else {
+            return hmm_.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior);
+        }
+    }
+    int do_align(const char* truth, const char* target, const std::int8_t* qualities,
+                 const int truth_len, const int target_len,
+                 const char* snv_mask, const std::int8_t* snv_prior,
+                 const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                 const short nuc_prior,
+                 int& first_pos, char* align1, char* align2) const noexcept override
+    {
+        if (snv_mask) {
+            return hmm_.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior,
+                              first_pos, align1, align2);
+        } else {
+            return hmm_.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior,
+                              first_pos, align1, align2);
+        }
+    }
+    int do_calculate_flank_score(const int truth_len, const int lhs_flank_len, const int rhs_flank_len,
+                                 const char* target, const std::int8_t* quals,
+                                 const char* snv_mask, const std::int8_t* snv_prior,
+                                 const std::int8_t* gap_open, const std::int8_t* gap_extend,
+                                 const short nuc_prior, const int first_pos,
+                                 const char* aln1, const char* aln2,
+                                 int& target_mask_size) const noexcept override
+    {
+        if (snv_mask) {
+            return hmm_.calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, target, quals, snv_mask, snv_prior,
+                                              gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2, target_mask_size);
+        } else {
+            return hmm_.calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, quals, gap_open, gap_extend,
+                                              nuc_prior, first_pos, aln1, aln2, target_mask_size);
+        }
+    }
+    void do_align(const AlignmentTask* tasks, const std::size_t* order, const std::size_t num_tasks,
+                  const short nuc_prior, int* result) const override
+    {
+        align_tasks(tasks, order, num_tasks, nuc_prior, result, std::integral_constant<bool, (BandSize <= max_inter_band_size_)> {});
+    }
+
+    void align_tasks(const AlignmentTask* tasks, const std::size_t* order, const std::size_t num_tasks,
+                     const short nuc_prior, int* result, std::true_type) const
+    {
+        using InterHMM = InterPairHMM<typename InstructionSets::template Inter<ScoreType>, BandSize>;
+        InterHMM {}.align(tasks, order, num_tasks, nuc_prior, result);
+    }
+    void align_tasks(const AlignmentTask* tasks, const std::size_t*, const std::size_t num_tasks,
+                     const short nuc_prior, int* result, std::false_type) const noexcept
+    {
+        for (std::size_t idx {0}; idx < num_tasks; ++idx) {
+            const AlignmentTask& task {tasks[idx]};
+            result[idx] = hmm_.align(task.truth, task.target, task.qualities, task.target_len + 2 * hmm_.band_size() - 1, task.target_len,
+                                     task.snv_mask, task.snv_prior, task.gap_open, task.gap_extend, nuc_prior);
+        }
+    }
+};
+
+template <typename InstructionSets,
+          typename ScoreType,
+          std::size_t... Is>
+const PairHMMKernel* const* get_pair_hmm_kernels(std::index_sequence<Is...>) noexcept
+{
+    using Kernels = std::tuple<PairHMMKernelImpl<InstructionSets, kernel_band_size(Is), ScoreType>...>;
+    static const Kernels kernels {};
+    static const PairHMMKernel* const result[] {std::addressof(std::get<Is>(kernels))...};
+    return result;
+}
+
+template <typename InstructionSets,
+          typename ScoreType>
+const PairHMMKernel* find_kernel(const int min_band_size) noexcept
+{
+    const auto kernels = get_pair_hmm_kernels<InstructionSets, ScoreType>(std::make_index_sequence<num_kernel_band_sizes>());
+    for (std::size_t idx {0}; idx < num_kernel_band_sizes; ++idx) {
+        if (static_cast<int>(kernel_band_size(idx)) >= min_band_size) return kernels[idx];
+    }
+    return nullptr;
+}
+
+template <typename InstructionSets>
+const PairHMMKernel* find_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    if (precision == ScorePrecision::int16) {
+        return find_kernel<InstructionSets, short>(min_band_size);
+    } else {
+        return find_kernel<InstructionSets, int>(min_band_size);
+    }
+}
+
+} // namespace detail
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
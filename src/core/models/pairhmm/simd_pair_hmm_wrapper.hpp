@@ -4,43 +4,41 @@
 #ifndef simd_pair_hmm_wrapper_hpp
 #define simd_pair_hmm_wrapper_hpp
 
-#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
 
-#include <boost/variant.hpp>
-
-#include "exceptions/user_error.hpp"
-#include "simd_pair_hmm_factory.hpp"
+#include "simd_pair_hmm_kernel.hpp"
+#include "logging/profiler.hpp"
 
 namespace octopus { namespace hmm { namespace simd {
 
 namespace detail {
 
-constexpr unsigned ipow(unsigned base, unsigned exponent) noexcept
+inline const std::int8_t* penalty_data(const std::int8_t* penalties, int, std::vector<std::int8_t>&) noexcept
 {
-    return exponent == 0 ? 1 : base * ipow(base, exponent - 1);
+    return penalties;
 }
 
-template <typename T, std::size_t... I>
-constexpr auto make_phmm_tuple(std::index_sequence<I...>) { return std::make_tuple(SimdPairHMM<ipow(2, I + 3), T>{}...); }
-
-template <typename Tuple>
-struct to_variant;
-
-template <typename... Ts>
-struct to_variant<std::tuple<Ts...>>
+// Kernels only take per-position penalties, so constant penalties are expanded
+template <typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+const std::int8_t* penalty_data(const T penalty, const int size, std::vector<std::int8_t>& buffer)
 {
-    using type = boost::variant<Ts...>;
-};
-
-template <typename Tuple>
-using to_variant_t = typename to_variant<Tuple>::type;
+    buffer.assign(size, penalty);
+    return buffer.data();
+}
 
 } // namespace detail
 
+// Dispatches to the kernel for the widest instruction set supported by the host CPU. With
+// ScorePrecision::int16, scores that saturate the 16-bit kernel are recomputed with the
+// 32-bit kernel, so the wider kernel is only paid for by the alignments that need it.
 class PairHMMWrapper
 {
 public:
-    enum class ScorePrecision { int16, int32 };
+    using ScorePrecision = simd::ScorePrecision;
     
     class TooLargeBandSizeError : public std::runtime_error
     {
@@ -74,17 +72,24 @@ public:
     
     int band_size() const noexcept
     {
-        return boost::apply_visitor([] (const auto& hmm) noexcept { return hmm.band_size(); }, hmm_);
+        return kernel_->band_size();
     }
     
     const char* name() const noexcept
     {
-        return boost::apply_visitor([] (const auto& hmm) noexcept { return hmm.name(); }, hmm_);
+        return kernel_->name();
     }
     
     void reset(int min_band_size, ScorePrecision score_precision = ScorePrecision::int16)
     {
-        hmm_ = make_simd_pair_hmm(min_band_size, score_precision);
+        const auto kernel = find_pair_hmm_kernel(min_band_size, score_precision);
+        if (!kernel) throw TooLargeBandSizeError {min_band_size, max_band_size(score_precision)};
+        kernel_ = kernel;
+        if (score_precision == ScorePrecision::int16) {
+            wide_kernel_ = find_pair_hmm_kernel(kernel_->band_size(), ScorePrecision::int32);
+        } else {
+            wide_kernel_ = nullptr;
+        }
     }
     
     template <typename OpenPenaltyArrayOrConstant,
@@ -99,9 +104,14 @@ public:
           const ExtendPenaltyArrayOrConstant gap_extend,
           short nuc_prior) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        const auto open = detail::penalty_data(gap_open, truth_len, open_buffer);
+        const auto extend = detail::penalty_data(gap_extend, truth_len, extend_buffer);
+        count_cells(*kernel_, target_len);
+        const auto score = kernel_->align(truth, target, qualities, truth_len, target_len, open, extend, nuc_prior);
+        if (!is_saturated(score)) return score;
+        count_cells(*wide_kernel_, target_len);
+        return wide_kernel_->align(truth, target, qualities, truth_len, target_len, open, extend, nuc_prior);
     }
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -117,9 +127,14 @@ public:
           const ExtendPenaltyArrayOrConstant gap_extend,
           short nuc_prior) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        const auto open = detail::penalty_data(gap_open, truth_len, open_buffer);
+        const auto extend = detail::penalty_data(gap_extend, truth_len, extend_buffer);
+        count_cells(*kernel_, target_len);
+        const auto score = kernel_->align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, open, extend, nuc_prior);
+        if (!is_saturated(score)) return score;
+        count_cells(*wide_kernel_, target_len);
+        return wide_kernel_->align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, open, extend, nuc_prior);
     }
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -136,9 +151,16 @@ public:
           char* align1,
           char* align2) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, gap_open, gap_extend, nuc_prior, first_pos, align1, align2);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        const auto open = detail::penalty_data(gap_open, truth_len, open_buffer);
+        const auto extend = detail::penalty_data(gap_extend, truth_len, extend_buffer);
+        count_cells(*kernel_, target_len);
+        const auto score = kernel_->align(truth, target, qualities, truth_len, target_len, open, extend, nuc_prior,
+                                          first_pos, align1, align2);
+        if (!is_saturated(score, first_pos)) return score;
+        count_cells(*wide_kernel_, target_len);
+        return wide_kernel_->align(truth, target, qualities, truth_len, target_len, open, extend, nuc_prior,
+                                   first_pos, align1, align2);
     }
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -157,9 +179,16 @@ public:
           char* align1,
           char* align2) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, first_pos, align1, align2);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        const auto open = detail::penalty_data(gap_open, truth_len, open_buffer);
+        const auto extend = detail::penalty_data(gap_extend, truth_len, extend_buffer);
+        count_cells(*kernel_, target_len);
+        const auto score = kernel_->align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, open, extend,
+                                          nuc_prior, first_pos, align1, align2);
+        if (!is_saturated(score, first_pos)) return score;
+        count_cells(*wide_kernel_, target_len);
+        return wide_kernel_->align(truth, target, qualities, truth_len, target_len, snv_mask, snv_prior, open, extend,
+                                   nuc_prior, first_pos, align1, align2);
     }
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -176,9 +205,11 @@ public:
                           const char* aln2,
                           int& target_mask_size) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, quals, gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2, target_mask_size);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        return kernel_->calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, quals,
+                                              detail::penalty_data(gap_open, truth_len, open_buffer),
+                                              detail::penalty_data(gap_extend, truth_len, extend_buffer),
+                                              nuc_prior, first_pos, aln1, aln2, target_mask_size);
     }
     template <typename OpenPenaltyArrayOrConstant,
               typename ExtendPenaltyArrayOrConstant>
@@ -198,56 +229,69 @@ public:
                           const char* aln2,
                           int& target_mask_size) const noexcept
     {
-        return boost::apply_visitor([&] (const auto& hmm) noexcept {
-            return hmm.calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, target, quals, snv_mask, snv_prior, gap_open, gap_extend, nuc_prior, first_pos, aln1, aln2, target_mask_size);
-        }, hmm_);
+        thread_local std::vector<std::int8_t> open_buffer {}, extend_buffer {};
+        return kernel_->calculate_flank_score(truth_len, lhs_flank_len, rhs_flank_len, target, quals, snv_mask, snv_prior,
+                                              detail::penalty_data(gap_open, truth_len, open_buffer),
+                                              detail::penalty_data(gap_extend, truth_len, extend_buffer),
+                                              nuc_prior, first_pos, aln1, aln2, target_mask_size);
     }
 
-private:
-    using ShortPairHMMs = decltype(detail::make_phmm_tuple<short>(std::make_index_sequence<6>()));
-    using IntPairHMMs   = decltype(detail::make_phmm_tuple<int>(std::make_index_sequence<6>()));
-    using PairHMMs      = decltype(std::tuple_cat(ShortPairHMMs {}, IntPairHMMs {}));
-    
-    using PairHmmVariant = detail::to_variant_t<PairHMMs>;
-    
-    PairHmmVariant hmm_;
-    
-    template <typename Hmms>
-    constexpr static int max_band_size() { return std::tuple_element_t<std::tuple_size<Hmms>::value - 1, Hmms>::band_size(); }
-    
-    template <typename Hmms, std::size_t... Is>
-    PairHmmVariant make_simd_pair_hmm_helper(const int min_band_size, std::index_sequence<Is...>) const
+    // Scores all tasks, whose truth windows must be sized for band_size(). Small bands use
+    // the inter-sequence kernel, which aligns one task per SIMD lane.
+    void
+    align(const std::vector<AlignmentTask>& tasks,
+          const short nuc_prior,
+          std::vector<int>& result) const
     {
-        if (min_band_size <= max_band_size<Hmms>()) {
-            PairHmmVariant result {};
-            int unused[] = {((Is == 0 || std::tuple_element_t<(Is > 0 ? Is - 1 : 0), Hmms>::band_size() < min_band_size)
-                            && min_band_size <= std::tuple_element_t<Is, Hmms>::band_size()
-                            ? (result = std::tuple_element_t<Is, Hmms> {}, 0) : 0)...};
-            (void) unused;
-            return result;
-        } else {
-            throw TooLargeBandSizeError {min_band_size, max_band_size<Hmms>()};
+        count_cells(*kernel_, tasks);
+        kernel_->align(tasks, nuc_prior, result);
+        if (!wide_kernel_) return;
+        thread_local std::vector<AlignmentTask> saturated_tasks {};
+        thread_local std::vector<std::size_t> saturated_indices {};
+        thread_local std::vector<int> wide_scores {};
+        saturated_tasks.clear();
+        saturated_indices.clear();
+        for (std::size_t task_idx {0}; task_idx < tasks.size(); ++task_idx) {
+            if (is_saturated(result[task_idx])) {
+                saturated_tasks.push_back(tasks[task_idx]);
+                saturated_indices.push_back(task_idx);
+            }
+        }
+        if (saturated_tasks.empty()) return;
+        count_cells(*wide_kernel_, saturated_tasks);
+        wide_kernel_->align(saturated_tasks, nuc_prior, wide_scores);
+        for (std::size_t task_idx {0}; task_idx < saturated_tasks.size(); ++task_idx) {
+            result[saturated_indices[task_idx]] = wide_scores[task_idx];
         }
     }
-    PairHmmVariant make_simd_pair_hmm(const int min_band_size, const ScorePrecision score_precision) const
+    
+    static int max_band_size(ScorePrecision score_precision) noexcept
     {
-        if (score_precision == ScorePrecision::int16) {
-            using Hmms = ShortPairHMMs;
-            return make_simd_pair_hmm_helper<Hmms>(min_band_size, std::make_index_sequence<std::tuple_size<Hmms>::value>());
-        } else {
-            using Hmms = IntPairHMMs;
-            return make_simd_pair_hmm_helper<Hmms>(min_band_size, std::make_index_sequence<std::tuple_size<Hmms>::value>());
-        }
+        return max_pair_hmm_band_size(score_precision);
     }
 
-public:
-    static int max_band_size(ScorePrecision score_precision) noexcept
+private:
+    const PairHMMKernel* kernel_, *wide_kernel_;
+    
+    // The kernels evaluate two anti-diagonals of band_size cells for each of target_len + band_size steps
+    static void count_cells(const PairHMMKernel& kernel, const int target_len) noexcept
     {
-        if (score_precision == ScorePrecision::int16) {
-            return max_band_size<ShortPairHMMs>();
-        } else {
-            return max_band_size<IntPairHMMs>();
-        }
+        const auto band_size = static_cast<std::size_t>(kernel.band_size());
+        profiling::count(profiling::Counter::pair_hmm_cells, 2 * (target_len + band_size) * band_size);
+    }
+    static void count_cells(const PairHMMKernel& kernel, const std::vector<AlignmentTask>& tasks) noexcept
+    {
+        if (!profiling::is_enabled()) return;
+        for (const auto& task : tasks) count_cells(kernel, task.target_len);
+    }
+    
+    bool is_saturated(const int score) const noexcept
+    {
+        return wide_kernel_ && score >= kernel_->max_score();
+    }
+    bool is_saturated(const int score, const int first_pos) const noexcept
+    {
+        return wide_kernel_ && (first_pos == -1 || score >= kernel_->max_score());
     }
 };
 
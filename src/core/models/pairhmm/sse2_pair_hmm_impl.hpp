@@ -9,21 +9,21 @@
 #endif
 
 #include <cstdint>
-#include <array>
-#include <tuple>
 #include <type_traits>
 #include <cassert>
 #include <emmintrin.h>
 
-#include "utils/array_tricks.hpp"
+#include "simd_aligned_storage.hpp"
 
 namespace octopus { namespace hmm { namespace simd {
 
 template <typename T>
 constexpr bool is_short_or_int = std::is_same<T, short>::value || std::is_same<T, int>::value;
 
+// Tag only distinguishes instantiations compiled with different target flags
 template <unsigned BandSize = 8,
-          typename ScoreTp = short>
+          typename ScoreTp = short,
+          typename Tag = void>
 class SSE2PairHMMInstructionSet
 {
     using BlockType = __m128i;
@@ -46,20 +46,36 @@ private:
     static_assert(BandSize % block_words_ == 0, "BandSize must be multiple of block words");
     
 protected:
-    using VectorType = std::array<BlockType, num_blocks_>;
+    using VectorType = BlockArray<BlockType, num_blocks_, Tag>;
     
     constexpr static int band_size = num_blocks_ * block_words_;
     
     static_assert(sizeof(VectorType) / word_size == band_size, "size error");
     
+private:
+    // As make_array in utils/array_tricks.hpp, for VectorType
+    template <std::size_t... Is>
+    static VectorType make_vector(const BlockType& first, const BlockType& rest, std::index_sequence<Is...>) noexcept
+    {
+        return {{first, (static_cast<void>(Is), rest)...}};
+    }
+    static VectorType make_vector(const BlockType& first, const BlockType& rest) noexcept
+    {
+        return make_vector(first, rest, std::make_index_sequence<num_blocks_ - 1>());
+    }
+    static VectorType make_vector(const BlockType& value) noexcept
+    {
+        return make_vector(value, value);
+    }
+    
 private:
     static VectorType do_vectorise(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm_set1_epi16(x));
+        return make_vector(_mm_set1_epi16(x));
     }
     static VectorType do_vectorise(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm_set1_epi32(x));
+        return make_vector(_mm_set1_epi32(x));
     }
 protected:
     static VectorType vectorise(ScoreType x) noexcept
@@ -100,11 +116,11 @@ protected:
 private:
     static VectorType do_vectorise_zero_set_last(ScoreType x, short) noexcept
     {
-        return make_array<num_blocks_>(_mm_set_epi16(0,0,0,0,0,0,0,x), _mm_set_epi16(0,0,0,0,0,0,0,0));
+        return make_vector(_mm_set_epi16(0,0,0,0,0,0,0,x), _mm_set_epi16(0,0,0,0,0,0,0,0));
     }
     static VectorType do_vectorise_zero_set_last(ScoreType x, int) noexcept
     {
-        return make_array<num_blocks_>(_mm_set_epi32(0,0,0,x), _mm_set_epi32(0,0,0,0));
+        return make_vector(_mm_set_epi32(0,0,0,x), _mm_set_epi32(0,0,0,0));
     }
 protected:
     static VectorType vectorise_zero_set_last(ScoreType x) noexcept
@@ -130,7 +146,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        return do_extract<word_index>(std::get<block_index>(a), ScoreType {});
+        return do_extract<word_index>(a[block_index], ScoreType {});
     }
 private:
     template <std::size_t... Is>
@@ -166,7 +182,7 @@ protected:
         static_assert(block_index < num_blocks_, "block index out range");
         constexpr static auto word_index = index % block_words_;
         static_assert(word_index < block_words_, "word index out range");
-        std::get<block_index>(a) = do_insert<word_index>(std::get<block_index>(a), value, ScoreType {});
+        a[block_index] = do_insert<word_index>(a[block_index], value, ScoreType {});
         return a;
     }
 private:
@@ -242,7 +258,7 @@ protected:
         adjacent_apply_reverse([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm_or_si128(_mm_slli_si128(rhs, word_size), _mm_srli_si128(lhs, block_bytes_ - word_size));
         }, a, a);
-        std::get<0>(a) = _mm_slli_si128(std::get<0>(a), word_size);
+        a[0] = _mm_slli_si128(a[0], word_size);
         return a;
     }
     static VectorType _right_shift_word(VectorType a) noexcept
@@ -250,7 +266,7 @@ protected:
         adjacent_apply([] (const auto& lhs, const auto& rhs) noexcept {
             return _mm_or_si128(_mm_srli_si128(lhs, word_size), _mm_slli_si128(rhs, block_bytes_ - word_size));
         }, a, a);
-        std::get<num_blocks_ - 1>(a) = _mm_srli_si128(std::get<num_blocks_ - 1>(a), word_size);
+        a[num_blocks_ - 1] = _mm_srli_si128(a[num_blocks_ - 1], word_size);
         return a;
     }
 private:
@@ -0,0 +1,33 @@
+// Copyright (c) 2015-2019 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// The baseline kernels. Compiled with -msse4.1 as the SSE2 instruction set policy uses epi32
+// extracts and minimums, so SSE4.1 is the minimum supported instruction set.
+
+#include "simd_pair_hmm_kernel_impl.hpp"
+#include "sse2_pair_hmm_impl.hpp"
+
+namespace octopus { namespace hmm { namespace simd { namespace detail {
+
+namespace {
+
+struct SSE41InstructionSets
+{
+    template <unsigned BandSize, typename ScoreType>
+    using Intra = SSE2PairHMMInstructionSet<BandSize, ScoreType, SSE41InstructionSets>;
+    
+    template <typename ScoreType>
+    using Inter = SSE2PairHMMInstructionSet<16 / sizeof(ScoreType), ScoreType, SSE41InstructionSets>;
+};
+
+} // namespace
+
+const PairHMMKernel* find_sse4_1_pair_hmm_kernel(const int min_band_size, const ScorePrecision precision) noexcept
+{
+    return find_kernel<SSE41InstructionSets>(min_band_size, precision);
+}
+
+} // namespace detail
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
@@ -20,6 +20,7 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <exception>
 #include <sstream>
 #include <iostream>
 #include <cassert>
@@ -48,7 +49,9 @@
 #include "logging/error_handler.hpp"
 #include "core/tools/vcf_header_factory.hpp"
 #include "io/variant/vcf.hpp"
+#include "io/variant/vcf_spec.hpp"
 #include "utils/timing.hpp"
+#include "utils/thread_pool.hpp"
 #include "exceptions/program_error.hpp"
 #include "exceptions/system_error.hpp"
 #include "csr/filters/variant_call_filter.hpp"
@@ -56,8 +59,7 @@
 #include "readpipe/buffered_read_pipe.hpp"
 #include "core/tools/bam_realigner.hpp"
 #include "core/tools/indel_profiler.hpp"
-
-#include "timers.hpp" // BENCHMARK
+#include "core/models/pairhmm/simd_pair_hmm_kernel.hpp"
 
 namespace octopus {
 
@@ -221,6 +223,7 @@ void log_startup_info(const GenomeCallingComponents& components)
             ls << " (" << cores << " cores detected)";
         }
     }
+    stream(log) << "Using " << hmm::simd::pair_hmm_instruction_set() << " pair HMM kernels";
     auto sl = stream(log);
     auto output_path = components.output().path();
     if (apply_csr(components)) {
@@ -457,17 +460,11 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
 
 void run_octopus_single_threaded(GenomeCallingComponents& components)
 {
-    #ifdef BENCHMARK
-    init_timers();
-    #endif
     components.progress_meter().start();
     for (const auto& contig : components.contigs()) {
         run_octopus_on_contig(ContigCallingComponents {contig, components});
     }
     components.progress_meter().stop();
-    #ifdef BENCHMARK
-        print_all_timers();
-    #endif
 }
 
 bool can_use_temp_bcf(const GenomicRegion& region)
@@ -496,20 +493,24 @@ auto create_unique_temp_output_file_path(const GenomicRegion& region,
     return result;
 }
 
-VcfHeader make_temp_vcf_header(const GenomeCallingComponents& components, const GenomicRegion& region)
+// Temp files get the same contig and field dictionaries as the final output so that their
+// records can be appended verbatim when the temp files are merged
+VcfHeader make_temp_vcf_header(const GenomeCallingComponents& components)
 {
-    const auto call_types = get_call_types(components, {region.contig_name()});
-    return make_vcf_header(components.samples(), region.contig_name(), components.reference(), call_types, {"octopus-internal", ""});
+    const auto call_types = get_call_types(components, components.contigs());
+    return make_vcf_header(components.samples(), components.contigs(), components.reference(), call_types, {"octopus-internal", ""});
 }
 
-VcfWriter create_unique_temp_output_file(const GenomicRegion& region, const GenomeCallingComponents& components)
+VcfWriter create_unique_temp_output_file(const GenomicRegion& region, const GenomeCallingComponents& components,
+                                         const VcfHeader& header)
 {
-    return {create_unique_temp_output_file_path(region, components), make_temp_vcf_header(components, region)};
+    return {create_unique_temp_output_file_path(region, components), header};
 }
 
-VcfWriter create_unique_temp_output_file(const GenomicRegion::ContigName& contig, const GenomeCallingComponents& components)
+VcfWriter create_unique_temp_output_file(const GenomicRegion::ContigName& contig, const GenomeCallingComponents& components,
+                                         const VcfHeader& header)
 {
-    return create_unique_temp_output_file(components.reference().contig_region(contig), components);
+    return create_unique_temp_output_file(components.reference().contig_region(contig), components, header);
 }
 
 using TempVcfWriterMap = std::unordered_map<ContigName, VcfWriter>;
@@ -521,8 +522,9 @@ TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components
     }
     TempVcfWriterMap result {};
     result.reserve(components.contigs().size());
+    const auto header = make_temp_vcf_header(components);
     for (const auto& contig : components.contigs()) {
-        auto contig_writer = create_unique_temp_output_file(contig, components);
+        auto contig_writer = create_unique_temp_output_file(contig, components, header);
         contig_writer.close();
         result.emplace(contig, std::move(contig_writer));
     }
@@ -585,7 +587,6 @@ struct TaskMakerSyncPacket
     TaskMakerSyncPacket() : batch_size_hint {1}, waiting {true}, num_tasks {0}, finished {}, all_done {false} {}
     std::condition_variable cv;
     std::mutex mutex;
-    bool ready = true;
     std::atomic_uint batch_size_hint; // Only read by task maker
     std::atomic_bool waiting; // Only read by task maker
     std::atomic_uint num_tasks;
@@ -606,7 +607,6 @@ void make_region_tasks(const GenomicRegion& region,
     auto subregion = propose_call_subregion(components, region, window_config);
     if (ends_equal(subregion, region)) {
         lock.lock();
-        sync.cv.wait(lock, [&] () { return sync.ready; });
         result.emplace(std::move(subregion), policy);
         ++sync.num_tasks;
         if (last_region_in_contig) {
@@ -632,7 +632,6 @@ void make_region_tasks(const GenomicRegion& region,
             assert(!batch.empty());
             assert(!lock.owns_lock());
             lock.lock();
-            sync.cv.wait(lock, [&] () { return sync.ready; });
             for (auto&& r : batch) result.emplace(std::move(r), policy);
             sync.num_tasks += batch.size();
             if (done) {
@@ -698,7 +697,11 @@ void make_tasks_helper(TaskMap& tasks,
             const auto& contig = contigs[i];
             if (debug_log) stream(*debug_log) << "Making tasks for contig " << contig;
             auto contig_components = make_contig_components(contig, components, num_threads);
-            make_contig_tasks(contig_components, execution_policy, tasks[contig], sync, i == contigs.size() - 1, window_config);
+            auto& contig_tasks = [&] () -> TaskQueue& {
+                std::lock_guard<std::mutex> lock {sync.mutex}; // the task map is shared with the callers
+                return tasks[contig];
+            }();
+            make_contig_tasks(contig_components, execution_policy, contig_tasks, sync, i == contigs.size() - 1, window_config);
             if (debug_log) stream(*debug_log) << "Finished making tasks for contig " << contig;
         }
         if (debug_log) *debug_log << "Finished making tasks";
@@ -750,11 +753,10 @@ unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
     return num_cores;
 }
 
+// Requires the sync mutex is held
 Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
 {
     assert(!tasks.empty());
-    std::unique_lock<std::mutex> lock {sync.mutex};
-    sync.ready = false;
     assert(sync.num_tasks > 0);
     const auto contig_task_itr = std::begin(tasks);
     assert(!contig_task_itr->second.empty());
@@ -766,9 +768,6 @@ Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
         tasks.erase(contig_task_itr);
     }
     --sync.num_tasks;
-    sync.ready = true;
-    lock.unlock();
-    sync.cv.notify_one();
     return result;
 }
 
@@ -792,49 +791,6 @@ std::ostream& operator<<(std::ostream& os, const CompletedTask& task)
     return os;
 }
 
-struct CallerSyncPacket
-{
-    CallerSyncPacket() : num_finished {0} {}
-    std::condition_variable cv;
-    std::mutex mutex;
-    std::atomic_uint num_finished;
-};
-
-template<typename R>
-bool is_ready(const std::future<R>& f)
-{
-    return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-}
-
-auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
-{
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
-        try {
-            CompletedTask result {task};
-            result.runtime.start = std::chrono::system_clock::now();
-            result.calls = components.caller->call(task.region, components.progress_meter);
-            result.runtime.end = std::chrono::system_clock::now();
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            return result;
-        } catch (const std::exception& e) {
-            logging::ErrorLogger error_log {};
-            stream(error_log) << "Encountered a problem whilst calling " << task << "(" << e.what() << ")";
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(2s); // Try to make sure the error is logged before raising
-            std::unique_lock<std::mutex> lock {sync.mutex};
-            ++sync.num_finished;
-            lock.unlock();
-            sync.cv.notify_all();
-            throw;
-        }
-    });
-}
-
 using CompletedTaskMap = std::map<ContigName, std::map<ContigRegion, CompletedTask>>;
 using HoldbackTask = boost::optional<std::reference_wrapper<const CompletedTask>>;
 
@@ -875,6 +831,130 @@ auto make_contig_calling_component_factory_map(GenomeCallingComponents& componen
     return result;
 }
 
+// Calling windows are launched by whichever thread frees a task slot, so once the first windows are
+// running the pool workers consume the pending tasks themselves from the window completion handler.
+// All the members except workers are guarded by the task maker mutex, as launching pops pending tasks.
+struct CallerSyncPacket
+{
+    CallerSyncPacket(TaskMap& pending_tasks, TaskMakerSyncPacket& task_maker_sync,
+                     const ContigCallingComponentFactoryMap& calling_components,
+                     const WindowConfig& window_config, const unsigned max_running)
+    : pending_tasks {pending_tasks}
+    , task_maker_sync {task_maker_sync}
+    , calling_components {calling_components}
+    , window_config {window_config}
+    , max_running {max_running}
+    , workers {max_running}
+    {}
+    TaskMap& pending_tasks;
+    TaskMakerSyncPacket& task_maker_sync;
+    const ContigCallingComponentFactoryMap& calling_components;
+    const WindowConfig& window_config;
+    const unsigned max_running;
+    unsigned num_running = 0;
+    std::deque<Task> started = {};
+    std::deque<CompletedTask> completed = {};
+    std::exception_ptr error = {};
+    ThreadPool workers; // last so running tasks are joined before the rest is destroyed
+};
+
+bool is_finished(const CallerSyncPacket& sync) noexcept
+{
+    if (sync.num_running > 0) return false;
+    return sync.error || (sync.task_maker_sync.all_done && sync.task_maker_sync.num_tasks == 0);
+}
+
+bool can_launch(const CallerSyncPacket& sync) noexcept
+{
+    return !sync.error && sync.num_running < sync.max_running && sync.task_maker_sync.num_tasks > 0;
+}
+
+auto split(const Task& task, const unsigned max_parts, const GenomicRegion::Size min_part_size)
+{
+    const auto num_parts = std::max(std::min(GenomicRegion::Size {max_parts}, size(task.region) / min_part_size),
+                                    GenomicRegion::Size {1});
+    const auto part_size = size(task.region) / num_parts;
+    std::vector<Task> result {};
+    result.reserve(num_parts);
+    auto part_begin = mapped_begin(task.region);
+    for (GenomicRegion::Size i {1}; i <= num_parts; ++i) {
+        const auto part_end = i < num_parts ? part_begin + part_size : mapped_end(task.region);
+        result.emplace_back(GenomicRegion {contig_name(task.region), part_begin, part_end}, task.policy);
+        part_begin = part_end;
+    }
+    return result;
+}
+
+// Pops pending tasks into the free task slots. If the task maker has fallen behind, so a popped
+// task is the last one pending while other slots are free, the task is split between the free slots
+// rather than leaving them idle. Requires the task maker mutex is held.
+std::vector<Task> pop_launchable(CallerSyncPacket& sync)
+{
+    std::vector<Task> result {};
+    while (can_launch(sync)) {
+        const auto num_free_slots = sync.max_running - sync.num_running;
+        auto task = pop(sync.pending_tasks, sync.task_maker_sync);
+        if (sync.task_maker_sync.num_tasks == 0 && num_free_slots > 1 && sync.window_config.min_size) {
+            auto parts = split(task, num_free_slots, *sync.window_config.min_size);
+            sync.num_running += parts.size();
+            utils::append(std::move(parts), result);
+        } else {
+            ++sync.num_running;
+            result.push_back(std::move(task));
+        }
+    }
+    const auto num_free_slots = sync.max_running - sync.num_running;
+    sync.task_maker_sync.waiting = num_free_slots > 0;
+    sync.task_maker_sync.batch_size_hint = std::max(num_free_slots, sync.max_running / 2);
+    utils::append(result, sync.started);
+    return result;
+}
+
+void launch(std::vector<Task> tasks, CallerSyncPacket& sync);
+
+void run(const Task& task, CallerSyncPacket& sync)
+{
+    boost::optional<CompletedTask> result {};
+    std::exception_ptr error {};
+    try {
+        const auto components = sync.calling_components.at(contig_name(task))();
+        result = CompletedTask {task};
+        result->runtime.start = std::chrono::system_clock::now();
+        result->calls = components.caller->call(task.region, components.progress_meter);
+        result->runtime.end = std::chrono::system_clock::now();
+    } catch (const std::exception& e) {
+        logging::ErrorLogger error_log {};
+        stream(error_log) << "Encountered a problem whilst calling " << task << "(" << e.what() << ")";
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(2s); // Try to make sure the error is logged before raising
+        error = std::current_exception();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::vector<Task> next_tasks {};
+    {
+        std::lock_guard<std::mutex> lock {sync.task_maker_sync.mutex};
+        --sync.num_running;
+        if (error) {
+            if (!sync.error) sync.error = error;
+        } else {
+            sync.completed.push_back(std::move(*result));
+        }
+        next_tasks = pop_launchable(sync);
+    }
+    sync.task_maker_sync.cv.notify_all();
+    launch(std::move(next_tasks), sync);
+}
+
+void launch(std::vector<Task> tasks, CallerSyncPacket& sync)
+{
+    static auto debug_log = get_debug_log();
+    for (auto& task : tasks) {
+        if (debug_log) stream(*debug_log) << "Spawning task " << task;
+        sync.workers.push([task = std::move(task), &sync] () { run(task, sync); });
+    }
+}
+
 auto find_first_lhs_connecting(const std::deque<VcfRecord>& lhs_calls, const GenomicRegion& rhs_region)
 {
     const auto rhs_begin = mapped_begin(rhs_region);
@@ -1066,17 +1146,8 @@ void wait_until_finished(TaskWriterSyncPacket& sync)
     sync.cv.notify_one();
 }
 
-using FutureCompletedTasks = std::vector<std::future<CompletedTask>>;
 using RemainingTaskMap = std::map<ContigName, std::deque<CompletedTask>>;
 
-void extract_remaining_future_tasks(FutureCompletedTasks& futures, std::deque<CompletedTask>& result)
-{
-    const auto itr = std::remove_if(std::begin(futures), std::end(futures), [] (const auto& f) { return !f.valid(); });
-    std::transform(std::begin(futures), itr, std::back_inserter(result), [] (auto& fut) { return fut.get(); });
-    futures.clear();
-    futures.shrink_to_fit();
-}
-
 void extract_buffered_tasks(CompletedTaskMap& buffered_tasks, std::deque<CompletedTask>& result)
 {
     for (auto& p : buffered_tasks) {
@@ -1103,10 +1174,9 @@ RemainingTaskMap make_map(std::deque<CompletedTask>& tasks)
     return result;
 }
 
-RemainingTaskMap extract_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks)
+RemainingTaskMap extract_remaining_tasks(CompletedTaskMap& buffered_tasks)
 {
     std::deque<CompletedTask> tasks {};
-    extract_remaining_future_tasks(futures, tasks);
     extract_buffered_tasks(buffered_tasks, tasks);
     return make_map(tasks);
 }
@@ -1126,12 +1196,10 @@ void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs)
     }
 }
 
-void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
+void write_remaining_tasks(CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
                            const ContigCallingComponentFactoryMap& calling_components)
 {
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Waiting for " << futures.size() << " running tasks to finish";
-    auto remaining_tasks = extract_remaining_tasks(futures, buffered_tasks);
+    auto remaining_tasks = extract_remaining_tasks(buffered_tasks);
     resolve_connecting_calls(remaining_tasks, calling_components);
     write(std::move(remaining_tasks), temp_vcfs);
 }
@@ -1162,7 +1230,6 @@ void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& compone
 
 void run_octopus_multi_threaded(GenomeCallingComponents& components)
 {
-    using namespace std::chrono_literals;
     static auto debug_log = get_debug_log();
     
     const auto num_task_threads = calculate_num_task_threads(components);
@@ -1179,7 +1246,6 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     task_maker_thread.detach();
     
-    FutureCompletedTasks futures(num_task_threads);
     TaskMap running_tasks {ContigOrder {components.contigs()}};
     CompletedTaskMap buffered_tasks {};
     std::map<ContigName, HoldbackTask> holdbacks {};
@@ -1190,9 +1256,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
         holdbacks.emplace(contig, boost::none);
     }
     
-    CallerSyncPacket caller_sync {};
     const auto calling_components = make_contig_calling_component_factory_map(components);
-    unsigned num_idle_futures {0};
+    const auto window_config = default_window_config;
+    CallerSyncPacket caller_sync {pending_tasks, task_maker_sync, calling_components, window_config, num_task_threads};
     
     auto temp_writers = make_temp_vcf_writers(components);
     TaskWriterSyncPacket task_writer_sync {};
@@ -1204,75 +1270,45 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     task_writer_thread.detach();
     
-    // Wait for the first task to be made
-    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0; };
-    while(task_maker_sync.num_tasks == 0) {
-        pending_task_lock.lock();
-        task_maker_sync.cv.wait(pending_task_lock, tasks_available);
-        pending_task_lock.unlock();
-    }
-    task_maker_sync.batch_size_hint = num_task_threads / 2;
-    
     components.progress_meter().start();
     
-    while (!task_maker_sync.all_done || task_maker_sync.num_tasks > 0) {
+    // The workers launch the next pending tasks as their windows complete, so this thread only launches
+    // tasks that are made while slots are free, and orders the completed tasks for writing.
+    std::deque<Task> started_tasks {};
+    std::deque<CompletedTask> completed_tasks {};
+    bool finished {false};
+    while (!finished) {
         pending_task_lock.lock();
+        task_maker_sync.cv.wait(pending_task_lock, [&] () {
+            return !caller_sync.completed.empty() || can_launch(caller_sync) || is_finished(caller_sync);
+        });
         assert(count_tasks(pending_tasks) == task_maker_sync.num_tasks);
-        if (!task_maker_sync.all_done && task_maker_sync.num_tasks == 0) {
-            task_maker_sync.batch_size_hint = std::max(num_idle_futures, num_task_threads / 2);
-            if (num_idle_futures < futures.size()) {
-                // If there are running futures then it's good periodically check to see if
-                // any have finished and process them while we wait for the task maker.
-                while (task_maker_sync.num_tasks == 0 && caller_sync.num_finished == 0) {
-                    auto now = std::chrono::system_clock::now();
-                    task_maker_sync.cv.wait_until(pending_task_lock, now + 5s, tasks_available);
-                }
-            } else {
-                task_maker_sync.cv.wait(pending_task_lock, tasks_available);
-            }
-        }
+        auto launchable_tasks = pop_launchable(caller_sync);
+        std::swap(caller_sync.started, started_tasks);
+        std::swap(caller_sync.completed, completed_tasks);
+        finished = is_finished(caller_sync);
         pending_task_lock.unlock();
-        num_idle_futures = 0;
-        for (auto& future : futures) {
-            if (is_ready(future)) {
-                auto completed_task = future.get();
-                const auto& contig = contig_name(completed_task.region);
-                write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
-                                running_tasks.at(contig), holdbacks.at(contig),
-                                task_writer_sync, calling_components.at(contig));
-                --caller_sync.num_finished;
-            }
-            if (!future.valid()) {
-                pending_task_lock.lock();
-                if (task_maker_sync.num_tasks > 0) {
-                    pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
-                    auto task = pop(pending_tasks, task_maker_sync);
-                    future = run(task, calling_components.at(contig_name(task))(), caller_sync);
-                    running_tasks.at(contig_name(task)).push(std::move(task));
-                } else {
-                    pending_task_lock.unlock();
-                    ++num_idle_futures;
-                }
-            }
+        launch(std::move(launchable_tasks), caller_sync);
+        for (auto& task : started_tasks) {
+            running_tasks.at(contig_name(task)).push(std::move(task));
         }
-        // If there are no idle futures then all threads are busy and we must wait for one to finish,
-        // otherwise we must have run out of tasks, so we should wait for new ones.
-        if (num_idle_futures == 0 && caller_sync.num_finished == 0) {
-            task_maker_sync.waiting = false;
-            std::unique_lock<std::mutex> lock {caller_sync.mutex};
-            caller_sync.cv.wait(lock, [&] () { return caller_sync.num_finished > 0; });
-            task_maker_sync.waiting = true;
-        } else {
-            if (debug_log) stream(*debug_log) << "There are " << num_idle_futures << " idle futures";
+        started_tasks.clear();
+        for (auto& completed_task : completed_tasks) {
+            const auto& contig = contig_name(completed_task.region);
+            write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
+                            running_tasks.at(contig), holdbacks.at(contig),
+                            task_writer_sync, calling_components.at(contig));
         }
+        completed_tasks.clear();
     }
+    if (caller_sync.error) std::rethrow_exception(caller_sync.error);
     assert(task_maker_sync.num_tasks == 0);
     assert(pending_tasks.empty());
     running_tasks.clear();
     holdbacks.clear(); // holdbacks are just references to buffered tasks
     if (debug_log) *debug_log << "Finished making new tasks. Waiting for task writer to complete existing jobs";
     wait_until_finished(task_writer_sync);
-    write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
+    write_remaining_tasks(buffered_tasks, temp_writers, calling_components);
     components.progress_meter().stop();
     merge(std::move(temp_writers), components);
 }
@@ -1312,7 +1348,9 @@ void log_filtering_info(const GenomeCallingComponents& components)
 std::vector<GenomicRegion> extract_call_regions(VcfReader& vcf)
 {
     std::deque<GenomicRegion> regions {};
-    auto p = vcf.iterate(VcfReader::UnpackPolicy::sites);
+    // Only END is needed to compute the mapped region of each call
+    const VcfReader::Projection fields {VcfReader::Projection::KeyList {vcfspec::info::endPosition}};
+    auto p = vcf.iterate(fields);
     std::transform(std::move(p.first), std::move(p.second), std::back_inserter(regions),
                    [] (const VcfRecord& record) { return mapped_region(record); });
     return {std::make_move_iterator(std::begin(regions)), std::make_move_iterator(std::end(regions))};
@@ -1365,13 +1403,136 @@ Pedigree get_pedigree(const GenomeCallingComponents& components)
     return *result;
 }
 
+BufferedReadPipe make_filter_read_pipe(const GenomeCallingComponents& components, std::vector<GenomicRegion> hints,
+                                       const unsigned num_shards = 1)
+{
+    // The hints are the calls themselves so are accurate enough to prefetch on, but prefetching
+    // fetches the next buffer while holding the current one, so buffers are sized for both. Shards
+    // already overlap their fetches, and prefetching needs a second thread.
+    const bool prefetch {num_shards == 1 && is_multithreaded(components)};
+    const auto buffer_size = prefetch ? components.prefetching_packed_read_buffer_size() : components.packed_read_buffer_size() / num_shards;
+    BufferedReadPipe::Config buffer_config {std::max(buffer_size, std::size_t {1})};
+    buffer_config.fetch_expansion = 100;
+    buffer_config.max_hint_gap = 5'000;
+    buffer_config.prefetch_hints = prefetch;
+    BufferedReadPipe result {components.filter_read_pipe(), buffer_config};
+    result.hint(std::move(hints));
+    return result;
+}
+
+std::vector<GenomicRegion> get_filter_read_hints(const GenomeCallingComponents& components,
+                                                 const std::vector<GenomicRegion>& call_regions)
+{
+    if (use_unfiltered_call_region_hints_for_filtering(components)) {
+        return call_regions;
+    } else {
+        return flatten(components.search_regions());
+    }
+}
+
+auto make_call_filter(const GenomeCallingComponents& components, const VcfReader& in,
+                      BufferedReadPipe read_pipe, boost::optional<ProgressMeter&> progress,
+                      boost::optional<unsigned> max_threads)
+{
+    return components.call_filter_factory().make(components.reference(), std::move(read_pipe), in.fetch_header(),
+                                                 components.ploidies(),
+                                                 make_filtering_haplotype_likelihood_model(components),
+                                                 get_pedigree(components),
+                                                 progress, max_threads);
+}
+
+bool has_index(const boost::filesystem::path& vcf_path)
+{
+    namespace fs = boost::filesystem;
+    return fs::exists(vcf_path.string() + ".csi") || fs::exists(vcf_path.string() + ".tbi");
+}
+
+auto get_contigs_in_order(const std::vector<GenomicRegion>& regions)
+{
+    std::vector<GenomicRegion::ContigName> result {};
+    for (const auto& region : regions) {
+        if (result.empty() || result.back() != region.contig_name()) {
+            result.push_back(region.contig_name());
+        }
+    }
+    return result;
+}
+
+auto extract_contig_regions(const std::vector<GenomicRegion>& regions, const GenomicRegion::ContigName& contig)
+{
+    std::vector<GenomicRegion> result {};
+    std::copy_if(std::cbegin(regions), std::cend(regions), std::back_inserter(result),
+                 [&] (const auto& region) { return region.contig_name() == contig; });
+    return result;
+}
+
+bool can_shard_csr(const GenomeCallingComponents& components, const VcfReader& in)
+{
+    // Shards need an indexed input to iterate each contig, and somewhere to write their output
+    return components.call_filter_factory().is_shardable() && is_multithreaded(components)
+           && components.temp_directory() && has_index(in.path());
+}
+
+auto create_unique_temp_filter_output_file_path(const GenomicRegion::ContigName& contig,
+                                                const GenomeCallingComponents& components)
+{
+    auto result = *components.temp_directory();
+    boost::filesystem::path file_name {contig + "_filtered_temp"};
+    file_name += can_use_temp_bcf(GenomicRegion {contig, 0, 0}) ? ".bcf" : ".vcf";
+    result /= file_name;
+    return result;
+}
+
+// Each contig is filtered by an independent filter, with its own facet factory and read buffer, so
+// filtering scales with the number of threads like calling does. Contig outputs are stitched in order.
+void run_sharded_csr(GenomeCallingComponents& components, const VcfReader& in,
+                     const std::vector<GenomicRegion>& call_regions,
+                     const std::vector<GenomicRegion::ContigName>& call_contigs,
+                     ProgressMeter& progress)
+{
+    static auto debug_log = get_debug_log();
+    const auto num_threads = calculate_num_task_threads(components);
+    const auto num_shard_threads = std::min(num_threads, static_cast<unsigned>(call_contigs.size()));
+    const auto max_threads_per_shard = std::max(num_threads / num_shard_threads, 1u);
+    if (debug_log) {
+        stream(*debug_log) << "Filtering " << call_contigs.size() << " contigs with " << num_shard_threads
+                           << " shard threads and " << max_threads_per_shard << " threads per shard";
+    }
+    const auto hints = get_filter_read_hints(components, call_regions);
+    std::vector<VcfWriter> shard_outputs {};
+    shard_outputs.reserve(call_contigs.size());
+    for (const auto& contig : call_contigs) {
+        shard_outputs.emplace_back(create_unique_temp_filter_output_file_path(contig, components));
+    }
+    progress.start();
+    {
+        ThreadPool shard_workers {num_shard_threads};
+        std::vector<std::future<void>> shards {};
+        shards.reserve(call_contigs.size());
+        for (std::size_t shard_idx {0}; shard_idx < call_contigs.size(); ++shard_idx) {
+            shards.push_back(shard_workers.push([&, shard_idx] () {
+                const auto& contig = call_contigs[shard_idx];
+                auto read_pipe = make_filter_read_pipe(components, extract_contig_regions(hints, contig), num_shard_threads);
+                const auto filter = make_call_filter(components, in, std::move(read_pipe), boost::none, max_threads_per_shard);
+                assert(filter);
+                filter->filter(in, shard_outputs[shard_idx], contig);
+                shard_outputs[shard_idx].close();
+                progress.log_completed(contig);
+            }));
+        }
+        for (auto& shard : shards) shard.get();
+    }
+    progress.stop();
+    auto shard_readers = writers_to_readers(std::move(shard_outputs), false);
+    VcfWriter& out {*components.filtered_output()};
+    merge(shard_readers, out, call_contigs);
+}
+
 void run_csr(GenomeCallingComponents& components)
 {
     if (apply_csr(components)) {
         log_filtering_info(components);
         ProgressMeter progress {components.search_regions()};
-        const auto& filter_factory = components.call_filter_factory();
-        const auto& filter_read_pipe = components.filter_read_pipe();
         boost::optional<boost::filesystem::path> input_path {};
         if (components.filter_request()) {
             input_path = components.filter_request();
@@ -1379,25 +1540,24 @@ void run_csr(GenomeCallingComponents& components)
             input_path = components.output().path();
         }
         assert(input_path); // cannot be stdout
-        BufferedReadPipe::Config buffer_config {components.read_buffer_size()};
-        buffer_config.fetch_expansion = 100;
-        buffer_config.max_hint_gap = 5'000;
-        BufferedReadPipe buffered_rp {filter_read_pipe, buffer_config};
-        if (use_unfiltered_call_region_hints_for_filtering(components)) {
-            buffered_rp.hint(extract_call_regions(*input_path));
+        const VcfReader in {std::move(*input_path)};
+        // Reading every call is only worthwhile if the regions are needed for read hints or sharding
+        const bool can_shard {can_shard_csr(components, in)};
+        std::vector<GenomicRegion> call_regions {};
+        if (can_shard || use_unfiltered_call_region_hints_for_filtering(components)) {
+            call_regions = extract_call_regions(in.path());
+        }
+        const auto call_contigs = get_contigs_in_order(call_regions);
+        if (can_shard && call_contigs.size() > 1) {
+            run_sharded_csr(components, in, call_regions, call_contigs, progress);
         } else {
-            buffered_rp.hint(flatten(components.search_regions()));
+            const auto filter = make_call_filter(components, in, make_filter_read_pipe(components, get_filter_read_hints(components, call_regions)),
+                                                 progress, components.num_threads());
+            assert(filter);
+            VcfWriter& out {*components.filtered_output()};
+            filter->filter(in, out);
         }
-        const VcfReader in {std::move(*input_path)};
-        const auto filter = filter_factory.make(components.reference(), std::move(buffered_rp), in.fetch_header(),
-                                                components.ploidies(),
-                                                make_filtering_haplotype_likelihood_model(components),
-                                                get_pedigree(components),
-                                                progress, components.num_threads());
-        assert(filter);
-        VcfWriter& out {*components.filtered_output()};
-        filter->filter(in, out);
-        out.close();
+        components.filtered_output()->close();
     }
 }
 
@@ -1666,8 +1826,15 @@ void run_post_calling_requests(GenomeCallingComponents& components)
     run_bam_realign(components);
 }
 
+void init_shared_thread_pool(const GenomeCallingComponents& components)
+{
+    // The calling thread also does work in the parallel algorithms
+    set_shared_thread_pool_size(calculate_num_task_threads(components) - 1);
+}
+
 void run_octopus(GenomeCallingComponents& components, UserCommandInfo info)
 {
+    init_shared_thread_pool(components);
     run_variant_calling(components, std::move(info));
     run_post_calling_requests(components);
     cleanup(components);
@@ -19,7 +19,6 @@
 #include "utils/append.hpp"
 
 #include <iostream> // DEBUG
-#include "timers.hpp"
 
 #define _unused(x) ((void)(x))
 
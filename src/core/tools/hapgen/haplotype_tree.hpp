@@ -5,7 +5,6 @@
 #define haplotype_tree_hpp
 
 #include <vector>
-#include <list>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -15,8 +14,9 @@
 #include <type_traits>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
 
@@ -43,9 +43,9 @@ public:
     
     HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference);
     
-    HaplotypeTree(const HaplotypeTree&);
-    HaplotypeTree& operator=(const HaplotypeTree&);
-    HaplotypeTree(HaplotypeTree&&)            = default;
+    HaplotypeTree(const HaplotypeTree&)            = default;
+    HaplotypeTree& operator=(const HaplotypeTree&) = default;
+    HaplotypeTree(HaplotypeTree&&)                 = default;
     HaplotypeTree& operator=(HaplotypeTree&&) = default;
     
     ~HaplotypeTree() = default;
@@ -93,19 +93,32 @@ public:
     void write_dot(std::ostream& out) const;
     
 private:
-    using Tree = boost::adjacency_list<
-        boost::listS, boost::listS, boost::bidirectionalS, ContigAllele, boost::no_property
-    >;
+    // The tree is stored in flat arrays rather than as a node based graph. Nodes refer to
+    // their allele by index into a table of unique alleles, and to their parent and siblings
+    // by index, so equal alleles on different branches are only stored once and compare by
+    // index. Removed nodes are recycled and clear() keeps the arrays' capacity, so a tree
+    // reused across regions rarely allocates.
+    using Vertex      = std::uint32_t;
+    using AlleleIndex = std::uint32_t;
     
-    using Vertex = boost::graph_traits<Tree>::vertex_descriptor;
-    using Edge   = boost::graph_traits<Tree>::edge_descriptor;
+    static constexpr Vertex null_vertex_ {std::numeric_limits<Vertex>::max()};
+    static constexpr AlleleIndex null_allele_ {std::numeric_limits<AlleleIndex>::max()};
+    
+    struct Node
+    {
+        AlleleIndex allele;
+        Vertex parent, first_child, last_child, prev_sibling, next_sibling;
+    };
     
     using HaplotypeVertexMultiMap = std::unordered_multimap<Haplotype, Vertex>;
     
     std::reference_wrapper<const ReferenceGenome> reference_;
-    Tree tree_;
+    std::vector<Node> nodes_;
+    std::vector<Vertex> free_nodes_;
+    std::vector<ContigAllele> alleles_;
+    std::unordered_map<ContigAllele, AlleleIndex> allele_indices_;
     Vertex root_;
-    std::list<Vertex> haplotype_leafs_;
+    std::vector<Vertex> haplotype_leafs_;
     GenomicRegion::ContigName contig_;
     
     mutable HaplotypeVertexMultiMap haplotype_leaf_cache_;
@@ -113,19 +126,28 @@ private:
     
     using LeafIterator = decltype(haplotype_leafs_)::iterator;
     using LeafConstIterator = decltype(haplotype_leafs_)::const_iterator;
-    using CacheIterator = decltype(haplotype_leaf_cache_)::iterator;
     
+    const ContigAllele& allele_of(Vertex v) const noexcept;
+    std::size_t num_vertices() const noexcept;
+    AlleleIndex intern(const ContigAllele& allele);
+    Vertex add_vertex(AlleleIndex allele);
+    Vertex add_vertex(const ContigAllele& allele);
+    void add_edge(Vertex u, Vertex v) noexcept;
+    void remove_edge(Vertex u, Vertex v) noexcept;
+    void remove_vertex(Vertex v);
+    void compact_alleles();
     bool is_leaf(Vertex v) const;
     bool is_bifurcating(Vertex v) const;
     Vertex remove_forward(Vertex u);
     Vertex remove_backward(Vertex v);
     Vertex get_previous_allele(Vertex allele) const;
     Vertex find_allele_before(Vertex v, const ContigAllele& allele) const;
-    Vertex find_allele_on_branch(LeafIterator leaf, const ContigAllele& allele) const;
+    Vertex find_allele_on_branch(Vertex leaf, const ContigAllele& allele) const;
     bool allele_exists(Vertex leaf, const ContigAllele& allele) const;
-    std::pair<LeafIterator, bool> extend_haplotype(LeafIterator leaf, const ContigAllele& new_allele);
-    LeafIterator extend_haplotype(LeafIterator leaf, const Haplotype& other);
-    Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region) const;
+    void extend_haplotype(Vertex leaf, const ContigAllele& new_allele, std::vector<Vertex>& new_leafs);
+    void extend_haplotype(Vertex leaf, const Haplotype& haplotype, std::vector<Vertex>& new_leafs);
+    // Reference bases are taken from the flanks of reference_source, which defines the region
+    Haplotype extract_haplotype(Vertex leaf, const Haplotype& reference_source) const;
     HaplotypeLength extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const;
     bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const;
     bool is_branch_exact_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
@@ -136,6 +158,7 @@ private:
     LeafConstIterator 
     find_equal_haplotype_leaf(LeafConstIterator first, LeafConstIterator last,
                               const Haplotype& haplotype) const;
+    void prune_leaf(Vertex leaf, const ContigRegion& region);
     void clear_overlapped(const ContigRegion& region);
     std::pair<Vertex, bool> clear(Vertex leaf, const ContigRegion& region);
     std::pair<Vertex, bool> clear_external(Vertex leaf, const ContigRegion& region);
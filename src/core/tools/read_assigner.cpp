@@ -233,13 +233,14 @@ auto calculate_likelihoods(const Genotype<Haplotype>& genotype,
     const auto read_hashes = compute_read_hashes(reads);
     static constexpr unsigned char mapperKmerSize {6};
     auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
+    MappedIndexCounts haplotype_mapping_counts {};
     HaplotypeLikelihoods result {};
     result.reserve(genotype.ploidy());
     const auto indel_factor = estimate_max_indel_size(genotype) + estimate_max_indel_size(reads);
     for (const auto& haplotype : genotype) {
         const auto expanded_haplotype = expand_for_alignment(haplotype, reads_region, indel_factor, model);
         populate_kmer_hash_table<mapperKmerSize>(expanded_haplotype.sequence(), haplotype_hashes);
-        auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
+        init_mapping_counts(haplotype_hashes, haplotype_mapping_counts);
         model.reset(expanded_haplotype);
         std::vector<double> likelihoods(reads.size());
         std::transform(std::cbegin(reads), std::cend(reads), std::cbegin(read_hashes), std::begin(likelihoods),
@@ -248,7 +249,6 @@ auto calculate_likelihoods(const Genotype<Haplotype>& genotype,
                            reset_mapping_counts(haplotype_mapping_counts);
                            return model.evaluate(read, mapping_positions);
                        });
-        clear_kmer_hash_table(haplotype_hashes);
         result.push_back(std::move(likelihoods));
     }
     return result;
@@ -0,0 +1,195 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_assignment_spill.hpp"
+
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <functional>
+#include <cassert>
+
+#include <boost/functional/hash.hpp>
+
+#include "utils/mappable_algorithms.hpp"
+#include "exceptions/file_open_error.hpp"
+
+namespace octopus {
+
+ReadAssignmentSpill::ReadAssignmentSpill(Path file, std::vector<SampleName> samples)
+: path_ {std::move(file)}
+, samples_ {std::move(samples)}
+, file_ {path_.string(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc}
+, index_ {}
+, end_ {0}
+, cached_chunk_ {}
+, cached_records_ {}
+{
+    if (!file_.is_open()) {
+        throw FileOpenError {path_, "read assignment"};
+    }
+}
+
+const ReadAssignmentSpill::Path& ReadAssignmentSpill::path() const noexcept
+{
+    return path_;
+}
+
+const std::vector<SampleName>& ReadAssignmentSpill::samples() const noexcept
+{
+    return samples_;
+}
+
+namespace {
+
+template <typename T>
+void write_value(const T& value, std::string& buffer)
+{
+    const auto bytes = reinterpret_cast<const char*>(std::addressof(value));
+    buffer.append(bytes, sizeof(T));
+}
+
+void write_sequence(const VcfRecord::NucleotideSequence& sequence, std::string& buffer)
+{
+    write_value(static_cast<std::uint32_t>(sequence.size()), buffer);
+    buffer.append(sequence);
+}
+
+template <typename T>
+T read_value(const char*& data)
+{
+    T result;
+    std::copy(data, data + sizeof(T), reinterpret_cast<char*>(std::addressof(result)));
+    data += sizeof(T);
+    return result;
+}
+
+auto read_sequence(const char*& data)
+{
+    const auto size = read_value<std::uint32_t>(data);
+    VcfRecord::NucleotideSequence result {data, data + size};
+    data += size;
+    return result;
+}
+
+} // namespace
+
+void ReadAssignmentSpill::write(const std::deque<VcfRecord>& records,
+                                const std::vector<boost::optional<RecordAssignments>>& assignments)
+{
+    assert(records.size() == assignments.size());
+    std::string buffer {};
+    std::uint32_t num_records {0};
+    write_value(num_records, buffer);
+    boost::optional<GenomicRegion> region {};
+    for (std::size_t i {0}; i < records.size(); ++i) {
+        if (!assignments[i]) continue;
+        const auto& record = records[i];
+        write_value(record.pos(), buffer);
+        write_sequence(record.ref(), buffer);
+        write_value(static_cast<std::uint32_t>(record.num_alt()), buffer);
+        for (const auto& alt : record.alt()) write_sequence(alt, buffer);
+        for (const auto& sample : samples_) {
+            const auto sample_itr = assignments[i]->find(sample);
+            if (sample_itr != std::cend(*assignments[i])) {
+                write_value(static_cast<std::uint32_t>(sample_itr->second.size()), buffer);
+                for (const auto& assignment : sample_itr->second) {
+                    write_value(assignment.read, buffer);
+                    write_value(assignment.allele, buffer);
+                }
+            } else {
+                write_value(std::uint32_t {0}, buffer);
+            }
+        }
+        region = region ? encompassing_region(*region, mapped_region(record)) : mapped_region(record);
+        ++num_records;
+    }
+    if (num_records == 0) return;
+    std::copy_n(reinterpret_cast<const char*>(&num_records), sizeof(num_records), std::begin(buffer));
+    std::lock_guard<std::mutex> lock {mutex_};
+    file_.seekp(end_);
+    file_.write(buffer.data(), buffer.size());
+    index_[region->contig_name()].push_back({*region, end_, buffer.size()});
+    end_ += buffer.size();
+}
+
+std::vector<boost::optional<ReadAssignmentSpill::RecordAssignments>>
+ReadAssignmentSpill::fetch(const std::vector<VcfRecord>& records) const
+{
+    std::vector<boost::optional<RecordAssignments>> result(records.size());
+    if (records.empty()) return result;
+    const auto region = encompassing_region(std::cbegin(records), std::cend(records));
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto contig_itr = index_.find(region.contig_name());
+    if (contig_itr == std::cend(index_)) return result;
+    std::size_t num_unresolved {records.size()};
+    // Newest chunks first so re-called regions resolve to the latest calls
+    for (auto chunk_itr = std::crbegin(contig_itr->second); chunk_itr != std::crend(contig_itr->second); ++chunk_itr) {
+        if (!overlaps(chunk_itr->region, region)) continue;
+        const auto& spilled_records = read(*chunk_itr);
+        for (std::size_t i {0}; i < records.size(); ++i) {
+            if (result[i]) continue;
+            const auto& record = records[i];
+            const auto match = std::find_if(std::cbegin(spilled_records), std::cend(spilled_records),
+                                            [&record] (const SpilledRecord& spilled) {
+                                                return spilled.pos == record.pos() && spilled.ref == record.ref() && spilled.alt == record.alt();
+                                            });
+            if (match != std::cend(spilled_records)) {
+                result[i] = match->assignments;
+                --num_unresolved;
+            }
+        }
+        if (num_unresolved == 0) break;
+    }
+    return result;
+}
+
+// private methods
+
+const std::vector<ReadAssignmentSpill::SpilledRecord>& ReadAssignmentSpill::read(const Chunk& chunk) const
+{
+    if (cached_chunk_ && *cached_chunk_ == chunk.offset) return cached_records_;
+    std::string buffer(chunk.size, '\0');
+    file_.seekg(chunk.offset);
+    file_.read(&buffer[0], chunk.size);
+    const char* data {buffer.data()};
+    const auto num_records = read_value<std::uint32_t>(data);
+    cached_records_.clear();
+    cached_records_.reserve(num_records);
+    for (std::uint32_t i {0}; i < num_records; ++i) {
+        SpilledRecord record {};
+        record.pos = read_value<GenomicRegion::Position>(data);
+        record.ref = read_sequence(data);
+        const auto num_alts = read_value<std::uint32_t>(data);
+        record.alt.reserve(num_alts);
+        for (std::uint32_t j {0}; j < num_alts; ++j) record.alt.push_back(read_sequence(data));
+        record.assignments.reserve(samples_.size());
+        for (const auto& sample : samples_) {
+            const auto num_assignments = read_value<std::uint32_t>(data);
+            auto& sample_assignments = record.assignments[sample];
+            sample_assignments.reserve(num_assignments);
+            for (std::uint32_t k {0}; k < num_assignments; ++k) {
+                Assignment assignment {};
+                assignment.read = read_value<ReadKey>(data);
+                assignment.allele = read_value<AlleleIndex>(data);
+                sample_assignments.push_back(assignment);
+            }
+        }
+        cached_records_.push_back(std::move(record));
+    }
+    cached_chunk_ = chunk.offset;
+    return cached_records_;
+}
+
+ReadAssignmentSpill::ReadKey make_read_key(const AlignedRead& read) noexcept
+{
+    using boost::hash_combine;
+    std::size_t result {std::hash<std::string> {}(read.name())};
+    hash_combine(result, read.is_marked_first_template_segment());
+    hash_combine(result, read.is_marked_last_template_segment());
+    hash_combine(result, read.is_marked_supplementary_alignment());
+    return result;
+}
+
+} // namespace octopus
@@ -0,0 +1,106 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_assignment_spill_hpp
+#define read_assignment_spill_hpp
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <ios>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "io/variant/vcf_record.hpp"
+
+namespace octopus {
+
+/*
+ ReadAssignmentSpill persists the read-to-allele assignments made by the caller for each
+ emitted call, so call set refinement can reuse them rather than reassign every read.
+
+ Assignments are appended to a temporary file in chunks, one chunk per call region, and only
+ a small per-contig index of the chunks is kept in memory. Chunks written later supersede
+ earlier chunks, so regions that are called more than once resolve to the latest calls.
+ */
+class ReadAssignmentSpill
+{
+public:
+    using Path = boost::filesystem::path;
+
+    using ReadKey = std::uint64_t;
+    // 0 for the REF allele and i for the i-th ALT allele
+    using AlleleIndex = std::uint8_t;
+
+    struct Assignment
+    {
+        ReadKey read;
+        AlleleIndex allele;
+    };
+
+    using SampleAssignments = std::vector<Assignment>; // sorted by read key
+    using RecordAssignments = std::unordered_map<SampleName, SampleAssignments>;
+
+    ReadAssignmentSpill() = delete;
+
+    ReadAssignmentSpill(Path file, std::vector<SampleName> samples);
+
+    ReadAssignmentSpill(const ReadAssignmentSpill&)            = delete;
+    ReadAssignmentSpill& operator=(const ReadAssignmentSpill&) = delete;
+    ReadAssignmentSpill(ReadAssignmentSpill&&)                 = delete;
+    ReadAssignmentSpill& operator=(ReadAssignmentSpill&&)      = delete;
+
+    ~ReadAssignmentSpill() = default;
+
+    const Path& path() const noexcept;
+    const std::vector<SampleName>& samples() const noexcept;
+
+    // Writes the assignments of each record that has them. Records must be sorted and on the same contig.
+    void write(const std::deque<VcfRecord>& records, const std::vector<boost::optional<RecordAssignments>>& assignments);
+
+    // The assignments for each record, if they were written
+    std::vector<boost::optional<RecordAssignments>> fetch(const std::vector<VcfRecord>& records) const;
+
+private:
+    struct Chunk
+    {
+        GenomicRegion region;
+        std::streamoff offset;
+        std::size_t size;
+    };
+
+    struct SpilledRecord
+    {
+        GenomicRegion::Position pos;
+        VcfRecord::NucleotideSequence ref;
+        std::vector<VcfRecord::NucleotideSequence> alt;
+        RecordAssignments assignments;
+    };
+
+    Path path_;
+    std::vector<SampleName> samples_;
+    mutable std::fstream file_;
+    std::unordered_map<GenomicRegion::ContigName, std::vector<Chunk>> index_;
+    std::streamoff end_;
+
+    mutable boost::optional<std::streamoff> cached_chunk_;
+    mutable std::vector<SpilledRecord> cached_records_;
+
+    mutable std::mutex mutex_;
+
+    const std::vector<SpilledRecord>& read(const Chunk& chunk) const;
+};
+
+ReadAssignmentSpill::ReadKey make_read_key(const AlignedRead& read) noexcept;
+
+} // namespace octopus
+
+#endif
@@ -9,6 +9,7 @@
 
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "config/common.hpp"
 #include "basics/aligned_read.hpp"
@@ -34,8 +35,12 @@ CigarScanner::CigarScanner(const ReferenceGenome& reference, Options options)
 : reference_ {reference}
 , options_ {options}
 , buffer_ {}
+, contigs_ {}
+, samples_ {}
+, candidate_table_ {}
+, likely_misaligned_candidate_table_ {}
 , candidates_ {}
-, likely_misaligned_candidates_ {}
+, is_candidates_current_ {false}
 , max_seen_candidate_size_ {}
 , combined_read_coverage_tracker_ {}
 , misaligned_read_coverage_tracker_ {}
@@ -52,13 +57,6 @@ bool CigarScanner::do_requires_reads() const noexcept
 
 namespace {
 
-template <typename Sequence, typename P, typename S>
-Sequence copy(const Sequence& sequence, const P pos, const S size)
-{
-    const auto it = std::next(std::cbegin(sequence), pos);
-    return Sequence {it, std::next(it, size)};
-}
-
 double ln_probability_read_correctly_aligned(const double misalign_penalty, const AlignedRead& read,
                                              const double max_expected_mutation_rate)
 {
@@ -85,13 +83,10 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
                             CoverageTracker<GenomicRegion>& coverage_tracker,
                             CoverageTracker<GenomicRegion>& forward_strand_coverage_tracker)
 {
-    using std::cbegin; using std::next; using std::move;
     using Flag = CigarOperation::Flag;
-    const auto& read_contig   = contig_name(read);
-    const auto& read_sequence = read.sequence();
+    const auto& read_contig = contig_name(read);
     auto ref_index = mapped_begin(read);
     std::size_t read_index {0};
-    GenomicRegion region;
     double misalignment_penalty {0};
     buffer_.clear();
     for (const auto& cigar_operation : read.cigar()) {
@@ -99,7 +94,7 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
         switch (cigar_operation.flag()) {
             case Flag::alignmentMatch:
                 misalignment_penalty += add_snvs_in_match_range(GenomicRegion {read_contig, ref_index, ref_index + op_size},
-                                                                read, read_index, sample);
+                                                                read, read_index);
                 read_index += op_size;
                 ref_index  += op_size;
                 break;
@@ -109,11 +104,7 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
                 break;
             case Flag::substitution:
             {
-                region = GenomicRegion {read_contig, ref_index, ref_index + op_size};
-                add_candidate(region,
-                              reference_.get().fetch_sequence(region),
-                              copy(read_sequence, read_index, op_size),
-                              read, read_index, sample);
+                add_candidate(ref_index, op_size, read_index, op_size);
                 read_index += op_size;
                 ref_index  += op_size;
                 if (options_.misalignment_parameters) misalignment_penalty += op_size * options_.misalignment_parameters->snv_penalty;
@@ -121,21 +112,14 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
             }
             case Flag::insertion:
             {
-                add_candidate(GenomicRegion {read_contig, ref_index, ref_index},
-                              "",
-                              copy(read_sequence, read_index, op_size),
-                              read, read_index, sample);
+                add_candidate(ref_index, 0, read_index, op_size);
                 read_index += op_size;
                 if (options_.misalignment_parameters)  misalignment_penalty += options_.misalignment_parameters->indel_penalty;
                 break;
             }
             case Flag::deletion:
             {
-                region = GenomicRegion {read_contig, ref_index, ref_index + op_size};
-                add_candidate(move(region),
-                              reference_.get().fetch_sequence(region),
-                              "",
-                              read, read_index, sample);
+                add_candidate(ref_index, op_size, read_index, 0);
                 ref_index += op_size;
                 if (options_.misalignment_parameters)  misalignment_penalty += options_.misalignment_parameters->indel_penalty;
                 break;
@@ -174,12 +158,15 @@ void CigarScanner::add_read(const SampleName& sample, const AlignedRead& read,
         coverage_tracker.add(read);
         if (is_forward_strand(read)) forward_strand_coverage_tracker.add(read);
     }
+    const auto contig_index = get_contig_index(read_contig);
+    const auto sample_index = get_sample_index(sample);
     if (!is_likely_misaligned(read, misalignment_penalty)) {
-        utils::append(std::move(buffer_), candidates_);
+        add_pending_candidates(read, contig_index, sample_index, candidate_table_);
     } else {
-        utils::append(std::move(buffer_), likely_misaligned_candidates_);
+        add_pending_candidates(read, contig_index, sample_index, likely_misaligned_candidate_table_);
         misaligned_read_coverage_tracker_.add(clipped_mapped_region(read));
     }
+    if (!buffer_.empty()) is_candidates_current_ = false;
 }
 
 void CigarScanner::do_add_reads(const SampleName& sample, ReadVectorIterator first, ReadVectorIterator last)
@@ -253,8 +240,10 @@ void choose_push_back(Variant candidate, std::vector<Variant>& final_candidates,
 
 std::vector<Variant> CigarScanner::do_generate(const RegionSet& regions) const
 {
-    std::sort(std::begin(candidates_), std::end(candidates_));
-    std::sort(std::begin(likely_misaligned_candidates_), std::end(likely_misaligned_candidates_));
+    if (!is_candidates_current_) {
+        candidates_ = make_candidates(candidate_table_);
+        is_candidates_current_ = true;
+    }
     std::vector<Variant> result {};
     for (const auto& region : regions) {
         generate(region, result);
@@ -265,8 +254,12 @@ std::vector<Variant> CigarScanner::do_generate(const RegionSet& regions) const
 void CigarScanner::do_clear() noexcept
 {
     free_memory(buffer_);
+    free_memory(contigs_);
+    free_memory(samples_);
+    candidate_table_.clear();
+    likely_misaligned_candidate_table_.clear();
     free_memory(candidates_);
-    free_memory(likely_misaligned_candidates_);
+    is_candidates_current_ = false;
     free_memory(combined_read_coverage_tracker_);
     free_memory(misaligned_read_coverage_tracker_);
     free_memory(sample_read_coverage_tracker_);
@@ -281,8 +274,16 @@ std::string CigarScanner::name() const
 
 // private methods
 
-double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read,
-                                             std::size_t read_index, const SampleName& origin)
+void CigarScanner::add_candidate(const GenomicRegion::Position begin, const GenomicRegion::Size ref_size,
+                                 const std::size_t read_offset, const std::size_t alt_size)
+{
+    if (ref_size <= options_.max_variant_size) {
+        buffer_.push_back({begin, ref_size, read_offset, alt_size});
+        max_seen_candidate_size_ = std::max(max_seen_candidate_size_, ref_size);
+    }
+}
+
+double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read, std::size_t read_index)
 {
     const NucleotideSequence ref_segment {reference_.get().fetch_sequence(region)};
     double misalignment_penalty {0};
@@ -290,8 +291,7 @@ double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const
         const char ref_base {ref_segment[ref_index]}, read_base {read.sequence()[read_index]};
         if (ref_base != read_base && ref_base != 'N' && read_base != 'N') {
             const auto begin_pos = region.begin() + static_cast<GenomicRegion::Position>(ref_index);
-            add_candidate(GenomicRegion {region.contig_name(), begin_pos, begin_pos + 1},
-                          ref_base, read_base, read, read_index, origin);
+            add_candidate(begin_pos, 1, read_index, 1);
             if (options_.misalignment_parameters && read.base_qualities()[read_index] >= options_.misalignment_parameters->snv_threshold) {
                 misalignment_penalty += options_.misalignment_parameters->snv_penalty;
             }
@@ -300,6 +300,60 @@ double CigarScanner::add_snvs_in_match_range(const GenomicRegion& region, const
     return misalignment_penalty;
 }
 
+CigarScanner::CandidateTable::ContigIndex CigarScanner::get_contig_index(const GenomicRegion::ContigName& contig)
+{
+    // Reads are usually added contig by contig so check the most recent first
+    if (!contigs_.empty() && contigs_.back() == contig) return contigs_.size() - 1;
+    const auto itr = std::find(std::cbegin(contigs_), std::cend(contigs_), contig);
+    if (itr != std::cend(contigs_)) return std::distance(std::cbegin(contigs_), itr);
+    contigs_.push_back(contig);
+    return contigs_.size() - 1;
+}
+
+CigarScanner::CandidateTable::SampleIndex CigarScanner::get_sample_index(const SampleName& sample)
+{
+    const auto itr = std::find_if(std::cbegin(samples_), std::cend(samples_),
+                                  [&] (const SampleName& s) { return &s == &sample || s == sample; });
+    if (itr != std::cend(samples_)) return std::distance(std::cbegin(samples_), itr);
+    samples_.emplace_back(sample);
+    return samples_.size() - 1;
+}
+
+void CigarScanner::add_pending_candidates(const AlignedRead& read, const CandidateTable::ContigIndex contig,
+                                          const CandidateTable::SampleIndex sample, CandidateTable& table) const
+{
+    const auto read_begin = mapped_begin(read);
+    const auto read_end = mapped_end(read);
+    const auto is_forward = is_forward_strand(read);
+    const auto& base_qualities = read.base_qualities();
+    for (const auto& candidate : buffer_) {
+        const auto first_base_quality_itr = std::next(std::cbegin(base_qualities), candidate.read_offset);
+        CandidateTable::Observation observation {};
+        observation.sample = sample;
+        observation.base_quality_sum = std::accumulate(first_base_quality_itr, std::next(first_base_quality_itr, candidate.alt_size), 0u);
+        observation.mapping_quality = read.mapping_quality();
+        observation.is_forward_strand = is_forward;
+        observation.is_edge = candidate.begin == read_begin || candidate.begin + candidate.ref_size == read_end;
+        table.add(contig, candidate.begin, candidate.ref_size,
+                  std::next(std::cbegin(read.sequence()), candidate.read_offset), candidate.alt_size,
+                  observation);
+    }
+}
+
+std::vector<CigarScanner::Candidate> CigarScanner::make_candidates(const CandidateTable& table) const
+{
+    std::vector<Candidate> result {};
+    result.reserve(table.size());
+    std::uint32_t entry_index {0};
+    for (const auto& entry : table.entries()) {
+        GenomicRegion region {contigs_[entry.contig], entry.begin, entry.begin + entry.ref_size};
+        auto ref_sequence = entry.ref_size > 0 ? reference_.get().fetch_sequence(region) : NucleotideSequence {};
+        result.emplace_back(Variant {std::move(region), std::move(ref_sequence), table.alt_sequence(entry)}, entry_index++);
+    }
+    std::sort(std::begin(result), std::end(result));
+    return result;
+}
+
 void CigarScanner::generate(const GenomicRegion& region, std::vector<Variant>& result) const
 {
     using std::begin; using std::end; using std::cbegin; using std::cend; using std::next;
@@ -317,22 +371,13 @@ void CigarScanner::generate(const GenomicRegion& region, std::vector<Variant>& r
         const auto num_matches = std::distance(cbegin(viable_candidates), next_candidate_itr);
         const auto observation = make_observation(cbegin(viable_candidates), next_candidate_itr);
         if (options_.include(observation)) {
-            if (num_matches > 1) {
-                auto unique_itr = cbegin(viable_candidates);
-                while (unique_itr != next_candidate_itr) {
-                    result.push_back(unique_itr->variant);
-                    unique_itr = std::find_if_not(next(unique_itr), next_candidate_itr,
-                                                  [unique_itr] (const Candidate& c) {
-                                                      return c.variant == unique_itr->variant;
-                                                  });
-                }
-            } else {
-                result.push_back(candidate.variant);
-            }
+            // candidates are unique so each match is a distinct variant
+            std::for_each(cbegin(viable_candidates), next_candidate_itr,
+                          [&] (const Candidate& c) { result.push_back(c.variant); });
         }
         viable_candidates.advance_begin(num_matches);
     }
-    if (debug_log_ && !likely_misaligned_candidates_.empty()) {
+    if (debug_log_ && !likely_misaligned_candidate_table_.empty()) {
         const auto novel_unique_misaligned_variants = get_novel_likely_misaligned_candidates(result);
         if (!novel_unique_misaligned_variants.empty()) {
             stream(*debug_log_) << "DynamicCigarScanner: ignoring "
@@ -342,13 +387,6 @@ void CigarScanner::generate(const GenomicRegion& region, std::vector<Variant>& r
     }
 }
 
-unsigned CigarScanner::sum_base_qualities(const Candidate& candidate) const noexcept
-{
-    const auto first_base_qual_itr = std::next(std::cbegin(candidate.source.get().base_qualities()), candidate.offset);
-    const auto last_base_qual_itr = std::next(first_base_qual_itr, alt_sequence_size(candidate.variant));
-    return std::accumulate(first_base_qual_itr, last_base_qual_itr, 0u);
-}
-
 bool CigarScanner::is_likely_misaligned(const AlignedRead& read, const double penalty) const
 {
     if (options_.misalignment_parameters) {
@@ -368,53 +406,40 @@ CigarScanner::make_observation(const CandidateIterator first_match, const Candid
     VariantObservation result {};
     result.variant = candidate.variant;
     result.total_depth = get_min_depth(candidate.variant, combined_read_coverage_tracker_);
-    std::vector<Candidate> observations {first_match, last_match};
-    std::sort(begin(observations), end(observations),
-              [] (const Candidate& lhs, const Candidate& rhs) { return lhs.origin.get() < rhs.origin.get(); });
-    for (auto observation_itr = begin(observations); observation_itr != end(observations);) {
-        const auto& origin = observation_itr->origin;
-        auto next_itr = std::find_if_not(next(observation_itr), end(observations),
-                                         [&] (const Candidate& c) { return c.origin.get() == origin.get(); });
-        const auto num_observations = static_cast<unsigned>(std::distance(observation_itr, next_itr));
-        std::vector<unsigned> observed_base_qualities(num_observations);
-        std::transform(observation_itr, next_itr, begin(observed_base_qualities),
-                       [this] (const Candidate& c) noexcept { return sum_base_qualities(c); });
-        std::vector<AlignedRead::MappingQuality> observed_mapping_qualities(num_observations);
-        std::transform(observation_itr, next_itr, begin(observed_mapping_qualities),
-                       [] (const Candidate& c) noexcept { return c.source.get().mapping_quality(); });
-        const auto forward_strand_support = std::accumulate(observation_itr, next_itr, 0u,
-                                                     [] (unsigned curr, const Candidate& c) noexcept {
-                                                         if (is_forward_strand(c.source.get())) {
-                                                             ++curr;
-                                                         }
-                                                         return curr;
-                                                     });
-        const auto edge_support = std::accumulate(observation_itr, next_itr, 0u,
-                                                      [] (unsigned curr, const Candidate& c) noexcept {
-                                                          if (begins_equal(c, c.source.get()) || ends_equal(c, c.source.get())) {
-                                                              ++curr;
-                                                          }
-                                                          return curr;
-                                                      });
-        const auto depth = std::max(get_min_depth(candidate.variant, sample_read_coverage_tracker_.at(origin)), num_observations);
-        const auto forward_depth = get_min_depth(candidate.variant, sample_forward_strand_coverage_tracker_.at(origin));
-        result.sample_observations.push_back({origin, depth, forward_depth,
-                                              std::move(observed_base_qualities),
-                                              std::move(observed_mapping_qualities),
-                                              forward_strand_support, edge_support});
-        observation_itr = next_itr;
+    std::vector<boost::optional<VariantObservation::SampleObservationStats>> sample_observations(samples_.size());
+    std::for_each(first_match, last_match, [&] (const Candidate& match) {
+        const auto& entry = candidate_table_.entries()[match.entry];
+        for (auto index = entry.first_observation; index != CandidateTable::no_observation;) {
+            const auto& observation = candidate_table_.observation(index);
+            auto& sample_observation = sample_observations[observation.sample];
+            if (!sample_observation) {
+                sample_observation = VariantObservation::SampleObservationStats {samples_[observation.sample], 0, 0, {}, {}, 0, 0};
+            }
+            sample_observation->observed_base_qualities.push_back(observation.base_quality_sum);
+            sample_observation->observed_mapping_qualities.push_back(observation.mapping_quality);
+            if (observation.is_forward_strand) ++sample_observation->forward_strand_support;
+            if (observation.is_edge) ++sample_observation->edge_support;
+            index = observation.next;
+        }
+    });
+    for (auto& sample_observation : sample_observations) {
+        if (sample_observation) {
+            const auto& sample = sample_observation->sample.get();
+            const auto num_observations = static_cast<unsigned>(sample_observation->observed_base_qualities.size());
+            sample_observation->depth = std::max(get_min_depth(candidate.variant, sample_read_coverage_tracker_.at(sample)), num_observations);
+            sample_observation->forward_strand_depth = get_min_depth(candidate.variant, sample_forward_strand_coverage_tracker_.at(sample));
+            result.sample_observations.push_back(std::move(*sample_observation));
+        }
     }
+    std::sort(std::begin(result.sample_observations), std::end(result.sample_observations),
+              [] (const auto& lhs, const auto& rhs) { return lhs.sample.get() < rhs.sample.get(); });
     return result;
 }
 
 std::vector<Variant>
 CigarScanner::get_novel_likely_misaligned_candidates(const std::vector<Variant>& current_candidates) const
 {
-    std::is_sorted(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_));
-    std::vector<Candidate> unique_misaligned_candidates {};
-    unique_misaligned_candidates.reserve(likely_misaligned_candidates_.size());
-    std::unique_copy(std::cbegin(likely_misaligned_candidates_), std::cend(likely_misaligned_candidates_),
-                     std::back_inserter(unique_misaligned_candidates));
+    const auto unique_misaligned_candidates = make_candidates(likely_misaligned_candidate_table_);
     std::vector<Variant> unique_misaligned_variants {};
     unique_misaligned_variants.reserve(unique_misaligned_candidates.size());
     std::transform(std::cbegin(unique_misaligned_candidates), std::cend(unique_misaligned_candidates),
@@ -429,6 +454,101 @@ CigarScanner::get_novel_likely_misaligned_candidates(const std::vector<Variant>&
     return result;
 }
 
+// CandidateTable
+
+constexpr std::uint32_t CigarScanner::CandidateTable::no_observation;
+constexpr std::uint32_t CigarScanner::CandidateTable::empty_slot;
+
+void CigarScanner::CandidateTable::add(const ContigIndex contig, const GenomicRegion::Position begin,
+                                       const GenomicRegion::Size ref_size, const SequenceIterator alt_first,
+                                       const std::size_t alt_size, Observation observation)
+{
+    if (2 * (entries_.size() + 1) > slots_.size()) {
+        rehash(std::max(slots_.size() * 2, std::size_t {64}));
+    }
+    std::size_t hash {0};
+    using boost::hash_combine;
+    hash_combine(hash, contig);
+    hash_combine(hash, begin);
+    hash_combine(hash, ref_size);
+    boost::hash_range(hash, alt_first, std::next(alt_first, alt_size));
+    const auto mask = slots_.size() - 1;
+    auto slot = hash & mask;
+    for (; slots_[slot] != empty_slot; slot = (slot + 1) & mask) {
+        const auto& entry = entries_[slots_[slot]];
+        if (entry.hash == hash && is_equal(entry, contig, begin, ref_size, alt_first, alt_size)) break;
+    }
+    if (slots_[slot] == empty_slot) {
+        Entry entry {};
+        entry.contig = contig;
+        entry.begin = begin;
+        entry.ref_size = ref_size;
+        entry.alt_size = static_cast<std::uint32_t>(alt_size);
+        entry.hash = hash;
+        entry.first_observation = entry.last_observation = no_observation;
+        if (alt_size <= entry.inline_alt.size()) {
+            std::copy_n(alt_first, alt_size, std::begin(entry.inline_alt));
+        } else {
+            entry.alt_offset = long_alt_sequences_.size();
+            long_alt_sequences_.append(alt_first, std::next(alt_first, alt_size));
+        }
+        slots_[slot] = static_cast<std::uint32_t>(entries_.size());
+        entries_.push_back(entry);
+    }
+    auto& entry = entries_[slots_[slot]];
+    const auto observation_index = static_cast<std::uint32_t>(observations_.size());
+    observation.next = no_observation;
+    observations_.push_back(observation);
+    if (entry.last_observation == no_observation) {
+        entry.first_observation = observation_index;
+    } else {
+        observations_[entry.last_observation].next = observation_index;
+    }
+    entry.last_observation = observation_index;
+}
+
+CigarScanner::NucleotideSequence CigarScanner::CandidateTable::alt_sequence(const Entry& entry) const
+{
+    const auto first = alt_data(entry);
+    return NucleotideSequence {first, first + entry.alt_size};
+}
+
+void CigarScanner::CandidateTable::clear() noexcept
+{
+    free_memory(slots_);
+    free_memory(entries_);
+    free_memory(observations_);
+    free_memory(long_alt_sequences_);
+}
+
+const char* CigarScanner::CandidateTable::alt_data(const Entry& entry) const noexcept
+{
+    if (entry.alt_size <= entry.inline_alt.size()) {
+        return entry.inline_alt.data();
+    } else {
+        return long_alt_sequences_.data() + entry.alt_offset;
+    }
+}
+
+bool CigarScanner::CandidateTable::is_equal(const Entry& entry, const ContigIndex contig, const GenomicRegion::Position begin,
+                                            const GenomicRegion::Size ref_size, const SequenceIterator alt_first,
+                                            const std::size_t alt_size) const noexcept
+{
+    return entry.contig == contig && entry.begin == begin && entry.ref_size == ref_size && entry.alt_size == alt_size
+        && std::equal(alt_first, std::next(alt_first, alt_size), alt_data(entry));
+}
+
+void CigarScanner::CandidateTable::rehash(const std::size_t num_slots)
+{
+    slots_.assign(num_slots, empty_slot);
+    const auto mask = num_slots - 1;
+    for (std::uint32_t index {0}; index < entries_.size(); ++index) {
+        auto slot = entries_[index].hash & mask;
+        while (slots_[slot] != empty_slot) slot = (slot + 1) & mask;
+        slots_[slot] = index;
+    }
+}
+
 // non-member methods
 
 namespace {
@@ -5,11 +5,14 @@
 #define cigar_scanner_hpp
 
 #include <vector>
-#include <deque>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <utility>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 #include <boost/optional.hpp>
 
@@ -92,17 +95,80 @@ private:
     void do_clear() noexcept override;
     std::string name() const override;
     
+    using NucleotideSequence = AlignedRead::NucleotideSequence;
+    using SequenceIterator = NucleotideSequence::const_iterator;
+    
+    // Observations are accumulated per unique candidate as reads are added, so the
+    // candidate sequences are only materialised once per unique candidate in do_generate.
+    class CandidateTable
+    {
+    public:
+        using SampleIndex = std::uint32_t;
+        using ContigIndex = std::uint32_t;
+        
+        struct Observation
+        {
+            std::uint32_t next;
+            SampleIndex sample;
+            unsigned base_quality_sum;
+            AlignedRead::MappingQuality mapping_quality;
+            bool is_forward_strand, is_edge;
+        };
+        
+        struct Entry
+        {
+            ContigIndex contig;
+            GenomicRegion::Position begin;
+            GenomicRegion::Size ref_size;
+            std::uint32_t alt_size;
+            std::size_t hash;
+            std::uint32_t first_observation, last_observation;
+            std::size_t alt_offset;
+            std::array<char, 16> inline_alt;
+        };
+        
+        static constexpr std::uint32_t no_observation = std::numeric_limits<std::uint32_t>::max();
+        
+        CandidateTable() = default;
+        
+        CandidateTable(const CandidateTable&)            = default;
+        CandidateTable& operator=(const CandidateTable&) = default;
+        CandidateTable(CandidateTable&&)                 = default;
+        CandidateTable& operator=(CandidateTable&&)      = default;
+        
+        ~CandidateTable() = default;
+        
+        void add(ContigIndex contig, GenomicRegion::Position begin, GenomicRegion::Size ref_size,
+                 SequenceIterator alt_first, std::size_t alt_size, Observation observation);
+        
+        bool empty() const noexcept { return entries_.empty(); }
+        std::size_t size() const noexcept { return entries_.size(); }
+        const std::vector<Entry>& entries() const noexcept { return entries_; }
+        NucleotideSequence alt_sequence(const Entry& entry) const;
+        const Observation& observation(std::uint32_t index) const noexcept { return observations_[index]; }
+        
+        void clear() noexcept;
+        
+    private:
+        static constexpr std::uint32_t empty_slot = std::numeric_limits<std::uint32_t>::max();
+        
+        std::vector<std::uint32_t> slots_;
+        std::vector<Entry> entries_;
+        std::vector<Observation> observations_;
+        NucleotideSequence long_alt_sequences_;
+        
+        const char* alt_data(const Entry& entry) const noexcept;
+        bool is_equal(const Entry& entry, ContigIndex contig, GenomicRegion::Position begin, GenomicRegion::Size ref_size,
+                      SequenceIterator alt_first, std::size_t alt_size) const noexcept;
+        void rehash(std::size_t num_slots);
+    };
+    
     struct Candidate : public Comparable<Candidate>, public Mappable<Candidate>
     {
         Variant variant;
-        std::reference_wrapper<const AlignedRead> source;
-        std::reference_wrapper<const SampleName> origin;
-        std::size_t offset;
+        std::uint32_t entry;
         
-        template <typename T1, typename T2, typename T3>
-        Candidate(T1&& region, T2&& sequence_removed, T3&& sequence_added,
-                  const AlignedRead& source, std::size_t offset,
-                  const SampleName& origin);
+        Candidate(Variant variant, std::uint32_t entry) : variant {std::move(variant)}, entry {entry} {}
         
         const GenomicRegion& mapped_region() const noexcept { return variant.mapped_region(); }
         
@@ -110,57 +176,43 @@ private:
         friend bool operator<(const Candidate& lhs, const Candidate& rhs) noexcept { return lhs.variant < rhs.variant; }
     };
     
-    using NucleotideSequence = AlignedRead::NucleotideSequence;
-    using SequenceIterator = NucleotideSequence::const_iterator;
+    struct PendingCandidate
+    {
+        GenomicRegion::Position begin;
+        GenomicRegion::Size ref_size;
+        std::size_t read_offset, alt_size;
+    };
+    
     using SampleCoverageTrackerMap = std::unordered_map<SampleName, CoverageTracker<GenomicRegion>>;
     
     std::reference_wrapper<const ReferenceGenome> reference_;
     Options options_;
-    std::vector<Candidate> buffer_;
-    mutable std::deque<Candidate> candidates_, likely_misaligned_candidates_;
+    std::vector<PendingCandidate> buffer_;
+    std::vector<GenomicRegion::ContigName> contigs_;
+    std::vector<std::reference_wrapper<const SampleName>> samples_;
+    CandidateTable candidate_table_, likely_misaligned_candidate_table_;
+    mutable std::vector<Candidate> candidates_;
+    mutable bool is_candidates_current_;
     Variant::MappingDomain::Size max_seen_candidate_size_;
     CoverageTracker<GenomicRegion> combined_read_coverage_tracker_, misaligned_read_coverage_tracker_;
     SampleCoverageTrackerMap sample_read_coverage_tracker_, sample_forward_strand_coverage_tracker_;
     
     using CandidateIterator = OverlapIterator<decltype(candidates_)::const_iterator>;
     
-    template <typename T1, typename T2, typename T3>
-    void add_candidate(T1&& region, T2&& sequence_removed, T3&& sequence_added,
-                       const AlignedRead& read, std::size_t offset, const SampleName& sample);
-    double add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read,
-                                   std::size_t read_index, const SampleName& origin);
+    void add_candidate(GenomicRegion::Position begin, GenomicRegion::Size ref_size,
+                       std::size_t read_offset, std::size_t alt_size);
+    double add_snvs_in_match_range(const GenomicRegion& region, const AlignedRead& read, std::size_t read_index);
+    CandidateTable::ContigIndex get_contig_index(const GenomicRegion::ContigName& contig);
+    CandidateTable::SampleIndex get_sample_index(const SampleName& sample);
+    void add_pending_candidates(const AlignedRead& read, CandidateTable::ContigIndex contig,
+                                CandidateTable::SampleIndex sample, CandidateTable& table) const;
+    std::vector<Candidate> make_candidates(const CandidateTable& table) const;
     void generate(const GenomicRegion& region, std::vector<Variant>& result) const;
-    unsigned sum_base_qualities(const Candidate& candidate) const noexcept;
     bool is_likely_misaligned(const AlignedRead& read, double penalty) const;
     VariantObservation make_observation(CandidateIterator first_match, CandidateIterator last_match) const;
     std::vector<Variant> get_novel_likely_misaligned_candidates(const std::vector<Variant>& current_candidates) const;
 };
 
-template <typename T1, typename T2, typename T3>
-CigarScanner::Candidate::Candidate(T1&& region, T2&& sequence_removed, T3&& sequence_added,
-                                   const AlignedRead& source, std::size_t offset,
-                                   const SampleName& origin)
-: variant {std::forward<T1>(region), std::forward<T2>(sequence_removed), std::forward<T3>(sequence_added)}
-, source {source}
-, origin {origin}
-, offset {offset}
-{}
-
-template <typename T1, typename T2, typename T3>
-void CigarScanner::add_candidate(T1&& region, T2&& sequence_removed, T3&& sequence_added,
-                                 const AlignedRead& read, const std::size_t offset,
-                                 const SampleName& sample)
-{
-    const auto candidate_size = size(region);
-    if (candidate_size <= options_.max_variant_size) {
-        buffer_.emplace_back(std::forward<T1>(region),
-                             std::forward<T2>(sequence_removed),
-                             std::forward<T3>(sequence_added),
-                             read, offset, sample);
-        max_seen_candidate_size_ = std::max(max_seen_candidate_size_, candidate_size);
-    }
-}
-
 struct KnownCopyNumberInclusionPredicate
 {
     KnownCopyNumberInclusionPredicate(unsigned copy_number = 2) : copy_number_ {copy_number} {}
@@ -6,9 +6,9 @@
 #include <algorithm>
 #include <iterator>
 #include <deque>
+#include <array>
+#include <atomic>
 #include <stdexcept>
-#include <thread>
-#include <future>
 #include <cassert>
 
 #include "tandem/tandem.hpp"
@@ -23,6 +23,7 @@
 #include "utils/global_aligner.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/free_memory.hpp"
+#include "utils/parallel_transform.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "logging/logging.hpp"
 
@@ -349,40 +350,10 @@ std::vector<Variant> LocalReassembler::do_generate(const RegionSet& regions) con
     finalise_bins(bins, regions);
     if (bins.empty()) return {};
     std::deque<Variant> candidates {};
-    if (execution_policy_ == ExecutionPolicy::seq || bins.size() < 2) {
-        for (auto& bin : bins) {
-            if (debug_log_) {
-                stream(*debug_log_) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
-            }
-            const auto num_default_failures = try_assemble_with_defaults(bin, candidates);
-            if (num_default_failures == default_kmer_sizes_.size()) {
-                try_assemble_with_fallbacks(bin, candidates);
-            }
-            bin.clear();
-        }
+    if (execution_policy_ == ExecutionPolicy::seq) {
+        assemble(bins, candidates);
     } else {
-        const std::size_t num_threads {4};
-        std::vector<std::future<std::deque<Variant>>> bin_futures(std::min(bins.size(), num_threads));
-        for (auto first_bin = std::begin(bins), last_bin = std::end(bins); first_bin != last_bin; ) {
-            const auto batch_size = std::min(num_threads, static_cast<std::size_t>(std::distance(first_bin, last_bin)));
-            const auto next_bin = std::next(first_bin, batch_size);
-            auto last_future = std::transform(first_bin, next_bin, std::begin(bin_futures), [&] (Bin& bin) {
-                if (debug_log_) {
-                    stream(*debug_log_) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
-                }
-                return std::async([&] () {
-                    std::deque<Variant> result {};
-                    const auto num_default_failures = try_assemble_with_defaults(bin, result);
-                    if (num_default_failures == default_kmer_sizes_.size()) {
-                        try_assemble_with_fallbacks(bin, result);
-                    }
-                    bin.clear();
-                    return result;
-                });
-            });
-            std::for_each(std::begin(bin_futures), last_future, [&] (auto& f) { utils::append(f.get(), candidates); });
-            first_bin = next_bin;
-        }
+        parallel_assemble(bins, candidates);
     }
     remove_duplicates(candidates);
     remove_larger_than(candidates, max_variant_size_);
@@ -487,53 +458,167 @@ void log_failure(L& log, const char* type, const unsigned k)
     if (log) stream(*log, 8) << type << " assembler with kmer size " << k << " failed";
 }
 
+template <typename L, typename B>
+void log_assembling(L& log, const B& bin)
+{
+    if (log) stream(*log) << "Assembling " << bin.size() << " reads in bin " << mapped_region(bin);
+}
+
+template <typename L, typename S>
+void log_status(L& log, const char* type, const unsigned k, const S status)
+{
+    switch (status) {
+        case S::success:
+            log_success(log, type, k);
+            break;
+        case S::partial_success:
+            log_partial_success(log, type, k);
+            break;
+        default:
+            log_failure(log, type, k);
+    }
+}
+
 } // namespace
 
+void LocalReassembler::assemble(BinList& bins, std::deque<Variant>& result) const
+{
+    std::vector<AssemblerStatus> fallback_statuses {};
+    for (auto& bin : bins) {
+        log_assembling(debug_log_, bin);
+        const auto num_default_failures = try_assemble_with_defaults(bin, result);
+        if (num_default_failures == default_kmer_sizes_.size()) {
+            fallback_statuses.clear();
+            try_assemble_with_fallbacks(bin, result, fallback_statuses);
+            log_fallback_statuses(fallback_statuses);
+        }
+        bin.clear();
+    }
+}
+
+void LocalReassembler::parallel_assemble(BinList& bins, std::deque<Variant>& result) const
+{
+    // Every bin and default kmer size pair is independent, so all are run as separate tasks
+    // rather than one task per bin, otherwise a single complex bin holds up the whole batch.
+    // Results and statuses are kept per task, then merged and logged in the same order as
+    // the sequential version once all tasks are done, as the debug log is not thread-safe.
+    const auto num_kmer_sizes = default_kmer_sizes_.size();
+    std::vector<std::deque<Variant>> default_candidates(bins.size() * num_kmer_sizes);
+    std::vector<AssemblerStatus> default_statuses(default_candidates.size(), AssemblerStatus::failed);
+    parallel_for(default_candidates.size(), [&] (const std::size_t i) {
+        const auto k = default_kmer_sizes_[i % num_kmer_sizes];
+        default_statuses[i] = assemble_bin(k, bins[i / num_kmer_sizes], default_candidates[i]);
+    });
+    std::vector<std::size_t> fallback_bins {};
+    for (std::size_t bin_idx {0}; bin_idx < bins.size(); ++bin_idx) {
+        const auto first_status = std::next(std::cbegin(default_statuses), bin_idx * num_kmer_sizes);
+        if (std::none_of(first_status, std::next(first_status, num_kmer_sizes),
+                         [] (auto status) { return status == AssemblerStatus::success; })) {
+            fallback_bins.push_back(bin_idx);
+        }
+    }
+    std::vector<std::deque<Variant>> fallback_candidates(fallback_bins.size());
+    std::vector<std::vector<AssemblerStatus>> fallback_statuses(fallback_bins.size());
+    parallel_for(fallback_bins.size(), [&] (const std::size_t i) {
+        try_assemble_with_fallbacks(bins[fallback_bins[i]], fallback_candidates[i], fallback_statuses[i]);
+    });
+    auto fallback_itr = std::cbegin(fallback_bins);
+    for (std::size_t bin_idx {0}; bin_idx < bins.size(); ++bin_idx) {
+        log_assembling(debug_log_, bins[bin_idx]);
+        for (std::size_t k_idx {0}; k_idx < num_kmer_sizes; ++k_idx) {
+            const auto task_idx = bin_idx * num_kmer_sizes + k_idx;
+            log_status(debug_log_, "Default", default_kmer_sizes_[k_idx], default_statuses[task_idx]);
+            utils::append(std::move(default_candidates[task_idx]), result);
+        }
+        if (fallback_itr != std::cend(fallback_bins) && *fallback_itr == bin_idx) {
+            const auto fallback_idx = std::distance(std::cbegin(fallback_bins), fallback_itr);
+            log_fallback_statuses(fallback_statuses[fallback_idx]);
+            utils::append(std::move(fallback_candidates[fallback_idx]), result);
+            ++fallback_itr;
+        }
+        bins[bin_idx].clear();
+    }
+}
+
 unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const
 {
     unsigned num_failures {0};
     for (const auto k : default_kmer_sizes_) {
         const auto status = assemble_bin(k, bin, result);
-        switch (status) {
-            case AssemblerStatus::success:
-                log_success(debug_log_, "Default", k);
-                break;
-            case AssemblerStatus::partial_success:
-                log_partial_success(debug_log_, "Default", k);
-                ++num_failures;
-                break;
-            default:
-                log_failure(debug_log_, "Default", k);
-                ++num_failures;
-        }
+        log_status(debug_log_, "Default", k, status);
+        if (status != AssemblerStatus::success) ++num_failures;
     }
     return num_failures;
 }
 
-void LocalReassembler::try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const
+void LocalReassembler::try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result,
+                                                   std::vector<AssemblerStatus>& statuses) const
 {
+    if (execution_policy_ != ExecutionPolicy::seq && fallback_kmer_sizes_.size() > 1) {
+        parallel_try_assemble_with_fallbacks(bin, result, statuses);
+        return;
+    }
     auto prev_k = default_kmer_sizes_.back();
     for (const auto k : fallback_kmer_sizes_) {
         const auto status = assemble_bin(k, bin, result);
-        switch (status) {
-            case AssemblerStatus::success:
-                log_success(debug_log_, "Fallback", k);
-                if (k - prev_k > 5) {
-                    const auto gap = k - prev_k;
-                    assemble_bin(k - gap / 2, bin, result);
-                    assemble_bin(k + gap / 2, bin, result);
-                }
-                return;
-            case AssemblerStatus::partial_success:
-                log_partial_success(debug_log_, "Fallback", k);
-                break;
-            default:
-                log_failure(debug_log_, "Fallback", k);
+        statuses.push_back(status);
+        if (status == AssemblerStatus::success) {
+            if (k - prev_k > 5) {
+                const auto gap = k - prev_k;
+                assemble_bin(k - gap / 2, bin, result);
+                assemble_bin(k + gap / 2, bin, result);
+            }
+            return;
+        }
+        prev_k = k;
+    }
+}
+
+void LocalReassembler::parallel_try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result,
+                                                            std::vector<AssemblerStatus>& statuses) const
+{
+    // All fallback sizes are tried speculatively; sizes after the first success are
+    // discarded so the result matches the sequential version.
+    const auto num_fallbacks = fallback_kmer_sizes_.size();
+    std::vector<std::deque<Variant>> fallback_candidates(num_fallbacks);
+    std::vector<AssemblerStatus> speculative_statuses(num_fallbacks, AssemblerStatus::failed);
+    std::atomic<std::size_t> first_success {num_fallbacks};
+    parallel_for(num_fallbacks, [&] (const std::size_t i) {
+        if (i > first_success.load()) return;
+        speculative_statuses[i] = assemble_bin(fallback_kmer_sizes_[i], bin, fallback_candidates[i]);
+        if (speculative_statuses[i] == AssemblerStatus::success) {
+            auto prev_first_success = first_success.load();
+            while (i < prev_first_success && !first_success.compare_exchange_weak(prev_first_success, i)) {}
+        }
+    });
+    auto prev_k = default_kmer_sizes_.back();
+    for (std::size_t i {0}; i < num_fallbacks; ++i) {
+        const auto k = fallback_kmer_sizes_[i];
+        statuses.push_back(speculative_statuses[i]);
+        utils::append(std::move(fallback_candidates[i]), result);
+        if (speculative_statuses[i] == AssemblerStatus::success) {
+            if (k - prev_k > 5) {
+                const auto gap = k - prev_k;
+                const std::array<unsigned, 2> gap_kmer_sizes {k - gap / 2, k + gap / 2};
+                std::array<std::deque<Variant>, 2> gap_candidates {};
+                parallel_for(gap_kmer_sizes.size(), [&] (const std::size_t j) {
+                    assemble_bin(gap_kmer_sizes[j], bin, gap_candidates[j]);
+                });
+                for (auto& candidates : gap_candidates) utils::append(std::move(candidates), result);
+            }
+            return;
         }
         prev_k = k;
     }
 }
 
+void LocalReassembler::log_fallback_statuses(const std::vector<AssemblerStatus>& statuses) const
+{
+    for (std::size_t i {0}; i < statuses.size(); ++i) {
+        log_status(debug_log_, "Fallback", fallback_kmer_sizes_[i], statuses[i]);
+    }
+}
+
 GenomicRegion LocalReassembler::propose_assembler_region(const GenomicRegion& input_region, unsigned kmer_size) const
 {
     if (input_region.begin() < kmer_size) {
@@ -130,8 +130,14 @@ private:
     void prepare_bins(const GenomicRegion& active_region, BinList& bins) const;
     bool should_assemble_bin(const Bin& bin) const;
     void finalise_bins(BinList& bins, const RegionSet& active_regions) const;
+    void assemble(BinList& bins, std::deque<Variant>& result) const;
+    void parallel_assemble(BinList& bins, std::deque<Variant>& result) const;
     unsigned try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const;
-    void try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const;
+    void try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result,
+                                     std::vector<AssemblerStatus>& statuses) const;
+    void parallel_try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result,
+                                              std::vector<AssemblerStatus>& statuses) const;
+    void log_fallback_statuses(const std::vector<AssemblerStatus>& statuses) const;
     GenomicRegion propose_assembler_region(const GenomicRegion& input_region, unsigned kmer_size) const;
     void load(const Bin& bin, Assembler& assembler) const;
     AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const;
@@ -115,12 +115,12 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
         auto base_quality_itr = std::next(std::cbegin(base_qualities), kmer_size());
         Kmer prev_kmer {kmer_begin, kmer_end};
         bool prev_kmer_good {true};
-        auto vertex_itr = vertex_cache_.find(prev_kmer);
+        const auto prev_vertex = vertex_cache_.find(prev_kmer);
         auto ref_kmer_itr = std::cbegin(reference_kmers_);
-        if (vertex_itr == std::cend(vertex_cache_)) {
+        if (!prev_vertex) {
             const auto u = add_vertex(prev_kmer);
             if (!u) prev_kmer_good = false;
-        } else if (is_reference(vertex_itr->second)) {
+        } else if (is_reference(*prev_vertex)) {
             ref_kmer_itr = std::find(std::cbegin(reference_kmers_), std::cend(reference_kmers_), prev_kmer);
             assert(ref_kmer_itr != std::cend(reference_kmers_));
             auto next_kmer_begin = std::next(kmer_begin);
@@ -149,9 +149,10 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
         ++kmer_begin;
         ++kmer_end;
         for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end, ++base_quality_itr) {
-            Kmer kmer {kmer_begin, kmer_end};
-            const auto kmer_itr = vertex_cache_.find(kmer);
-            if (kmer_itr == std::cend(vertex_cache_)) {
+            Kmer kmer {prev_kmer.next()};
+            assert(kmer.begin() == kmer_begin && kmer.end() == kmer_end);
+            const auto kmer_vertex = vertex_cache_.find(kmer);
+            if (!kmer_vertex) {
                 const auto v = add_vertex(kmer);
                 if (v) {
                     if (prev_kmer_good) {
@@ -166,7 +167,7 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
             } else {
                 if (prev_kmer_good) {
                     const auto u = vertex_cache_.at(prev_kmer);
-                    const auto v = kmer_itr->second;
+                    const auto v = *kmer_vertex;
                     Edge e; bool e_in_graph;
                     std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
                     if (e_in_graph) {
@@ -175,7 +176,7 @@ void Assembler::insert_read(const NucleotideSequence& sequence,
                         add_edge(u, v, 1, is_forward_strand, *base_quality_itr);
                     }
                 }
-                if (is_reference(kmer_itr->second)) {
+                if (is_reference(*kmer_vertex)) {
                     ref_kmer_itr = std::find(ref_kmer_itr, std::cend(reference_kmers_), kmer);
                     if (ref_kmer_itr != std::cend(reference_kmers_)) {
                         auto next_kmer_begin = std::next(kmer_begin);
@@ -374,10 +375,72 @@ void Assembler::write_dot(std::ostream& out) const
 }
 
 // Kmer
+
+namespace {
+
+constexpr std::size_t max_packed_kmer_size {32};
+
+constexpr std::int8_t non_canonical_code {-1};
+
+std::int8_t pack(const char base) noexcept
+{
+    switch (base) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return non_canonical_code;
+    }
+}
+
+template <typename ForwardIt>
+boost::optional<std::uint64_t> pack(ForwardIt first, const ForwardIt last) noexcept
+{
+    if (static_cast<std::size_t>(std::distance(first, last)) > max_packed_kmer_size) return boost::none;
+    std::uint64_t result {0};
+    for (; first != last; ++first) {
+        const auto code = pack(*first);
+        if (code == non_canonical_code) return boost::none;
+        result = (result << 2) | static_cast<std::uint64_t>(code);
+    }
+    return result;
+}
+
+std::size_t hash_code(std::uint64_t code) noexcept
+{
+    // MurmurHash3 finaliser: the low bits are used to index the vertex table
+    code ^= code >> 33;
+    code *= 0xff51afd7ed558ccdULL;
+    code ^= code >> 33;
+    code *= 0xc4ceb9fe1a85ec53ULL;
+    code ^= code >> 33;
+    return static_cast<std::size_t>(code);
+}
+
+} // namespace
+
 Assembler::Kmer::Kmer(SequenceIterator first, SequenceIterator last) noexcept
 : first_ {first}
 , last_ {last}
-, hash_ {boost::hash_range(first_, last_)}
+{
+    const auto code = pack(first_, last_);
+    if (code) {
+        code_ = *code;
+        hash_ = hash_code(code_);
+        is_packed_ = true;
+    } else {
+        code_ = 0;
+        hash_ = boost::hash_range(first_, last_);
+        is_packed_ = false;
+    }
+}
+
+Assembler::Kmer::Kmer(SequenceIterator first, SequenceIterator last, std::uint64_t code) noexcept
+: first_ {first}
+, last_ {last}
+, code_ {code}
+, hash_ {hash_code(code)}
+, is_packed_ {true}
 {}
 
 char Assembler::Kmer::front() const noexcept
@@ -410,15 +473,167 @@ std::size_t Assembler::Kmer::hash() const noexcept
     return hash_;
 }
 
+Assembler::Kmer Assembler::Kmer::next() const noexcept
+{
+    if (is_packed_) {
+        const auto code = pack(*last_);
+        if (code != non_canonical_code) {
+            const auto k = static_cast<std::size_t>(std::distance(first_, last_));
+            const auto mask = k < max_packed_kmer_size ? (std::uint64_t {1} << (2 * k)) - 1 : ~std::uint64_t {0};
+            return Kmer {std::next(first_), std::next(last_), ((code_ << 2) | static_cast<std::uint64_t>(code)) & mask};
+        }
+    }
+    return Kmer {std::next(first_), std::next(last_)};
+}
+
 bool operator==(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
 {
-    return std::equal(lhs.first_, lhs.last_, rhs.first_);
+    if (lhs.is_packed_ && rhs.is_packed_) return lhs.code_ == rhs.code_;
+    // A packed and an unpacked kmer of the same size cannot be equal
+    if (lhs.is_packed_ || rhs.is_packed_) return false;
+    return lhs.hash_ == rhs.hash_ && std::equal(lhs.first_, lhs.last_, rhs.first_);
 }
 
 bool operator<(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
 {
+    // The 2-bit code preserves lexicographical order of ACGT
+    if (lhs.is_packed_ && rhs.is_packed_) return lhs.code_ < rhs.code_;
     return std::lexicographical_compare(lhs.first_, lhs.last_, rhs.first_, rhs.last_);
 }
+
+// KmerVertexMap
+
+std::size_t Assembler::KmerVertexMap::size() const noexcept
+{
+    return entries_.size();
+}
+
+bool Assembler::KmerVertexMap::empty() const noexcept
+{
+    return entries_.empty();
+}
+
+const Assembler::Vertex* Assembler::KmerVertexMap::find(const Kmer& kmer) const noexcept
+{
+    if (slots_.empty()) return nullptr;
+    const auto slot = slots_[find_slot(kmer)];
+    return slot > 0 ? &entries_[slot - 1].second : nullptr;
+}
+
+std::size_t Assembler::KmerVertexMap::count(const Kmer& kmer) const noexcept
+{
+    return find(kmer) != nullptr ? 1 : 0;
+}
+
+Assembler::Vertex Assembler::KmerVertexMap::at(const Kmer& kmer) const
+{
+    const auto result = find(kmer);
+    if (result == nullptr) {
+        throw std::out_of_range {"KmerVertexMap::at"};
+    }
+    return *result;
+}
+
+bool Assembler::KmerVertexMap::emplace(const Kmer& kmer, const Vertex v)
+{
+    // Keep the load factor at most 1/2 so probe sequences stay short
+    if (2 * (entries_.size() + 1) > slots_.size()) {
+        rehash(std::max(slots_.size() * 2, std::size_t {16}));
+    }
+    const auto slot_idx = find_slot(kmer);
+    if (slots_[slot_idx] > 0) return false;
+    entries_.emplace_back(kmer, v);
+    slots_[slot_idx] = static_cast<Slot>(entries_.size());
+    return true;
+}
+
+std::size_t Assembler::KmerVertexMap::erase(const Kmer& kmer)
+{
+    if (slots_.empty()) return 0;
+    auto hole = find_slot(kmer);
+    if (slots_[hole] == 0) return 0;
+    const auto entry_idx = slots_[hole] - 1;
+    // Backward shift deletion, so lookups never need to skip over tombstones
+    const auto mask = slots_.size() - 1;
+    for (auto idx = (hole + 1) & mask; slots_[idx] > 0; idx = (idx + 1) & mask) {
+        const auto home = home_slot(entries_[slots_[idx] - 1].first);
+        if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+            slots_[hole] = slots_[idx];
+            hole = idx;
+        }
+    }
+    slots_[hole] = 0;
+    // Keep entries contiguous by moving the last entry into the erased one
+    const auto last_idx = entries_.size() - 1;
+    if (entry_idx != last_idx) {
+        auto idx = home_slot(entries_.back().first);
+        while (slots_[idx] != last_idx + 1) idx = (idx + 1) & mask;
+        slots_[idx] = static_cast<Slot>(entry_idx + 1);
+        entries_[entry_idx] = std::move(entries_.back());
+    }
+    entries_.pop_back();
+    return 1;
+}
+
+namespace {
+
+std::size_t num_slots_for(const std::size_t n) noexcept
+{
+    std::size_t result {16};
+    while (result < 2 * n) result *= 2;
+    return result;
+}
+
+} // namespace
+
+void Assembler::KmerVertexMap::reserve(const std::size_t n)
+{
+    entries_.reserve(n);
+    const auto num_slots = num_slots_for(n);
+    if (num_slots > slots_.size()) rehash(num_slots);
+}
+
+void Assembler::KmerVertexMap::shrink_to_fit()
+{
+    entries_.shrink_to_fit();
+    const auto num_slots = num_slots_for(entries_.size());
+    if (num_slots < slots_.size()) rehash(num_slots);
+}
+
+void Assembler::KmerVertexMap::clear() noexcept
+{
+    entries_.clear();
+    std::fill(std::begin(slots_), std::end(slots_), 0);
+}
+
+std::size_t Assembler::KmerVertexMap::home_slot(const Kmer& kmer) const noexcept
+{
+    return kmer.hash() & (slots_.size() - 1);
+}
+
+std::size_t Assembler::KmerVertexMap::find_slot(const Kmer& kmer) const noexcept
+{
+    const auto mask = slots_.size() - 1;
+    auto idx = home_slot(kmer);
+    while (slots_[idx] > 0) {
+        const auto& entry = entries_[slots_[idx] - 1].first;
+        if (entry.hash() == kmer.hash() && entry == kmer) break;
+        idx = (idx + 1) & mask;
+    }
+    return idx;
+}
+
+void Assembler::KmerVertexMap::rehash(const std::size_t num_slots)
+{
+    assert(num_slots >= 2 * entries_.size() && (num_slots & (num_slots - 1)) == 0);
+    slots_.assign(num_slots, 0);
+    const auto mask = num_slots - 1;
+    for (std::size_t i {0}; i < entries_.size(); ++i) {
+        auto idx = home_slot(entries_[i].first);
+        while (slots_[idx] > 0) idx = (idx + 1) & mask;
+        slots_[idx] = static_cast<Slot>(i + 1);
+    }
+}
 //
 // Assembler private methods
 //
@@ -426,6 +641,8 @@ void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequ
 {
     assert(sequence.size() >= kmer_size());
     vertex_cache_.reserve(sequence.size() + std::pow(4, 5));
+    const auto num_reference_kmers = count_kmers(sequence, kmer_size());
+    graph_.reserve(2 * num_reference_kmers, 2 * num_reference_kmers);
     auto kmer_begin = std::cbegin(sequence);
     auto kmer_end   = std::next(kmer_begin, kmer_size());
     reference_kmers_.emplace_back(kmer_begin, kmer_end);
@@ -441,7 +658,7 @@ void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequ
     ++kmer_begin;
     ++kmer_end;
     for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
+        reference_kmers_.push_back(reference_kmers_.back().next());
         const auto& kmer = reference_kmers_.back();
         if (!contains_kmer(kmer)) {
             const auto v = add_vertex(kmer, true);
@@ -489,7 +706,7 @@ void Assembler::insert_reference_into_populated_graph(const NucleotideSequence&
     ++kmer_begin;
     ++kmer_end;
     for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
+        reference_kmers_.push_back(reference_kmers_.back().next());
         if (!contains_kmer(reference_kmers_.back())) {
             const auto v = add_vertex(reference_kmers_.back(), true);
             if (v) {
@@ -515,7 +732,7 @@ void Assembler::insert_reference_into_populated_graph(const NucleotideSequence&
             reference_edges_.push_back(e);
         }
     }
-    vertex_cache_.rehash(vertex_cache_.size());
+    vertex_cache_.shrink_to_fit();
     reference_kmers_.shrink_to_fit();
     reference_vertices_.shrink_to_fit();
     reference_edges_.shrink_to_fit();
@@ -751,9 +968,9 @@ boost::optional<Assembler::Vertex> Assembler::find_joining_kmer(const Vertex v)
     for (const auto base : bases) {
         adjacent_kmer.back() = base;
         const Kmer k {std::cbegin(adjacent_kmer), std::cend(adjacent_kmer)};
-        const auto itr = vertex_cache_.find(k);
-        if (itr != std::cend(vertex_cache_)) {
-            return itr->second;
+        const auto v = vertex_cache_.find(k);
+        if (v) {
+            return *v;
         }
     }
     return boost::none;
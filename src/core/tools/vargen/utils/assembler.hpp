@@ -10,16 +10,18 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <tuple>
 #include <stdexcept>
 #include <iosfwd>
 
-#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/graph_traits.hpp>
 #include <boost/optional.hpp>
 
 #include "concepts/equitable.hpp"
 #include "concepts/comparable.hpp"
+#include "flat_digraph.hpp"
 
 namespace octopus { namespace coretools { class Assembler; }}
 
@@ -99,6 +101,8 @@ public:
     void write_dot(std::ostream& out) const;
     
 private:
+    // Kmers of up to 32 canonical bases are also packed into a 2-bit code, which makes hashing
+    // and comparison a single integer operation. Other kmers compare by sequence.
     class Kmer : public Comparable<Kmer>
     {
     public:
@@ -125,21 +129,23 @@ private:
         
         std::size_t hash() const noexcept;
         
+        // The kmer starting one base further along the same sequence
+        Kmer next() const noexcept;
+        
         friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
         friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
     private:
         SequenceIterator first_, last_;
+        std::uint64_t code_;
         std::size_t hash_;
+        bool is_packed_;
+        
+        Kmer(SequenceIterator first, SequenceIterator last, std::uint64_t code) noexcept;
     };
     
     friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
     friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
     
-    struct KmerHash
-    {
-        std::size_t operator()(const Kmer& k) const noexcept { return k.hash(); }
-    };
-    
     struct GraphEdge
     {
         using WeightType = unsigned;
@@ -156,7 +162,9 @@ private:
         bool is_reference = false;
     };
     
-    using KmerGraph = boost::adjacency_list<boost::listS, boost::listS, boost::bidirectionalS, GraphNode, GraphEdge>;
+    // Vertices and edges are kept in contiguous arrays, but the graph still models the boost graph
+    // concepts, as cycle removal, bubble extraction and the k-shortest path search use boost algorithms.
+    using KmerGraph = FlatDigraph<GraphNode, GraphEdge>;
     
     using Vertex = boost::graph_traits<KmerGraph>::vertex_descriptor;
     using Edge   = boost::graph_traits<KmerGraph>::edge_descriptor;
@@ -164,6 +172,45 @@ private:
     using VertexIterator = boost::graph_traits<KmerGraph>::vertex_iterator;
     using EdgeIterator   = boost::graph_traits<KmerGraph>::edge_iterator;
     
+    // Open addressing kmer index. Entries are stored contiguously and located with a linear
+    // probing table of entry offsets, so a lookup rarely touches more than two cache lines.
+    class KmerVertexMap
+    {
+    public:
+        KmerVertexMap() = default;
+        
+        KmerVertexMap(const KmerVertexMap&)            = default;
+        KmerVertexMap& operator=(const KmerVertexMap&) = default;
+        KmerVertexMap(KmerVertexMap&&)                 = default;
+        KmerVertexMap& operator=(KmerVertexMap&&)      = default;
+        
+        ~KmerVertexMap() = default;
+        
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+        
+        const Vertex* find(const Kmer& kmer) const noexcept;
+        std::size_t count(const Kmer& kmer) const noexcept;
+        Vertex at(const Kmer& kmer) const;
+        
+        bool emplace(const Kmer& kmer, Vertex v);
+        std::size_t erase(const Kmer& kmer);
+        
+        void reserve(std::size_t n);
+        void shrink_to_fit();
+        void clear() noexcept;
+        
+    private:
+        using Slot = std::uint32_t; // entry offset + 1, or 0 if empty
+        
+        std::vector<std::pair<Kmer, Vertex>> entries_;
+        std::vector<Slot> slots_;
+        
+        std::size_t home_slot(const Kmer& kmer) const noexcept;
+        std::size_t find_slot(const Kmer& kmer) const noexcept;
+        void rehash(std::size_t num_slots);
+    };
+    
     using DominatorMap = std::unordered_map<Vertex, Vertex>;
     
     using Path = std::deque<Vertex>;
@@ -192,7 +239,7 @@ private:
     
     KmerGraph graph_;
     
-    std::unordered_map<Kmer, Vertex, KmerHash> vertex_cache_;
+    KmerVertexMap vertex_cache_;
     Path reference_vertices_;
     std::deque<Edge> reference_edges_;
     
@@ -0,0 +1,577 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef flat_digraph_hpp
+#define flat_digraph_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cassert>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/pending/property.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace octopus { namespace coretools {
+
+// A bidirectional graph with bundled vertex and edge properties, stored in two contiguous arrays.
+// Each vertex heads doubly linked lists of its out and in edges, which are threaded through the
+// edge array, so walking adjacencies never leaves the two arrays.
+//
+// Removed vertices and edges are left in place and skipped, so descriptors stay valid and
+// vertices, edges and adjacencies are visited in insertion order, as with a listS
+// boost::adjacency_list. The space is only reclaimed by clear().
+//
+// The free functions below model the boost graph concepts, so boost graph algorithms can be used
+// directly. There is no internal vertex index; pass one with vertex_index_map.
+template <typename VertexBundle, typename EdgeBundle>
+class FlatDigraph
+{
+    using Index = std::uint32_t;
+    static constexpr Index null_index {std::numeric_limits<Index>::max()};
+
+public:
+    using vertex_descriptor = Index;
+
+    class edge_descriptor
+    {
+    public:
+        edge_descriptor() = default;
+        explicit edge_descriptor(Index index) noexcept : index_ {index} {}
+
+        friend bool operator==(const edge_descriptor& lhs, const edge_descriptor& rhs) noexcept { return lhs.index_ == rhs.index_; }
+        friend bool operator!=(const edge_descriptor& lhs, const edge_descriptor& rhs) noexcept { return lhs.index_ != rhs.index_; }
+        friend bool operator<(const edge_descriptor& lhs, const edge_descriptor& rhs) noexcept { return lhs.index_ < rhs.index_; }
+    private:
+        Index index_ = null_index;
+
+        friend FlatDigraph;
+    };
+
+private:
+    // Each step moves from one position in the vertex or edge array to the next
+    template <typename Step, typename Value>
+    class Iterator : public boost::iterator_facade<Iterator<Step, Value>, Value, boost::forward_traversal_tag, Value>
+    {
+    public:
+        Iterator() = default;
+        Iterator(const FlatDigraph* graph, Index index) noexcept : graph_ {graph}, index_ {index} {}
+    private:
+        const FlatDigraph* graph_ = nullptr;
+        Index index_ = null_index;
+
+        friend boost::iterator_core_access;
+
+        Value dereference() const { return Step::dereference(*graph_, index_); }
+        bool equal(const Iterator& other) const noexcept { return index_ == other.index_; }
+        void increment() noexcept { index_ = Step::next(*graph_, index_); }
+    };
+
+    struct VertexStep
+    {
+        static vertex_descriptor dereference(const FlatDigraph&, Index v) noexcept { return v; }
+        static Index next(const FlatDigraph& g, Index v) noexcept { return g.next_vertex(v + 1); }
+    };
+    struct EdgeStep
+    {
+        static edge_descriptor dereference(const FlatDigraph&, Index e) noexcept { return edge_descriptor {e}; }
+        static Index next(const FlatDigraph& g, Index e) noexcept { return g.next_edge(e + 1); }
+    };
+    struct OutEdgeStep : public EdgeStep
+    {
+        static Index next(const FlatDigraph& g, Index e) noexcept { return g.edges_[e].next_out; }
+    };
+    struct InEdgeStep : public EdgeStep
+    {
+        static Index next(const FlatDigraph& g, Index e) noexcept { return g.edges_[e].next_in; }
+    };
+    struct AdjacentStep : public OutEdgeStep
+    {
+        static vertex_descriptor dereference(const FlatDigraph& g, Index e) noexcept { return g.edges_[e].target; }
+    };
+    struct InvAdjacentStep : public InEdgeStep
+    {
+        static vertex_descriptor dereference(const FlatDigraph& g, Index e) noexcept { return g.edges_[e].source; }
+    };
+
+public:
+    using directed_category      = boost::bidirectional_tag;
+    using edge_parallel_category = boost::allow_parallel_edge_tag;
+    struct traversal_category
+    : public boost::bidirectional_graph_tag
+    , public boost::adjacency_graph_tag
+    , public boost::vertex_list_graph_tag
+    , public boost::edge_list_graph_tag {};
+
+    using vertex_iterator        = Iterator<VertexStep, vertex_descriptor>;
+    using edge_iterator          = Iterator<EdgeStep, edge_descriptor>;
+    using out_edge_iterator      = Iterator<OutEdgeStep, edge_descriptor>;
+    using in_edge_iterator       = Iterator<InEdgeStep, edge_descriptor>;
+    using adjacency_iterator     = Iterator<AdjacentStep, vertex_descriptor>;
+    using inv_adjacency_iterator = Iterator<InvAdjacentStep, vertex_descriptor>;
+
+    using vertices_size_type = std::size_t;
+    using edges_size_type    = std::size_t;
+    using degree_size_type   = std::size_t;
+
+    using vertex_bundled = VertexBundle;
+    using edge_bundled   = EdgeBundle;
+    using graph_bundled  = boost::no_property;
+
+    FlatDigraph() = default;
+
+    FlatDigraph(const FlatDigraph&)            = default;
+    FlatDigraph& operator=(const FlatDigraph&) = default;
+    FlatDigraph(FlatDigraph&&)                 = default;
+    FlatDigraph& operator=(FlatDigraph&&)      = default;
+
+    ~FlatDigraph() = default;
+
+    static vertex_descriptor null_vertex() noexcept { return null_index; }
+
+    VertexBundle& operator[](vertex_descriptor v) noexcept { return vertices_[v].bundle; }
+    const VertexBundle& operator[](vertex_descriptor v) const noexcept { return vertices_[v].bundle; }
+    EdgeBundle& operator[](edge_descriptor e) noexcept { return edges_[e.index_].bundle; }
+    const EdgeBundle& operator[](edge_descriptor e) const noexcept { return edges_[e.index_].bundle; }
+
+    std::size_t num_vertices() const noexcept { return num_vertices_; }
+    std::size_t num_edges() const noexcept { return num_edges_; }
+
+    vertex_descriptor source(edge_descriptor e) const noexcept { return edges_[e.index_].source; }
+    vertex_descriptor target(edge_descriptor e) const noexcept { return edges_[e.index_].target; }
+    std::size_t out_degree(vertex_descriptor v) const noexcept { return vertices_[v].out_degree; }
+    std::size_t in_degree(vertex_descriptor v) const noexcept { return vertices_[v].in_degree; }
+
+    std::pair<vertex_iterator, vertex_iterator> vertices() const noexcept
+    {
+        return {vertex_iterator {this, next_vertex(0)}, vertex_iterator {this, null_index}};
+    }
+    std::pair<edge_iterator, edge_iterator> edges() const noexcept
+    {
+        return {edge_iterator {this, next_edge(0)}, edge_iterator {this, null_index}};
+    }
+    std::pair<out_edge_iterator, out_edge_iterator> out_edges(vertex_descriptor v) const noexcept
+    {
+        return {out_edge_iterator {this, vertices_[v].first_out}, out_edge_iterator {this, null_index}};
+    }
+    std::pair<in_edge_iterator, in_edge_iterator> in_edges(vertex_descriptor v) const noexcept
+    {
+        return {in_edge_iterator {this, vertices_[v].first_in}, in_edge_iterator {this, null_index}};
+    }
+    std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices(vertex_descriptor v) const noexcept
+    {
+        return {adjacency_iterator {this, vertices_[v].first_out}, adjacency_iterator {this, null_index}};
+    }
+    std::pair<inv_adjacency_iterator, inv_adjacency_iterator> inv_adjacent_vertices(vertex_descriptor v) const noexcept
+    {
+        return {inv_adjacency_iterator {this, vertices_[v].first_in}, inv_adjacency_iterator {this, null_index}};
+    }
+
+    // The first u -> v edge, as boost::edge
+    std::pair<edge_descriptor, bool> edge(vertex_descriptor u, vertex_descriptor v) const noexcept
+    {
+        for (auto e = vertices_[u].first_out; e != null_index; e = edges_[e].next_out) {
+            if (edges_[e].target == v) return {edge_descriptor {e}, true};
+        }
+        return {edge_descriptor {}, false};
+    }
+
+    vertex_descriptor add_vertex(VertexBundle bundle)
+    {
+        assert(vertices_.size() < null_index);
+        vertices_.emplace_back(std::move(bundle));
+        ++num_vertices_;
+        return static_cast<vertex_descriptor>(vertices_.size() - 1);
+    }
+
+    // The vertex must have no edges
+    void remove_vertex(vertex_descriptor v) noexcept
+    {
+        assert(!vertices_[v].is_removed && vertices_[v].out_degree == 0 && vertices_[v].in_degree == 0);
+        vertices_[v].is_removed = true;
+        --num_vertices_;
+    }
+
+    edge_descriptor add_edge(vertex_descriptor u, vertex_descriptor v, EdgeBundle bundle)
+    {
+        assert(edges_.size() < null_index);
+        const auto e = static_cast<Index>(edges_.size());
+        auto& source = vertices_[u];
+        auto& target = vertices_[v];
+        edges_.emplace_back(std::move(bundle), u, v, source.last_out, target.last_in);
+        if (source.last_out != null_index) {
+            edges_[source.last_out].next_out = e;
+        } else {
+            source.first_out = e;
+        }
+        source.last_out = e;
+        ++source.out_degree;
+        if (target.last_in != null_index) {
+            edges_[target.last_in].next_in = e;
+        } else {
+            target.first_in = e;
+        }
+        target.last_in = e;
+        ++target.in_degree;
+        ++num_edges_;
+        return edge_descriptor {e};
+    }
+
+    void remove_edge(edge_descriptor e) noexcept
+    {
+        auto& edge = edges_[e.index_];
+        assert(edge.source != null_index);
+        auto& source = vertices_[edge.source];
+        auto& target = vertices_[edge.target];
+        (edge.prev_out != null_index ? edges_[edge.prev_out].next_out : source.first_out) = edge.next_out;
+        (edge.next_out != null_index ? edges_[edge.next_out].prev_out : source.last_out) = edge.prev_out;
+        (edge.prev_in != null_index ? edges_[edge.prev_in].next_in : target.first_in) = edge.next_in;
+        (edge.next_in != null_index ? edges_[edge.next_in].prev_in : target.last_in) = edge.prev_in;
+        --source.out_degree;
+        --target.in_degree;
+        edge.source = edge.target = null_index;
+        --num_edges_;
+    }
+
+    // Removes every u -> v edge
+    void remove_edge(vertex_descriptor u, vertex_descriptor v) noexcept
+    {
+        remove_out_edge_if(u, [this, v] (edge_descriptor e) { return target(e) == v; });
+    }
+
+    template <typename Predicate>
+    void remove_edge_if(Predicate pred)
+    {
+        for (auto e = next_edge(0); e != null_index; e = next_edge(e + 1)) {
+            if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+        }
+    }
+    template <typename Predicate>
+    void remove_out_edge_if(vertex_descriptor v, Predicate pred)
+    {
+        for (auto e = vertices_[v].first_out; e != null_index;) {
+            const auto next = edges_[e].next_out;
+            if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+            e = next;
+        }
+    }
+    template <typename Predicate>
+    void remove_in_edge_if(vertex_descriptor v, Predicate pred)
+    {
+        for (auto e = vertices_[v].first_in; e != null_index;) {
+            const auto next = edges_[e].next_in;
+            if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+            e = next;
+        }
+    }
+
+    void clear_out_edges(vertex_descriptor v) noexcept
+    {
+        while (vertices_[v].first_out != null_index) remove_edge(edge_descriptor {vertices_[v].first_out});
+    }
+    void clear_in_edges(vertex_descriptor v) noexcept
+    {
+        while (vertices_[v].first_in != null_index) remove_edge(edge_descriptor {vertices_[v].first_in});
+    }
+    void clear_vertex(vertex_descriptor v) noexcept
+    {
+        clear_out_edges(v);
+        clear_in_edges(v);
+    }
+
+    void reserve(std::size_t num_vertices, std::size_t num_edges)
+    {
+        vertices_.reserve(num_vertices);
+        edges_.reserve(num_edges);
+    }
+
+    void clear() noexcept
+    {
+        vertices_.clear();
+        edges_.clear();
+        num_vertices_ = 0;
+        num_edges_ = 0;
+    }
+
+private:
+    struct StoredVertex
+    {
+        VertexBundle bundle;
+        Index first_out = null_index, last_out = null_index, first_in = null_index, last_in = null_index;
+        Index out_degree = 0, in_degree = 0;
+        bool is_removed = false;
+
+        StoredVertex(VertexBundle bundle) : bundle {std::move(bundle)} {}
+    };
+    struct StoredEdge
+    {
+        EdgeBundle bundle;
+        Index source, target; // null_index if removed
+        Index prev_out, next_out = null_index, prev_in, next_in = null_index;
+
+        StoredEdge(EdgeBundle bundle, Index source, Index target, Index prev_out, Index prev_in)
+        : bundle {std::move(bundle)}, source {source}, target {target}, prev_out {prev_out}, prev_in {prev_in} {}
+    };
+
+    std::vector<StoredVertex> vertices_;
+    std::vector<StoredEdge> edges_;
+    std::size_t num_vertices_ = 0, num_edges_ = 0;
+
+    Index next_vertex(Index v) const noexcept
+    {
+        while (v < vertices_.size() && vertices_[v].is_removed) ++v;
+        return v < vertices_.size() ? v : null_index;
+    }
+    Index next_edge(Index e) const noexcept
+    {
+        while (e < edges_.size() && edges_[e].source == null_index) ++e;
+        return e < edges_.size() ? e : null_index;
+    }
+};
+
+// Property map of one member of the vertex or edge bundles
+template <typename Graph, typename Descriptor, typename Bundle, typename T>
+class FlatDigraphBundleMap
+: public boost::put_get_helper<T&, FlatDigraphBundleMap<Graph, Descriptor, Bundle, T>>
+{
+public:
+    using key_type   = Descriptor;
+    using value_type = std::remove_const_t<T>;
+    using reference  = T&;
+    using category   = boost::lvalue_property_map_tag;
+
+    FlatDigraphBundleMap() = default;
+    FlatDigraphBundleMap(Graph* graph, T Bundle::* member) noexcept : graph_ {graph}, member_ {member} {}
+
+    reference operator[](const key_type& key) const { return (*graph_)[key].*member_; }
+private:
+    Graph* graph_ = nullptr;
+    T Bundle::* member_ = nullptr;
+};
+
+// boost graph concept functions
+
+template <typename V, typename E>
+auto source(typename FlatDigraph<V, E>::edge_descriptor e, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.source(e);
+}
+
+template <typename V, typename E>
+auto target(typename FlatDigraph<V, E>::edge_descriptor e, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.target(e);
+}
+
+template <typename V, typename E>
+auto out_edges(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.out_edges(v);
+}
+
+template <typename V, typename E>
+auto in_edges(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.in_edges(v);
+}
+
+template <typename V, typename E>
+auto out_degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.out_degree(v);
+}
+
+template <typename V, typename E>
+auto in_degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.in_degree(v);
+}
+
+template <typename V, typename E>
+auto degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.in_degree(v) + g.out_degree(v);
+}
+
+template <typename V, typename E>
+auto adjacent_vertices(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.adjacent_vertices(v);
+}
+
+template <typename V, typename E>
+auto inv_adjacent_vertices(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.inv_adjacent_vertices(v);
+}
+
+template <typename V, typename E>
+auto vertices(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.vertices();
+}
+
+template <typename V, typename E>
+auto num_vertices(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.num_vertices();
+}
+
+template <typename V, typename E>
+auto edges(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.edges();
+}
+
+template <typename V, typename E>
+auto num_edges(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.num_edges();
+}
+
+template <typename V, typename E>
+auto edge(typename FlatDigraph<V, E>::vertex_descriptor u, typename FlatDigraph<V, E>::vertex_descriptor v,
+          const FlatDigraph<V, E>& g) noexcept
+{
+    return g.edge(u, v);
+}
+
+template <typename V, typename E>
+auto add_vertex(const typename FlatDigraph<V, E>::vertex_bundled& bundle, FlatDigraph<V, E>& g)
+{
+    return g.add_vertex(bundle);
+}
+
+template <typename V, typename E>
+void remove_vertex(typename FlatDigraph<V, E>::vertex_descriptor v, FlatDigraph<V, E>& g) noexcept
+{
+    g.remove_vertex(v);
+}
+
+template <typename V, typename E>
+void clear_vertex(typename FlatDigraph<V, E>::vertex_descriptor v, FlatDigraph<V, E>& g) noexcept
+{
+    g.clear_vertex(v);
+}
+
+template <typename V, typename E>
+void clear_out_edges(typename FlatDigraph<V, E>::vertex_descriptor v, FlatDigraph<V, E>& g) noexcept
+{
+    g.clear_out_edges(v);
+}
+
+template <typename V, typename E>
+void clear_in_edges(typename FlatDigraph<V, E>::vertex_descriptor v, FlatDigraph<V, E>& g) noexcept
+{
+    g.clear_in_edges(v);
+}
+
+template <typename V, typename E>
+auto add_edge(typename FlatDigraph<V, E>::vertex_descriptor u, typename FlatDigraph<V, E>::vertex_descriptor v,
+              const typename FlatDigraph<V, E>::edge_bundled& bundle, FlatDigraph<V, E>& g)
+{
+    return std::make_pair(g.add_edge(u, v, bundle), true);
+}
+
+template <typename V, typename E>
+void remove_edge(typename FlatDigraph<V, E>::vertex_descriptor u, typename FlatDigraph<V, E>::vertex_descriptor v,
+                 FlatDigraph<V, E>& g) noexcept
+{
+    g.remove_edge(u, v);
+}
+
+template <typename V, typename E>
+void remove_edge(typename FlatDigraph<V, E>::edge_descriptor e, FlatDigraph<V, E>& g) noexcept
+{
+    g.remove_edge(e);
+}
+
+template <typename Predicate, typename V, typename E>
+void remove_edge_if(Predicate pred, FlatDigraph<V, E>& g)
+{
+    g.remove_edge_if(pred);
+}
+
+template <typename Predicate, typename V, typename E>
+void remove_out_edge_if(typename FlatDigraph<V, E>::vertex_descriptor v, Predicate pred, FlatDigraph<V, E>& g)
+{
+    g.remove_out_edge_if(v, pred);
+}
+
+template <typename Predicate, typename V, typename E>
+void remove_in_edge_if(typename FlatDigraph<V, E>::vertex_descriptor v, Predicate pred, FlatDigraph<V, E>& g)
+{
+    g.remove_in_edge_if(v, pred);
+}
+
+template <typename V, typename E, typename T, typename Bundle>
+auto get(T Bundle::* member, FlatDigraph<V, E>& g) noexcept
+{
+    using Graph = FlatDigraph<V, E>;
+    using Descriptor = std::conditional_t<std::is_base_of<Bundle, V>::value,
+                                          typename Graph::vertex_descriptor, typename Graph::edge_descriptor>;
+    return FlatDigraphBundleMap<Graph, Descriptor, Bundle, T> {&g, member};
+}
+
+template <typename V, typename E, typename T, typename Bundle>
+auto get(T Bundle::* member, const FlatDigraph<V, E>& g) noexcept
+{
+    using Graph = FlatDigraph<V, E>;
+    using Descriptor = std::conditional_t<std::is_base_of<Bundle, V>::value,
+                                          typename Graph::vertex_descriptor, typename Graph::edge_descriptor>;
+    return FlatDigraphBundleMap<const Graph, Descriptor, Bundle, const T> {&g, member};
+}
+
+} // namespace coretools
+} // namespace octopus
+
+namespace boost {
+
+template <typename V, typename E, typename T, typename Bundle>
+struct property_map<octopus::coretools::FlatDigraph<V, E>, T Bundle::*>
+{
+private:
+    using Graph = octopus::coretools::FlatDigraph<V, E>;
+    using Descriptor = std::conditional_t<std::is_base_of<Bundle, V>::value,
+                                          typename Graph::vertex_descriptor, typename Graph::edge_descriptor>;
+public:
+    using type       = octopus::coretools::FlatDigraphBundleMap<Graph, Descriptor, Bundle, T>;
+    using const_type = octopus::coretools::FlatDigraphBundleMap<const Graph, Descriptor, Bundle, const T>;
+};
+
+// So calls qualified with boost:: find the FlatDigraph overloads, as they do for adjacency_list
+using octopus::coretools::source;
+using octopus::coretools::target;
+using octopus::coretools::out_edges;
+using octopus::coretools::in_edges;
+using octopus::coretools::out_degree;
+using octopus::coretools::in_degree;
+using octopus::coretools::degree;
+using octopus::coretools::adjacent_vertices;
+using octopus::coretools::inv_adjacent_vertices;
+using octopus::coretools::vertices;
+using octopus::coretools::num_vertices;
+using octopus::coretools::edges;
+using octopus::coretools::num_edges;
+using octopus::coretools::edge;
+using octopus::coretools::add_vertex;
+using octopus::coretools::remove_vertex;
+using octopus::coretools::clear_vertex;
+using octopus::coretools::clear_out_edges;
+using octopus::coretools::clear_in_edges;
+using octopus::coretools::add_edge;
+using octopus::coretools::remove_edge;
+using octopus::coretools::remove_edge_if;
+using octopus::coretools::remove_out_edge_if;
+using octopus::coretools::remove_in_edge_if;
+using octopus::coretools::get;
+
+} // namespace boost
+
+#endif
@@ -115,7 +115,9 @@ std::string VcfExtractor::name() const
 std::vector<Variant> VcfExtractor::fetch_variants(const GenomicRegion& region) const
 {
   std::deque<Variant> variants {};
-    for (auto p = reader_->iterate(region, VcfReader::UnpackPolicy::sites); p.first != p.second; ++p.first) {
+    // Only the site columns are used so no INFO or FORMAT fields are decoded
+    static const VcfReader::Projection fields {VcfReader::Projection::KeyList {}};
+    for (auto p = reader_->iterate(region, fields); p.first != p.second; ++p.first) {
         if (is_good(*p.first)) {
             extract_variants(*p.first, variants, options_.split_complex);
         }
@@ -599,7 +599,7 @@ void set_allele_counts(const Call& call, const std::vector<SampleName>& samples,
                        VcfRecord::Builder& result)
 {
     auto p = get_allele_counts(alt_alleles, call, samples);
-    result.set_info("AC", utils::to_strings(p.first));
+    result.set_info("AC", p.first);
     result.set_info("AN", p.second);
 }
 
@@ -639,14 +639,14 @@ VcfRecord VcfRecordFactory::make(std::unique_ptr<Call> call) const
             static const Phred<double> max_genotype_quality {10'000};
             const auto gq = static_cast<int>(std::round(std::min(max_genotype_quality, genotype_call.posterior).score()));
             set_vcf_genotype(sample, genotype_call, result, is_refcall);
-            result.set_format(sample, "GQ", std::to_string(gq));
+            result.set_format(sample, "GQ", gq);
             result.set_format(sample, "DP", max_coverage(call_reads.at(sample)));
             result.set_format(sample, "MQ", static_cast<unsigned>(rmq_mapping_quality(call_reads.at(sample))));
             if (call->is_phased(sample)) {
                 const auto& phase = *genotype_call.phase;
                 auto pq = std::min(100, static_cast<int>(std::round(phase.score().score())));
                 result.set_format(sample, "PS", mapped_begin(phase.region()) + 1);
-                result.set_format(sample, "PQ", std::to_string(pq));
+                result.set_format(sample, "PQ", pq);
             }
         }
     }
@@ -700,7 +700,7 @@ void set_allele_counts(const std::vector<VcfRecord::NucleotideSequence>& alt_all
                        VcfRecord::Builder& result)
 {
     auto p = get_allele_counts(alt_alleles, genotypes);
-    result.set_info("AC", utils::to_strings(p.first));
+    result.set_info("AC", p.first);
     result.set_info("AN", p.second);
 }
 
@@ -788,14 +788,14 @@ VcfRecord VcfRecordFactory::make_segment(std::vector<std::unique_ptr<Call>>&& ca
                              std::string {vcfspec::missingValue}, std::string {vcfspec::allele::nonref});
             }
             result.set_genotype(sample, genotype_call, VcfRecord::Builder::Phasing::phased);
-            result.set_format(sample, "GQ", std::to_string(gq));
+            result.set_format(sample, "GQ", gq);
             result.set_format(sample, "DP", max_coverage(reads_.at(sample), region));
             result.set_format(sample, "MQ", static_cast<unsigned>(rmq_mapping_quality(reads_.at(sample), region)));
             if (calls.front()->is_phased(sample)) {
                 const auto phase = *calls.front()->get_genotype_call(sample).phase;
                 auto pq = std::min(100, static_cast<int>(std::round(phase.score().score())));
                 result.set_format(sample, "PS", mapped_begin(phase.region()) + 1);
-                result.set_format(sample, "PQ", std::to_string(pq));
+                result.set_format(sample, "PQ", pq);
             }
         }
     }
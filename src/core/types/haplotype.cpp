@@ -4,6 +4,7 @@
 #include "haplotype.hpp"
 
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <stdexcept>
 #include <iostream>
@@ -374,12 +375,86 @@ Haplotype::NucleotideSequence Haplotype::fetch_reference_sequence(const ContigRe
     return result;
 }
 
+void Haplotype::append_reference_or_fetch(NucleotideSequence& result, const ContigRegion& region) const
+{
+    struct ReferenceSegment
+    {
+        ContigRegion::Position begin, end;
+        NucleotideSequence::size_type offset;
+    };
+    std::array<ReferenceSegment, 2> segments {};
+    const auto& haplotype_region = region_.contig_region();
+    if (explicit_alleles_.empty()) {
+        segments[0] = {haplotype_region.begin(), haplotype_region.end(), 0};
+        segments[1] = {haplotype_region.end(), haplotype_region.end(), sequence_.size()};
+    } else {
+        segments[0] = {haplotype_region.begin(), explicit_allele_region_.begin(), 0};
+        const auto rhs_flank_size = haplotype_region.end() - explicit_allele_region_.end();
+        segments[1] = {explicit_allele_region_.end(), haplotype_region.end(), sequence_.size() - rhs_flank_size};
+    }
+    const auto fetch = [&] (const auto begin, const auto end) {
+        if (begin < end) result.append(reference_.get().fetch_sequence(GenomicRegion {region_.contig_name(), begin, end}));
+    };
+    auto position = region.begin();
+    for (const auto& segment : segments) {
+        if (position >= region.end() || segment.begin >= region.end()) break;
+        if (segment.end <= position) continue;
+        if (position < segment.begin) {
+            fetch(position, segment.begin);
+            position = segment.begin;
+        }
+        const auto end = std::min(region.end(), segment.end);
+        result.append(sequence_, segment.offset + (position - segment.begin), end - position);
+        position = end;
+    }
+    fetch(position, region.end());
+}
+
+Haplotype::Haplotype(GenomicRegion region, std::vector<ContigAllele> explicit_alleles,
+                     const Haplotype& reference_source)
+: region_ {std::move(region)}
+, explicit_alleles_ {std::move(explicit_alleles)}
+, explicit_allele_region_ {}
+, sequence_ {}
+, cached_hash_ {0}
+, reference_ {reference_source.reference_}
+{
+    assert(is_same_contig(region_, reference_source.region_));
+    if (!explicit_alleles_.empty()) {
+        explicit_allele_region_ = encompassing_region(explicit_alleles_.front(), explicit_alleles_.back());
+        const auto lhs_reference_region = left_overhang_region(region_.contig_region(), explicit_allele_region_);
+        const auto rhs_reference_region = right_overhang_region(region_.contig_region(), explicit_allele_region_);
+        auto num_bases = region_size(lhs_reference_region) + region_size(rhs_reference_region);
+        for (const auto& allele : explicit_alleles_) num_bases += ::octopus::sequence_size(allele);
+        sequence_.reserve(num_bases);
+        if (!is_empty(lhs_reference_region)) {
+            reference_source.append_reference_or_fetch(sequence_, lhs_reference_region);
+        }
+        append(sequence_, std::cbegin(explicit_alleles_), std::cend(explicit_alleles_));
+        if (!is_empty(rhs_reference_region)) {
+            reference_source.append_reference_or_fetch(sequence_, rhs_reference_region);
+        }
+    } else {
+        sequence_.reserve(region_size(region_));
+        reference_source.append_reference_or_fetch(sequence_, region_.contig_region());
+    }
+    cached_hash_ = std::hash<NucleotideSequence>()(sequence_);
+}
+
 // Builder
 
 Haplotype::Builder::Builder(const GenomicRegion& region, const ReferenceGenome& reference)
 :
 region_ {region},
-reference_ {reference}
+reference_ {reference},
+reference_source_ {nullptr}
+{}
+
+Haplotype::Builder::Builder(const GenomicRegion& region, const Haplotype& reference_source)
+:
+region_ {region},
+reference_ {reference_source.reference_},
+reference_source_ {is_same_contig(region, reference_source) ? &reference_source : nullptr}
 {}
 
 bool Haplotype::Builder::can_push_back(const ContigAllele& allele) const noexcept
@@ -492,6 +567,13 @@ void Haplotype::Builder::push_front(Allele&& allele)
 
 Haplotype Haplotype::Builder::build()
 {
+    if (reference_source_) {
+        return Haplotype {
+            std::move(region_),
+            {std::make_move_iterator(std::begin(explicit_alleles_)), std::make_move_iterator(std::end(explicit_alleles_))},
+            *reference_source_
+        };
+    }
     return Haplotype {
         std::move(region_),
         std::make_move_iterator(std::begin(explicit_alleles_)),
@@ -514,7 +596,18 @@ void Haplotype::Builder::update_region(const Allele& allele)
 ContigAllele Haplotype::Builder::get_intervening_reference_allele(const ContigAllele& lhs, const ContigAllele& rhs) const
 {
     const auto region = *intervening_region(lhs, rhs);
-    return ContigAllele {region, reference_.get().fetch_sequence(GenomicRegion {region_.contig_name(), region})};
+    return ContigAllele {region, fetch_reference_sequence(region)};
+}
+
+Haplotype::NucleotideSequence Haplotype::Builder::fetch_reference_sequence(const ContigRegion& region) const
+{
+    if (reference_source_) {
+        NucleotideSequence result {};
+        result.reserve(region_size(region));
+        reference_source_->append_reference_or_fetch(result, region);
+        return result;
+    }
+    return reference_.get().fetch_sequence(GenomicRegion {region_.contig_name(), region});
 }
 
 // non-member methods
@@ -556,7 +649,7 @@ Haplotype do_copy(const Haplotype& haplotype, const GenomicRegion& region, std::
         throw std::logic_error {"Haplotype: trying to copy uncontained region"};
     }
     if (is_same_region(haplotype, region)) return haplotype;
-    Haplotype::Builder result {region, haplotype.reference_};
+    Haplotype::Builder result {region, haplotype};
     if (haplotype.explicit_alleles_.empty()) return result.build();
     const auto& contig_region = region.contig_region();
     if (contains(contig_region, haplotype.explicit_allele_region_)) {
@@ -625,7 +718,7 @@ Haplotype copy(const Haplotype& haplotype, const std::vector<GenomicRegion>& reg
     if (regions.size() == 1) return copy<Haplotype>(haplotype, regions.front());
     using std::end; using std::cbegin; using std::cend; using std::prev;
     const auto copy_region = encompassing_region(regions);
-    Haplotype::Builder result {copy_region, haplotype.reference_};
+    Haplotype::Builder result {copy_region, haplotype};
     if (haplotype.explicit_alleles_.empty()) return result.build();
     auto copied_region = head_region(haplotype);
     for (const auto& region : regions) {
@@ -671,11 +764,7 @@ bool is_reference(const Haplotype& haplotype)
 Haplotype expand(const Haplotype& haplotype, Haplotype::MappingDomain::Size n)
 {
     if (n == 0) return haplotype;
-    return Haplotype {
-        expand(mapped_region(haplotype), n),
-        std::cbegin(haplotype.explicit_alleles_), std::cend(haplotype.explicit_alleles_),
-        haplotype.reference_
-    };
+    return Haplotype {expand(mapped_region(haplotype), n), haplotype.explicit_alleles_, haplotype};
 }
 
 Haplotype remap(const Haplotype& haplotype, const GenomicRegion& region)
@@ -683,16 +772,12 @@ Haplotype remap(const Haplotype& haplotype, const GenomicRegion& region)
     if (is_same_region(haplotype, region)) {
         return haplotype;
     } else if (contains(region, haplotype)) {
-        return Haplotype {
-            region, std::cbegin(haplotype.explicit_alleles_), std::cend(haplotype.explicit_alleles_), haplotype.reference_
-        };
+        return Haplotype {region, haplotype.explicit_alleles_, haplotype};
     } else if (contains(haplotype, region)) {
         return copy<Haplotype>(haplotype, region);
     } else if (is_same_contig(haplotype, region)) {
         const auto remap_alleles = haplotype_contained_range(haplotype.explicit_alleles_, region.contig_region());
-        return Haplotype {
-            region, std::cbegin(remap_alleles), std::cend(remap_alleles), haplotype.reference_
-        };
+        return Haplotype {region, {std::cbegin(remap_alleles), std::cend(remap_alleles)}, haplotype};
     } else {
         return Haplotype {region, haplotype.reference_};
     }
@@ -126,7 +126,13 @@ private:
     void append(NucleotideSequence& result, const ContigAllele& allele) const;
     void append(NucleotideSequence& result, AlleleIterator first, AlleleIterator last) const;
     void append_reference(NucleotideSequence& result, const ContigRegion& region) const;
+    void append_reference_or_fetch(NucleotideSequence& result, const ContigRegion& region) const;
     NucleotideSequence fetch_reference_sequence(const ContigRegion& region) const;
+    
+    // Takes reference bases from the flanks of reference_source where possible, rather than
+    // fetching them from the reference genome
+    Haplotype(GenomicRegion region, std::vector<ContigAllele> explicit_alleles,
+              const Haplotype& reference_source);
 };
 
 template <typename R>
@@ -205,6 +211,9 @@ public:
     Builder() = delete;
     
     explicit Builder(const GenomicRegion& region, const ReferenceGenome& reference);
+    // Reference bases are taken from reference_source where it has them (e.g. a reference
+    // Haplotype shared by many builds), so it must outlive the Builder
+    Builder(const GenomicRegion& region, const Haplotype& reference_source);
     
     Builder(const Builder&)            = default;
     Builder& operator=(const Builder&) = default;
@@ -236,7 +245,9 @@ private:
     GenomicRegion region_;
     std::deque<ContigAllele> explicit_alleles_;
     std::reference_wrapper<const ReferenceGenome> reference_;
+    const Haplotype* reference_source_;
     
+    NucleotideSequence fetch_reference_sequence(const ContigRegion& region) const;
     ContigAllele get_intervening_reference_allele(const ContigAllele& lhs, const ContigAllele& rhs) const;
     void update_region(const ContigAllele& allele) noexcept;
     void update_region(const Allele& allele);
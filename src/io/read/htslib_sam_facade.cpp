@@ -177,8 +177,37 @@ bool is_cram(const boost::filesystem::path& file)
 
 } // namespace
 
+HtslibThreadPool::HtslibThreadPool(const unsigned num_threads)
+: pool_ {hts_tpool_init(static_cast<int>(num_threads)), 0}
+, num_threads_ {num_threads}
+{
+    if (pool_.pool == nullptr) {
+        throw std::runtime_error {"HtslibThreadPool: could not create thread pool"};
+    }
+}
+
+HtslibThreadPool::~HtslibThreadPool()
+{
+    hts_tpool_destroy(pool_.pool);
+}
+
+unsigned HtslibThreadPool::num_threads() const noexcept
+{
+    return num_threads_;
+}
+
+htsThreadPool* HtslibThreadPool::get() noexcept
+{
+    return &pool_;
+}
+
 HtslibSamFacade::HtslibSamFacade(Path file_path)
+: HtslibSamFacade {std::move(file_path), std::shared_ptr<HtslibThreadPool> {}}
+{}
+
+HtslibSamFacade::HtslibSamFacade(Path file_path, std::shared_ptr<HtslibThreadPool> thread_pool)
 : file_path_ {std::move(file_path)}
+, thread_pool_ {std::move(thread_pool)}
 , hts_file_ {open_hts_file(file_path_), HtsFileDeleter {}}
 , hts_header_ {(hts_file_) ? sam_hdr_read(hts_file_.get()) : nullptr, HtsHeaderDeleter {}}
 , hts_index_ {(hts_file_) ? sam_index_load(hts_file_.get(), file_path_.c_str()) : nullptr, HtsIndexDeleter {}}
@@ -211,6 +240,7 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
         }
     }
     try {
+        attach_thread_pool();
         init_maps();
     } catch(...) {
         close();
@@ -273,6 +303,7 @@ void HtslibSamFacade::open()
     if (hts_file_) {
         hts_header_.reset(sam_hdr_read(hts_file_.get()));
         hts_index_.reset(sam_index_load(hts_file_.get(), file_path_.c_str()));
+        attach_thread_pool();
     }
 }
 
@@ -793,6 +824,15 @@ HtslibSamFacade::ReadContainer HtslibSamFacade::fetch_all_reads(const GenomicReg
     return result;
 }
 
+void HtslibSamFacade::attach_thread_pool()
+{
+    if (thread_pool_ && hts_file_) {
+        if (hts_set_thread_pool(hts_file_.get(), thread_pool_->get()) != 0) {
+            throw std::runtime_error {"HtslibSamFacade: could not attach thread pool to " + file_path_.string()};
+        }
+    }
+}
+
 bool is_tag_type(const std::string& header_line, const std::string& tag)
 {
     return header_line.compare(1, 2, tag) == 0;
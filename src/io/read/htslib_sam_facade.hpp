@@ -17,6 +17,7 @@
 
 #include "htslib/hts.h"
 #include "htslib/sam.h"
+#include "htslib/thread_pool.h"
 
 #include "basics/aligned_read.hpp"
 #include "read_reader_impl.hpp"
@@ -29,6 +30,30 @@ class AnnotatedAlignedRead;
 
 namespace io {
 
+// A pool of htslib worker threads that can be attached to any number of open files so that
+// BGZF/CRAM block decompression runs ahead of record iteration.
+class HtslibThreadPool
+{
+public:
+    HtslibThreadPool() = delete;
+    
+    HtslibThreadPool(unsigned num_threads);
+    
+    HtslibThreadPool(const HtslibThreadPool&)            = delete;
+    HtslibThreadPool& operator=(const HtslibThreadPool&) = delete;
+    HtslibThreadPool(HtslibThreadPool&&)                 = delete;
+    HtslibThreadPool& operator=(HtslibThreadPool&&)      = delete;
+    
+    ~HtslibThreadPool();
+    
+    unsigned num_threads() const noexcept;
+    htsThreadPool* get() noexcept;
+    
+private:
+    htsThreadPool pool_;
+    unsigned num_threads_;
+};
+
 class HtslibSamFacade : public IReadReaderImpl
 {
 public:
@@ -48,6 +73,7 @@ public:
     HtslibSamFacade() = delete;
     
     HtslibSamFacade(Path file_path);
+    HtslibSamFacade(Path file_path, std::shared_ptr<HtslibThreadPool> thread_pool);
     HtslibSamFacade(Path sam_out, Path sam_template);
     
     HtslibSamFacade(const HtslibSamFacade&)            = delete;
@@ -178,6 +204,9 @@ private:
     
     Path file_path_;
     
+    // Must outlive hts_file_
+    std::shared_ptr<HtslibThreadPool> thread_pool_;
+    
     std::unique_ptr<htsFile, HtsFileDeleter> hts_file_;
     std::unique_ptr<bam_hdr_t, HtsHeaderDeleter> hts_header_;
     std::unique_ptr<hts_idx_t, HtsIndexDeleter> hts_index_;
@@ -188,6 +217,7 @@ private:
     
     std::vector<SampleName> samples_;
     
+    void attach_thread_pool();
     void init_maps();
     HtsTid get_htslib_target(const GenomicRegion::ContigName& contig) const;
     const GenomicRegion::ContigName& get_contig_name(HtsTid target) const;
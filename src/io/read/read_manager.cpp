@@ -15,13 +15,19 @@
 #include "basics/aligned_read.hpp"
 #include "utils/append.hpp"
 #include "utils/coverage_tracker.hpp"
+#include "htslib_sam_facade.hpp"
 
 namespace octopus { namespace io {
 
 ReadManager::ReadManager(std::vector<Path> read_file_paths, unsigned max_open_files)
+: ReadManager {std::move(read_file_paths), max_open_files, 0}
+{}
+
+ReadManager::ReadManager(std::vector<Path> read_file_paths, unsigned max_open_files, unsigned num_decompression_threads)
 : max_open_files_ {max_open_files}
 , num_files_ {static_cast<unsigned>(read_file_paths.size())}
 , all_readers_single_sample_ {true}
+, decompression_pool_ {num_decompression_threads > 0 ? std::make_shared<HtslibThreadPool>(num_decompression_threads) : nullptr}
 , closed_readers_ {
     std::make_move_iterator(std::begin(read_file_paths)),
     std::make_move_iterator(std::end(read_file_paths))}
@@ -61,6 +67,7 @@ ReadManager::ReadManager(ReadManager&& other)
     max_open_files_                 = move(other.max_open_files_);
     num_files_                      = move(other.num_files_);
     all_readers_single_sample_      = move(other.all_readers_single_sample_);
+    decompression_pool_             = move(other.decompression_pool_);
     closed_readers_                 = move(other.closed_readers_);
     open_readers_                   = move(other.open_readers_);
     reader_paths_containing_sample_ = move(other.reader_paths_containing_sample_);
@@ -77,6 +84,7 @@ ReadManager& ReadManager::operator=(ReadManager&& other)
         max_open_files_                 = move(other.max_open_files_);
         num_files_                      = move(other.num_files_);
         all_readers_single_sample_      = move(other.all_readers_single_sample_);
+        decompression_pool_             = move(other.decompression_pool_);
         closed_readers_                 = move(other.closed_readers_);
         open_readers_                   = move(other.open_readers_);
         reader_paths_containing_sample_ = move(other.reader_paths_containing_sample_);
@@ -95,6 +103,7 @@ void swap(ReadManager& lhs, ReadManager& rhs) noexcept
     swap(lhs.max_open_files_,                 rhs.max_open_files_);
     swap(lhs.num_files_,                      rhs.num_files_);
     swap(lhs.all_readers_single_sample_,             rhs.all_readers_single_sample_);
+    swap(lhs.decompression_pool_,             rhs.decompression_pool_);
     swap(lhs.closed_readers_,                 rhs.closed_readers_);
     swap(lhs.open_readers_,                   rhs.open_readers_);
     swap(lhs.reader_paths_containing_sample_, rhs.reader_paths_containing_sample_);
@@ -551,7 +560,7 @@ void ReadManager::open_initial_files()
 
 ReadReader ReadManager::make_reader(const Path& reader_path) const
 {
-    return ReadReader {reader_path};
+    return ReadReader {reader_path, decompression_pool_};
 }
 
 bool ReadManager::all_readers_are_open() const noexcept
@@ -11,6 +11,7 @@
 #include <initializer_list>
 #include <cstddef>
 #include <mutex>
+#include <memory>
 
 #include <boost/filesystem.hpp>
 
@@ -27,6 +28,8 @@ class AlignedRead;
 
 namespace io {
 
+class HtslibThreadPool;
+
 class ReadManager
 {
 public:
@@ -41,6 +44,8 @@ public:
     ReadManager() = default;
     
     ReadManager(std::vector<Path> read_file_paths, unsigned max_open_files);
+    // Decompression threads are shared by all open files and are in addition to any calling threads
+    ReadManager(std::vector<Path> read_file_paths, unsigned max_open_files, unsigned num_decompression_threads);
     ReadManager(std::initializer_list<Path> read_file_paths);
     
     ReadManager(const ReadManager&)            = delete;
@@ -115,6 +120,8 @@ private:
     unsigned num_files_;
     bool all_readers_single_sample_;
     
+    std::shared_ptr<HtslibThreadPool> decompression_pool_;
+    
     mutable ClosedReaderSet closed_readers_;
     mutable OpenReaderMap open_readers_;
     
@@ -67,19 +67,23 @@ bool is_valid_read_file_type(const boost::filesystem::path& file_path)
     return includes(validReadFileExtensions, get_extension(file_path));
 }
 
-auto make_reader(const boost::filesystem::path& file_path)
+auto make_reader(const boost::filesystem::path& file_path, std::shared_ptr<HtslibThreadPool> decompression_pool)
 {
     if (!is_valid_read_file_type(file_path)) {
         throw UnknownReadFileFormat {file_path};
     }
-    return std::make_unique<HtslibSamFacade>(file_path);
+    return std::make_unique<HtslibSamFacade>(file_path, std::move(decompression_pool));
 }
 
 } //namespace
 
 ReadReader::ReadReader(const boost::filesystem::path& file_path)
+: ReadReader {file_path, nullptr}
+{}
+
+ReadReader::ReadReader(const boost::filesystem::path& file_path, std::shared_ptr<HtslibThreadPool> decompression_pool)
 : file_path_ {file_path}
-, impl_ {make_reader(file_path_)}
+, impl_ {make_reader(file_path_, std::move(decompression_pool))}
 {}
 
 ReadReader::ReadReader(ReadReader&& other)
@@ -24,6 +24,8 @@ class AlignedRead;
 
 namespace io {
 
+class HtslibThreadPool;
+
 /*
  ReadReader is a simple RAII threadsafe wrapper around a IReadReaderImpl
  */
@@ -42,6 +44,7 @@ public:
     ReadReader() = default;
     
     ReadReader(const Path& file_path);
+    ReadReader(const Path& file_path, std::shared_ptr<HtslibThreadPool> decompression_pool);
     
     ReadReader(const ReadReader&)            = delete;
     ReadReader& operator=(const ReadReader&) = delete;
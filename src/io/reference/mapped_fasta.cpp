@@ -0,0 +1,187 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "mapped_fasta.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "utils/sequence_utils.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/missing_index_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+
+namespace octopus { namespace io {
+
+namespace {
+
+class MissingMappedFasta : public MissingFileError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    MissingMappedFasta(MappedFasta::Path file) : MissingFileError {std::move(file), "fasta"} {}
+};
+
+class MissingMappedFastaIndex : public MissingIndexError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+    
+    std::string do_help() const override
+    {
+        return "ensure that a valid fasta index (.fai) exists in the same directory as the given "
+        "fasta file. You can make one with the 'samtools faidx' command";
+    }
+public:
+    MissingMappedFastaIndex(MappedFasta::Path file) : MissingIndexError {std::move(file), "fasta"} {}
+};
+
+class MalformedMappedFasta : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    MalformedMappedFasta(MappedFasta::Path file) : MalformedFileError {std::move(file), "fasta"} {}
+};
+
+bool is_valid_fasta(const MappedFasta::Path& path)
+{
+    const auto extension = path.extension().string();
+    return extension == ".fa" || extension == ".fasta";
+}
+
+bool is_valid_fasta_index(const MappedFasta::Path& path)
+{
+    return path.extension().string() == ".fai";
+}
+
+auto map_file(const MappedFasta::Path& path)
+{
+    try {
+        return std::make_shared<const boost::iostreams::mapped_file_source>(path.string());
+    } catch (const std::ios::failure& e) {
+        throw MalformedMappedFasta {path};
+    }
+}
+
+} // namespace
+
+MappedFasta::MappedFasta(Path fasta_path)
+: MappedFasta {fasta_path, fasta_path.string() + ".fai", Options {}}
+{}
+
+MappedFasta::MappedFasta(Path fasta_path, Options options)
+: MappedFasta {fasta_path, fasta_path.string() + ".fai", options}
+{}
+
+MappedFasta::MappedFasta(Path fasta_path, Path fasta_index_path, Options options)
+: path_ {std::move(fasta_path)}
+, index_path_ {std::move(fasta_index_path)}
+, fasta_ {}
+, fasta_index_ {}
+, contig_names_ {}
+, options_ {options}
+{
+    using boost::filesystem::exists;
+    if (!exists(path_)) {
+        throw MissingMappedFasta {path_};
+    }
+    if (!is_valid_fasta(path_)) {
+        throw MalformedMappedFasta {path_};
+    }
+    if (!exists(index_path_)) {
+        index_path_ = path_;
+        index_path_.replace_extension("fai");
+        if (!exists(index_path_)) {
+            throw MissingMappedFastaIndex {path_};
+        }
+    }
+    if (!is_valid_fasta_index(index_path_)) {
+        throw MalformedMappedFasta {index_path_};
+    }
+    fasta_ = map_file(path_);
+    fasta_index_ = std::make_shared<const bioio::FastaIndex>(bioio::read_fasta_index(index_path_.string()));
+    contig_names_ = bioio::read_fasta_index_contig_names(index_path_.string());
+}
+
+// virtual private methods
+
+std::unique_ptr<ReferenceReader> MappedFasta::do_clone() const
+{
+    return std::make_unique<MappedFasta>(*this);
+}
+
+bool MappedFasta::do_is_open() const noexcept
+{
+    return fasta_ && fasta_->is_open();
+}
+
+std::string MappedFasta::do_fetch_reference_name() const
+{
+    return path_.stem().string();
+}
+
+std::vector<MappedFasta::ContigName> MappedFasta::do_fetch_contig_names() const
+{
+    return contig_names_;
+}
+
+MappedFasta::GenomicSize MappedFasta::do_fetch_contig_size(const ContigName& contig) const
+{
+    if (fasta_index_->count(contig) == 0) {
+        throw std::runtime_error {"contig \"" + contig +
+            "\" not found in fasta index \"" + index_path_.string() + "\""};
+    }
+    return static_cast<GenomicSize>(fasta_index_->at(contig).length);
+}
+
+MappedFasta::GeneticSequence MappedFasta::do_fetch_sequence(const GenomicRegion& region) const
+{
+    const auto& index = fasta_index_->at(contig_name(region));
+    const std::size_t begin {mapped_begin(region)};
+    GeneticSequence result {};
+    if (begin < index.length && index.line_length > 0) {
+        const auto length = std::min(static_cast<std::size_t>(size(region)), index.length - begin);
+        result.reserve(size(region));
+        const auto line_end_bytes = index.line_byte_length - index.line_length;
+        auto offset = index.offset + begin / index.line_length * index.line_byte_length + begin % index.line_length;
+        auto pos = begin;
+        while (result.size() < length && offset < fasta_->size()) {
+            auto n = std::min(index.line_length - pos % index.line_length, length - result.size());
+            n = std::min(n, fasta_->size() - offset);
+            result.append(fasta_->data() + offset, n);
+            pos += n;
+            offset += n;
+            if (pos % index.line_length == 0) offset += line_end_bytes;
+        }
+    }
+    if (options_.base_transform_policy == Options::CapitalisationPolicy::capitalise) {
+        utils::capitalise(result);
+    }
+    if (options_.iupac_ambiguity_symbol_policy == Options::IUPACAmbiguitySymbolPolicy::disambiguate) {
+        utils::disambiguate_iupac_bases(result, true);
+    }
+    if (result.size() < size(region)) {
+        if (options_.base_fill_policy == Options::BaseFillPolicy::throw_exception) {
+            throw std::runtime_error {"MappedFasta: requested bad reference region " + to_string(region)};
+        }
+        if (options_.base_fill_policy == Options::BaseFillPolicy::fill_with_ns) {
+            result.resize(size(region), 'N');
+        }
+    }
+    return result;
+}
+
+} // namespace io
+} // namespace octopus
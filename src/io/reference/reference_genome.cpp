@@ -9,8 +9,8 @@
 #include <numeric>
 
 #include "fasta.hpp"
-#include "threadsafe_fasta.hpp"
 #include "caching_fasta.hpp"
+#include "mapped_fasta.hpp"
 
 namespace octopus {
 
@@ -101,7 +101,6 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
                                const bool disambiguate_iupac_ambiguity_symbols)
 {
     using namespace io;
-    std::unique_ptr<ReferenceReader> impl_ {};
     Fasta::Options options {};
     if (capitalise_bases) {
         options.base_transform_policy = Fasta::Options::CapitalisationPolicy::capitalise;
@@ -111,13 +110,12 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
     }
     options.base_fill_policy = Fasta::Options::BaseFillPolicy::fill_with_ns;
     if (is_threaded) {
-        impl_ = std::make_unique<ThreadsafeFasta>(std::make_unique<Fasta>(reference_path, options));
-    } else {
-        impl_ = std::make_unique<Fasta>(std::move(reference_path), options);
+        // All threads share one lock-free mapping of the file, so a cache would only add contention
+        return ReferenceGenome {std::make_unique<MappedFasta>(std::move(reference_path), options)};
     }
+    std::unique_ptr<ReferenceReader> impl_ {std::make_unique<Fasta>(std::move(reference_path), options)};
     if (max_cache_size.bytes() > 0) {
-        double locality_bias {0.99}, forward_bias {0.99};
-        if (is_threaded) locality_bias = 0.25;
+        const double locality_bias {0.99}, forward_bias {0.99};
         return ReferenceGenome {std::make_unique<CachingFasta>(std::move(impl_), max_cache_size.bytes(),
                                                                locality_bias, forward_bias)};
     } else {
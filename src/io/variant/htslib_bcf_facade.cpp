@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <algorithm>
+#include <queue>
 #include <utility>
 #include <cstdlib>
 #include <cstring>
@@ -18,6 +19,8 @@
 #include <boost/optional.hpp>
 #include <boost/container/small_vector.hpp>
 
+#include "htslib/bgzf.h"
+
 #include "basics/genomic_region.hpp"
 #include "utils/string_utils.hpp"
 #include "exceptions/file_open_error.hpp"
@@ -213,7 +216,7 @@ std::size_t HtslibBcfFacade::count_records(const GenomicRegion& region) const
     return count_records(sr);
 }
 
-HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const UnpackPolicy level) const
+HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const Projection& fields) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     if (bcf_sr_add_reader(sr.get(), file_path_.c_str()) != 1) {
@@ -225,12 +228,12 @@ HtslibBcfFacade::RecordIteratorPtrPair HtslibBcfFacade::iterate(const UnpackPoli
             throw std::runtime_error {"failed to open file " + file_path_.string()};
         }
     }
-    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), fields),
                           std::make_unique<RecordIterator>(*this));
 }
 
 HtslibBcfFacade::RecordIteratorPtrPair
-HtslibBcfFacade::iterate(const std::string& contig, const UnpackPolicy level) const
+HtslibBcfFacade::iterate(const std::string& contig, const Projection& fields) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     if (bcf_sr_set_regions(sr.get(), contig.c_str(), 0) != 0) {
@@ -245,12 +248,12 @@ HtslibBcfFacade::iterate(const std::string& contig, const UnpackPolicy level) co
             throw std::runtime_error {"failed to open file " + file_path_.string()};
         }
     }
-    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), fields),
                           std::make_unique<RecordIterator>(*this));
 }
 
 HtslibBcfFacade::RecordIteratorPtrPair
-HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+HtslibBcfFacade::iterate(const GenomicRegion& region, const Projection& fields) const
 {
     HtsBcfSrPtr sr {bcf_sr_init(), HtsSrsDeleter {}};
     const auto region_str = to_string(region);
@@ -266,12 +269,12 @@ HtslibBcfFacade::iterate(const GenomicRegion& region, const UnpackPolicy level)
             throw std::runtime_error {"failed to open file " + file_path_.string()};
         }
     }
-    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), level),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, std::move(sr), fields),
                           std::make_unique<RecordIterator>(*this));
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const Projection& fields) const
 {
     const auto n_records = count_records();
     if (n_records == 0) return {};
@@ -280,11 +283,11 @@ HtslibBcfFacade::fetch_records(const UnpackPolicy level) const
         sr.release();
         throw std::runtime_error {"failed to open file " + file_path_.string()};
     }
-    return fetch_records(sr.get(), level, n_records);
+    return fetch_records(sr.get(), fields, n_records);
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const std::string& contig, const Projection& fields) const
 {
     const auto n_records = count_records(contig);
     if (n_records == 0) return {};
@@ -296,11 +299,11 @@ HtslibBcfFacade::fetch_records(const std::string& contig, const UnpackPolicy lev
         sr.release();
         throw std::runtime_error {"failed to open file " + file_path_.string()};
     }
-    return fetch_records(sr.get(), level, n_records);
+    return fetch_records(sr.get(), fields, n_records);
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+HtslibBcfFacade::fetch_records(const GenomicRegion& region, const Projection& fields) const
 {
     const auto n_records = count_records(region);
     if (n_records == 0) return {};
@@ -313,7 +316,7 @@ HtslibBcfFacade::fetch_records(const GenomicRegion& region, const UnpackPolicy l
         sr.release();
         throw std::runtime_error {"failed to open file " + file_path_.string()};
     }
-    return fetch_records(sr.get(), level, n_records);
+    return fetch_records(sr.get(), fields, n_records);
 }
 
 auto hts_tag_type(const std::string& tag)
@@ -437,24 +440,176 @@ void HtslibBcfFacade::write(const VcfRecord& record)
     bcf_destroy(hts_record);
 }
 
+namespace {
+
+struct HtsIndexDeleter
+{
+    void operator()(hts_idx_t* index) const { hts_idx_destroy(index); }
+};
+struct HtsItrDeleter
+{
+    void operator()(hts_itr_t* itr) const { hts_itr_destroy(itr); }
+};
+
+bool has_same_ids(const bcf_hdr_t* src, const bcf_hdr_t* dst, const int dictionary) noexcept
+{
+    for (int id {0}; id < src->n[dictionary]; ++id) {
+        const auto key = src->id[dictionary][id].key;
+        if (key != nullptr && bcf_hdr_id2int(dst, dictionary, key) != id) return false;
+    }
+    return true;
+}
+
+// Maps raw records from the source header ids to the destination header ids. When only the contig
+// ids differ the record is patched in place, otherwise htslib must unpack it to translate the keys.
+class RawRecordTranslator
+{
+public:
+    RawRecordTranslator(const bcf_hdr_t* dst, bcf_hdr_t* src)
+    : dst_ {dst}
+    , src_ {src}
+    , contig_ids_(src->n[BCF_DT_CTG])
+    , is_key_translation_required_ {!has_same_ids(src, dst, BCF_DT_ID)}
+    {
+        for (int id {0}; id < src->n[BCF_DT_CTG]; ++id) {
+            contig_ids_[id] = bcf_hdr_name2id(dst, bcf_hdr_id2name(src, id));
+        }
+    }
+    
+    void operator()(bcf1_t* record) const
+    {
+        if (contig_ids_[record->rid] < 0) {
+            throw std::runtime_error {"HtslibBcfFacade: required contig header line missing for contig \""
+                                      + std::string {bcf_hdr_id2name(src_, record->rid)} + "\""};
+        }
+        if (is_key_translation_required_) {
+            bcf_translate(dst_, src_, record);
+        } else {
+            record->rid = contig_ids_[record->rid];
+        }
+    }
+    
+private:
+    const bcf_hdr_t* dst_;
+    bcf_hdr_t* src_;
+    std::vector<int> contig_ids_;
+    bool is_key_translation_required_;
+};
+
+// Same order as VcfRecord: position, reference length, then REF and ALT alleles
+bool is_before(const bcf1_t* lhs, const bcf1_t* rhs) noexcept
+{
+    if (lhs->pos != rhs->pos) return lhs->pos < rhs->pos;
+    if (lhs->rlen != rhs->rlen) return lhs->rlen < rhs->rlen;
+    const auto ref_order = std::strcmp(lhs->d.allele[0], rhs->d.allele[0]);
+    if (ref_order != 0) return ref_order < 0;
+    return std::lexicographical_compare(lhs->d.allele + 1, lhs->d.allele + lhs->n_allele,
+                                        rhs->d.allele + 1, rhs->d.allele + rhs->n_allele,
+                                        [] (const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+}
+
+} // namespace
+
+bool HtslibBcfFacade::can_write_raw(const HtslibBcfFacade& src) const noexcept
+{
+    return file_ && header_ && src.file_ && src.header_ && src.is_bcf() && samples_ == src.samples_;
+}
+
+void HtslibBcfFacade::append_raw(HtslibBcfFacade& src)
+{
+    if (file_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record to closed file"};
+    }
+    if (header_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record without a header"};
+    }
+    if (can_concatenate(src)) {
+        concatenate(src);
+        return;
+    }
+    const RawRecordTranslator translate {header_.get(), src.header_.get()};
+    HtsBcf1Ptr record {bcf_init(), HtsBcf1Deleter {}};
+    int status;
+    while ((status = bcf_read(src.file_.get(), src.header_.get(), record.get())) == 0) {
+        translate(record.get());
+        if (bcf_write(file_.get(), header_.get(), record.get()) < 0) {
+            throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+        }
+    }
+    if (status < -1) {
+        throw std::runtime_error {"HtslibBcfFacade: failed to read record from " + src.file_path_.string()};
+    }
+}
+
+void HtslibBcfFacade::merge_raw(std::vector<HtslibBcfFacade>& sources, const std::vector<std::string>& contigs)
+{
+    if (file_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record to closed file"};
+    }
+    if (header_ == nullptr) {
+        throw std::runtime_error {"HtslibBcfFacade: trying to write record without a header"};
+    }
+    std::vector<RawRecordTranslator> translators {};
+    std::vector<std::unique_ptr<hts_idx_t, HtsIndexDeleter>> indices {};
+    std::vector<HtsBcf1Ptr> records {};
+    translators.reserve(sources.size());
+    indices.reserve(sources.size());
+    records.reserve(sources.size());
+    for (auto& src : sources) {
+        translators.emplace_back(header_.get(), src.header_.get());
+        indices.emplace_back(bcf_index_load(src.file_path_.c_str()));
+        if (!indices.back()) {
+            throw std::runtime_error {"failed to open index for file " + src.file_path_.string()};
+        }
+        records.emplace_back(bcf_init(), HtsBcf1Deleter {});
+    }
+    std::vector<std::unique_ptr<hts_itr_t, HtsItrDeleter>> iterators(sources.size());
+    const auto read_next = [&] (const std::size_t source) {
+        if (bcf_itr_next(sources[source].file_.get(), iterators[source].get(), records[source].get()) < 0) return false;
+        bcf_unpack(records[source].get(), BCF_UN_STR);
+        return true;
+    };
+    // Ties are broken by source order so the merge is stable
+    const auto is_after = [&] (const std::size_t lhs, const std::size_t rhs) {
+        if (is_before(records[rhs].get(), records[lhs].get())) return true;
+        return !is_before(records[lhs].get(), records[rhs].get()) && lhs > rhs;
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(is_after)> record_queue {is_after};
+    for (const auto& contig : contigs) {
+        for (std::size_t source {0}; source < sources.size(); ++source) {
+            iterators[source].reset(bcf_itr_querys(indices[source].get(), sources[source].header_.get(), contig.c_str()));
+            if (iterators[source] && read_next(source)) record_queue.push(source);
+        }
+        while (!record_queue.empty()) {
+            const auto source = record_queue.top();
+            record_queue.pop();
+            translators[source](records[source].get());
+            if (bcf_write(file_.get(), header_.get(), records[source].get()) < 0) {
+                throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+            }
+            if (read_next(source)) record_queue.push(source);
+        }
+    }
+}
+
 // HtslibBcfFacade::RecordIterator
 
 HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade)
 : facade_ {facade}
 , hts_iterator_ {nullptr}
-, level_ {}
+, fields_ {}
 , record_ {nullptr}
 {}
 
 HtslibBcfFacade::RecordIterator::RecordIterator(const HtslibBcfFacade& facade,
                                                 HtsBcfSrPtr hts_iterator,
-                                                UnpackPolicy level)
+                                                Projection fields)
 : facade_ {facade}
 , hts_iterator_ {std::move(hts_iterator)}
-, level_ {level}
+, fields_ {std::move(fields)}
 {
     if (bcf_sr_next_line(hts_iterator_.get())) {
-        record_ = std::make_shared<VcfRecord>(facade_.get().fetch_record(hts_iterator_.get(), level_));
+        record_ = std::make_shared<VcfRecord>(facade_.get().fetch_record(hts_iterator_.get(), fields_));
     } else {
         hts_iterator_ = nullptr;
     }
@@ -473,7 +628,7 @@ HtslibBcfFacade::RecordIterator::pointer HtslibBcfFacade::RecordIterator::operat
 void HtslibBcfFacade::RecordIterator::next()
 {
     if (bcf_sr_next_line(hts_iterator_.get())) {
-        *record_ = facade_.get().fetch_record(hts_iterator_.get(), level_);
+        *record_ = facade_.get().fetch_record(hts_iterator_.get(), fields_);
     } else {
         hts_iterator_ = nullptr;
     }
@@ -595,7 +750,8 @@ void set_filter(const bcf_hdr_t* header, bcf1_t* record, const std::vector<std::
     }
 }
 
-void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder)
+void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder,
+                  const IVcfReaderImpl::Projection& fields)
 {
     int* intinfo {nullptr};
     float* floatinfo {nullptr};
@@ -609,27 +765,29 @@ void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& b
             throw std::runtime_error {"HtslibBcfFacade: found INFO key not present in header file"};
         }
         const char* key {header->id[BCF_DT_ID][key_id].key};
-        std::vector<std::string> values {};
+        if (!fields.all_info() && !fields.includes_info(key)) continue;
+        VcfRecord::Values values {};
         switch (bcf_hdr_id2type(header, BCF_HL_INFO, key_id)) {
             case BCF_HT_INT: {
                 const auto num_values_written = bcf_get_info_int32(header, record, key, &intinfo, &nintinfo);
                 if (num_values_written > 0) {
-                    values.reserve(num_values_written);
-                    std::transform(intinfo, intinfo + num_values_written, std::back_inserter(values),
-                                   [](auto v) {
-                                       return v != bcf_int32_missing ? std::to_string(v) : bcf_missing_str;
-                                   });
+                    const auto last = std::find(intinfo, intinfo + num_values_written, bcf_int32_vector_end);
+                    // bcf_int32_missing is VcfRecord::Values::missing_integer
+                    values = std::vector<VcfRecord::Values::IntegerType>(intinfo, last);
                 }
                 break;
             }
             case BCF_HT_REAL: {
                 const auto num_values_written = bcf_get_info_float(header, record, key, &floatinfo, &nfloatinfo);
                 if (num_values_written > 0) {
-                    values.reserve(num_values_written);
-                    std::transform(floatinfo, floatinfo + num_values_written, std::back_inserter(values),
+                    const auto last = std::find_if(floatinfo, floatinfo + num_values_written,
+                                                   [] (auto v) { return bcf_float_is_vector_end(v); });
+                    std::vector<VcfRecord::Values::FloatType> reals(std::distance(floatinfo, last));
+                    std::transform(floatinfo, last, std::begin(reals),
                                    [] (auto v) {
-                                       return v != bcf_float_missing ? std::to_string(v) : bcf_missing_str;
+                                       return !bcf_float_is_missing(v) ? v : VcfRecord::Values::missing_real;
                                    });
+                    values = std::move(reals);
                 }
                 break;
             }
@@ -642,8 +800,7 @@ void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& b
                 break;
             }
             case BCF_HT_FLAG: {
-                values.reserve(1);
-                values.emplace_back((bcf_get_info_flag(header, record, key, &flaginfo, &nflaginfo) == 1) ? "1" : "0");
+                values = std::vector<VcfRecord::ValueType> {(bcf_get_info_flag(header, record, key, &flaginfo, &nflaginfo) == 1) ? "1" : "0"};
                 break;
             }
         }
@@ -662,39 +819,63 @@ float get_bcf_float_missing() noexcept
     return result;
 }
 
+template <typename OutputIt>
+OutputIt copy_int32(const VcfRecord::Values& values, OutputIt result)
+{
+    if (values.type() == VcfRecord::Values::Type::integer) {
+        // missing_integer and bcf_int32_missing are both INT32_MIN
+        return std::copy(std::cbegin(values.integers()), std::cend(values.integers()), result);
+    }
+    for (std::size_t i {0}; i < values.size(); ++i, ++result) {
+        *result = values.integer(i);
+    }
+    return result;
+}
+
+template <typename OutputIt>
+OutputIt copy_float(const VcfRecord::Values& values, OutputIt result)
+{
+    if (values.type() == VcfRecord::Values::Type::real) {
+        // missing_real and bcf_float_missing are the same NaN
+        return std::copy(std::cbegin(values.reals()), std::cend(values.reals()), result);
+    }
+    for (std::size_t i {0}; i < values.size(); ++i, ++result) {
+        *result = !values.is_missing(i) ? values.real(i) : get_bcf_float_missing();
+    }
+    return result;
+}
+
 void set_info(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source)
 {
     for (const auto& key : source.info_keys()) {
-        const auto& values    = source.info_value(key);
+        const auto& values    = source.typed_info_value(key);
         const auto num_values = static_cast<int>(values.size());
         static constexpr std::size_t defaultBufferCapacity {100};
         switch (bcf_hdr_id2type(header, BCF_HL_INFO, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
             case BCF_HT_INT:
             {
                 bc::small_vector<int, defaultBufferCapacity> vals(num_values);
-                std::transform(std::cbegin(values), std::cend(values), std::begin(vals),
-                               [] (const auto& v) { return !is_missing(v) ? std::stoi(v) : bcf_int32_missing; });
+                copy_int32(values, std::begin(vals));
                 bcf_update_info_int32(header, dest, key.c_str(), vals.data(), num_values);
                 break;
             }
             case BCF_HT_REAL:
             {
                 bc::small_vector<float, defaultBufferCapacity> vals(num_values);
-                std::transform(std::cbegin(values), std::cend(values), std::begin(vals),
-                               [] (const auto& v) { return !is_missing(v) ? std::stof(v) : get_bcf_float_missing(); });
+                copy_float(values, std::begin(vals));
                 bcf_update_info_float(header, dest, key.c_str(), vals.data(), num_values);
                 break;
             }
             case BCF_HT_STR:
             {
                 // Can we also use small_vector here?
-                const auto vals = utils::join(values, vcfspec::info::valueSeperator);
+                const auto vals = utils::join(values.to_strings(), vcfspec::info::valueSeperator);
                 bcf_update_info_string(header, dest, key.c_str(), vals.c_str());
                 break;
             }
             case BCF_HT_FLAG:
             {
-                bcf_update_info_flag(header, dest, key.c_str(), "", values.empty() || values.front() == "1");
+                bcf_update_info_flag(header, dest, key.c_str(), "", values.empty() || values.string(0) == "1");
                 break;
             }
         }
@@ -706,7 +887,7 @@ bool has_samples(const bcf_hdr_t* header)
     return bcf_hdr_nsamples(header) > 0;
 }
 
-auto extract_format(const bcf_hdr_t* header, const bcf1_t* record)
+auto extract_format(const bcf_hdr_t* header, const bcf1_t* record, const IVcfReaderImpl::Projection& fields)
 {
     std::vector<VcfRecord::KeyType> result {};
     result.reserve(record->n_fmt);
@@ -715,14 +896,17 @@ auto extract_format(const bcf_hdr_t* header, const bcf1_t* record)
         if (key_id >= header->n[BCF_DT_ID]) {
             throw std::runtime_error {"HtslibBcfFacade: found FORMAT key not present in header file"};
         }
-        result.emplace_back(header->id[BCF_DT_ID][key_id].key);
+        VcfRecord::KeyType key {header->id[BCF_DT_ID][key_id].key};
+        if (fields.includes_format(key)) result.push_back(std::move(key));
     }
     return result;
 }
 
-void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder)
+void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& builder,
+                     const IVcfReaderImpl::Projection& fields)
 {
-    auto format = extract_format(header, record);
+    auto format = extract_format(header, record, fields);
+    if (format.empty()) return;
     const auto num_samples = record->n_sample;
     builder.reserve_samples(num_samples);
     auto first_format = std::cbegin(format);
@@ -763,7 +947,7 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
     int nintformat {}, nfloatformat {}, nstringformat {};
     for (auto itr = first_format, end = std::cend(format); itr != end; ++itr) {
         const auto& key = *itr;
-        std::vector<std::vector<std::string>> values(num_samples, std::vector<std::string> {});
+        std::vector<VcfRecord::Values> values(num_samples);
         switch (bcf_hdr_id2type(header, BCF_HL_FMT, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
             case BCF_HT_INT: {
                 const auto num_values_written = bcf_get_format_int32(header, record, key.c_str(), &intformat, &nintformat);
@@ -776,11 +960,7 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
                         const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
                         assert(num_pad_values <= num_values_per_sample);
                         const auto num_sample_values = num_values_per_sample - num_pad_values;
-                        values[sample].reserve(num_sample_values);
-                        std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
-                                       [] (auto v) {
-                                           return v != bcf_int32_missing ? std::to_string(v) : bcf_missing_str;
-                                       });
+                        values[sample] = std::vector<VcfRecord::Values::IntegerType>(ptr, ptr + num_sample_values);
                     }
                 }
                 break;
@@ -796,11 +976,12 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
                         const auto num_pad_values = std::distance(std::make_reverse_iterator(ptr + num_values_per_sample), pad_ritr);
                         assert(num_pad_values <= num_values_per_sample);
                         const auto num_sample_values = num_values_per_sample - num_pad_values;
-                        values[sample].reserve(num_sample_values);
-                        std::transform(ptr, ptr + num_sample_values, std::back_inserter(values[sample]),
+                        std::vector<VcfRecord::Values::FloatType> reals(num_sample_values);
+                        std::transform(ptr, ptr + num_sample_values, std::begin(reals),
                                        [] (auto v) {
-                                           return v != bcf_float_missing ? std::to_string(v) : bcf_missing_str;
+                                           return !bcf_float_is_missing(v) ? v : VcfRecord::Values::missing_real;
                                        });
+                        values[sample] = std::move(reals);
                     }
                 }
                 break;
@@ -811,7 +992,7 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
                     unsigned sample {0};
                     std::for_each(stringformat, stringformat + num_samples,
                                   [&values, &sample] (const char* str) {
-                                      values[sample++].emplace_back(str);
+                                      values[sample++].push_back(str);
                                   });
                 }
                 break;
@@ -845,7 +1026,7 @@ auto max_format_cardinality(const VcfRecord& record, const VcfRecord::KeyType& k
 {
     std::size_t result {0};
     for (const auto& sample : samples) {
-        result = std::max(result, record.get_sample_value(sample, key).size());
+        result = std::max(result, record.typed_sample_value(sample, key).size());
     }
     return result;
 }
@@ -881,7 +1062,7 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
         auto genotype_itr = std::begin(genotype);
         for (const auto& sample : samples) {
             const bool is_phased {source.is_sample_phased(sample)};
-            const auto& genotype = source.get_sample_value(sample, vcfspec::format::genotype);
+            const auto& genotype = source.genotype(sample);
             const auto ploidy = static_cast<unsigned>(genotype.size());
             genotype_itr = std::transform(std::cbegin(genotype), std::cend(genotype), genotype_itr,
                                           [is_phased, &alleles] (const auto& allele) {
@@ -910,9 +1091,8 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
               bc::small_vector<int, defaultValueCapacity> typed_values(num_values);
               auto value_itr = std::begin(typed_values);
               for (const auto& sample : samples) {
-                  const auto& values = source.get_sample_value(sample, key);
-                  value_itr = std::transform(std::cbegin(values), std::cend(values), value_itr,
-                                             [] (const auto& v) { return !is_missing(v) ? std::stoi(v) : bcf_int32_missing; });
+                  const auto& values = source.typed_sample_value(sample, key);
+                  value_itr = copy_int32(values, value_itr);
                   assert(values.size() <= num_values_per_sample);
                   value_itr = std::fill_n(value_itr, num_values_per_sample - values.size(), pad);
               }
@@ -925,9 +1105,8 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
               bc::small_vector<float, defaultValueCapacity> typed_values(num_values);
               auto value_itr = std::begin(typed_values);
               for (const auto& sample : samples) {
-                  const auto& values = source.get_sample_value(sample, key);
-                  value_itr = std::transform(std::cbegin(values), std::cend(values), value_itr,
-                                             [] (const auto& v) { return !is_missing(v) ? std::stof(v) : get_bcf_float_missing(); });
+                  const auto& values = source.typed_sample_value(sample, key);
+                  value_itr = copy_float(values, value_itr);
                   assert(values.size() <= num_values_per_sample);
                   value_itr = std::fill_n(value_itr, num_values_per_sample - values.size(), pad);
               }
@@ -938,18 +1117,22 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
           {
               bc::small_vector<const char*, defaultValueCapacity> typed_values;
               if (key_cardinality && *key_cardinality <= 1) {
-                  typed_values.resize(num_values);
-                  auto value_itr = std::begin(typed_values);
+                  str_buffer.clear();
+                  str_buffer.reserve(num_values);
                   for (const auto& sample : samples) {
-                      const auto& values = source.get_sample_value(sample, key);
-                      value_itr = std::transform(std::cbegin(values), std::cend(values), value_itr,
-                                                 [] (const auto& value) { return value.c_str(); });
+                      const auto& values = source.typed_sample_value(sample, key);
+                      for (std::size_t i {0}; i < values.size(); ++i) {
+                          str_buffer.push_back(values.string(i));
+                      }
                   }
+                  typed_values.resize(num_values);
+                  std::transform(std::cbegin(str_buffer), std::cend(str_buffer), std::begin(typed_values),
+                                 [] (const auto& value) { return value.c_str(); });
               } else {
                   str_buffer.clear();
                   str_buffer.reserve(num_samples);
                   for (const auto& sample : samples) {
-                      str_buffer.push_back(utils::join(source.get_sample_value(sample, key), vcfspec::format::valueSeperator));
+                      str_buffer.push_back(utils::join(source.typed_sample_value(sample, key).to_strings(), vcfspec::format::valueSeperator));
                   }
                   num_values = num_samples;
                   typed_values.resize(num_values);
@@ -969,6 +1152,58 @@ bool HtslibBcfFacade::is_bcf() const noexcept
     return file_->format.format == bcf;
 }
 
+bool HtslibBcfFacade::can_concatenate(const HtslibBcfFacade& src) const noexcept
+{
+    return is_bcf() && file_->format.compression == bgzf && src.file_->format.compression == bgzf
+        && has_same_ids(src.header_.get(), header_.get(), BCF_DT_ID)
+        && has_same_ids(src.header_.get(), header_.get(), BCF_DT_CTG);
+}
+
+void HtslibBcfFacade::concatenate(HtslibBcfFacade& src)
+{
+    static const std::array<char, 28> bgzf_eof_marker {{
+        '\037', '\213', '\010', '\4', '\0', '\0', '\0', '\0', '\0', '\377', '\6', '\0', '\102', '\103',
+        '\2', '\0', '\033', '\0', '\3', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0'
+    }};
+    const auto src_bgzf = src.file_->fp.bgzf;
+    const auto dst_bgzf = file_->fp.bgzf;
+    // Any records decompressed along with the source header must be recompressed
+    if (src_bgzf->block_offset < src_bgzf->block_length) {
+        const auto first = static_cast<const char*>(src_bgzf->uncompressed_block) + src_bgzf->block_offset;
+        if (bgzf_write(dst_bgzf, first, src_bgzf->block_length - src_bgzf->block_offset) < 0) {
+            throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+        }
+    }
+    if (bgzf_flush(dst_bgzf) < 0) {
+        throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+    }
+    // The remaining blocks are copied as is, holding back enough bytes to drop the source EOF marker
+    const auto marker_size = bgzf_eof_marker.size();
+    std::vector<char> buffer(BGZF_MAX_BLOCK_SIZE + marker_size);
+    std::size_t num_held {0};
+    for (;;) {
+        const auto num_read = bgzf_raw_read(src_bgzf, buffer.data() + num_held, BGZF_MAX_BLOCK_SIZE);
+        if (num_read < 0) {
+            throw std::runtime_error {"HtslibBcfFacade: failed to read blocks from " + src.file_path_.string()};
+        }
+        if (num_read == 0) break;
+        num_held += num_read;
+        if (num_held > marker_size) {
+            const auto num_write = num_held - marker_size;
+            if (bgzf_raw_write(dst_bgzf, buffer.data(), num_write) < 0) {
+                throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+            }
+            std::copy(std::next(std::cbegin(buffer), num_write), std::next(std::cbegin(buffer), num_held), std::begin(buffer));
+            num_held = marker_size;
+        }
+    }
+    if (!(num_held == marker_size && std::equal(std::cbegin(bgzf_eof_marker), std::cend(bgzf_eof_marker), std::cbegin(buffer)))) {
+        if (num_held > 0 && bgzf_raw_write(dst_bgzf, buffer.data(), num_held) < 0) {
+            throw std::runtime_error {"HtslibBcfFacade: record write failed"};
+        }
+    }
+}
+
 std::size_t HtslibBcfFacade::count_records(HtsBcfSrPtr& sr) const
 {
     std::size_t result {0};
@@ -976,10 +1211,14 @@ std::size_t HtslibBcfFacade::count_records(HtsBcfSrPtr& sr) const
     return result;
 }
 
-VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const
+VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, const Projection& fields) const
 {
     auto hts_record = bcf_sr_get_line(sr, 0);
-    bcf_unpack(hts_record, level == UnpackPolicy::all ? BCF_UN_ALL : BCF_UN_SHR);
+    const bool unpack_samples {fields.any_format() && has_samples(header_.get())};
+    int unpack_level {BCF_UN_STR | BCF_UN_FLT};
+    if (fields.any_info()) unpack_level |= BCF_UN_INFO;
+    if (unpack_samples) unpack_level |= BCF_UN_FMT;
+    bcf_unpack(hts_record, unpack_level);
     VcfRecord::Builder record_builder {};
     extract_chrom(header_.get(), hts_record, record_builder);
     extract_pos(hts_record, record_builder);
@@ -988,20 +1227,22 @@ VcfRecord HtslibBcfFacade::fetch_record(const bcf_srs_t* sr, UnpackPolicy level)
     extract_alt(hts_record, record_builder);
     extract_qual(hts_record, record_builder);
     extract_filter(header_.get(), hts_record, record_builder);
-    extract_info(header_.get(), hts_record, record_builder);
-    if (level == UnpackPolicy::all && has_samples(header_.get())) {
-        extract_samples(header_.get(), hts_record, record_builder);
+    if (fields.any_info()) {
+        extract_info(header_.get(), hts_record, record_builder, fields);
+    }
+    if (unpack_samples) {
+        extract_samples(header_.get(), hts_record, record_builder, fields);
     }
     return record_builder.build_once();
 }
 
 HtslibBcfFacade::RecordContainer
-HtslibBcfFacade::fetch_records(bcf_srs_t* sr, const UnpackPolicy level, const std::size_t num_records) const
+HtslibBcfFacade::fetch_records(bcf_srs_t* sr, const Projection& fields, const std::size_t num_records) const
 {
     RecordContainer result {};
     result.reserve(num_records);
     while (bcf_sr_next_line(sr)) {
-        result.push_back(fetch_record(sr, level));
+        result.push_back(fetch_record(sr, fields));
     }
     return result;
 }
@@ -5,6 +5,7 @@
 #define htslib_bcf_facade_hpp
 
 #include <string>
+#include <vector>
 #include <set>
 #include <memory>
 #include <cstddef>
@@ -29,6 +30,7 @@ class HtslibBcfFacade : public IVcfReaderImpl
 public:
     using Path = boost::filesystem::path;
     using IVcfReaderImpl::UnpackPolicy;
+    using IVcfReaderImpl::Projection;
     using IVcfReaderImpl::RecordContainer;
     using IVcfReaderImpl::RecordIteratorPtrPair;
     class RecordIterator;
@@ -53,17 +55,23 @@ public:
     std::size_t count_records(const std::string& contig) const override;
     std::size_t count_records(const GenomicRegion& region) const override;
     
-    RecordIteratorPtrPair iterate(UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordIteratorPtrPair iterate(const Projection& fields) const override;
+    RecordIteratorPtrPair iterate(const std::string& contig, const Projection& fields) const override;
+    RecordIteratorPtrPair iterate(const GenomicRegion& region, const Projection& fields) const override;
     
-    RecordContainer fetch_records(UnpackPolicy level) const override;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const override;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordContainer fetch_records(const Projection& fields) const override;
+    RecordContainer fetch_records(const std::string& contig, const Projection& fields) const override;
+    RecordContainer fetch_records(const GenomicRegion& region, const Projection& fields) const override;
     
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
     
+    // Raw record transfer. Records are copied from BCF sources without being decoded into
+    // VcfRecord, so INFO and FORMAT fields are never unpacked. Sources must be freshly opened.
+    bool can_write_raw(const HtslibBcfFacade& src) const noexcept;
+    void append_raw(HtslibBcfFacade& src);
+    void merge_raw(std::vector<HtslibBcfFacade>& sources, const std::vector<std::string>& contigs);
+    
 private:
     struct HtsFileDeleter
     {
@@ -91,9 +99,11 @@ private:
     std::vector<std::string> samples_;
     
     bool is_bcf() const noexcept;
+    bool can_concatenate(const HtslibBcfFacade& src) const noexcept;
+    void concatenate(HtslibBcfFacade& src);
     std::size_t count_records(HtsBcfSrPtr& sr) const;
-    VcfRecord fetch_record(const bcf_srs_t* sr, UnpackPolicy level) const;
-    RecordContainer fetch_records(bcf_srs_t*, UnpackPolicy level, size_t num_records) const;
+    VcfRecord fetch_record(const bcf_srs_t* sr, const Projection& fields) const;
+    RecordContainer fetch_records(bcf_srs_t*, const Projection& fields, size_t num_records) const;
     
     friend RecordIterator;
 };
@@ -108,7 +118,7 @@ public:
     using reference         = const VcfRecord&;
     
     RecordIterator(const HtslibBcfFacade& facade);
-    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, UnpackPolicy level);
+    RecordIterator(const HtslibBcfFacade& facade, HtsBcfSrPtr hts_iterator, Projection fields);
     
     RecordIterator(const RecordIterator&)            = default;
     RecordIterator& operator=(const RecordIterator&) = default;
@@ -136,7 +146,7 @@ private:
     std::reference_wrapper<const HtslibBcfFacade> facade_;
     
     HtsBcfSrSharedPtr hts_iterator_;
-    UnpackPolicy level_;
+    Projection fields_;
     
     std::shared_ptr<VcfRecord> record_;
 };
@@ -16,7 +16,8 @@ namespace octopus {
 
 VcfHeader parse_header(std::ifstream& vcf_file);
 bool overlaps(const std::string& line, const GenomicRegion& region);
-VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::SampleName>& samples = {});
+VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::SampleName>& samples,
+                       const IVcfReaderImpl::Projection& fields);
 
 template <char Delim>
 struct Token
@@ -83,64 +84,61 @@ std::size_t VcfParser::count_records(const GenomicRegion& region) const
     return result;
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const Projection& fields) const
 {
     reset_vcf();
-    return std::make_pair(std::make_unique<RecordIterator>(*this, level),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, fields),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(const std::string& contig, UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const std::string& contig, const Projection& fields) const
 {
     reset_vcf();
-    return std::make_pair(std::make_unique<RecordIterator>(*this, level, contig),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, fields, contig),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordIteratorPtrPair VcfParser::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+VcfParser::RecordIteratorPtrPair VcfParser::iterate(const GenomicRegion& region, const Projection& fields) const
 {
     reset_vcf();
-    return std::make_pair(std::make_unique<RecordIterator>(*this, level, region),
+    return std::make_pair(std::make_unique<RecordIterator>(*this, fields, region),
                           std::make_unique<RecordIterator>());
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const Projection& fields) const
 {
     RecordContainer result {};
     result.reserve(count_records());
-    bool unpack_all {level == UnpackPolicy::all};
     std::transform(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
-                   std::back_inserter(result), [this, unpack_all] (const auto& line) {
-                       return (unpack_all) ? parse_record(line, samples_) : parse_record(line);
+                   std::back_inserter(result), [this, &fields] (const auto& line) {
+                       return parse_record(line, samples_, fields);
                    });
     reset_vcf();
     return result;
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const std::string& contig, const Projection& fields) const
 {
     RecordContainer result {};
     result.reserve(count_records(contig));
-    bool unpack_all {level == UnpackPolicy::all};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
-                  [this, &result, &contig, unpack_all] (const auto& line) {
+                  [this, &result, &contig, &fields] (const auto& line) {
                       if (is_same_contig(line, contig)) {
-                          result.push_back((unpack_all) ? parse_record(line, samples_) : parse_record(line));
+                          result.push_back(parse_record(line, samples_, fields));
                       }
                   });
     reset_vcf();
     return result;
 }
 
-VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+VcfParser::RecordContainer VcfParser::fetch_records(const GenomicRegion& region, const Projection& fields) const
 {
     RecordContainer result {};
     result.reserve(count_records(region));
-    bool unpack_all {level == UnpackPolicy::all};
     std::for_each(std::istream_iterator<Line>(file_), std::istream_iterator<Line>(),
-                  [this, &result, &region, unpack_all] (const std::string& line) {
+                  [this, &result, &region, &fields] (const std::string& line) {
                       if (overlaps(line, region)) {
-                          result.push_back((unpack_all) ? parse_record(line, samples_) : parse_record(line));
+                          result.push_back(parse_record(line, samples_, fields));
                       }
                   });
     reset_vcf();
@@ -314,12 +312,14 @@ void parse_info_field(const std::string& field, VcfRecord::Builder& rb)
 
 using InfoField = Token<';'>;
 
-void parse_info(const std::string& column, VcfRecord::Builder& rb)
+void parse_info(const std::string& column, const IVcfReaderImpl::Projection& fields, VcfRecord::Builder& rb)
 {
     std::istringstream ss {column};
     std::for_each(std::istream_iterator<InfoField>(ss), std::istream_iterator<InfoField>(),
-                  [&rb] (const auto& field) {
-                      parse_info_field(field, rb);
+                  [&rb, &fields] (const std::string& field) {
+                      if (fields.all_info() || fields.includes_info(field.substr(0, field.find_first_of('=')))) {
+                          parse_info_field(field, rb);
+                      }
                   });
 }
 
@@ -357,24 +357,30 @@ void parse_genotype(const VcfRecord::SampleName& sample, const std::string& geno
 using SampleField = Token<':'>;
 
 void parse_sample(const std::string& column, const VcfRecord::SampleName& sample,
-                  const std::vector<std::string>& format, VcfRecord::Builder& rb)
+                  const std::vector<std::string>& format, const IVcfReaderImpl::Projection& fields,
+                  VcfRecord::Builder& rb)
 {
     auto first_key = std::cbegin(format);
     std::istringstream ss {column};
     std::istream_iterator<SampleField> first_value {ss};
     if (format.front() == "GT") { // GT must always come first, if present
-        parse_genotype(sample, *first_value, rb);
+        if (fields.includes_format(*first_key)) {
+            parse_genotype(sample, *first_value, rb);
+        }
         ++first_key;
         ++first_value;
     }
     std::for_each(first_value, std::istream_iterator<SampleField> {},
-                  [&rb, &sample, &first_key] (const std::string& value) {
-                      rb.set_format(sample, *first_key, split(value, ','));
+                  [&rb, &sample, &first_key, &fields] (const std::string& value) {
+                      if (fields.includes_format(*first_key)) {
+                          rb.set_format(sample, *first_key, split(value, ','));
+                      }
                       ++first_key;
                   });
 }
 
-VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::SampleName>& samples)
+VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::SampleName>& samples,
+                       const IVcfReaderImpl::Projection& fields)
 {
     std::istringstream ss {line};
     std::istream_iterator<Column> it {ss}, eos {};
@@ -406,16 +412,23 @@ VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::Sam
         rb.set_filter(split(it->data, ';'));
     }
     ++it;
-    parse_info(it->data, rb);
+    if (fields.any_info()) {
+        parse_info(it->data, fields, rb);
+    }
     ++it;
     
-    if (!samples.empty() && it != eos) {
+    if (!samples.empty() && fields.any_format() && it != eos) {
         auto format = split(it->data, ':');
         ++it;
         for (const auto& sample : samples) {
-            parse_sample(it->data, sample, format, rb); // set after so can move
+            parse_sample(it->data, sample, format, fields, rb); // set after so can move
             ++it;
         }
+        if (!fields.all_format()) {
+            format.erase(std::remove_if(std::begin(format), std::end(format),
+                                        [&fields] (const auto& key) { return !fields.includes_format(key); }),
+                         std::end(format));
+        }
         rb.set_format(std::move(format));
     }
     
@@ -424,27 +437,23 @@ VcfRecord parse_record(const std::string& line, const std::vector<VcfRecord::Sam
 
 // VcfParser::RecordIterator
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack)
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, Projection fields)
 : parent_vcf_ {&vcf}
-, unpack_ {unpack}
+, fields_ {std::move(fields)}
 , local_ {vcf.file_path_.string()}
 , contig_ {}
 , region_ {}
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
-            record_ = std::make_shared<VcfRecord>(parse_record(line_, vcf.samples_));
-        } else {
-            record_ = std::make_shared<VcfRecord>(parse_record(line_));
-        }
+        record_ = std::make_shared<VcfRecord>(parse_record(line_, vcf.samples_, fields_));
     } else {
         record_ = nullptr;
     }
 }
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, std::string contig)
-: RecordIterator {vcf, unpack}
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, Projection fields, std::string contig)
+: RecordIterator {vcf, std::move(fields)}
 {
     contig_ = std::move(contig);
     if (record_ && record_->chrom() != *contig_) {
@@ -452,8 +461,8 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
     }
 }
 
-VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, GenomicRegion region)
-: RecordIterator {vcf, unpack}
+VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, Projection fields, GenomicRegion region)
+: RecordIterator {vcf, std::move(fields)}
 {
     region_ = std::move(region);
     if (record_ && !overlaps(*record_, *region_)) {
@@ -463,16 +472,12 @@ VcfParser::RecordIterator::RecordIterator(const VcfParser& vcf, UnpackPolicy unp
 
 VcfParser::RecordIterator::RecordIterator(const RecordIterator& other)
 : parent_vcf_ {other.parent_vcf_}
-, unpack_ {other.unpack_}
+, fields_ {other.fields_}
 , local_ {parent_vcf_->file_path_.string()}
 {
     local_.seekg(parent_vcf_->file_.tellg());
     if (std::getline(local_, line_)) {
-        if (unpack_ == UnpackPolicy::all) {
-            record_ = std::make_shared<VcfRecord>(parse_record(line_, parent_vcf_->samples_));
-        } else {
-            record_ = std::make_shared<VcfRecord>(parse_record(line_));
-        }
+        record_ = std::make_shared<VcfRecord>(parse_record(line_, parent_vcf_->samples_, fields_));
     } else {
         record_ = nullptr;
     }
@@ -482,7 +487,7 @@ VcfParser::RecordIterator& VcfParser::RecordIterator::operator=(RecordIterator o
 {
     using std::swap;
     swap(parent_vcf_, other.parent_vcf_);
-    swap(unpack_,     other.unpack_);
+    swap(fields_,     other.fields_);
     swap(local_,      other.local_);
     return *this;
 }
@@ -500,11 +505,7 @@ VcfParser::RecordIterator::pointer VcfParser::RecordIterator::operator->() const
 void VcfParser::RecordIterator::next()
 {
     while (std::getline(local_, line_) && !line_.empty()) {
-        if (unpack_ == UnpackPolicy::all) {
-            *record_ = parse_record(line_, parent_vcf_->samples_);
-        } else {
-            *record_ = parse_record(line_);
-        }
+        *record_ = parse_record(line_, parent_vcf_->samples_, fields_);
         if (region_) {
             if (!overlaps(*record_, *region_)) continue;
         } else if (contig_) {
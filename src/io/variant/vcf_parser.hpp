@@ -52,13 +52,13 @@ public:
     std::size_t count_records(const std::string& contig) const override;
     std::size_t count_records(const GenomicRegion& region) const override;
     
-    RecordIteratorPtrPair iterate(UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const override;
-    RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordIteratorPtrPair iterate(const Projection& fields) const override;
+    RecordIteratorPtrPair iterate(const std::string& contig, const Projection& fields) const override;
+    RecordIteratorPtrPair iterate(const GenomicRegion& region, const Projection& fields) const override;
     
-    RecordContainer fetch_records(UnpackPolicy level) const override;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const override;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const override;
+    RecordContainer fetch_records(const Projection& fields) const override;
+    RecordContainer fetch_records(const std::string& contig, const Projection& fields) const override;
+    RecordContainer fetch_records(const GenomicRegion& region, const Projection& fields) const override;
     
     friend RecordIterator;
     friend bool operator==(const RecordIterator& lhs, const RecordIterator& rhs);
@@ -87,9 +87,9 @@ public:
     
     RecordIterator() = default;
     
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack);
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, std::string contig);
-    RecordIterator(const VcfParser& vcf, UnpackPolicy unpack, GenomicRegion region);
+    RecordIterator(const VcfParser& vcf, Projection fields);
+    RecordIterator(const VcfParser& vcf, Projection fields, std::string contig);
+    RecordIterator(const VcfParser& vcf, Projection fields, GenomicRegion region);
     
     RecordIterator(const RecordIterator&);
     RecordIterator& operator=(RecordIterator);
@@ -113,7 +113,7 @@ public:
 private:
     std::shared_ptr<VcfRecord> record_;
     const VcfParser* parent_vcf_;
-    UnpackPolicy unpack_;
+    Projection fields_;
     mutable std::ifstream local_;
     mutable std::string line_;
     boost::optional<std::string> contig_;
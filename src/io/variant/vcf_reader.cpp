@@ -183,42 +183,42 @@ std::size_t VcfReader::count_records(const GenomicRegion& region) const
     return reader_->count_records(region);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return reader_->fetch_records(level);
+    return reader_->fetch_records(fields);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const std::string& contig, const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const std::string& contig, const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return reader_->fetch_records(contig, level);
+    return reader_->fetch_records(contig, fields);
 }
 
-VcfReader::RecordContainer VcfReader::fetch_records(const GenomicRegion& region, const UnpackPolicy level) const
+VcfReader::RecordContainer VcfReader::fetch_records(const GenomicRegion& region, const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    return reader_->fetch_records(region, level);
+    return reader_->fetch_records(region, fields);
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const UnpackPolicy level) const
+VcfReader::RecordIteratorPair VcfReader::iterate(const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    auto p = reader_->iterate(level);
+    auto p = reader_->iterate(fields);
     return std::make_pair(std::move(p.first), std::move(p.second));
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const std::string& contig, const UnpackPolicy level) const
+VcfReader::RecordIteratorPair VcfReader::iterate(const std::string& contig, const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    auto p = reader_->iterate(contig, level);
+    auto p = reader_->iterate(contig, fields);
     return std::make_pair(std::move(p.first), std::move(p.second));
 }
 
-VcfReader::RecordIteratorPair VcfReader::iterate(const GenomicRegion& region, const UnpackPolicy level) const
+VcfReader::RecordIteratorPair VcfReader::iterate(const GenomicRegion& region, const Projection& fields) const
 {
     std::lock_guard<std::mutex> lock {mutex_};
-    auto p = reader_->iterate(region, level);
+    auto p = reader_->iterate(region, fields);
     return std::make_pair(std::move(p.first), std::move(p.second));
 }
 
@@ -29,6 +29,7 @@ class VcfReader
 public:
     using Path = boost::filesystem::path;
     using UnpackPolicy = IVcfReaderImpl::UnpackPolicy;
+    using Projection = IVcfReaderImpl::Projection;
     using RecordContainer = IVcfReaderImpl::RecordContainer;
     
     class RecordIterator;
@@ -59,13 +60,13 @@ public:
     std::size_t count_records(const std::string& contig) const;
     std::size_t count_records(const GenomicRegion& region) const;
     
-    RecordContainer fetch_records(UnpackPolicy level = UnpackPolicy::all) const;
-    RecordContainer fetch_records(const std::string& contig, UnpackPolicy level = UnpackPolicy::all) const;
-    RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const Projection& fields = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const std::string& contig, const Projection& fields = UnpackPolicy::all) const;
+    RecordContainer fetch_records(const GenomicRegion& region, const Projection& fields = UnpackPolicy::all) const;
     
-    RecordIteratorPair iterate(UnpackPolicy level = UnpackPolicy::all) const;
-    RecordIteratorPair iterate(const std::string& contig, UnpackPolicy level = UnpackPolicy::all) const;
-    RecordIteratorPair iterate(const GenomicRegion& region, UnpackPolicy level = UnpackPolicy::all) const;
+    RecordIteratorPair iterate(const Projection& fields = UnpackPolicy::all) const;
+    RecordIteratorPair iterate(const std::string& contig, const Projection& fields = UnpackPolicy::all) const;
+    RecordIteratorPair iterate(const GenomicRegion& region, const Projection& fields = UnpackPolicy::all) const;
     
 private:
     Path file_path_;
@@ -9,6 +9,9 @@
 #include <cstddef>
 #include <memory>
 #include <utility>
+#include <algorithm>
+
+#include <boost/optional.hpp>
 
 namespace octopus {
 
@@ -21,6 +24,8 @@ class IVcfReaderImpl
 public:
     enum class UnpackPolicy { all, sites };
     
+    class Projection;
+    
     using RecordContainer = std::vector<VcfRecord>;
     
     class RecordIterator
@@ -53,17 +58,55 @@ public:
     virtual std::size_t count_records(const std::string& contig) const = 0;
     virtual std::size_t count_records(const GenomicRegion& region) const = 0;
     
-    virtual RecordContainer fetch_records(UnpackPolicy level) const = 0; // fetches all records
-    virtual RecordContainer fetch_records(const std::string& contig, UnpackPolicy level) const = 0;
-    virtual RecordContainer fetch_records(const GenomicRegion& region, UnpackPolicy level) const = 0;
+    virtual RecordContainer fetch_records(const Projection& fields) const = 0; // fetches all records
+    virtual RecordContainer fetch_records(const std::string& contig, const Projection& fields) const = 0;
+    virtual RecordContainer fetch_records(const GenomicRegion& region, const Projection& fields) const = 0;
     
-    virtual RecordIteratorPtrPair iterate(UnpackPolicy level) const = 0;
-    virtual RecordIteratorPtrPair iterate(const std::string& contig, UnpackPolicy level) const  = 0;
-    virtual RecordIteratorPtrPair iterate(const GenomicRegion& region, UnpackPolicy level) const = 0;
+    virtual RecordIteratorPtrPair iterate(const Projection& fields) const = 0;
+    virtual RecordIteratorPtrPair iterate(const std::string& contig, const Projection& fields) const  = 0;
+    virtual RecordIteratorPtrPair iterate(const GenomicRegion& region, const Projection& fields) const = 0;
     
     virtual ~IVcfReaderImpl() noexcept = default;
 };
 
+// Selects the INFO and FORMAT fields that are decoded into each VcfRecord; the site
+// columns (CHROM, POS, ID, REF, ALT, QUAL, FILTER) are always decoded. Readers skip
+// fields that are not selected, so the cost of a pass is bounded by the fields used.
+class IVcfReaderImpl::Projection
+{
+public:
+    using KeyList = std::vector<std::string>;
+    
+    Projection(UnpackPolicy level = UnpackPolicy::all) // implicit
+    : info_keys_ {}
+    , format_keys_ {}
+    {
+        if (level == UnpackPolicy::sites) format_keys_ = KeyList {};
+    }
+    
+    Projection(KeyList info_keys, KeyList format_keys = {}) // GT must be listed if required
+    : info_keys_ {std::move(info_keys)}
+    , format_keys_ {std::move(format_keys)}
+    {}
+    
+    bool all_info() const noexcept { return !info_keys_; }
+    bool all_format() const noexcept { return !format_keys_; }
+    bool any_info() const noexcept { return !info_keys_ || !info_keys_->empty(); }
+    bool any_format() const noexcept { return !format_keys_ || !format_keys_->empty(); }
+    
+    bool includes_info(const std::string& key) const noexcept
+    {
+        return !info_keys_ || std::find(std::cbegin(*info_keys_), std::cend(*info_keys_), key) != std::cend(*info_keys_);
+    }
+    bool includes_format(const std::string& key) const noexcept
+    {
+        return !format_keys_ || std::find(std::cbegin(*format_keys_), std::cend(*format_keys_), key) != std::cend(*format_keys_);
+    }
+    
+private:
+    boost::optional<KeyList> info_keys_, format_keys_; // none means all keys
+};
+
 } // namespace octopus    
 
 #endif
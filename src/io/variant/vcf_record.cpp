@@ -5,9 +5,11 @@
 
 #include <algorithm>
 #include <iterator>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
 
-#include <boost/lexical_cast.hpp>
-
+#include "utils/free_memory.hpp"
 #include "vcf_spec.hpp"
 
 namespace octopus {
@@ -81,7 +83,12 @@ std::vector<VcfRecord::KeyType> VcfRecord::info_keys() const
     return result;
 }
 
-const std::vector<VcfRecord::ValueType>& VcfRecord::info_value(const KeyType& key) const
+std::vector<VcfRecord::ValueType> VcfRecord::info_value(const KeyType& key) const
+{
+    return info_.at(key).to_strings();
+}
+
+const VcfRecord::Values& VcfRecord::typed_info_value(const KeyType& key) const
 {
     return info_.at(key);
 }
@@ -127,6 +134,11 @@ unsigned VcfRecord::ploidy(const SampleName& sample) const
     return static_cast<unsigned>(genotypes_.at(sample).first.size());
 }
 
+const std::vector<VcfRecord::NucleotideSequence>& VcfRecord::genotype(const SampleName& sample) const
+{
+    return genotypes_.at(sample).first;
+}
+
 bool VcfRecord::is_sample_phased(const SampleName& sample) const
 {
     return genotypes_.at(sample).second;
@@ -180,9 +192,14 @@ bool VcfRecord::has_alt_allele(const SampleName& sample) const
                             }) != std::cend(genotype);
 }
 
-const std::vector<VcfRecord::ValueType>& VcfRecord::get_sample_value(const SampleName& sample, const KeyType& key) const
+std::vector<VcfRecord::ValueType> VcfRecord::get_sample_value(const SampleName& sample, const KeyType& key) const
 {
-    return (key == vcfspec::format::genotype) ? genotypes_.at(sample).first : samples_.at(sample).at(key);
+    return (key == vcfspec::format::genotype) ? genotypes_.at(sample).first : samples_.at(sample).at(key).to_strings();
+}
+
+const VcfRecord::Values& VcfRecord::typed_sample_value(const SampleName& sample, const KeyType& key) const
+{
+    return samples_.at(sample).at(key);
 }
 
 // helper non-members needed for printing
@@ -252,13 +269,13 @@ void VcfRecord::print_info(std::ostream& os) const
                       [&os] (const auto& p) {
                           os << p.first;
                           if (!p.second.empty()) {
-                              os << "=" << p.second;
+                              os << "=" << p.second.to_strings();
                           }
                           os << ';';
                       });
         os << last->first;
         if (!last->second.empty()) {
-            os << "=" << last->second;
+            os << "=" << last->second.to_strings();
         }
     }
 }
@@ -281,10 +298,10 @@ void VcfRecord::print_other_sample_data(std::ostream& os, const SampleName& samp
             const auto& data = samples_.at(sample);
             auto last = std::next(cbegin(data), data.size() - 1);
             std::for_each(std::cbegin(data), last, [&os] (const auto& p) {
-                print(os, p.second, ",");
+                print(os, p.second.to_strings(), ",");
                 os << ":";
             });
-            print(os, last->second, ",");
+            print(os, last->second.to_strings(), ",");
         }
     }
 }
@@ -322,21 +339,176 @@ void VcfRecord::print_sample_data(std::ostream& os) const
     }
 }
 
+// VcfRecord::Values
+
+namespace {
+
+constexpr std::uint32_t missing_real_bits {0x7F800001};
+
+VcfRecord::Values::FloatType make_missing_real() noexcept
+{
+    VcfRecord::Values::FloatType result;
+    std::memcpy(&result, &missing_real_bits, sizeof(result));
+    return result;
+}
+
+bool is_missing_real(const VcfRecord::Values::FloatType value) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits == missing_real_bits;
+}
+
+} // namespace
+
+constexpr VcfRecord::Values::IntegerType VcfRecord::Values::missing_integer;
+const VcfRecord::Values::FloatType VcfRecord::Values::missing_real {make_missing_real()};
+
+VcfRecord::Values::Values(std::vector<ValueType> values)
+: type_ {Type::string}
+, strings_ {std::move(values)}
+{}
+
+VcfRecord::Values::Values(std::vector<IntegerType> values)
+: type_ {Type::integer}
+, integers_ {std::move(values)}
+{}
+
+VcfRecord::Values::Values(std::vector<FloatType> values)
+: type_ {Type::real}
+, reals_ {std::move(values)}
+{}
+
+VcfRecord::Values::Type VcfRecord::Values::type() const noexcept
+{
+    return type_;
+}
+
+std::size_t VcfRecord::Values::size() const noexcept
+{
+    switch (type_) {
+        case Type::integer: return integers_.size();
+        case Type::real: return reals_.size();
+        default: return strings_.size();
+    }
+}
+
+bool VcfRecord::Values::empty() const noexcept
+{
+    return size() == 0;
+}
+
+bool VcfRecord::Values::is_missing(const std::size_t idx) const noexcept
+{
+    if (idx >= size()) return true;
+    switch (type_) {
+        case Type::integer: return integers_[idx] == missing_integer;
+        case Type::real: return is_missing_real(reals_[idx]);
+        default: return strings_[idx] == vcfspec::missingValue;
+    }
+}
+
+VcfRecord::Values::IntegerType VcfRecord::Values::integer(const std::size_t idx) const
+{
+    switch (type_) {
+        case Type::integer: return integers_.at(idx);
+        case Type::real: return is_missing(idx) ? missing_integer : static_cast<IntegerType>(reals_.at(idx));
+        default: return is_missing(idx) ? missing_integer : static_cast<IntegerType>(std::stoll(strings_.at(idx)));
+    }
+}
+
+VcfRecord::Values::FloatType VcfRecord::Values::real(const std::size_t idx) const
+{
+    switch (type_) {
+        case Type::integer: return is_missing(idx) ? missing_real : static_cast<FloatType>(integers_.at(idx));
+        case Type::real: return reals_.at(idx);
+        default: return is_missing(idx) ? missing_real : std::stof(strings_.at(idx));
+    }
+}
+
+VcfRecord::Values::ValueType VcfRecord::Values::string(const std::size_t idx) const
+{
+    if (type_ == Type::string) return strings_.at(idx);
+    if (is_missing(idx)) return vcfspec::missingValue;
+    return type_ == Type::integer ? std::to_string(integers_.at(idx)) : std::to_string(reals_.at(idx));
+}
+
+const std::vector<VcfRecord::Values::ValueType>& VcfRecord::Values::strings() const noexcept
+{
+    return strings_;
+}
+
+const std::vector<VcfRecord::Values::IntegerType>& VcfRecord::Values::integers() const noexcept
+{
+    return integers_;
+}
+
+const std::vector<VcfRecord::Values::FloatType>& VcfRecord::Values::reals() const noexcept
+{
+    return reals_;
+}
+
+std::vector<VcfRecord::Values::ValueType> VcfRecord::Values::to_strings() const
+{
+    if (type_ == Type::string) return strings_;
+    std::vector<ValueType> result {};
+    result.reserve(size());
+    for (std::size_t idx {0}; idx < size(); ++idx) {
+        result.push_back(string(idx));
+    }
+    return result;
+}
+
+void VcfRecord::Values::push_back(ValueType value)
+{
+    if (type_ != Type::string) {
+        strings_ = to_strings();
+        free_memory(integers_);
+        free_memory(reals_);
+        type_ = Type::string;
+    }
+    strings_.push_back(std::move(value));
+}
+
 // non-member functions
 
-std::vector<VcfRecord::NucleotideSequence> get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample)
+const std::vector<VcfRecord::NucleotideSequence>& get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample)
 {
-    return record.get_sample_value(sample, vcfspec::format::genotype);
+    return record.genotype(sample);
 }
 
-bool is_missing(const std::vector<VcfRecord::ValueType>& values) noexcept
+bool is_missing(const VcfRecord::Values& values) noexcept
 {
-    return values.size() < 2 && values.front() == vcfspec::missingValue;
+    return values.size() < 2 && values.is_missing(0);
 }
 
 bool is_info_missing(const VcfRecord::KeyType& key, const VcfRecord& record)
 {
-    return !record.has_info(key) || is_missing(record.info_value(key));
+    return !record.has_info(key) || is_missing(record.typed_info_value(key));
+}
+
+boost::optional<VcfRecord::Values::IntegerType> get_integer(const VcfRecord::Values& values, const std::size_t idx)
+{
+    if (values.is_missing(idx)) return boost::none;
+    return values.integer(idx);
+}
+
+boost::optional<VcfRecord::Values::FloatType> get_real(const VcfRecord::Values& values, const std::size_t idx)
+{
+    if (values.is_missing(idx)) return boost::none;
+    return values.real(idx);
+}
+
+boost::optional<VcfRecord::Values::IntegerType> get_info_integer(const VcfRecord& record, const VcfRecord::KeyType& key)
+{
+    if (!record.has_info(key)) return boost::none;
+    return get_integer(record.typed_info_value(key));
+}
+
+boost::optional<VcfRecord::Values::FloatType> get_info_real(const VcfRecord& record, const VcfRecord::KeyType& key)
+{
+    if (!record.has_info(key)) return boost::none;
+    return get_real(record.typed_info_value(key));
 }
 
 bool is_refcall(const VcfRecord& record)
@@ -383,14 +555,16 @@ bool is_validated(const VcfRecord& record) noexcept
 boost::optional<GenomicRegion> get_phase_region(const VcfRecord& record, const VcfRecord::SampleName& sample)
 {
     if (record.is_sample_phased(sample) && record.has_format(vcfspec::format::phaseSet)) {
-        return GenomicRegion {
-        record.chrom(),
-        boost::lexical_cast<ContigRegion::Position>(record.get_sample_value(sample, vcfspec::format::phaseSet).front()) - 1,
-        static_cast<ContigRegion::Position>(record.pos() + record.ref().size()) - 1
-        };
-    } else {
-        return boost::none;
+        const auto phase_set = get_integer(record.typed_sample_value(sample, vcfspec::format::phaseSet));
+        if (phase_set && *phase_set > 0) {
+            return GenomicRegion {
+            record.chrom(),
+            static_cast<ContigRegion::Position>(*phase_set) - 1,
+            static_cast<ContigRegion::Position>(record.pos() + record.ref().size()) - 1
+            };
+        }
     }
+    return boost::none;
 }
 
 bool operator==(const VcfRecord& lhs, const VcfRecord& rhs)
@@ -567,9 +741,20 @@ VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, std::initia
     return this->set_info(key, std::vector<ValueType> {values});
 }
 
+VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, Values values)
+{
+    if (key == "END") {
+        if (values.size() != 1)
+            throw std::runtime_error {"VcfRecord::Builder INFO key END requires 1 value"};
+        end_ = values.integer(0);
+    }
+    info_[key] = std::move(values);
+    return *this;
+}
+
 VcfRecord::Builder& VcfRecord::Builder::set_info_flag(KeyType key)
 {
-    return this->set_info(std::move(key), {});
+    return this->set_info(std::move(key), std::vector<ValueType> {});
 }
 
 VcfRecord::Builder& VcfRecord::Builder::set_info_missing(const KeyType& key)
@@ -670,6 +855,12 @@ VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, con
     return this->set_format(sample, key, std::vector<ValueType> {values});
 }
 
+VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, const KeyType& key, Values values)
+{
+    samples_[sample][key] = std::move(values);
+    return *this;
+}
+
 VcfRecord::Builder& VcfRecord::Builder::set_format_missing(const SampleName& sample, const KeyType& key)
 {
     return this->set_format(sample, key, std::string {vcfspec::missingValue});
@@ -13,6 +13,8 @@
 #include <utility>
 #include <initializer_list>
 #include <functional>
+#include <limits>
+#include <type_traits>
 
 #include <boost/optional.hpp>
 #include <boost/container/flat_map.hpp>
@@ -30,6 +32,7 @@ class VcfRecord : public Comparable<VcfRecord>, public Mappable<VcfRecord>
 {
 public:
     class Builder;
+    class Values;
     
     using NucleotideSequence = std::string;
     using QualityType        = float;
@@ -89,7 +92,8 @@ public:
     const std::vector<KeyType>& filter() const noexcept;
     bool has_info(const KeyType& key) const noexcept;
     std::vector<KeyType> info_keys() const;
-    const std::vector<ValueType>& info_value(const KeyType& key) const;
+    std::vector<ValueType> info_value(const KeyType& key) const;
+    const Values& typed_info_value(const KeyType& key) const;
     
     //
     // Sample releated functions
@@ -100,6 +104,7 @@ public:
     unsigned num_samples() const noexcept;
     bool has_genotypes() const noexcept;
     unsigned ploidy(const SampleName& sample) const;
+    const std::vector<NucleotideSequence>& genotype(const SampleName& sample) const;
     bool is_sample_phased(const SampleName& sample) const;
     bool is_homozygous(const SampleName& sample) const;
     bool is_heterozygous(const SampleName& sample) const;
@@ -108,14 +113,15 @@ public:
     bool is_homozygous_non_ref(const SampleName& sample) const;
     bool has_ref_allele(const SampleName& sample) const;
     bool has_alt_allele(const SampleName& sample) const;
-    const std::vector<ValueType>& get_sample_value(const SampleName& sample, const KeyType& key) const;
+    std::vector<ValueType> get_sample_value(const SampleName& sample, const KeyType& key) const;
+    const Values& typed_sample_value(const SampleName& sample, const KeyType& key) const; // not GT, see genotype
     
     friend std::ostream& operator<<(std::ostream& os, const VcfRecord& record);
     friend Builder;
     
 private:
     using Genotype = std::pair<std::vector<NucleotideSequence>, bool>;
-    using ValueMap = boost::container::flat_map<KeyType, std::vector<ValueType>>;
+    using ValueMap = boost::container::flat_map<KeyType, Values>;
     
     // mandatory fields
     GenomicRegion region_;
@@ -140,15 +146,75 @@ private:
     void print_sample_data(std::ostream& os) const;
 };
 
+// INFO and FORMAT values are kept in the type they were set with, so numeric fields can be
+// encoded directly rather than being converted to strings and parsed back again.
+class VcfRecord::Values
+{
+public:
+    using ValueType   = VcfRecord::ValueType;
+    using IntegerType = std::int32_t;
+    using FloatType   = float;
+    
+    enum class Type { string, integer, real };
+    
+    static constexpr IntegerType missing_integer = std::numeric_limits<IntegerType>::min();
+    // The NaN htslib uses for missing floats. It is matched by bit pattern, so other NaNs are
+    // values, and the check still holds when NaN tests are optimised away.
+    static const FloatType missing_real;
+    
+    Values() = default;
+    
+    Values(std::vector<ValueType> values);
+    Values(std::vector<IntegerType> values);
+    Values(std::vector<FloatType> values);
+    
+    Values(const Values&)            = default;
+    Values& operator=(const Values&) = default;
+    Values(Values&&)                 = default;
+    Values& operator=(Values&&)      = default;
+    
+    ~Values() = default;
+    
+    Type type() const noexcept;
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    
+    bool is_missing(std::size_t idx) const noexcept; // true if idx is out of range
+    IntegerType integer(std::size_t idx) const;
+    FloatType real(std::size_t idx) const;
+    ValueType string(std::size_t idx) const;
+    
+    // The vector matching type(), the others are empty
+    const std::vector<ValueType>& strings() const noexcept;
+    const std::vector<IntegerType>& integers() const noexcept;
+    const std::vector<FloatType>& reals() const noexcept;
+    
+    std::vector<ValueType> to_strings() const;
+    
+    void push_back(ValueType value);
+    
+private:
+    Type type_ = Type::string;
+    std::vector<ValueType> strings_;
+    std::vector<IntegerType> integers_;
+    std::vector<FloatType> reals_;
+};
+
 // non-member functions
 
-std::vector<VcfRecord::NucleotideSequence> get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample);
+const std::vector<VcfRecord::NucleotideSequence>& get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample);
 VcfRecord::NucleotideSequence get_ancestral_allele(const VcfRecord& record);
 std::vector<unsigned> get_allele_count(const VcfRecord& record);
 std::vector<double> get_allele_frequency(const VcfRecord& record);
 
 bool is_info_missing(const VcfRecord::KeyType& key, const VcfRecord& record);
 
+// boost::none if the value is absent or missing
+boost::optional<VcfRecord::Values::IntegerType> get_integer(const VcfRecord::Values& values, std::size_t idx = 0);
+boost::optional<VcfRecord::Values::FloatType> get_real(const VcfRecord::Values& values, std::size_t idx = 0);
+boost::optional<VcfRecord::Values::IntegerType> get_info_integer(const VcfRecord& record, const VcfRecord::KeyType& key);
+boost::optional<VcfRecord::Values::FloatType> get_info_real(const VcfRecord& record, const VcfRecord::KeyType& key);
+
 bool is_refcall(const VcfRecord& record);
 bool is_filtered(const VcfRecord& record) noexcept;
 bool is_dbsnp_member(const VcfRecord& record) noexcept;
@@ -202,9 +268,11 @@ public:
     Builder& reserve_info(unsigned n);
     Builder& add_info(const KeyType& key); // flags
     Builder& set_info(const KeyType& key, const ValueType& value);
-    template <typename T> Builder& set_info(const KeyType& key, const T& value); // calls std::to_string
+    template <typename T> Builder& set_info(const KeyType& key, const T& value); // numbers are stored natively
+    template <typename T> Builder& set_info(const KeyType& key, const std::vector<T>& values); // numbers only
     Builder& set_info(const KeyType& key, std::vector<ValueType> values);
     Builder& set_info(const KeyType& key, std::initializer_list<ValueType> values);
+    Builder& set_info(const KeyType& key, Values values);
     Builder& set_info_flag(KeyType key);
     Builder& set_info_missing(const KeyType& key);
     Builder& clear_info() noexcept;
@@ -221,9 +289,12 @@ public:
     Builder& clear_genotype(const SampleName& sample) noexcept;
     Builder& set_format(const SampleName& sample, const KeyType& key, const ValueType& value);
     template <typename T>
-    Builder& set_format(const SampleName& sample, const KeyType& key, const T& value); // calls std::to_string
+    Builder& set_format(const SampleName& sample, const KeyType& key, const T& value); // numbers are stored natively
+    template <typename T>
+    Builder& set_format(const SampleName& sample, const KeyType& key, const std::vector<T>& values); // numbers only
     Builder& set_format(const SampleName& sample, const KeyType& key, std::vector<ValueType> values);
     Builder& set_format(const SampleName& sample, const KeyType& key, std::initializer_list<ValueType> values);
+    Builder& set_format(const SampleName& sample, const KeyType& key, Values values);
     Builder& set_format_missing(const SampleName& sample, const KeyType& key);
     Builder& clear_format() noexcept;
     Builder& clear_format(const SampleName& sample) noexcept;
@@ -259,6 +330,9 @@ private:
     decltype(VcfRecord::genotypes_) genotypes_ = {};
     decltype(VcfRecord::samples_) samples_ = {};
     boost::optional<GenomicRegion::Position> end_;
+    
+    template <typename T> static Values make_values(const T& value, std::true_type);
+    template <typename T> static Values make_values(const T& value, std::false_type);
 };
 
 template <typename String1, typename String2, typename Sequence1, typename Sequence2,
@@ -330,17 +404,45 @@ VcfRecord::VcfRecord(GenomicRegion region, String&& id,
 {}
 
 template <typename T>
-VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, const T& value)
+VcfRecord::Values VcfRecord::Builder::make_values(const T& value, std::true_type)
+{
+    using NativeType = std::conditional_t<std::is_integral<T>::value, Values::IntegerType, Values::FloatType>;
+    return Values {std::vector<NativeType> {static_cast<NativeType>(value)}};
+}
+
+template <typename T>
+VcfRecord::Values VcfRecord::Builder::make_values(const T& value, std::false_type)
 {
     using std::to_string;
-    return set_info(key, to_string(value));
+    return Values {std::vector<ValueType> {to_string(value)}};
+}
+
+template <typename T>
+VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, const T& value)
+{
+    return set_info(key, make_values(value, std::is_arithmetic<T> {}));
+}
+
+template <typename T>
+VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, const std::vector<T>& values)
+{
+    static_assert(std::is_arithmetic<T>::value, "");
+    using NativeType = std::conditional_t<std::is_integral<T>::value, Values::IntegerType, Values::FloatType>;
+    return set_info(key, Values {std::vector<NativeType>(std::cbegin(values), std::cend(values))});
 }
 
 template <typename T>
 VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, const KeyType& key, const T& value)
 {
-    using std::to_string;
-    return set_format(sample, key, to_string(value));
+    return set_format(sample, key, make_values(value, std::is_arithmetic<T> {}));
+}
+
+template <typename T>
+VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, const KeyType& key, const std::vector<T>& values)
+{
+    static_assert(std::is_arithmetic<T>::value, "");
+    using NativeType = std::conditional_t<std::is_integral<T>::value, Values::IntegerType, Values::FloatType>;
+    return set_format(sample, key, Values {std::vector<NativeType>(std::cbegin(values), std::cend(values))});
 }
 
 } // namespace octopus
@@ -304,6 +304,14 @@ void merge_contig_unique(const std::vector<VcfReader>& sources, VcfWriter& dst,
                          const ReaderContigRecordCountMap& reader_contig_counts)
 {
     const auto contig_readers = extract_unique_readers(reader_contig_counts);
+    std::vector<VcfReader::Path> ordered_paths {};
+    ordered_paths.reserve(contig_readers.size());
+    for (const auto& contig : contigs) {
+        if (contig_readers.count(contig) == 1) {
+            ordered_paths.push_back(contig_readers.at(contig).get().path());
+        }
+    }
+    if (dst.try_append_raw(ordered_paths)) return;
     for (const auto& contig : contigs) {
         if (contig_readers.count(contig) == 1) {
             copy(contig_readers.at(contig), dst);
@@ -393,11 +401,25 @@ auto make_record_iterator_queue(const std::vector<VcfReader>& sources, const std
     return result;
 }
 
+auto get_paths(const std::vector<VcfReader>& readers)
+{
+    std::vector<VcfReader::Path> result {};
+    result.reserve(readers.size());
+    std::transform(std::cbegin(readers), std::cend(readers), std::back_inserter(result),
+                   [] (const VcfReader& reader) { return reader.path(); });
+    return result;
+}
+
 void merge(std::vector<VcfReader>& sources, VcfWriter& dst, const std::vector<std::string>& contigs)
 {
     if (sources.empty()) return;
     if (sources.size() == 1) {
-        copy(sources.front(), dst);
+        if (!dst.is_header_written()) {
+            dst << fetch_header(sources.front());
+        }
+        if (!dst.try_append_raw(get_paths(sources))) {
+            copy(sources.front(), dst);
+        }
         return;
     }
     if (!dst.is_header_written()) {
@@ -406,7 +428,7 @@ void merge(std::vector<VcfReader>& sources, VcfWriter& dst, const std::vector<st
     auto reader_contig_counts = get_contig_count_map(sources, contigs);
     if (is_unique_contig_per_reader(reader_contig_counts)) {
         merge_contig_unique(sources, dst, contigs, reader_contig_counts);
-    } else {
+    } else if (!dst.try_merge_raw(get_paths(sources), contigs)) {
         static constexpr std::size_t maxBufferSize {100000};
         if (count_records(reader_contig_counts) <= maxBufferSize) {
             one_step_merge(sources, dst, contigs, reader_contig_counts);
@@ -477,7 +499,7 @@ VcfRecord convert_to_legacy(const VcfRecord& record, const std::vector<std::stri
         cb.set_alt(std::move(new_alt));
     }
     for (const auto& sample : samples) {
-        const auto& gt = record.get_sample_value(sample, vcfspec::format::genotype);
+        const auto& gt = record.genotype(sample);
         const auto first_non_legacy = std::find_if(std::cbegin(gt), std::cend(gt), is_missing_or_has_deleted);
         if (first_non_legacy != std::cend(gt)) {
             const auto& ref = record.ref();
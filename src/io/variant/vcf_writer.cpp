@@ -5,6 +5,7 @@
 
 #include <stdexcept>
 #include <utility>
+#include <algorithm>
 #include <sstream>
 
 #include <boost/filesystem/operations.hpp>
@@ -175,6 +176,34 @@ void VcfWriter::write(const VcfRecord& record)
     }
 }
 
+bool VcfWriter::try_append_raw(const std::vector<Path>& sources)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (!(writer_ && is_header_written_)) return false;
+    // Sources are opened one at a time as there may be one per contig
+    const auto is_raw_source = [this] (const Path& source) { return writer_->can_write_raw(HtslibBcfFacade {source}); };
+    if (!std::all_of(std::cbegin(sources), std::cend(sources), is_raw_source)) return false;
+    for (const auto& source : sources) {
+        HtslibBcfFacade src {source};
+        writer_->append_raw(src);
+    }
+    return true;
+}
+
+bool VcfWriter::try_merge_raw(const std::vector<Path>& sources, const std::vector<std::string>& contigs)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    if (!(writer_ && is_header_written_)) return false;
+    std::vector<HtslibBcfFacade> srcs {};
+    srcs.reserve(sources.size());
+    for (const auto& source : sources) {
+        srcs.emplace_back(source);
+        if (!writer_->can_write_raw(srcs.back())) return false;
+    }
+    writer_->merge_raw(srcs, contigs);
+    return true;
+}
+
 bool VcfWriter::can_write_index() const noexcept
 {
     return file_path_ && is_header_written_
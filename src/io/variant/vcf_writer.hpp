@@ -4,6 +4,8 @@
 #ifndef vcf_writer_hpp
 #define vcf_writer_hpp
 
+#include <vector>
+#include <string>
 #include <memory>
 #include <mutex>
 #include <type_traits>
@@ -52,6 +54,11 @@ public:
     void write(const VcfHeader& header);
     void write(const VcfRecord& record);
     
+    // Copies records from BCF files without decoding them into VcfRecord. Nothing is written
+    // and false is returned if any source cannot be copied raw (e.g. it has different samples).
+    bool try_append_raw(const std::vector<Path>& sources);
+    bool try_merge_raw(const std::vector<Path>& sources, const std::vector<std::string>& contigs);
+    
 private:
     boost::optional<Path> file_path_;
     std::unique_ptr<HtslibBcfFacade> writer_;
@@ -0,0 +1,331 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "profiler.hpp"
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+
+#include "exceptions/unwritable_file_error.hpp"
+
+namespace octopus { namespace profiling {
+
+namespace detail {
+
+std::atomic<bool> enabled {false};
+thread_local CounterArray thread_counters {};
+
+} // namespace detail
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Event
+{
+    std::string name;
+    const char* category;
+    Clock::time_point begin, end;
+    detail::CounterArray counters;
+    bool has_counters;
+};
+
+class UnwritableTraceFile : public UnwritableFileError
+{
+    std::string do_where() const override { return "profiling::init"; }
+public:
+    UnwritableTraceFile(boost::filesystem::path file) : UnwritableFileError {std::move(file), "profile trace"} {}
+};
+
+class ThreadBuffer;
+
+class TraceWriter
+{
+public:
+    void open(const boost::filesystem::path& trace_file);
+    void close() noexcept;
+
+    void add(ThreadBuffer* buffer);
+    void remove(ThreadBuffer* buffer) noexcept;
+    int next_thread_id() noexcept { return next_thread_id_++; }
+
+    void write(int thread_id, const std::vector<Event>& events);
+
+private:
+    void write_unlocked(std::string formatted);
+    std::string format(int thread_id, const std::vector<Event>& events) const;
+
+    std::mutex mutex_;
+    std::ofstream file_;
+    Clock::time_point epoch_;
+    bool is_first_event_;
+    std::vector<ThreadBuffer*> buffers_;
+    std::atomic<int> next_thread_id_ {1};
+};
+
+TraceWriter& get_writer()
+{
+    static TraceWriter writer {};
+    return writer;
+}
+
+class ThreadBuffer
+{
+public:
+    ThreadBuffer() : thread_id_ {get_writer().next_thread_id()} { get_writer().add(this); }
+
+    ~ThreadBuffer()
+    {
+        flush();
+        get_writer().remove(this);
+    }
+
+    int thread_id() const noexcept { return thread_id_; }
+
+    void add(Event event)
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        events_.push_back(std::move(event));
+        if (events_.size() >= max_buffered_events_) {
+            auto events = take_unlocked();
+            lock.unlock();
+            get_writer().write(thread_id_, events);
+        }
+    }
+
+    void flush()
+    {
+        const auto events = take();
+        if (!events.empty()) get_writer().write(thread_id_, events);
+    }
+
+    // The buffer mutex is never held while waiting on the writer mutex, so the writer can take
+    // events from all buffers when closing
+    std::vector<Event> take()
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        return take_unlocked();
+    }
+
+private:
+    static constexpr std::size_t max_buffered_events_ {1024};
+
+    int thread_id_;
+    std::mutex mutex_;
+    std::vector<Event> events_;
+
+    std::vector<Event> take_unlocked()
+    {
+        std::vector<Event> result {};
+        result.reserve(max_buffered_events_);
+        std::swap(result, events_);
+        return result;
+    }
+};
+
+ThreadBuffer& get_thread_buffer()
+{
+    thread_local ThreadBuffer buffer {};
+    return buffer;
+}
+
+void TraceWriter::open(const boost::filesystem::path& trace_file)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    file_.open(trace_file.string());
+    if (!file_) {
+        throw UnwritableTraceFile {trace_file};
+    }
+    file_ << "{\"traceEvents\":[\n";
+    epoch_ = Clock::now();
+    is_first_event_ = true;
+}
+
+void TraceWriter::close() noexcept
+{
+    try {
+        // Buffers cannot be removed while the lock is held, so all are alive
+        std::lock_guard<std::mutex> lock {mutex_};
+        for (auto buffer : buffers_) {
+            const auto events = buffer->take();
+            if (!events.empty()) write_unlocked(format(buffer->thread_id(), events));
+        }
+        if (file_.is_open()) {
+            file_ << "\n]}\n";
+            file_.close();
+        }
+    } catch (...) {}
+}
+
+void TraceWriter::add(ThreadBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    buffers_.push_back(buffer);
+}
+
+void TraceWriter::remove(ThreadBuffer* buffer) noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    buffers_.erase(std::remove(std::begin(buffers_), std::end(buffers_), buffer), std::end(buffers_));
+}
+
+std::string escape(const std::string& str)
+{
+    std::string result {};
+    result.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+const char* to_string(const Counter counter) noexcept
+{
+    switch (counter) {
+        case Counter::reads: return "reads";
+        case Counter::haplotypes: return "haplotypes";
+        case Counter::genotypes: return "genotypes";
+        case Counter::pair_hmm_cells: return "pair_hmm_cells";
+    }
+    return "";
+}
+
+const char* to_string(const Stage stage) noexcept
+{
+    switch (stage) {
+        case Stage::candidate_generation: return "candidate_generation";
+        case Stage::haplotype_generation: return "haplotype_generation";
+        case Stage::haplotype_likelihoods: return "haplotype_likelihoods";
+        case Stage::latent_inference: return "latent_inference";
+        case Stage::phasing: return "phasing";
+        case Stage::vcf_record_construction: return "vcf_record_construction";
+    }
+    return "";
+}
+
+const char* to_string(const RegionTimer::Kind kind) noexcept
+{
+    return kind == RegionTimer::Kind::window ? "window" : "active_region";
+}
+
+double to_microseconds(const Clock::duration duration) noexcept
+{
+    return std::chrono::duration<double, std::micro> {duration}.count();
+}
+
+std::string TraceWriter::format(const int thread_id, const std::vector<Event>& events) const
+{
+    std::ostringstream ss {};
+    ss << std::fixed << std::setprecision(3);
+    for (const auto& event : events) {
+        ss << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\""
+           << ",\"ts\":" << to_microseconds(event.begin - epoch_) << ",\"dur\":" << to_microseconds(event.end - event.begin)
+           << ",\"pid\":1,\"tid\":" << thread_id;
+        if (event.has_counters) {
+            ss << ",\"args\":{";
+            for (std::size_t i {0}; i < num_counters; ++i) {
+                if (i > 0) ss << ',';
+                ss << '"' << to_string(static_cast<Counter>(i)) << "\":" << event.counters[i];
+            }
+            ss << '}';
+        }
+        ss << '}';
+    }
+    return ss.str();
+}
+
+void TraceWriter::write(const int thread_id, const std::vector<Event>& events)
+{
+    // Format outside the lock as writes can come from all calling threads
+    auto formatted = format(thread_id, events);
+    std::lock_guard<std::mutex> lock {mutex_};
+    write_unlocked(std::move(formatted));
+}
+
+void TraceWriter::write_unlocked(std::string formatted)
+{
+    if (!file_.is_open()) return;
+    if (is_first_event_) {
+        formatted.erase(0, 2); // leading ",\n"
+        is_first_event_ = false;
+    }
+    file_ << formatted;
+}
+
+} // namespace
+
+void init(const boost::filesystem::path& trace_file)
+{
+    get_writer().open(trace_file);
+    detail::enabled = true;
+}
+
+void close() noexcept
+{
+    if (detail::enabled.exchange(false)) {
+        get_writer().close();
+    }
+}
+
+StageTimer::StageTimer(const Stage stage) noexcept
+: stage_ {stage}
+, enabled_ {is_enabled()}
+, begin_ {}
+{
+    if (enabled_) begin_ = Clock::now();
+}
+
+StageTimer::~StageTimer()
+{
+    if (enabled_) {
+        try {
+            get_thread_buffer().add({to_string(stage_), "stage", begin_, Clock::now(), {}, false});
+        } catch (...) {}
+    }
+}
+
+RegionTimer::RegionTimer(const Kind kind, const GenomicRegion& region)
+: kind_ {kind}
+, enabled_ {is_enabled()}
+, region_ {}
+, begin_ {}
+, counters_ {}
+, is_set_ {}
+{
+    if (enabled_) {
+        region_ = region;
+        counters_ = detail::thread_counters;
+        begin_ = Clock::now();
+    }
+}
+
+RegionTimer::~RegionTimer()
+{
+    if (enabled_) {
+        const auto end = Clock::now();
+        for (std::size_t i {0}; i < num_counters; ++i) {
+            if (!is_set_[i]) counters_[i] = detail::thread_counters[i] - counters_[i];
+        }
+        try {
+            get_thread_buffer().add({to_string(*region_), to_string(kind_), begin_, end, counters_, true});
+        } catch (...) {}
+    }
+}
+
+void RegionTimer::set(const Counter counter, const std::size_t value) noexcept
+{
+    const auto idx = static_cast<std::size_t>(counter);
+    counters_[idx] = value;
+    is_set_[idx] = true;
+}
+
+} // namespace profiling
+} // namespace octopus
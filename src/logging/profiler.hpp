@@ -0,0 +1,124 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef profiler_hpp
+#define profiler_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+
+namespace octopus { namespace profiling {
+
+/*
+    Records where calling time is spent, per calling window and active region, as a Chrome
+    trace (load in chrome://tracing or Perfetto). Nothing is recorded unless init has been
+    called, and disabled timers cost a single relaxed atomic load.
+
+    Events are buffered per thread and written in batches, so recording is lock-free apart from
+    an uncontended per-thread mutex. Counters are also per thread, so work done on helper
+    threads (e.g. parallel likelihood population) is not attributed to the enclosing region.
+*/
+
+enum class Stage
+{
+    candidate_generation,
+    haplotype_generation,
+    haplotype_likelihoods,
+    latent_inference,
+    phasing,
+    vcf_record_construction
+};
+
+enum class Counter { reads, haplotypes, genotypes, pair_hmm_cells };
+
+constexpr std::size_t num_counters {4};
+
+void init(const boost::filesystem::path& trace_file);
+
+// Writes buffered events and closes the trace file. Safe to call more than once.
+void close() noexcept;
+
+namespace detail {
+
+using CounterArray = std::array<std::uint64_t, num_counters>;
+
+extern std::atomic<bool> enabled;
+extern thread_local CounterArray thread_counters;
+
+} // namespace detail
+
+inline bool is_enabled() noexcept
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Adds to the counters of the current thread
+inline void count(const Counter counter, const std::size_t n) noexcept
+{
+    if (is_enabled()) detail::thread_counters[static_cast<std::size_t>(counter)] += n;
+}
+
+class StageTimer
+{
+public:
+    StageTimer() = delete;
+
+    StageTimer(Stage stage) noexcept;
+
+    StageTimer(const StageTimer&)            = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    StageTimer(StageTimer&&)                 = delete;
+    StageTimer& operator=(StageTimer&&)      = delete;
+
+    ~StageTimer();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Stage stage_;
+    bool enabled_;
+    Clock::time_point begin_;
+};
+
+class RegionTimer
+{
+public:
+    enum class Kind { window, active_region };
+
+    RegionTimer() = delete;
+
+    RegionTimer(Kind kind, const GenomicRegion& region);
+
+    RegionTimer(const RegionTimer&)            = delete;
+    RegionTimer& operator=(const RegionTimer&) = delete;
+    RegionTimer(RegionTimer&&)                 = delete;
+    RegionTimer& operator=(RegionTimer&&)      = delete;
+
+    ~RegionTimer();
+
+    // Overrides the value that would otherwise be accumulated by count during the region
+    void set(Counter counter, std::size_t value) noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Kind kind_;
+    bool enabled_;
+    boost::optional<GenomicRegion> region_; // only copied when enabled
+    Clock::time_point begin_;
+    detail::CounterArray counters_;
+    std::array<bool, num_counters> is_set_;
+};
+
+} // namespace profiling
+} // namespace octopus
+
+#endif
@@ -10,13 +10,16 @@
 #include "config/common.hpp"
 #include "logging/logging.hpp"
 #include "logging/main_logging.hpp"
+#include "logging/profiler.hpp"
 #include "config/option_parser.hpp"
 #include "config/option_collation.hpp"
 #include "core/octopus.hpp"
 #include "utils/timing.hpp"
 #include "utils/system_utils.hpp"
 #include "utils/string_utils.hpp"
+#include "core/models/pairhmm/simd_pair_hmm_kernel.hpp"
 #include "exceptions/error.hpp"
+#include "exceptions/system_error.hpp"
 #include "logging/error_handler.hpp"
 
 using namespace octopus;
@@ -27,6 +30,7 @@ namespace {
 template <typename E>
 auto log_exception(const E& e)
 {
+    profiling::close();
     log_error(e);
     log_program_end();
     return EXIT_FAILURE;
@@ -45,6 +49,8 @@ void init_common(const OptionMap& options)
     logging::init(get_debug_log_file_name(options), get_trace_log_file_name(options));
     DEBUG_MODE = options::is_debug_mode(options);
     TRACE_MODE = options::is_trace_mode(options);
+    const auto profile_trace = get_profile_trace_file_name(options);
+    if (profile_trace) profiling::init(*profile_trace);
 }
 
 std::string to_string(const int argc, const char** argv)
@@ -58,6 +64,21 @@ bool could_exceed_open_file_limit(const OptionMap& options)
     return options::estimate_max_open_files(options) >= get_max_open_files();
 }
 
+class UnsupportedProcessor : public SystemError
+{
+    std::string do_where() const override { return "check_processor_support"; }
+    std::string do_why() const override { return "This processor does not support SSE4.1, which is the minimum required"; }
+    std::string do_help() const override { return "Run on a processor with SSE4.1 support"; }
+};
+
+// Otherwise the pair HMM would fail later with an illegal instruction
+void check_processor_support()
+{
+    if (!hmm::simd::is_pair_hmm_supported()) {
+        throw UnsupportedProcessor {};
+    }
+}
+
 void sanity_check(const OptionMap& options)
 {
     logging::WarningLogger warn_log {};
@@ -88,6 +109,7 @@ int main(const int argc, const char** argv)
             log_program_startup();
             logging::InfoLogger info_log {};
             const auto start = std::chrono::system_clock::now();
+            check_processor_support();
             sanity_check(options);
             log_command_line_options(options);
             auto components = collate_genome_calling_components(options);
@@ -97,12 +119,14 @@ int main(const int argc, const char** argv)
             if (validate(components)) {
                 run_octopus(components, {to_string(argc, argv), to_string(options, true, false)});
             }
+            profiling::close();
             log_program_end();
         } catch (const Error& e) {
             return log_exception(e);
         } catch (const std::exception& e) {
             return log_exception(e);
         } catch (...) {
+            profiling::close();
             log_unknown_error();
             log_program_end();
             return EXIT_FAILURE;
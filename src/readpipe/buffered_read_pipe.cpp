@@ -10,6 +10,7 @@
 
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace octopus {
 
@@ -23,12 +24,18 @@ BufferedReadPipe::BufferedReadPipe(const ReadPipe& source, Config config, std::v
 , buffer_ {}
 , buffered_region_ {}
 , hints_ {}
+, prefetch_ {}
 , debug_log_ {}
 {
     hint(std::move(hints));
     if (DEBUG_MODE) debug_log_ = logging::DebugLogger {};
 }
 
+BufferedReadPipe::~BufferedReadPipe()
+{
+    cancel_prefetch();
+}
+
 const ReadPipe& BufferedReadPipe::source() const noexcept
 {
     return source_.get();
@@ -36,6 +43,7 @@ const ReadPipe& BufferedReadPipe::source() const noexcept
 
 void BufferedReadPipe::clear() noexcept
 {
+    cancel_prefetch();
     buffer_.clear();
     buffered_region_ = boost::none;
     hints_.clear();
@@ -70,10 +78,39 @@ bool BufferedReadPipe::is_cached(const GenomicRegion& region) const noexcept
 
 // private methods
 
+namespace {
+
+// Packs one sample at a time, releasing each sample's unpacked reads as soon as they are packed,
+// so the fetched reads and their packed copy are never both held in full.
+PackedReadMap pack_and_release(ReadMap&& reads)
+{
+    PackedReadMap result {};
+    result.reserve(reads.size());
+    for (auto itr = std::begin(reads); itr != std::end(reads);) {
+        auto& packed = result.emplace(itr->first, pack(itr->second)).first->second;
+        packed.shrink_to_fit();
+        itr = reads.erase(itr);
+    }
+    return result;
+}
+
+// Buffers are fetched with a single read pipe fetch so that filtering and downsampling see the same
+// reads as an unbuffered fetch of the buffered region.
+PackedReadMap fetch_packed(const ReadPipe& source, const GenomicRegion& region)
+{
+    return pack_and_release(source.fetch_reads(region));
+}
+
+} // namespace
+
 void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
 {
     if (!is_cached(request)) {
         if (debug_log_) stream(*debug_log_) << "Request " << request << " is not cached";
+        if (use_prefetched_buffer(request)) {
+            prefetch_next_buffer();
+            return;
+        }
         auto max_region = get_max_fetch_region(request);
         if (debug_log_) stream(*debug_log_) << "Max fetch region for request " << request << " is " << max_region;
         bool unchecked_fetch {false};
@@ -84,34 +121,124 @@ void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
             buffered_region_ = source_.get().read_manager().find_covered_subregion(max_region, config_.max_buffer_size);
         }
         if (debug_log_) stream(*debug_log_) << "Buffer region for request " << request << " is " << *buffered_region_;
-        buffer_ = source_.get().fetch_reads(expand(*buffered_region_, config_.fetch_expansion));
+        const auto fetch_region = expand(*buffered_region_, config_.fetch_expansion);
+        buffer_.clear(); // the old buffer is not needed while the new one is fetched
         if (unchecked_fetch) {
-            const auto fetch_size = count_reads(buffer_);
-            if (fetch_size > config_.max_buffer_size) {
+            auto reads = source_.get().fetch_reads(fetch_region);
+            if (count_reads(reads) > config_.max_buffer_size) {
                 if (default_unchecked_fetch_overflowed_) {
                     adjusted_unchecked_fetch_overflowed_ = true;
                 } else {
                     default_unchecked_fetch_overflowed_ = true;
                 }
                 // Clear buffer of reads to rhs of request
-                for (auto& p : buffer_) {
+                for (auto& p : reads) {
                     const auto last_overlapped = find_first_after(p.second, request);
                     p.second.erase(last_overlapped, std::cend(p.second));
                 }
                 buffered_region_ = request;
             }
+            buffer_ = pack_and_release(std::move(reads));
         } else {
+            buffer_ = fetch_packed(source_, fetch_region);
             if (min_checked_fetch_size_) {
                 min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
             } else {
                 min_checked_fetch_size_ = size(*buffered_region_);
             }
         }
+        prefetch_next_buffer();
     } else if (debug_log_) {
         stream(*debug_log_) << "Request " << request << " is already cached";
     }
 }
 
+bool BufferedReadPipe::use_prefetched_buffer(const GenomicRegion& request) const
+{
+    if (!prefetch_) return false;
+    if (!contains(prefetch_->request, request)) {
+        if (debug_log_) stream(*debug_log_) << "Discarding prefetch for " << prefetch_->request << " for request " << request;
+        cancel_prefetch();
+        return false;
+    }
+    // A prefetch that has not started may be queued behind the caller on the same pool, so waiting
+    // for it could deadlock. Cancel it and fetch synchronously instead. Once started it is already
+    // fetching the reads we need, so waiting for it is never slower than fetching them again.
+    auto expected = PrefetchState::pending;
+    if (prefetch_->state->compare_exchange_strong(expected, PrefetchState::cancelled)) {
+        if (debug_log_) stream(*debug_log_) << "Cancelling pending prefetch for " << prefetch_->request << " for request " << request;
+        prefetch_ = boost::none;
+        return false;
+    }
+    auto prefetched = prefetch_->buffer.get();
+    prefetch_ = boost::none;
+    if (contains(prefetched.region, request)) {
+        if (debug_log_) stream(*debug_log_) << "Using prefetched buffer " << prefetched.region << " for request " << request;
+        buffer_ = std::move(prefetched.reads);
+        buffered_region_ = std::move(prefetched.region);
+        if (min_checked_fetch_size_) {
+            min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
+        } else {
+            min_checked_fetch_size_ = size(*buffered_region_);
+        }
+        return true;
+    } else {
+        if (debug_log_) stream(*debug_log_) << "Discarding prefetched buffer " << prefetched.region << " for request " << request;
+        return false;
+    }
+}
+
+void BufferedReadPipe::prefetch_next_buffer() const
+{
+    if (!config_.prefetch_hints || !buffered_region_) return;
+    cancel_prefetch();
+    if (get_shared_thread_pool().empty()) return; // nothing would run it
+    const auto next_request = next_hinted_request();
+    if (!next_request) return;
+    auto max_region = get_max_fetch_region(*next_request);
+    if (debug_log_) stream(*debug_log_) << "Prefetching buffer for hinted request " << *next_request;
+    // Only one buffer is prefetched at a time, and it is checked against the buffer size, so at most
+    // two buffers are ever held. The task must not capture this as the pipe may be moved.
+    auto state = std::make_shared<std::atomic<PrefetchState>>(PrefetchState::pending);
+    auto buffer = get_shared_thread_pool().push([source = source_, max_region, max_reads = config_.max_buffer_size,
+                                                 expansion = config_.fetch_expansion, state] () {
+        auto expected = PrefetchState::pending;
+        if (!state->compare_exchange_strong(expected, PrefetchState::running)) {
+            return PrefetchedBuffer {max_region, {}};
+        }
+        auto region = source.get().read_manager().find_covered_subregion(max_region, max_reads);
+        auto reads = fetch_packed(source, expand(region, expansion));
+        return PrefetchedBuffer {std::move(region), std::move(reads)};
+    });
+    prefetch_ = Prefetch {std::move(max_region), std::move(buffer), std::move(state)};
+}
+
+void BufferedReadPipe::cancel_prefetch() const noexcept
+{
+    if (!prefetch_ || !prefetch_->buffer.valid()) return; // may have been moved from
+    auto expected = PrefetchState::pending;
+    if (!prefetch_->state->compare_exchange_strong(expected, PrefetchState::cancelled)) {
+        // Already running on another thread, so it must finish before the source can go away
+        prefetch_->buffer.wait();
+    }
+    prefetch_ = boost::none;
+}
+
+boost::optional<GenomicRegion> BufferedReadPipe::next_hinted_request() const
+{
+    const auto& contig = buffered_region_->contig_name();
+    if (hints_.count(contig) == 0) return boost::none;
+    const auto& contig_hints = hints_.at(contig);
+    const auto itr = std::find_if(std::cbegin(contig_hints), std::cend(contig_hints),
+                                  [this] (const auto& hint) { return ends_before(*buffered_region_, hint); });
+    if (itr == std::cend(contig_hints)) return boost::none;
+    if (begins_before(*itr, *buffered_region_)) {
+        return right_overhang_region(*itr, *buffered_region_);
+    } else {
+        return *itr;
+    }
+}
+
 GenomicRegion BufferedReadPipe::get_max_fetch_region(const GenomicRegion& request) const
 {
     const auto default_max_region = get_default_max_fetch_region(request);
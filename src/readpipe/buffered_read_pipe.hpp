@@ -6,11 +6,15 @@
 
 #include <functional>
 #include <cstddef>
+#include <future>
+#include <memory>
+#include <atomic>
 
 #include <boost/optional.hpp>
 
 #include "read_pipe.hpp"
 #include "basics/genomic_region.hpp"
+#include "basics/packed_read_batch.hpp"
 #include "containers/mappable_map.hpp"
 #include "logging/logging.hpp"
 
@@ -26,6 +30,9 @@ public:
         boost::optional<GenomicRegion::Size> max_fetch_size = boost::none;
         boost::optional<GenomicRegion::Size> max_hint_gap = boost::none;
         bool allow_unchecked_fetches = true;
+        // Fetch the buffer for the next hinted region on the shared thread pool while the current one
+        // is in use. This holds up to two buffers, so is only worthwhile when hints are accurate.
+        bool prefetch_hints = false;
     };
     
     BufferedReadPipe() = delete;
@@ -38,7 +45,7 @@ public:
     BufferedReadPipe(BufferedReadPipe&&)                 = default;
     BufferedReadPipe& operator=(BufferedReadPipe&&)      = default;
     
-    ~BufferedReadPipe() = default;
+    ~BufferedReadPipe();
     
     const ReadPipe& source() const noexcept;
     
@@ -56,17 +63,37 @@ public:
 private:
     using RegionMap = MappableSetMap<GenomicRegion::ContigName, GenomicRegion>;
     
+    struct PrefetchedBuffer
+    {
+        GenomicRegion region;
+        PackedReadMap reads;
+    };
+    
+    enum class PrefetchState { pending, running, cancelled };
+    
+    struct Prefetch
+    {
+        GenomicRegion request;
+        std::future<PrefetchedBuffer> buffer;
+        std::shared_ptr<std::atomic<PrefetchState>> state;
+    };
+    
     std::reference_wrapper<const ReadPipe> source_;
     Config config_;
-    mutable ReadMap buffer_;
+    mutable PackedReadMap buffer_;
     mutable boost::optional<GenomicRegion> buffered_region_;
     mutable RegionMap hints_;
     mutable bool default_unchecked_fetch_overflowed_ = false;
     mutable bool adjusted_unchecked_fetch_overflowed_ = false;
     mutable boost::optional<GenomicRegion::Size> min_checked_fetch_size_ = boost::none;
+    mutable boost::optional<Prefetch> prefetch_;
     mutable boost::optional<logging::DebugLogger> debug_log_;
     
     void setup_buffer(const GenomicRegion& request) const;
+    bool use_prefetched_buffer(const GenomicRegion& request) const;
+    void prefetch_next_buffer() const;
+    void cancel_prefetch() const noexcept;
+    boost::optional<GenomicRegion> next_hinted_request() const;
     GenomicRegion get_max_fetch_region(const GenomicRegion& request) const;
     GenomicRegion get_default_max_fetch_region(const GenomicRegion& request) const;
     bool can_make_unchecked_fetch() const noexcept;
@@ -18,6 +18,7 @@
 #include "read_stats.hpp"
 #include "coverage_tracker.hpp"
 #include "sequence_utils.hpp"
+#include "basics/packed_read_batch.hpp"
 
 namespace octopus {
 
@@ -83,10 +84,12 @@ auto make_contig_sampling_distribution(const InputRegionMap& regions)
     return std::discrete_distribution<> {std::cbegin(contig_weights), std::cend(contig_weights)};
 }
 
-auto fragmented_footprint(const AlignedRead& read, const AlignedRead::NucleotideSequence::size_type fragment_size)
+template <typename Footprint>
+auto fragmented_footprint(const AlignedRead& read, const AlignedRead::NucleotideSequence::size_type fragment_size,
+                          Footprint read_footprint)
 {
     const auto fragments = split(read, fragment_size);
-    const static auto add_footprint = [] (auto total, const auto& read) { return total + footprint(read); };
+    const auto add_footprint = [read_footprint] (auto total, const auto& read) { return total + read_footprint(read); };
     return std::accumulate(std::cbegin(fragments), std::cend(fragments), MemoryFootprint {0}, add_footprint);
 }
 
@@ -189,6 +192,9 @@ profile_reads_helper(const std::vector<SampleName>& samples,
 {
     ReadSetProfile result {};
     std::deque<MemoryFootprint> memory_footprints {}, fragmented_memory_footprints {};
+    std::deque<MemoryFootprint> packed_memory_footprints {}, packed_fragmented_memory_footprints {};
+    const auto unpacked_read_footprint = [] (const AlignedRead& read) { return footprint(read); };
+    const auto packed_read_footprint = [] (const AlignedRead& read) { return packed_footprint(read); };
     std::unordered_map<GenomicRegion::ContigName, std::vector<DepthType>> contig_depths {};
     std::deque<unsigned> read_lengths {};
     std::deque<AlignedRead::MappingQuality> mapping_qualities {};
@@ -208,9 +214,11 @@ profile_reads_helper(const std::vector<SampleName>& samples,
             const auto read_visitor = [&] (const SampleName& sample, AlignedRead read) {
                 read_lengths.push_back(sequence_size(read));
                 mapping_qualities.push_back(read.mapping_quality());
-                memory_footprints.push_back(footprint(read));
+                memory_footprints.push_back(unpacked_read_footprint(read));
+                packed_memory_footprints.push_back(packed_read_footprint(read));
                 if (config.fragment_size) {
-                    fragmented_memory_footprints.push_back(fragmented_footprint(read, *config.fragment_size));
+                    fragmented_memory_footprints.push_back(fragmented_footprint(read, *config.fragment_size, unpacked_read_footprint));
+                    packed_fragmented_memory_footprints.push_back(fragmented_footprint(read, *config.fragment_size, packed_read_footprint));
                 }
                 depth_tracker.add(read);
                 if (!critical_region) {
@@ -275,9 +283,12 @@ profile_reads_helper(const std::vector<SampleName>& samples,
     }
     if (memory_footprints.empty()) return boost::none;
     fill_summary_stats(memory_footprints, result.memory_stats);
+    fill_summary_stats(packed_memory_footprints, result.packed_memory_stats);
     if (config.fragment_size) {
         result.fragmented_memory_stats = ReadSetProfile::ReadMemoryStats {};
         fill_summary_stats(fragmented_memory_footprints, *result.fragmented_memory_stats);
+        result.packed_fragmented_memory_stats = ReadSetProfile::ReadMemoryStats {};
+        fill_summary_stats(packed_fragmented_memory_footprints, *result.packed_fragmented_memory_stats);
     }
     fill_summary_stats(read_lengths, result.length_stats);
     fill_summary_stats(mapping_qualities, result.mapping_quality_stats);
@@ -365,9 +376,13 @@ std::ostream& operator<<(std::ostream& os, const ReadSetProfile::SampleCombinedD
 std::ostream& operator<<(std::ostream& os, const ReadSetProfile& profile)
 {
     os << "Read memory stats: " << profile.memory_stats << '\n';
+    os << "Packed read memory stats: " << profile.packed_memory_stats << '\n';
     if (profile.fragmented_memory_stats) {
         os << "Fragmented read memory stats: " << *profile.fragmented_memory_stats << '\n';
     }
+    if (profile.packed_fragmented_memory_stats) {
+        os << "Packed fragmented read memory stats: " << *profile.packed_fragmented_memory_stats << '\n';
+    }
     os << "Depth stats: " << profile.depth_stats << '\n';
     os << "Mapping quality stats: " << profile.mapping_quality_stats << '\n';
     os << "Read length stats: " << profile.length_stats << std::endl;
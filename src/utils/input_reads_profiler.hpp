@@ -57,8 +57,8 @@ struct ReadSetProfile
     using ReadMemoryStats = SummaryStats<MemoryFootprint>;
     
     SampleCombinedDepthStatsPair depth_stats;
-    ReadMemoryStats memory_stats;
-    boost::optional<ReadMemoryStats> fragmented_memory_stats;
+    ReadMemoryStats memory_stats, packed_memory_stats;
+    boost::optional<ReadMemoryStats> fragmented_memory_stats, packed_fragmented_memory_stats;
     ReadLengthStats length_stats;
     MappingQualityStats mapping_quality_stats;
 };
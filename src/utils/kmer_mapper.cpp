@@ -24,7 +24,7 @@ map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target,
 std::vector<std::size_t>
 map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable& target)
 {
-    MappedIndexCounts mapping_counts(target.second, 0);
+    auto mapping_counts = init_mapping_counts(target);
     return  map_query_to_target(query, target, mapping_counts);
 }
 
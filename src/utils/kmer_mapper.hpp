@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <numeric>
 #include <limits>
+#include <cassert>
 
 namespace octopus {
 
@@ -54,47 +55,91 @@ constexpr auto perfect_kmer_hash(InputIt first)
 
 using KmerPerfectHashes = std::vector<KmerHashType>;
 
+namespace detail {
+
+// Same values as perfect_hash, but without a table lookup so loops over bases vectorise
+inline KmerHashType perfect_hash_code(const char base) noexcept
+{
+    return static_cast<KmerHashType>(base == 'C') | (static_cast<KmerHashType>(base == 'G') << 1)
+            | (static_cast<KmerHashType>(base == 'T') * 3);
+}
+
+} // namespace detail
+
 template <unsigned char K>
-auto compute_kmer_hashes(const std::string& sequence)
+void compute_kmer_hashes(const std::string& sequence, KmerPerfectHashes& result)
 {
     if (sequence.size() < K) {
-        return KmerPerfectHashes {};
+        result.clear();
+        return;
     }
-    KmerPerfectHashes result(sequence.size() - K + 1);
-    auto result_it = std::begin(result);
-    for (auto it = std::cbegin(sequence); it != std::prev(std::cend(sequence), K - 1); ++it, ++result_it) {
-        *result_it = perfect_kmer_hash<K>(it);
+    const auto num_hashes = sequence.size() - K + 1;
+    result.assign(num_hashes, 0);
+    const char* bases {sequence.data()};
+    auto hashes = result.data();
+    // Base by base, rather than kmer by kmer, so the inner loop is SIMD friendly
+    for (unsigned i {0}; i < K; ++i, ++bases) {
+        const auto shift = 2 * i;
+        for (std::size_t j {0}; j < num_hashes; ++j) {
+            hashes[j] |= detail::perfect_hash_code(bases[j]) << shift;
+        }
     }
+}
+
+template <unsigned char K>
+auto compute_kmer_hashes(const std::string& sequence)
+{
+    KmerPerfectHashes result {};
+    compute_kmer_hashes<K>(sequence, result);
     return result;
 }
 
-using KmerHashTable = std::pair<std::vector<std::vector<std::size_t>>, std::size_t>;
+// Kmer positions of a target sequence stored in compressed sparse row form: the positions of
+// kmer hash h are positions[offsets[h]] to positions[offsets[h + 1]], in ascending order.
+// Tables can be repopulated without reallocation.
+struct KmerHashTable
+{
+    using Index = std::uint32_t;
+    std::vector<Index> offsets;
+    std::vector<Index> positions;
+    KmerPerfectHashes hashes;
+    std::size_t size;
+};
 
 template <unsigned char K>
 KmerHashTable init_kmer_hash_table()
 {
-    return std::make_pair(std::vector<std::vector<std::size_t>> {num_kmers(K), std::vector<std::size_t> {}}, 0);
+    return KmerHashTable {std::vector<KmerHashTable::Index>(num_kmers(K) + 1, 0), {}, {}, 0};
 }
 
 inline void clear_kmer_hash_table(KmerHashTable& table)
 {
-    for (auto& bin : table.first) bin.clear();
-    table.second = 0;
+    std::fill(std::begin(table.offsets), std::end(table.offsets), 0);
+    table.positions.clear();
+    table.size = 0;
 }
 
 template <unsigned char K>
 void populate_kmer_hash_table(const std::string& sequence, KmerHashTable& result)
 {
+    assert(result.offsets.size() == num_kmers(K) + 1);
     if (sequence.size() < K) {
+        clear_kmer_hash_table(result);
         return;
     }
-    const auto last_index = sequence.size() - K;
-    auto it = std::cbegin(sequence);
-    for (std::size_t index {0}; index <= last_index; ++index, ++it) {
-        result.first[perfect_kmer_hash<K>(it)].push_back(index);
+    compute_kmer_hashes<K>(sequence, result.hashes);
+    const auto num_positions = result.hashes.size();
+    assert(num_positions <= std::numeric_limits<KmerHashTable::Index>::max());
+    // Counting sort: count each hash, prefix sum to the bin ends, then fill the bins backwards
+    // so each bin ends up ascending and offsets[h] ends up at the start of bin h
+    std::fill(std::begin(result.offsets), std::end(result.offsets), 0);
+    for (const auto hash : result.hashes) ++result.offsets[hash];
+    std::partial_sum(std::cbegin(result.offsets), std::cend(result.offsets), std::begin(result.offsets));
+    result.positions.resize(num_positions);
+    for (auto index = num_positions; index > 0; --index) {
+        result.positions[--result.offsets[result.hashes[index - 1]]] = index - 1;
     }
-    for (auto& bin : result.first) bin.shrink_to_fit();
-    result.second = sequence.size() - K + 1;
+    result.size = num_positions;
 }
 
 template <unsigned char K>
@@ -102,6 +147,7 @@ KmerHashTable make_kmer_hash_table(const std::string& sequence)
 {
     auto result = init_kmer_hash_table<K>();
     populate_kmer_hash_table<K>(sequence, result);
+    result.hashes = KmerPerfectHashes {}; // scratch only needed for repopulation
     return result;
 }
 
@@ -109,7 +155,12 @@ using MappedIndexCounts = std::vector<unsigned>;
 
 inline MappedIndexCounts init_mapping_counts(const KmerHashTable& target)
 {
-    return MappedIndexCounts(target.second, 0);
+    return MappedIndexCounts(target.size, 0);
+}
+
+inline void init_mapping_counts(const KmerHashTable& target, MappedIndexCounts& result)
+{
+    result.assign(target.size, 0);
 }
 
 inline void reset_mapping_counts(MappedIndexCounts& mapping_counts)
@@ -126,7 +177,10 @@ OutputIt map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable
     std::size_t first_max_hit_index {0};
     unsigned num_max_hits {0};
     for (std::size_t query_index {0}; query_index < query.size(); ++query_index) {
-        for (const auto target_index : target.first[query[query_index]]) {
+        const auto hash = query[query_index];
+        const auto first_target_index = std::next(std::cbegin(target.positions), target.offsets[hash]);
+        const auto last_target_index = std::next(std::cbegin(target.positions), target.offsets[hash + 1]);
+        std::for_each(first_target_index, last_target_index, [&] (const std::size_t target_index) {
             if (target_index >= query_index) {
                 const auto mapping_begin = target_index - query_index;
                 if (++mapping_counts[mapping_begin] > max_hit_count) {
@@ -140,7 +194,7 @@ OutputIt map_query_to_target(const KmerPerfectHashes& query, const KmerHashTable
                     }
                 }
             }
-        }
+        });
     }
     if (max_hit_count > 0) {
         *result++ = first_max_hit_index++;
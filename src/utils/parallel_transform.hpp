@@ -6,11 +6,17 @@
 
 #include <iterator>
 #include <vector>
-#include <future>
 #include <algorithm>
 #include <cstddef>
 #include <utility>
 #include <type_traits>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+#include <boost/optional.hpp>
 
 #include "thread_pool.hpp"
 
@@ -18,100 +24,93 @@ namespace octopus {
 
 namespace detail {
 
-template <typename InputIt,
-          typename OutputIt,
-          typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op,
-                            std::random_access_iterator_tag)
+// Each pool worker gets several chunks so uneven items still balance
+static constexpr std::size_t transform_chunks_per_thread {4};
+
+// Applies f(worker, i) to every index in [0, n). The range is split into chunks that are claimed
+// from a shared counter by the calling thread and by helper tasks pushed onto the pool.
+// The calling thread always takes part, so progress never depends on pool workers
+// being free: chunks not yet claimed by a helper are just run by the caller. This
+// makes nested use from inside pool tasks safe. Each participating thread is given a
+// distinct worker index in [0, pool.size() + 1), and its chunks are contiguous.
+template <typename WorkerIndexFunction>
+void for_each_worker_index(const std::size_t n, WorkerIndexFunction&& f, ThreadPool& pool)
 {
-    using value_type  = typename std::iterator_traits<InputIt>::value_type;
-    using result_type = std::result_of_t<UnaryOp(value_type)>;
-    std::vector<std::future<result_type>> results(std::distance(first, last));
-    std::transform(first, last, std::begin(results),
-                   [&op](const auto& value) {
-                       return std::async(std::launch::async, op, std::cref(value));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    if (n == 0) return;
+    const auto max_chunks = std::min(n, transform_chunks_per_thread * (pool.size() + 1));
+    if (pool.empty() || max_chunks < 2) {
+        for (std::size_t i {0}; i < n; ++i) f(std::size_t {0}, i);
+        return;
+    }
+    const auto chunk_size = (n + max_chunks - 1) / max_chunks;
+    const auto num_chunks = (n + chunk_size - 1) / chunk_size;
+    struct SharedState
+    {
+        std::atomic<std::size_t> next_chunk {0}, next_worker {0};
+        std::size_t num_completed {0};
+        std::exception_ptr error {};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<SharedState>();
+    const auto run_chunks = [state, &f, n, chunk_size, num_chunks] () {
+        const auto worker = state->next_worker++;
+        for (auto chunk = state->next_chunk++; chunk < num_chunks; chunk = state->next_chunk++) {
+            std::exception_ptr error {};
+            try {
+                const auto chunk_end = std::min((chunk + 1) * chunk_size, n);
+                for (auto i = chunk * chunk_size; i < chunk_end; ++i) f(worker, i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lk {state->mutex};
+                if (error && !state->error) state->error = error;
+                ++state->num_completed;
+            }
+            state->cv.notify_all();
+        }
+    };
+    const auto num_helpers = std::min(pool.size(), num_chunks - 1);
+    for (std::size_t i {0}; i < num_helpers; ++i) {
+        pool.push(run_chunks);
+    }
+    run_chunks();
+    std::unique_lock<std::mutex> lk {state->mutex};
+    state->cv.wait(lk, [&] () { return state->num_completed == num_chunks; });
+    if (state->error) std::rethrow_exception(state->error);
 }
 
-template <typename InputIt,
-          typename OutputIt,
-          typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op,
-                            std::input_iterator_tag)
+template <typename IndexFunction>
+void for_each_index(const std::size_t n, IndexFunction&& f, ThreadPool& pool)
 {
-    return std::transform(first, last, result, std::move(op));
-}
-
-template <typename InputIt1,
-          typename InputIt2,
-          typename OutputIt,
-          typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
-                            std::random_access_iterator_tag, std::random_access_iterator_tag)
-{
-    using value_type1  = typename std::iterator_traits<InputIt1>::value_type;
-    using value_type2  = typename std::iterator_traits<InputIt2>::value_type;
-    using result_type = std::result_of_t<BinaryOp(value_type1, value_type2)>;
-    std::vector<std::future<result_type>> results(std::distance(first1, last1));
-    std::transform(first1, last1, first2, std::begin(results),
-                   [&op](const auto& a, const auto& b) {
-                       return std::async(std::launch::async, op, std::cref(a), std::cref(b));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    for_each_worker_index(n, [&f] (std::size_t, const std::size_t i) { f(i); }, pool);
 }
 
-template <typename InputIt1,
-          typename InputIt2,
-          typename OutputIt,
-          typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op,
-                            std::input_iterator_tag, std::input_iterator_tag)
-{
-    return std::transform(first1, last1, first2, result, std::move(op));
-}
+template <typename InputIt, typename UnaryOp>
+using UnaryTransformResult = std::decay_t<std::result_of_t<UnaryOp(typename std::iterator_traits<InputIt>::reference)>>;
 
-} // namespace detail
+template <typename InputIt1, typename InputIt2, typename BinaryOp>
+using BinaryTransformResult = std::decay_t<std::result_of_t<BinaryOp(typename std::iterator_traits<InputIt1>::reference,
+                                                                     typename std::iterator_traits<InputIt2>::reference)>>;
 
-template <typename InputIt,
-          typename OutputIt,
-          typename UnaryOp>
-OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op)
+template <typename T, typename OutputIt>
+OutputIt move_results(std::vector<boost::optional<T>>& results, OutputIt result)
 {
-    return detail::parallel_transform(first, last, result, std::move(op),
-                                      typename std::iterator_traits<InputIt>::iterator_category {});
-}
-
-template <typename InputIt1,
-          typename InputIt2,
-          typename OutputIt,
-          typename BinaryOp>
-OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op)
-{
-    return detail::parallel_transform(first1, last1, first2, result, std::move(op),
-                                      typename std::iterator_traits<InputIt1>::iterator_category {},
-                                      typename std::iterator_traits<InputIt2>::iterator_category {});
+    return std::transform(std::begin(results), std::end(results), result,
+                          [] (auto& value) { return std::move(*value); });
 }
 
-namespace detail {
-
 template <typename InputIt,
           typename OutputIt,
           typename UnaryOp>
 OutputIt transform(InputIt first, InputIt last, OutputIt result, UnaryOp op, ThreadPool& pool,
                    std::random_access_iterator_tag)
 {
-    using value_type  = typename std::iterator_traits<InputIt>::value_type;
-    using result_type = std::result_of_t<UnaryOp(value_type)>;
-    std::vector<std::future<result_type>> results(std::distance(first, last));
-    std::transform(first, last, std::begin(results),
-                   [&op, &pool](const auto& value) {
-                       return pool.push(op, std::cref(value));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    using result_type = UnaryTransformResult<InputIt, UnaryOp>;
+    std::vector<boost::optional<result_type>> results(std::distance(first, last));
+    for_each_index(results.size(), [&] (const std::size_t i) { results[i] = op(first[i]); }, pool);
+    return move_results(results, result);
 }
 
 template <typename InputIt,
@@ -130,16 +129,10 @@ template <typename InputIt1,
 OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op, ThreadPool& pool,
                    std::random_access_iterator_tag, std::random_access_iterator_tag)
 {
-    using value_type1  = typename std::iterator_traits<InputIt1>::value_type;
-    using value_type2  = typename std::iterator_traits<InputIt2>::value_type;
-    using result_type = std::result_of_t<BinaryOp(value_type1, value_type2)>;
-    std::vector<std::future<result_type>> results(std::distance(first1, last1));
-    std::transform(first1, last1, first2, std::begin(results),
-                   [&op, &pool](const auto& a, const auto& b) {
-                       return pool.push(op, std::cref(a), std::cref(b));
-                   });
-    return std::transform(std::begin(results), std::end(results), result,
-                          [](auto& f) { return f.get(); });
+    using result_type = BinaryTransformResult<InputIt1, InputIt2, BinaryOp>;
+    std::vector<boost::optional<result_type>> results(std::distance(first1, last1));
+    for_each_index(results.size(), [&] (const std::size_t i) { results[i] = op(first1[i], first2[i]); }, pool);
+    return move_results(results, result);
 }
 
 template <typename InputIt1,
@@ -174,6 +167,50 @@ OutputIt transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt re
                              typename std::iterator_traits<InputIt2>::iterator_category {});
 }
 
+// These use the pool running the calling thread, or the process-wide pool if the caller
+// is not a pool worker, so nested calls never create more threads than the pools own.
+
+template <typename InputIt,
+          typename OutputIt,
+          typename UnaryOp>
+OutputIt parallel_transform(InputIt first, InputIt last, OutputIt result, UnaryOp op)
+{
+    return transform(first, last, result, std::move(op), get_shared_thread_pool());
+}
+
+template <typename InputIt1,
+          typename InputIt2,
+          typename OutputIt,
+          typename BinaryOp>
+OutputIt parallel_transform(InputIt1 first1, InputIt1 last1, InputIt2 first2, OutputIt result, BinaryOp op)
+{
+    return transform(first1, last1, first2, result, std::move(op), get_shared_thread_pool());
+}
+
+// Calls f(i) for every i in [0, n) using the same pool as parallel_transform. f must be
+// safe to call concurrently for different indices.
+template <typename IndexFunction>
+void parallel_for(const std::size_t n, IndexFunction f)
+{
+    detail::for_each_index(n, f, get_shared_thread_pool());
+}
+
+// The maximum number of threads that a parallel_for_each_worker call made now can use.
+inline std::size_t parallel_for_max_workers()
+{
+    return get_shared_thread_pool().size() + 1;
+}
+
+// As parallel_for, but calls f(worker, i), where worker is a distinct index in
+// [0, parallel_for_max_workers()) for each thread taking part. Each worker processes
+// contiguous runs of indices, so per-thread state indexed by worker can be reused
+// across neighbouring indices.
+template <typename WorkerIndexFunction>
+void parallel_for_each_worker(const std::size_t n, WorkerIndexFunction f)
+{
+    detail::for_each_worker_index(n, f, get_shared_thread_pool());
+}
+
 } // namespace octopus
 
 #endif
@@ -5,29 +5,48 @@
 
 namespace octopus {
 
+namespace {
+
+// Identifies the pool (if any) that owns the calling thread, so pushes made from
+// inside a task go onto the local deque of the worker that made them.
+thread_local ThreadPool* this_thread_pool {nullptr};
+thread_local std::size_t this_thread_worker {0};
+
+std::atomic<std::size_t> shared_pool_size {0};
+std::atomic<bool> shared_pool_created {false};
+
+} // namespace
+
+void set_shared_thread_pool_size(const std::size_t n_threads)
+{
+    if (shared_pool_created) {
+        throw std::logic_error {"set_shared_thread_pool_size: shared pool already in use"};
+    }
+    shared_pool_size = n_threads;
+}
+
+ThreadPool& get_shared_thread_pool()
+{
+    if (this_thread_pool) return *this_thread_pool;
+    static ThreadPool shared_pool {(shared_pool_created = true, shared_pool_size.load())};
+    return shared_pool;
+}
+
 ThreadPool::ThreadPool() : ThreadPool {0} {}
 
 ThreadPool::ThreadPool(const std::size_t n_threads)
 : stop_ {false}
 , n_idle_ {n_threads}
+, n_pending_ {0}
+, victim_hint_ {0}
 {
+    queues_.reserve(n_threads + 1);
+    for (std::size_t i {0}; i <= n_threads; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
     workers_.reserve(n_threads);
     for (std::size_t i {0}; i < n_threads; ++i) {
-        workers_.emplace_back([this] {
-            std::function<void()> task;
-            while (true) {
-                std::unique_lock<std::mutex> lk {mutex_};
-                cv_.wait(lk, [this] () { return stop_ || !tasks_.empty(); });
-                if (stop_ && tasks_.empty()) return;
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                --n_idle_;
-                lk.unlock();
-                task();
-                lk.lock();
-                ++n_idle_;
-            }
-        });
+        workers_.emplace_back([this, i] { work(i); });
     }
 }
 
@@ -60,8 +79,91 @@ std::size_t ThreadPool::n_idle() const noexcept
 
 void ThreadPool::clear() noexcept
 {
-    std::lock_guard<std::mutex> lk {mutex_};
-    while (!tasks_.empty()) tasks_.pop();
+    for (auto& queue : queues_) {
+        std::lock_guard<std::mutex> lk {queue->mutex};
+        n_pending_ -= queue->tasks.size();
+        queue->tasks.clear();
+    }
+}
+
+// private methods
+
+void ThreadPool::enqueue(Task task)
+{
+    const auto worker = current_worker();
+    auto& queue = worker < workers_.size() ? *queues_[worker] : injection_queue();
+    {
+        std::lock_guard<std::mutex> lk {queue.mutex};
+        queue.tasks.push_back(std::move(task));
+        ++n_pending_;
+    }
+    // Acquiring the mutex ensures a worker about to sleep either sees the new task or gets the notification
+    { std::lock_guard<std::mutex> lk {mutex_}; }
+    cv_.notify_one();
+}
+
+bool ThreadPool::try_pop(const std::size_t worker, Task& result)
+{
+    if (n_pending_ == 0) return false;
+    if (worker < workers_.size() && try_pop_back(*queues_[worker], result)) return true;
+    if (try_pop_front(injection_queue(), result)) return true;
+    // Steal from the other workers, starting at a rotating offset to spread contention
+    const auto num_workers = workers_.size();
+    const auto offset = victim_hint_++;
+    for (std::size_t i {0}; i < num_workers; ++i) {
+        const auto victim = (offset + i) % num_workers;
+        if (victim != worker && try_pop_front(*queues_[victim], result)) return true;
+    }
+    return false;
+}
+
+bool ThreadPool::try_pop_back(TaskQueue& queue, Task& result)
+{
+    std::lock_guard<std::mutex> lk {queue.mutex};
+    if (queue.tasks.empty()) return false;
+    result = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --n_pending_;
+    return true;
+}
+
+bool ThreadPool::try_pop_front(TaskQueue& queue, Task& result)
+{
+    std::lock_guard<std::mutex> lk {queue.mutex};
+    if (queue.tasks.empty()) return false;
+    result = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    --n_pending_;
+    return true;
+}
+
+void ThreadPool::work(const std::size_t worker)
+{
+    this_thread_pool = this;
+    this_thread_worker = worker;
+    Task task;
+    while (true) {
+        if (try_pop(worker, task)) {
+            --n_idle_;
+            task();
+            task = nullptr;
+            ++n_idle_;
+        } else {
+            std::unique_lock<std::mutex> lk {mutex_};
+            cv_.wait(lk, [this] () { return stop_ || n_pending_ > 0; });
+            if (stop_ && n_pending_ == 0) return;
+        }
+    }
+}
+
+ThreadPool::TaskQueue& ThreadPool::injection_queue() noexcept
+{
+    return *queues_.back();
+}
+
+std::size_t ThreadPool::current_worker() const noexcept
+{
+    return this_thread_pool == this ? this_thread_worker : workers_.size();
 }
 
 } // namespace octopus
@@ -1,14 +1,17 @@
 // Copyright (c) 2015-2019 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-// This thread pool implementation is mostly derived from https://github.com/progschj/ThreadPool
+// This thread pool implementation is originally derived from https://github.com/progschj/ThreadPool
+// but now uses a work-stealing scheduler: each worker owns a task deque, tasks pushed from a
+// worker go onto that worker's deque (LIFO), tasks pushed from outside the pool go onto a shared
+// FIFO injection queue, and idle workers steal from the front of other workers' deques.
 
 #ifndef thread_pool_hpp
 #define thread_pool_hpp
 
 #include <cstddef>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -19,6 +22,7 @@
 #include <type_traits>
 #include <utility>
 #include <exception>
+#include <stdexcept>
 
 namespace octopus {
 
@@ -27,31 +31,47 @@ class ThreadPool
 public:
     ThreadPool();
     explicit ThreadPool(std::size_t n_threads);
-    
+
     ThreadPool(const ThreadPool&)             = delete;
     ThreadPool& operator=(const ThreadPool&)  = delete;
     ThreadPool(ThreadPool&& other) noexcept   = delete;
     ThreadPool& operator=(ThreadPool&& other) = delete;
-    
+
     ~ThreadPool() noexcept;
-    
+
     std::size_t size() const noexcept;
     bool empty() const noexcept;
     std::size_t n_idle() const noexcept;
-    
+
     void clear() noexcept;
-    
+
     template <typename F, typename... Args>
     auto push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>;
-    
+
 private:
+    using Task = std::function<void()>;
+
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
     std::mutex mutex_;
     std::condition_variable cv_;
     std::atomic<bool> stop_;
-    std::atomic<std::size_t> n_idle_;
-    
+    std::atomic<std::size_t> n_idle_, n_pending_, victim_hint_;
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_; // one per worker plus the shared injection queue
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+
+    void enqueue(Task task);
+    bool try_pop(std::size_t worker, Task& result);
+    bool try_pop_back(TaskQueue& queue, Task& result);
+    bool try_pop_front(TaskQueue& queue, Task& result);
+    void work(std::size_t worker);
+    TaskQueue& injection_queue() noexcept;
+    std::size_t current_worker() const noexcept;
 };
 
 template <typename F, typename... Args>
@@ -60,15 +80,21 @@ auto ThreadPool::push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(A
     using f_result_type = std::result_of_t<F(Args...)>;
     auto task = std::make_shared<std::packaged_task<f_result_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
     auto result = task->get_future();
-    {
-        std::lock_guard<std::mutex> lk {mutex_};
-        if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
-        tasks_.emplace([task] () { (*task)(); });
-    }
-    cv_.notify_one();
+    if (stop_) throw std::runtime_error {"ThreadPool: calling push on stopped pool"};
+    enqueue([task] () { (*task)(); });
     return result;
 }
 
+// Sets the number of workers in the process-wide pool. This must be called once at startup, before
+// the pool is first used. If it is never called the process-wide pool has no workers, so parallel
+// algorithms run on the calling thread and nothing runs in the background.
+void set_shared_thread_pool_size(std::size_t n_threads);
+
+// Returns the pool that owns the calling thread or, if the calling thread is not a pool worker,
+// the process-wide pool. Fine-grained parallel algorithms should use this so nested parallelism
+// runs on existing workers rather than creating new threads.
+ThreadPool& get_shared_thread_pool();
+
 } // namespace octopus
 
 #endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "core/tools/vargen/utils/assembler.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using coretools::Assembler;
+
+struct AssemblerInputs
+{
+    Assembler::NucleotideSequence reference_sequence;
+    std::vector<AlignedRead> reads;
+};
+
+auto make_assembler_inputs(const unsigned num_haplotypes, const unsigned num_reads)
+{
+    RandomEngine engine {default_seed};
+    const auto reference = make_benchmark_reference();
+    const auto region = make_benchmark_region();
+    const auto haplotypes = make_haplotypes(reference, region, num_haplotypes, engine, 0.01);
+    auto result = std::make_shared<AssemblerInputs>();
+    result->reference_sequence = reference.fetch_sequence(region);
+    result->reads = make_reads(haplotypes, num_reads, 150, engine);
+    return result;
+}
+
+// Fills in place so the timed body includes only the insertions
+void insert_reads(const AssemblerInputs& inputs, Assembler& assembler)
+{
+    for (const auto& read : inputs.reads) {
+        assembler.insert_read(read.sequence(), read.base_qualities(), Assembler::Direction::forward);
+    }
+}
+
+std::string make_name(const std::string& prefix, const unsigned kmer_size, const unsigned num_haplotypes, const unsigned num_reads)
+{
+    return prefix + "/k" + std::to_string(kmer_size) + "/haplotypes" + std::to_string(num_haplotypes)
+           + "/reads" + std::to_string(num_reads);
+}
+
+void add_assembly_benchmarks(BenchmarkSuite& suite, const unsigned kmer_size, const unsigned num_haplotypes, const unsigned num_reads)
+{
+    suite.add(make_name("assembler/construct", kmer_size, num_haplotypes, num_reads), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = make_assembler_inputs(num_haplotypes, num_reads);
+        return [=] () {
+            Assembler assembler {{kmer_size}, inputs->reference_sequence};
+            insert_reads(*inputs, assembler);
+            do_not_optimise(assembler.num_kmers());
+        };
+    });
+    // Follows the graph simplification and bubble extraction steps of LocalReassembler
+    suite.add(make_name("assembler/extract_variants", kmer_size, num_haplotypes, num_reads), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = make_assembler_inputs(num_haplotypes, num_reads);
+        return [=] () {
+            Assembler assembler {{kmer_size}, inputs->reference_sequence};
+            insert_reads(*inputs, assembler);
+            assembler.try_recover_dangling_branches();
+            assembler.prune(2);
+            if (!assembler.is_acyclic()) assembler.remove_nonreference_cycles();
+            assembler.cleanup();
+            const auto variants = assembler.extract_variants(50, 2.0);
+            do_not_optimise(variants);
+        };
+    });
+}
+
+} // namespace
+
+void add_assembler_benchmarks(BenchmarkSuite& suite)
+{
+    add_assembly_benchmarks(suite, 25, 2, 200);
+    add_assembly_benchmarks(suite, 25, 4, 400);
+    add_assembly_benchmarks(suite, 45, 4, 400);
+    // Either side of the largest kmer size packed into a 64-bit code, for comparing the two kmer representations
+    add_assembly_benchmarks(suite, 31, 4, 2000);
+    add_assembly_benchmarks(suite, 33, 4, 2000);
+}
+
+} // namespace benchmark
+} // namespace octopus
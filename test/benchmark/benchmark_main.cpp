@@ -0,0 +1,83 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <regex>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include <boost/program_options.hpp>
+
+#include "benchmark_suite.hpp"
+
+namespace po = boost::program_options;
+
+using namespace octopus::benchmark;
+
+int main(const int argc, const char** argv)
+{
+    po::options_description options {"octopus-benchmarks options"};
+    options.add_options()
+    ("help,h", "Produce help message")
+    ("list,l", po::bool_switch()->default_value(false), "List benchmark names and exit")
+    ("filter,f", po::value<std::string>()->default_value(".*"), "ECMAScript regex selecting benchmarks to run")
+    ("json,j", po::value<std::string>(), "Write results as JSON to this file ('-' for stdout)")
+    ("samples,n", po::value<unsigned>()->default_value(10), "Number of timed samples per benchmark")
+    ("min-sample-time", po::value<unsigned>()->default_value(100), "Minimum duration of each sample (milliseconds)");
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, options), vm);
+        po::notify(vm);
+    } catch (const po::error& e) {
+        std::cerr << e.what() << '\n' << options << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (vm.count("help")) {
+        std::cout << options << std::endl;
+        return EXIT_SUCCESS;
+    }
+    BenchmarkSuite suite {};
+    add_pair_hmm_benchmarks(suite);
+    add_haplotype_likelihood_benchmarks(suite);
+    add_assembler_benchmarks(suite);
+    add_haplotype_tree_benchmarks(suite);
+    add_genotype_benchmarks(suite);
+    add_genotype_model_benchmarks(suite);
+    add_vcf_writer_benchmarks(suite);
+    std::regex filter;
+    try {
+        filter = std::regex {vm["filter"].as<std::string>()};
+    } catch (const std::regex_error& e) {
+        std::cerr << "Invalid --filter: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (vm["list"].as<bool>()) {
+        for (const auto& name : suite.names()) {
+            if (std::regex_search(name, filter)) std::cout << name << '\n';
+        }
+        return EXIT_SUCCESS;
+    }
+    BenchmarkSuite::Options run_options {};
+    run_options.num_samples = std::max(vm["samples"].as<unsigned>(), 1u);
+    run_options.min_sample_time = std::chrono::milliseconds {vm["min-sample-time"].as<unsigned>()};
+    const auto json_to_stdout = vm.count("json") && vm["json"].as<std::string>() == "-";
+    // Keep stdout clean for JSON consumers
+    auto& log = json_to_stdout ? std::cerr : std::cout;
+    const auto results = suite.run(filter, run_options, log);
+    if (vm.count("json")) {
+        if (json_to_stdout) {
+            write_json(results, run_options, std::cout);
+        } else {
+            std::ofstream json {vm["json"].as<std::string>()};
+            if (!json) {
+                std::cerr << "Could not open " << vm["json"].as<std::string>() << " for writing" << std::endl;
+                return EXIT_FAILURE;
+            }
+            write_json(results, run_options, json);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+
+#include "config/config.hpp"
+#include "core/models/pairhmm/simd_pair_hmm_kernel.hpp"
+
+namespace octopus { namespace benchmark {
+
+void BenchmarkSuite::add(std::string name, Fixture fixture)
+{
+    benchmarks_.push_back({std::move(name), std::move(fixture)});
+}
+
+std::vector<std::string> BenchmarkSuite::names() const
+{
+    std::vector<std::string> result(benchmarks_.size());
+    std::transform(std::cbegin(benchmarks_), std::cend(benchmarks_), std::begin(result),
+                   [] (const Benchmark& benchmark) { return benchmark.name; });
+    return result;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Clock::duration time_iterations(const BenchmarkSuite::Body& body, const std::size_t iterations)
+{
+    const auto start = Clock::now();
+    for (std::size_t i {0}; i < iterations; ++i) body();
+    return Clock::now() - start;
+}
+
+std::size_t calibrate_iterations(const BenchmarkSuite::Body& body, const std::chrono::milliseconds min_sample_time)
+{
+    std::size_t result {1};
+    for (auto duration = time_iterations(body, result); duration < min_sample_time; duration = time_iterations(body, result)) {
+        if (duration.count() > 0) {
+            // Aim a little over the minimum so the next trial is usually the last
+            const auto ratio = 1.2 * min_sample_time / duration;
+            result = std::max(result + 1, static_cast<std::size_t>(result * std::min(ratio, 100.0)));
+        } else {
+            result *= 100;
+        }
+    }
+    return result;
+}
+
+double mean(const std::vector<double>& values)
+{
+    return std::accumulate(std::cbegin(values), std::cend(values), 0.0) / values.size();
+}
+
+double median(std::vector<double> values)
+{
+    const auto nth = std::next(std::begin(values), values.size() / 2);
+    std::nth_element(std::begin(values), nth, std::end(values));
+    if (values.size() % 2 == 1) return *nth;
+    return (*nth + *std::max_element(std::begin(values), nth)) / 2;
+}
+
+double stdev(const std::vector<double>& values, const double mean)
+{
+    if (values.size() < 2) return 0;
+    const auto ss = std::accumulate(std::cbegin(values), std::cend(values), 0.0,
+                                    [=] (double total, double x) { return total + (x - mean) * (x - mean); });
+    return std::sqrt(ss / (values.size() - 1));
+}
+
+BenchmarkResult run(const std::string& name, const BenchmarkSuite::Fixture& fixture, const BenchmarkSuite::Options& options)
+{
+    const auto body = fixture();
+    const auto iterations = calibrate_iterations(body, options.min_sample_time);
+    std::vector<double> sample_times(std::max(options.num_samples, 1u));
+    for (auto& sample_time : sample_times) {
+        const auto duration = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(time_iterations(body, iterations));
+        sample_time = duration.count() / iterations;
+    }
+    const auto mean_time = mean(sample_times);
+    return {name, iterations, sample_times.size(),
+            mean_time, median(sample_times),
+            *std::min_element(std::cbegin(sample_times), std::cend(sample_times)),
+            stdev(sample_times, mean_time)};
+}
+
+} // namespace
+
+std::vector<BenchmarkResult>
+BenchmarkSuite::run(const std::regex& filter, const Options options, std::ostream& log) const
+{
+    std::vector<BenchmarkResult> result {};
+    for (const auto& entry : benchmarks_) {
+        if (!std::regex_search(entry.name, filter)) continue;
+        log << std::left << std::setw(60) << entry.name << std::flush;
+        result.push_back(benchmark::run(entry.name, entry.fixture, options));
+        const auto& benchmark_result = result.back();
+        log << std::right << std::setw(16) << std::fixed << std::setprecision(1) << benchmark_result.median_ns << " ns"
+            << " (+/- " << std::setprecision(1) << benchmark_result.stddev_ns << ")" << std::endl;
+    }
+    return result;
+}
+
+namespace {
+
+std::string escape(const std::string& str)
+{
+    std::string result {};
+    result.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+std::string current_time()
+{
+    const auto now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    return buffer;
+}
+
+} // namespace
+
+void write_json(const std::vector<BenchmarkResult>& results, const BenchmarkSuite::Options& options, std::ostream& os)
+{
+    os << "{\n";
+    os << "  \"context\": {\n";
+    os << "    \"date\": \"" << current_time() << "\",\n";
+    os << "    \"octopus_version\": \"" << escape(config::to_string(config::Version, false)) << "\",\n";
+    os << "    \"compiler\": \"" << escape(config::System.compiler_name + " " + config::System.compiler_version) << "\",\n";
+    os << "    \"build_type\": \"" << escape(config::System.build_type) << "\",\n";
+    os << "    \"pair_hmm_instruction_set\": \"" << hmm::simd::pair_hmm_instruction_set() << "\",\n";
+    os << "    \"num_samples\": " << options.num_samples << ",\n";
+    os << "    \"min_sample_time_ms\": " << options.min_sample_time.count() << "\n";
+    os << "  },\n";
+    os << "  \"benchmarks\": [";
+    os << std::fixed << std::setprecision(3);
+    for (std::size_t i {0}; i < results.size(); ++i) {
+        const auto& result = results[i];
+        os << (i > 0 ? ",\n" : "\n");
+        os << "    {\"name\": \"" << escape(result.name) << "\""
+           << ", \"iterations_per_sample\": " << result.iterations_per_sample
+           << ", \"num_samples\": " << result.num_samples
+           << ", \"mean_ns\": " << result.mean_ns
+           << ", \"median_ns\": " << result.median_ns
+           << ", \"min_ns\": " << result.min_ns
+           << ", \"stddev_ns\": " << result.stddev_ns
+           << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+} // namespace benchmark
+} // namespace octopus
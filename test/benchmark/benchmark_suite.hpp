@@ -0,0 +1,83 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef benchmark_suite_hpp
+#define benchmark_suite_hpp
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <regex>
+#include <iosfwd>
+
+namespace octopus { namespace benchmark {
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t iterations_per_sample, num_samples;
+    double mean_ns, median_ns, min_ns, stddev_ns;
+};
+
+/*
+    BenchmarkSuite is a collection of named benchmarks. Each benchmark is a fixture that does any
+    setup outside of the timer, and returns the body that is timed. Bodies are run repeatedly
+    until a sample takes at least min_sample_time, and the per-iteration time of each sample
+    is recorded. All inputs should be generated from fixed seeds so results are comparable
+    between runs.
+*/
+class BenchmarkSuite
+{
+public:
+    using Body    = std::function<void()>;
+    using Fixture = std::function<Body()>;
+
+    struct Options
+    {
+        unsigned num_samples = 10;
+        std::chrono::milliseconds min_sample_time {100};
+    };
+
+    BenchmarkSuite() = default;
+
+    BenchmarkSuite(const BenchmarkSuite&)            = delete;
+    BenchmarkSuite& operator=(const BenchmarkSuite&) = delete;
+    BenchmarkSuite(BenchmarkSuite&&)                 = default;
+    BenchmarkSuite& operator=(BenchmarkSuite&&)      = default;
+
+    ~BenchmarkSuite() = default;
+
+    void add(std::string name, Fixture fixture);
+
+    std::vector<std::string> names() const;
+
+    // Runs all benchmarks with names matching filter, writing progress to log
+    std::vector<BenchmarkResult> run(const std::regex& filter, Options options, std::ostream& log) const;
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        Fixture fixture;
+    };
+
+    std::vector<Benchmark> benchmarks_;
+};
+
+void write_json(const std::vector<BenchmarkResult>& results, const BenchmarkSuite::Options& options, std::ostream& os);
+
+// Each is defined in the corresponding *_benchmarks.cpp
+void add_pair_hmm_benchmarks(BenchmarkSuite& suite);
+void add_haplotype_likelihood_benchmarks(BenchmarkSuite& suite);
+void add_assembler_benchmarks(BenchmarkSuite& suite);
+void add_haplotype_tree_benchmarks(BenchmarkSuite& suite);
+void add_genotype_benchmarks(BenchmarkSuite& suite);
+void add_genotype_model_benchmarks(BenchmarkSuite& suite);
+void add_vcf_writer_benchmarks(BenchmarkSuite& suite);
+
+} // namespace benchmark
+} // namespace octopus
+
+#endif
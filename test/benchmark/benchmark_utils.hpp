@@ -7,18 +7,30 @@
 #include <chrono>
 
 template <typename D = std::chrono::nanoseconds, typename F>
-D benchmark(F f, unsigned num_tests)
+D benchmark(F f, const unsigned num_tests)
 {
     D total {0};
-    
-    for (; num_tests > 0; --num_tests) {
-        const auto start = std::chrono::system_clock::now();
+
+    for (unsigned i {0}; i < num_tests; ++i) {
+        const auto start = std::chrono::steady_clock::now();
         f();
-        const auto end = std::chrono::system_clock::now();
+        const auto end = std::chrono::steady_clock::now();
         total += std::chrono::duration_cast<D>(end - start);
     }
-    
-    return D {total / num_tests};
+
+    return num_tests > 0 ? D {total / num_tests} : total;
 }
 
+namespace octopus { namespace benchmark {
+
+// Stops the compiler discarding a result that is otherwise unused
+template <typename T>
+void do_not_optimise(const T& value) noexcept
+{
+    asm volatile("" : : "g" (&value) : "memory");
+}
+
+} // namespace benchmark
+} // namespace octopus
+
 #endif
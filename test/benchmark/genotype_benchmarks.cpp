@@ -0,0 +1,54 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <memory>
+
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+struct GenotypeInputs
+{
+    ReferenceGenome reference;
+    MappableBlock<Haplotype> haplotypes;
+    MappableBlock<IndexedHaplotype<>> indexed_haplotypes;
+
+    GenotypeInputs(const unsigned num_haplotypes) : reference {make_benchmark_reference()}
+    {
+        RandomEngine engine {default_seed};
+        haplotypes = make_haplotypes(reference, make_benchmark_region(), num_haplotypes, engine);
+        indexed_haplotypes = index(haplotypes);
+    }
+};
+
+void add_generate_benchmark(BenchmarkSuite& suite, const unsigned num_haplotypes, const unsigned ploidy)
+{
+    const auto name = "genotype/generate_all/haplotypes" + std::to_string(num_haplotypes) + "/ploidy" + std::to_string(ploidy);
+    suite.add(name, [=] () -> BenchmarkSuite::Body {
+        const auto inputs = std::make_shared<GenotypeInputs>(num_haplotypes);
+        return [=] () {
+            const auto genotypes = generate_all_genotypes(inputs->indexed_haplotypes, ploidy);
+            do_not_optimise(genotypes);
+        };
+    });
+}
+
+} // namespace
+
+void add_genotype_benchmarks(BenchmarkSuite& suite)
+{
+    add_generate_benchmark(suite, 20, 2);
+    add_generate_benchmark(suite, 20, 3);
+    add_generate_benchmark(suite, 10, 4);
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,147 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iterator>
+
+#include "basics/trio.hpp"
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/genotype/uniform_genotype_prior_model.hpp"
+#include "core/models/genotype/uniform_population_prior_model.hpp"
+#include "core/models/genotype/individual_model.hpp"
+#include "core/models/genotype/population_model.hpp"
+#include "core/models/genotype/trio_model.hpp"
+#include "core/models/genotype/subclone_model.hpp"
+#include "core/models/mutation/denovo_model.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+// Haplotype likelihoods are computed once, so only the genotype model is timed
+struct ModelInputs
+{
+    ReferenceGenome reference;
+    std::vector<SampleName> samples;
+    MappableBlock<Haplotype> haplotypes;
+    MappableBlock<Genotype<IndexedHaplotype<>>> genotypes;
+    HaplotypeLikelihoodModel likelihood_model;
+    HaplotypeLikelihoodArray likelihoods;
+
+    ModelInputs(const unsigned num_samples, const unsigned num_haplotypes, const unsigned ploidy)
+    : reference {make_benchmark_reference()}
+    , samples {make_samples(num_samples)}
+    {
+        RandomEngine engine {default_seed};
+        haplotypes = make_haplotypes(reference, make_benchmark_region(), num_haplotypes, engine);
+        genotypes = generate_all_genotypes(index(haplotypes), ploidy);
+        const auto reads = make_reads(samples, haplotypes, 50, 150, engine);
+        likelihoods = HaplotypeLikelihoodArray {likelihood_model, num_haplotypes, samples};
+        likelihoods.populate(reads, haplotypes);
+    }
+};
+
+std::string make_name(const std::string& model_name, const unsigned num_samples, const unsigned num_haplotypes, const unsigned ploidy)
+{
+    return "genotype_model/" + model_name + "/samples" + std::to_string(num_samples) + "/haplotypes"
+           + std::to_string(num_haplotypes) + "/ploidy" + std::to_string(ploidy);
+}
+
+void add_individual_benchmark(BenchmarkSuite& suite, const unsigned num_haplotypes, const unsigned ploidy)
+{
+    suite.add(make_name("individual", 1, num_haplotypes, ploidy), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = std::make_shared<ModelInputs>(1, num_haplotypes, ploidy);
+        const auto prior_model = std::make_shared<UniformGenotypePriorModel>();
+        const auto genotype_model = std::make_shared<model::IndividualModel>(*prior_model);
+        genotype_model->prime(inputs->haplotypes);
+        inputs->likelihoods.prime(inputs->samples.front());
+        return [=] () {
+            const auto latents = genotype_model->evaluate(inputs->genotypes, inputs->likelihoods);
+            do_not_optimise(latents);
+        };
+    });
+}
+
+void add_population_benchmark(BenchmarkSuite& suite, const unsigned num_samples, const unsigned num_haplotypes, const unsigned ploidy)
+{
+    suite.add(make_name("population", num_samples, num_haplotypes, ploidy), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = std::make_shared<ModelInputs>(num_samples, num_haplotypes, ploidy);
+        const auto prior_model = std::make_shared<UniformPopulationPriorModel>();
+        prior_model->prime(inputs->haplotypes);
+        const auto genotype_model = std::make_shared<model::PopulationModel>(*prior_model);
+        return [=] () {
+            const auto latents = genotype_model->evaluate(inputs->samples, inputs->haplotypes, inputs->genotypes, inputs->likelihoods);
+            do_not_optimise(latents);
+        };
+    });
+}
+
+struct TrioModelState
+{
+    Trio trio;
+    UniformPopulationPriorModel prior_model;
+    DeNovoModel denovo_model;
+    model::TrioModel trio_model;
+
+    TrioModelState(const std::vector<SampleName>& samples, const MappableBlock<Haplotype>& haplotypes)
+    : trio {Trio::Mother {samples[0]}, Trio::Father {samples[1]}, Trio::Child {samples[2]}}
+    , prior_model {}
+    , denovo_model {{1e-8, 1e-9}, haplotypes.size(), DeNovoModel::CachingStrategy::address}
+    , trio_model {trio, prior_model, denovo_model, model::TrioModel::Options {}}
+    {
+        prior_model.prime(haplotypes);
+        denovo_model.prime(haplotypes);
+    }
+};
+
+void add_trio_benchmark(BenchmarkSuite& suite, const unsigned num_haplotypes)
+{
+    suite.add(make_name("trio", 3, num_haplotypes, 2), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = std::make_shared<ModelInputs>(3, num_haplotypes, 2);
+        const auto state = std::make_shared<TrioModelState>(inputs->samples, inputs->haplotypes);
+        return [=] () {
+            const auto latents = state->trio_model.evaluate(inputs->genotypes, inputs->likelihoods);
+            do_not_optimise(latents);
+        };
+    });
+}
+
+void add_subclone_benchmark(BenchmarkSuite& suite, const unsigned num_haplotypes, const unsigned num_clones)
+{
+    suite.add(make_name("subclone", 1, num_haplotypes, num_clones), [=] () -> BenchmarkSuite::Body {
+        const auto inputs = std::make_shared<ModelInputs>(1, num_haplotypes, num_clones);
+        const auto prior_model = std::make_shared<UniformGenotypePriorModel>();
+        model::SubcloneModel::Priors::GenotypeMixturesDirichletAlphaMap alphas {};
+        alphas.emplace(inputs->samples.front(), model::SubcloneModel::Priors::GenotypeMixturesDirichletAlphas(num_clones, 1.0));
+        const auto genotype_model = std::make_shared<model::SubcloneModel>(inputs->samples, model::SubcloneModel::Priors {*prior_model, std::move(alphas)});
+        genotype_model->prime(inputs->haplotypes);
+        const auto genotypes = std::make_shared<std::vector<Genotype<IndexedHaplotype<>>>>(std::cbegin(inputs->genotypes), std::cend(inputs->genotypes));
+        return [=] () {
+            const auto latents = genotype_model->evaluate(*genotypes, inputs->likelihoods);
+            do_not_optimise(latents);
+        };
+    });
+}
+
+} // namespace
+
+void add_genotype_model_benchmarks(BenchmarkSuite& suite)
+{
+    add_individual_benchmark(suite, 10, 2);
+    add_individual_benchmark(suite, 20, 2);
+    add_population_benchmark(suite, 3, 10, 2);
+    add_trio_benchmark(suite, 8);
+    add_subclone_benchmark(suite, 8, 3);
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,77 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+struct PopulateState
+{
+    ReferenceGenome reference;
+    std::vector<SampleName> samples;
+    MappableBlock<Haplotype> haplotypes;
+    ReadMap reads;
+    HaplotypeLikelihoodModel model;
+    HaplotypeLikelihoodArray likelihoods;
+
+    PopulateState(const unsigned num_samples, const unsigned num_haplotypes, const unsigned num_reads_per_sample)
+    : reference {make_benchmark_reference()}
+    , samples {make_samples(num_samples)}
+    {
+        RandomEngine engine {default_seed};
+        haplotypes = make_haplotypes(reference, make_benchmark_region(), num_haplotypes, engine);
+        reads = make_reads(samples, haplotypes, num_reads_per_sample, 150, engine);
+        likelihoods = HaplotypeLikelihoodArray {model, num_haplotypes, samples};
+    }
+};
+
+std::string make_name(const std::string& prefix, const unsigned num_samples, const unsigned num_haplotypes, const unsigned num_reads)
+{
+    return prefix + "/samples" + std::to_string(num_samples) + "/haplotypes" + std::to_string(num_haplotypes)
+           + "/reads" + std::to_string(num_reads);
+}
+
+void add_populate_benchmarks(BenchmarkSuite& suite, const unsigned num_samples, const unsigned num_haplotypes, const unsigned num_reads)
+{
+    // A new array has no memoised alignments, so every read is aligned
+    suite.add(make_name("haplotype_likelihood_array/populate/cold", num_samples, num_haplotypes, num_reads), [=] () -> BenchmarkSuite::Body {
+        const auto state = std::make_shared<PopulateState>(num_samples, num_haplotypes, num_reads);
+        return [=] () {
+            HaplotypeLikelihoodArray likelihoods {state->model, num_haplotypes, state->samples};
+            likelihoods.populate(state->reads, state->haplotypes);
+            do_not_optimise(likelihoods);
+        };
+    });
+    // Repopulating the same array reuses alignments from the previous call, as in overlapping windows
+    suite.add(make_name("haplotype_likelihood_array/populate/warm", num_samples, num_haplotypes, num_reads), [=] () -> BenchmarkSuite::Body {
+        const auto state = std::make_shared<PopulateState>(num_samples, num_haplotypes, num_reads);
+        state->likelihoods.populate(state->reads, state->haplotypes);
+        return [=] () {
+            state->likelihoods.populate(state->reads, state->haplotypes);
+            do_not_optimise(state->likelihoods);
+        };
+    });
+}
+
+} // namespace
+
+void add_haplotype_likelihood_benchmarks(BenchmarkSuite& suite)
+{
+    add_populate_benchmarks(suite, 1, 4, 200);
+    add_populate_benchmarks(suite, 1, 16, 200);
+    add_populate_benchmarks(suite, 3, 16, 200);
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,86 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using coretools::HaplotypeTree;
+
+struct TreeInputs
+{
+    ReferenceGenome reference;
+    std::vector<Allele> alleles;
+};
+
+// Each site contributes a reference and an alternative SNV allele, so the tree doubles in size per site
+auto make_tree_inputs(const unsigned num_sites, const GenomicRegion::Size spacing)
+{
+    RandomEngine engine {default_seed};
+    auto result = std::make_shared<TreeInputs>(TreeInputs {make_benchmark_reference(), {}});
+    const auto region = make_benchmark_region(num_sites * spacing);
+    result->alleles.reserve(2 * num_sites);
+    for (unsigned i {0}; i < num_sites; ++i) {
+        const auto begin = region.begin() + i * spacing + spacing / 2;
+        const GenomicRegion site {region.contig_name(), begin, begin + 1};
+        const auto ref_sequence = result->reference.fetch_sequence(site);
+        result->alleles.emplace_back(site, ref_sequence);
+        auto alt_sequence = ref_sequence;
+        while (alt_sequence == ref_sequence) alt_sequence = mutate(ref_sequence, 1.0, engine);
+        result->alleles.emplace_back(site, std::move(alt_sequence));
+    }
+    return result;
+}
+
+HaplotypeTree make_tree(const TreeInputs& inputs)
+{
+    HaplotypeTree result {inputs.alleles.front().mapped_region().contig_name(), inputs.reference};
+    for (const auto& allele : inputs.alleles) {
+        result.extend(allele);
+    }
+    return result;
+}
+
+void add_tree_benchmarks(BenchmarkSuite& suite, const unsigned num_sites, const GenomicRegion::Size spacing)
+{
+    const auto suffix = "/sites" + std::to_string(num_sites) + "/spacing" + std::to_string(spacing);
+    suite.add("haplotype_tree/extend" + suffix, [=] () -> BenchmarkSuite::Body {
+        const auto inputs = make_tree_inputs(num_sites, spacing);
+        return [=] () {
+            const auto tree = make_tree(*inputs);
+            do_not_optimise(tree.num_haplotypes());
+        };
+    });
+    suite.add("haplotype_tree/extract_haplotypes" + suffix, [=] () -> BenchmarkSuite::Body {
+        const auto inputs = make_tree_inputs(num_sites, spacing);
+        const auto tree = std::make_shared<HaplotypeTree>(make_tree(*inputs));
+        return [=] () {
+            const auto haplotypes = tree->extract_haplotypes();
+            do_not_optimise(haplotypes);
+        };
+    });
+}
+
+} // namespace
+
+void add_haplotype_tree_benchmarks(BenchmarkSuite& suite)
+{
+    add_tree_benchmarks(suite, 6, 20);
+    add_tree_benchmarks(suite, 10, 20);
+    add_tree_benchmarks(suite, 10, 100);
+}
+
+} // namespace benchmark
+} // namespace octopus
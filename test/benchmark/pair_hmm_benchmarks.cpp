@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "core/models/pairhmm/simd_pair_hmm_wrapper.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using hmm::simd::PairHMMWrapper;
+using hmm::simd::ScorePrecision;
+using hmm::simd::AlignmentTask;
+
+struct PairHMMInputs
+{
+    std::string truth, target;
+    std::vector<std::int8_t> qualities, gap_open, gap_extend, snv_priors;
+    std::string snv_mask;
+};
+
+// The target is sampled from the middle of the truth window, as in HaplotypeLikelihoodModel
+PairHMMInputs make_pair_hmm_inputs(const ReferenceGenome& reference, const int band_size, const int read_length,
+                                   RandomEngine& engine)
+{
+    const auto truth_size = static_cast<GenomicRegion::Size>(read_length + 2 * band_size - 1);
+    const auto region = make_benchmark_region(truth_size);
+    PairHMMInputs result {};
+    result.truth = reference.fetch_sequence(region);
+    result.target = mutate(result.truth.substr(band_size, read_length), 0.01, engine);
+    std::uniform_int_distribution<int> quality_dist {20, 40};
+    result.qualities.resize(read_length);
+    for (auto& quality : result.qualities) quality = quality_dist(engine);
+    result.gap_open.assign(truth_size, 45);
+    result.gap_extend.assign(truth_size, 3);
+    result.snv_priors.assign(truth_size, 127);
+    result.snv_mask.assign(truth_size, 'N');
+    return result;
+}
+
+void add_align_benchmark(BenchmarkSuite& suite, const int band_size, const ScorePrecision precision, const int read_length)
+{
+    const std::string name {"pair_hmm/align/" + std::string {precision == ScorePrecision::int16 ? "int16" : "int32"}
+                            + "/band" + std::to_string(band_size) + "/read" + std::to_string(read_length)};
+    suite.add(name, [=] () -> BenchmarkSuite::Body {
+        RandomEngine engine {default_seed};
+        const auto hmm = std::make_shared<PairHMMWrapper>(band_size, precision);
+        const auto reference = make_benchmark_reference();
+        const auto inputs = std::make_shared<PairHMMInputs>(make_pair_hmm_inputs(reference, hmm->band_size(), read_length, engine));
+        return [=] () {
+            const auto score = hmm->align(inputs->truth.data(), inputs->target.data(), inputs->qualities.data(),
+                                          static_cast<int>(inputs->truth.size()), static_cast<int>(inputs->target.size()),
+                                          inputs->snv_mask.data(), inputs->snv_priors.data(),
+                                          inputs->gap_open.data(), inputs->gap_extend.data(), 2);
+            do_not_optimise(score);
+        };
+    });
+}
+
+void add_batch_align_benchmark(BenchmarkSuite& suite, const int band_size, const int num_reads, const int read_length)
+{
+    const std::string name {"pair_hmm/batch_align/int16/band" + std::to_string(band_size)
+                            + "/reads" + std::to_string(num_reads) + "/read" + std::to_string(read_length)};
+    suite.add(name, [=] () -> BenchmarkSuite::Body {
+        RandomEngine engine {default_seed};
+        const auto hmm = std::make_shared<PairHMMWrapper>(band_size, ScorePrecision::int16);
+        const auto reference = make_benchmark_reference();
+        const auto inputs = std::make_shared<std::vector<PairHMMInputs>>();
+        for (int i {0}; i < num_reads; ++i) {
+            inputs->push_back(make_pair_hmm_inputs(reference, hmm->band_size(), read_length, engine));
+        }
+        const auto tasks = std::make_shared<std::vector<AlignmentTask>>();
+        for (const auto& input : *inputs) {
+            tasks->push_back({input.truth.data(), input.target.data(), input.qualities.data(), read_length,
+                              input.snv_mask.data(), input.snv_priors.data(), input.gap_open.data(), input.gap_extend.data()});
+        }
+        const auto scores = std::make_shared<std::vector<int>>();
+        return [=] () {
+            hmm->align(*tasks, 2, *scores);
+            do_not_optimise(scores->data());
+        };
+    });
+}
+
+} // namespace
+
+void add_pair_hmm_benchmarks(BenchmarkSuite& suite)
+{
+    for (const auto precision : {ScorePrecision::int16, ScorePrecision::int32}) {
+        for (const int band_size : {8, 16, 32, 64}) {
+            add_align_benchmark(suite, band_size, precision, 150);
+        }
+    }
+    add_align_benchmark(suite, 8, ScorePrecision::int16, 250);
+    add_batch_align_benchmark(suite, 8, 64, 150);
+    add_batch_align_benchmark(suite, 16, 64, 150);
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,120 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "synthetic_data.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+#include "basics/cigar_string.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace benchmark {
+
+ReferenceGenome make_benchmark_reference()
+{
+    return test::mock::make_reference();
+}
+
+GenomicRegion make_benchmark_region(const GenomicRegion::Size size)
+{
+    // Mock contig "4" is 2000bp
+    constexpr GenomicRegion::Position begin {200};
+    assert(size <= 1600);
+    return GenomicRegion {"4", begin, begin + size};
+}
+
+namespace {
+
+char random_base(RandomEngine& engine)
+{
+    static constexpr char bases[] {'A', 'C', 'G', 'T'};
+    std::uniform_int_distribution<int> base_dist {0, 3};
+    return bases[base_dist(engine)];
+}
+
+char random_substitution(const char base, RandomEngine& engine)
+{
+    auto result = base;
+    while (result == base) result = random_base(engine);
+    return result;
+}
+
+} // namespace
+
+std::string mutate(std::string sequence, const double snv_rate, RandomEngine& engine)
+{
+    std::bernoulli_distribution is_snv {snv_rate};
+    for (auto& base : sequence) {
+        if (is_snv(engine)) base = random_substitution(base, engine);
+    }
+    return sequence;
+}
+
+MappableBlock<Haplotype>
+make_haplotypes(const ReferenceGenome& reference, const GenomicRegion& region, const unsigned num_haplotypes,
+                RandomEngine& engine, const double snv_rate)
+{
+    const auto reference_sequence = reference.fetch_sequence(region);
+    MappableBlock<Haplotype> result {region};
+    result.reserve(num_haplotypes);
+    if (num_haplotypes > 0) result.emplace_back(region, reference_sequence, reference);
+    while (result.size() < num_haplotypes) {
+        result.emplace_back(region, mutate(reference_sequence, snv_rate, engine), reference);
+    }
+    return result;
+}
+
+std::vector<AlignedRead>
+make_reads(const MappableBlock<Haplotype>& haplotypes, const unsigned num_reads, const unsigned read_length,
+           RandomEngine& engine, const double error_rate)
+{
+    assert(!haplotypes.empty());
+    const auto& region = mapped_region(haplotypes);
+    constexpr GenomicRegion::Size pad {25};
+    assert(region_size(region) >= read_length + 2 * pad);
+    std::uniform_int_distribution<std::size_t> haplotype_dist {0, haplotypes.size() - 1};
+    std::uniform_int_distribution<GenomicRegion::Position> offset_dist {pad, region_size(region) - read_length - pad};
+    std::uniform_int_distribution<int> quality_dist {20, 40};
+    const auto cigar = parse_cigar(std::to_string(read_length) + "M");
+    std::vector<AlignedRead> result {};
+    result.reserve(num_reads);
+    for (unsigned i {0}; i < num_reads; ++i) {
+        const auto& haplotype = haplotypes[haplotype_dist(engine)];
+        const auto offset = offset_dist(engine);
+        auto sequence = mutate(haplotype.sequence().substr(offset, read_length), error_rate, engine);
+        AlignedRead::BaseQualityVector qualities(read_length);
+        std::generate(std::begin(qualities), std::end(qualities), [&] () { return quality_dist(engine); });
+        const auto begin = region.begin() + offset;
+        result.emplace_back("read" + std::to_string(i), GenomicRegion {region.contig_name(), begin, begin + read_length},
+                            std::move(sequence), std::move(qualities), cigar, 60, AlignedRead::Flags {}, "", "");
+    }
+    std::sort(std::begin(result), std::end(result));
+    return result;
+}
+
+ReadMap
+make_reads(const std::vector<SampleName>& samples, const MappableBlock<Haplotype>& haplotypes,
+           const unsigned num_reads_per_sample, const unsigned read_length, RandomEngine& engine)
+{
+    ReadMap result {};
+    result.reserve(samples.size());
+    for (const auto& sample : samples) {
+        const auto reads = make_reads(haplotypes, num_reads_per_sample, read_length, engine);
+        result.emplace(sample, ReadContainer {std::cbegin(reads), std::cend(reads)});
+    }
+    return result;
+}
+
+std::vector<SampleName> make_samples(const unsigned num_samples)
+{
+    std::vector<SampleName> result(num_samples);
+    for (unsigned i {0}; i < num_samples; ++i) {
+        result[i] = "SAMPLE" + std::to_string(i);
+    }
+    return result;
+}
+
+} // namespace benchmark
+} // namespace octopus
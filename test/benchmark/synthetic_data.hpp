@@ -0,0 +1,52 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef synthetic_data_hpp
+#define synthetic_data_hpp
+
+#include <vector>
+#include <string>
+#include <random>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/types/haplotype.hpp"
+#include "containers/mappable_block.hpp"
+
+namespace octopus { namespace benchmark {
+
+using RandomEngine = std::mt19937;
+
+// All synthetic inputs are drawn from engines seeded with this, so runs are reproducible
+constexpr RandomEngine::result_type default_seed {42};
+
+// The mock reference from test/mock, which needs no files
+ReferenceGenome make_benchmark_reference();
+
+// A region of the benchmark reference long enough to hold a typical calling window
+GenomicRegion make_benchmark_region(GenomicRegion::Size size = 600);
+
+std::string mutate(std::string sequence, double snv_rate, RandomEngine& engine);
+
+// The first haplotype is the reference, the others carry random SNVs
+MappableBlock<Haplotype>
+make_haplotypes(const ReferenceGenome& reference, const GenomicRegion& region, unsigned num_haplotypes,
+                RandomEngine& engine, double snv_rate = 0.005);
+
+// Reads are sampled uniformly from the haplotypes, with sequencing errors and simple cigars
+std::vector<AlignedRead>
+make_reads(const MappableBlock<Haplotype>& haplotypes, unsigned num_reads, unsigned read_length,
+           RandomEngine& engine, double error_rate = 0.005);
+
+ReadMap
+make_reads(const std::vector<SampleName>& samples, const MappableBlock<Haplotype>& haplotypes,
+           unsigned num_reads_per_sample, unsigned read_length, RandomEngine& engine);
+
+std::vector<SampleName> make_samples(unsigned num_samples);
+
+} // namespace benchmark
+} // namespace octopus
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_suite.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "benchmark_utils.hpp"
+#include "synthetic_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+struct VcfInputs
+{
+    VcfHeader header;
+    std::vector<VcfRecord> records;
+    fs::path path;
+
+    ~VcfInputs()
+    {
+        boost::system::error_code ec {};
+        fs::remove(path, ec);
+    }
+};
+
+// Records resemble diploid germline calls, with a few FORMAT fields per sample
+auto make_vcf_inputs(const unsigned num_samples, const unsigned num_records, const std::string& extension)
+{
+    RandomEngine engine {default_seed};
+    const auto samples = make_samples(num_samples);
+    auto header_builder = get_default_header_builder().set_samples(samples);
+    header_builder.add_contig("4");
+    header_builder.add_format("GT", "1", "String", "Genotype");
+    header_builder.add_format("GQ", "1", "Integer", "Genotype quality");
+    header_builder.add_format("DP", "1", "Integer", "Read depth");
+    auto result = std::make_shared<VcfInputs>(VcfInputs {header_builder.build_once(), {}, {}});
+    result->path = fs::temp_directory_path() / fs::unique_path("octopus-benchmark-%%%%-%%%%" + extension);
+    std::uniform_int_distribution<int> quality_dist {10, 1000}, depth_dist {10, 60}, allele_dist {0, 1};
+    result->records.reserve(num_records);
+    for (unsigned i {0}; i < num_records; ++i) {
+        VcfRecord::Builder record_builder {};
+        record_builder.set_chrom("4").set_pos(100 + 10 * i).set_ref("A").set_alt("C");
+        record_builder.set_qual(quality_dist(engine)).set_passed();
+        record_builder.set_format({"GT", "GQ", "DP"});
+        for (const auto& sample : samples) {
+            std::vector<boost::optional<unsigned>> genotype {};
+            genotype.emplace_back(allele_dist(engine));
+            genotype.emplace_back(1);
+            record_builder.set_genotype(sample, genotype, VcfRecord::Builder::Phasing::unphased);
+            record_builder.set_format(sample, "GQ", quality_dist(engine) / 10);
+            record_builder.set_format(sample, "DP", depth_dist(engine));
+        }
+        result->records.push_back(record_builder.build_once());
+    }
+    return result;
+}
+
+void add_write_benchmark(BenchmarkSuite& suite, const unsigned num_samples, const unsigned num_records, const std::string& extension)
+{
+    const auto name = "vcf_writer/write/" + extension.substr(1) + "/samples" + std::to_string(num_samples)
+                      + "/records" + std::to_string(num_records);
+    suite.add(name, [=] () -> BenchmarkSuite::Body {
+        const auto inputs = make_vcf_inputs(num_samples, num_records, extension);
+        return [=] () {
+            VcfWriter writer {inputs->path, inputs->header};
+            for (const auto& record : inputs->records) {
+                writer.write(record);
+            }
+            writer.close();
+        };
+    });
+}
+
+} // namespace
+
+void add_vcf_writer_benchmarks(BenchmarkSuite& suite)
+{
+    add_write_benchmark(suite, 1, 1000, ".vcf");
+    add_write_benchmark(suite, 3, 1000, ".vcf");
+    add_write_benchmark(suite, 3, 1000, ".vcf.gz");
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,28 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "mock_haplotype.hpp"
+
+namespace octopus { namespace test { namespace mock {
+
+Allele make_reference_allele(const ReferenceGenome& reference, const GenomicRegion& region)
+{
+    return Allele {region, reference.fetch_sequence(region)};
+}
+
+Allele make_snv(const ReferenceGenome& reference, const GenomicRegion::ContigName& contig, const GenomicRegion::Position position)
+{
+    const auto ref = make_reference_allele(reference, GenomicRegion {contig, position, position + 1});
+    return Allele {ref.mapped_region(), ref.sequence() == "A" ? "C" : "A"};
+}
+
+Haplotype make_haplotype(const ReferenceGenome& reference, const GenomicRegion& region, const std::vector<Allele>& alleles)
+{
+    Haplotype::Builder builder {region, reference};
+    for (const auto& allele : alleles) builder.push_back(allele);
+    return builder.build();
+}
+
+} // namespace mock
+} // namespace test
+} // namespace octopus
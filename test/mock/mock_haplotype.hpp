@@ -0,0 +1,27 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef mock_haplotype_hpp
+#define mock_haplotype_hpp
+
+#include <vector>
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+
+namespace octopus { namespace test { namespace mock {
+
+Allele make_reference_allele(const ReferenceGenome& reference, const GenomicRegion& region);
+
+// A base other than the reference base at position
+Allele make_snv(const ReferenceGenome& reference, const GenomicRegion::ContigName& contig, GenomicRegion::Position position);
+
+Haplotype make_haplotype(const ReferenceGenome& reference, const GenomicRegion& region, const std::vector<Allele>& alleles = {});
+
+} // namespace mock
+} // namespace test
+} // namespace octopus
+
+#endif
@@ -0,0 +1,23 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "mock_read.hpp"
+
+#include <utility>
+
+#include "basics/cigar_string.hpp"
+
+namespace octopus { namespace test { namespace mock {
+
+AlignedRead make_read(std::string name, const GenomicRegion::ContigName& contig, const GenomicRegion::Position begin,
+                      AlignedRead::NucleotideSequence sequence, AlignedRead::Flags flags)
+{
+    const auto length = static_cast<GenomicRegion::Position>(sequence.size());
+    AlignedRead::BaseQualityVector qualities(sequence.size(), 30);
+    return AlignedRead {std::move(name), GenomicRegion {contig, begin, begin + length}, std::move(sequence), std::move(qualities),
+                        parse_cigar(std::to_string(length) + "M"), 60, flags, "RG", ""};
+}
+
+} // namespace mock
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,22 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef mock_read_hpp
+#define mock_read_hpp
+
+#include <string>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+
+namespace octopus { namespace test { namespace mock {
+
+// A read aligned without gaps from begin, with uniform base qualities and a high mapping quality
+AlignedRead make_read(std::string name, const GenomicRegion::ContigName& contig, GenomicRegion::Position begin,
+                      AlignedRead::NucleotideSequence sequence, AlignedRead::Flags flags = {});
+
+} // namespace mock
+} // namespace test
+} // namespace octopus
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/packed_read_batch.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(basics)
+BOOST_AUTO_TEST_SUITE(packed_read_batch)
+
+namespace {
+
+std::vector<AlignedRead> make_mock_reads()
+{
+    AlignedRead::Flags reverse_flags {};
+    reverse_flags.reverse_mapped = true;
+    reverse_flags.duplicate = true;
+    std::vector<AlignedRead> result {};
+    result.emplace_back("read1", GenomicRegion {"1", 0, 4}, "ACGT", AlignedRead::BaseQualityVector {1, 2, 3, 4},
+                        parse_cigar("4M"), 10, AlignedRead::Flags {}, "RG1", "");
+    result.emplace_back("read2", GenomicRegion {"1", 2, 7}, "ANGTC", AlignedRead::BaseQualityVector {5, 6, 7, 8, 9},
+                        parse_cigar("1S4M"), 20, reverse_flags, "RG2", "AACC",
+                        "2", 100, 300, AlignedRead::Segment::Flags {true, false});
+    result.emplace_back("read3", GenomicRegion {"1", 10, 12}, "acgt", AlignedRead::BaseQualityVector {1, 1, 1, 1},
+                        parse_cigar("1M2I1M"), 30, AlignedRead::Flags {}, "RG1", "");
+    result.back().add_supplementary_alignment({GenomicRegion {"3", 5, 10}, parse_cigar("5M"), AlignedRead::Direction::forward, 40});
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(reads_are_materialised_unchanged)
+{
+    const auto reads = make_mock_reads();
+    const auto batch = pack(reads);
+    BOOST_REQUIRE_EQUAL(batch.size(), reads.size());
+    BOOST_CHECK(batch.is_sorted());
+    for (std::size_t i {0}; i < reads.size(); ++i) {
+        const auto read = batch[i];
+        BOOST_CHECK_EQUAL(read, reads[i]);
+        BOOST_CHECK_EQUAL(read.sequence(), reads[i].sequence());
+        BOOST_CHECK_EQUAL(read.read_group(), reads[i].read_group());
+        BOOST_CHECK_EQUAL(read.barcode(), reads[i].barcode());
+        BOOST_CHECK(read.flags() == reads[i].flags());
+        BOOST_REQUIRE_EQUAL(read.has_other_segment(), reads[i].has_other_segment());
+        if (read.has_other_segment()) {
+            BOOST_CHECK(read.next_segment() == reads[i].next_segment());
+        }
+        BOOST_CHECK_EQUAL(read.supplementary_alignments().size(), reads[i].supplementary_alignments().size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(copy_overlapped_returns_reads_overlapping_region)
+{
+    const auto reads = make_mock_reads();
+    const auto batch = pack(reads);
+    BOOST_CHECK_EQUAL(batch.copy_overlapped(GenomicRegion {"1", 3, 5}).size(), 2u);
+    BOOST_CHECK_EQUAL(batch.copy_overlapped(GenomicRegion {"1", 7, 10}).size(), 0u);
+    BOOST_CHECK_EQUAL(batch.copy_overlapped(GenomicRegion {"1", 11, 20}).size(), 1u);
+    BOOST_CHECK_EQUAL(batch.copy_overlapped(GenomicRegion {"2", 0, 20}).size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,139 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+
+#include <boost/variant.hpp>
+
+#include "basics/aligned_read.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/tools/read_assignment_spill.hpp"
+#include "core/csr/facets/samples.hpp"
+#include "core/csr/facets/alleles.hpp"
+#include "core/csr/facets/overlapping_reads.hpp"
+#include "core/csr/facets/read_assignments.hpp"
+#include "core/csr/measures/measure.hpp"
+#include "core/csr/measures/filtered_read_fraction.hpp"
+#include "core/csr/measures/allele_depth.hpp"
+#include "utils/genotype_reader.hpp"
+
+#include "mock/mock_read.hpp"
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+using csr::Measure;
+using csr::FilteredReadFraction;
+using csr::AlleleDepth;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(measure)
+
+namespace {
+
+const std::vector<std::string> samples {"sample1", "sample2"};
+
+// sample1 was called from 6 of its 8 reads, and sample2 has no calling depth
+VcfRecord make_call()
+{
+    using Values = VcfRecord::Values;
+    VcfRecord::Builder result {};
+    result.set_chrom("1").set_pos(100).set_ref("A").set_alt("C").set_qual(50);
+    result.set_info("DP", Values {std::vector<Values::IntegerType> {6}});
+    result.set_format({"GT", "DP"});
+    for (const auto& sample : samples) {
+        result.set_genotype(sample, std::vector<VcfRecord::NucleotideSequence> {"A", "C"}, VcfRecord::Builder::Phasing::unphased);
+    }
+    result.set_format(samples[0], "DP", 6);
+    result.set_format_missing(samples[1], "DP");
+    return result.build_once();
+}
+
+ReadMap make_reads()
+{
+    ReadMap result {};
+    const std::vector<std::size_t> num_reads {8, 4};
+    for (std::size_t s {0}; s < samples.size(); ++s) {
+        auto& reads = result[samples[s]];
+        for (std::size_t i {0}; i < num_reads[s]; ++i) {
+            reads.emplace(mock::make_read(samples[s] + "_" + std::to_string(i), "1", 90, std::string(20, 'A')));
+        }
+        // Does not overlap the call
+        reads.emplace(mock::make_read(samples[s] + "_away", "1", 200, std::string(20, 'A')));
+    }
+    return result;
+}
+
+Measure::FacetMap make_facets()
+{
+    Measure::FacetMap result {};
+    result.emplace("Samples", csr::FacetWrapper {std::make_unique<csr::Samples>(samples)});
+    result.emplace("OverlappingReads", csr::FacetWrapper {std::make_unique<csr::OverlappingReads>(make_reads())});
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(filtered_read_fraction_compares_calling_and_filtering_depths_for_each_sample)
+{
+    const auto call = make_call();
+    const auto facets = make_facets();
+    const FilteredReadFraction frf {};
+    const auto result = boost::get<std::vector<double>>(frf.evaluate(call, facets));
+    BOOST_REQUIRE_EQUAL(result.size(), samples.size());
+    BOOST_CHECK_CLOSE(result[0], 0.25, 1e-6);
+    // A missing calling depth leaves nothing to compare
+    BOOST_CHECK_EQUAL(result[1], 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(filtered_read_fraction_compares_combined_depths_when_samples_are_aggregated)
+{
+    const auto call = make_call();
+    const auto facets = make_facets();
+    const FilteredReadFraction frf {true};
+    BOOST_CHECK_CLOSE(boost::get<double>(frf.evaluate(call, facets)), 0.5, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(allele_depth_counts_the_read_assignments_made_by_the_caller)
+{
+    const auto reference = mock::make_reference();
+    VcfRecord::Builder call_builder {};
+    call_builder.set_chrom("1").set_pos(100).set_ref("T").set_alt("C").set_qual(50).set_format({"GT"});
+    call_builder.set_genotype(samples[0], std::vector<VcfRecord::NucleotideSequence> {"T", "C"}, VcfRecord::Builder::Phasing::unphased);
+    call_builder.set_genotype(samples[1], std::vector<VcfRecord::NucleotideSequence> {"T", "T"}, VcfRecord::Builder::Phasing::unphased);
+    const std::vector<VcfRecord> calls {call_builder.build_once()};
+    const auto reads = make_reads();
+    // The caller assigned four of sample1's reads to the alt, two to the ref, and left the rest unassigned
+    ReadAssignmentSpill::RecordAssignments assignments {};
+    for (std::size_t i {0}; i < 6; ++i) {
+        const auto read = mock::make_read(samples[0] + "_" + std::to_string(i), "1", 90, std::string(20, 'A'));
+        assignments[samples[0]].push_back({make_read_key(read), static_cast<ReadAssignmentSpill::AlleleIndex>(i < 4 ? 1 : 0)});
+    }
+    std::sort(std::begin(assignments[samples[0]]), std::end(assignments[samples[0]]),
+              [] (const auto& lhs, const auto& rhs) { return lhs.read < rhs.read; });
+    const csr::ReadAssignments::CalledAssignments called_assignments {assignments};
+    const auto genotypes = extract_genotypes(calls, samples, reference);
+    Measure::FacetMap facets {};
+    facets.emplace("Samples", csr::FacetWrapper {std::make_unique<csr::Samples>(samples)});
+    facets.emplace("Alleles", csr::FacetWrapper {std::make_unique<csr::Alleles>(samples, calls)});
+    facets.emplace("ReadAssignments", csr::FacetWrapper {std::make_unique<csr::ReadAssignments>(reference, genotypes, reads, calls, called_assignments)});
+    const AlleleDepth ad {};
+    const auto result = boost::get<std::vector<boost::optional<int>>>(ad.evaluate(calls.front(), facets));
+    BOOST_REQUIRE_EQUAL(result.size(), samples.size());
+    BOOST_REQUIRE(result[0]);
+    BOOST_CHECK_EQUAL(*result[0], 4);
+    BOOST_CHECK(!result[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,150 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <memory>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "basics/ploidy_map.hpp"
+#include "io/read/read_manager.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "io/variant/vcf_utils.hpp"
+#include "readpipe/read_pipe.hpp"
+#include "readpipe/buffered_read_pipe.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/csr/filters/variant_call_filter.hpp"
+#include "core/csr/filters/threshold_filter_factory.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(variant_call_filter)
+
+namespace {
+
+const std::string sample {"test"};
+const std::vector<std::string> contigs {"1", "2", "3"};
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+VcfHeader make_calls_header(const ReferenceGenome& reference)
+{
+    VcfHeader::Builder result {};
+    result.set_file_format("VCFv4.3");
+    for (const auto& contig : contigs) {
+        result.add_contig(contig, {{"length", std::to_string(reference.contig_size(contig))}});
+    }
+    result.add_format("GT", "1", "String", "Genotype");
+    result.add_format("GQ", "1", "Integer", "Conditional genotype quality");
+    result.add_sample(sample);
+    return result.build_once();
+}
+
+// Calls every 20bp on each contig, with qualities on either side of the filter thresholds
+fs::path make_calls_vcf(const fs::path& directory, const ReferenceGenome& reference)
+{
+    auto path = directory / "calls.bcf";
+    VcfWriter writer {path, make_calls_header(reference)};
+    int call_idx {0};
+    for (const auto& contig : contigs) {
+        for (GenomicRegion::Position pos {10}; pos + 10 < reference.contig_size(contig) && pos < 400; pos += 20, ++call_idx) {
+            const auto ref = reference.fetch_sequence(GenomicRegion {contig, pos - 1, pos});
+            const VcfRecord::NucleotideSequence alt {ref == "A" ? "C" : "A"};
+            VcfRecord::Builder call {};
+            call.set_chrom(contig).set_pos(pos).set_ref(ref).set_alt(alt);
+            call.set_qual(call_idx % 3 == 0 ? 5 : 50);
+            call.set_format({"GT", "GQ"});
+            call.set_genotype(sample, {ref, alt}, VcfRecord::Builder::Phasing::unphased);
+            call.set_format(sample, "GQ", call_idx % 5 == 0 ? 3 : 40);
+            writer << call.build_once();
+        }
+    }
+    writer.close();
+    index_vcf(path);
+    return path;
+}
+
+auto make_filter(const csr::VariantCallFilterFactory& factory, const ReferenceGenome& reference,
+                 const ReadPipe& read_pipe, const VcfReader& calls)
+{
+    BufferedReadPipe buffered_read_pipe {read_pipe, BufferedReadPipe::Config {1'000}};
+    return factory.make(reference, std::move(buffered_read_pipe), calls.fetch_header(), PloidyMap {},
+                        HaplotypeLikelihoodModel {}, boost::none);
+}
+
+std::vector<std::string> read_records(const fs::path& path)
+{
+    const VcfReader reader {path};
+    std::vector<std::string> result {};
+    for (const auto& record : reader.fetch_records()) {
+        std::ostringstream ss {};
+        ss << record;
+        result.push_back(ss.str());
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(threshold_filters_are_shardable)
+{
+    BOOST_CHECK(csr::ThresholdFilterFactory {"QUAL < 10"}.is_shardable());
+}
+
+BOOST_AUTO_TEST_CASE(sharded_filtering_matches_unsharded_filtering)
+{
+    const auto reference = mock::make_reference();
+    const TempDirectory temp {};
+    const auto calls_path = make_calls_vcf(temp.path, reference);
+    const VcfReader calls {calls_path};
+    const ReadManager read_manager {};
+    const ReadPipe read_pipe {read_manager, {sample}};
+    const csr::ThresholdFilterFactory factory {"QUAL < 10 | GQ < 10"};
+    BOOST_REQUIRE(factory.is_shardable());
+
+    const auto unsharded_path = temp.path / "unsharded.bcf";
+    {
+        VcfWriter unsharded {unsharded_path};
+        make_filter(factory, reference, read_pipe, calls)->filter(calls, unsharded);
+    }
+    std::vector<VcfWriter> shards {};
+    for (const auto& contig : contigs) {
+        shards.emplace_back(temp.path / (contig + "_filtered_temp.bcf"));
+        make_filter(factory, reference, read_pipe, calls)->filter(calls, shards.back(), contig);
+        shards.back().close();
+    }
+    auto shard_readers = writers_to_readers(std::move(shards), false);
+    const auto sharded_path = temp.path / "sharded.bcf";
+    {
+        VcfWriter sharded {sharded_path};
+        merge(shard_readers, sharded, contigs);
+    }
+    const auto expected = read_records(unsharded_path);
+    const auto actual = read_records(sharded_path);
+    BOOST_REQUIRE(!expected.empty());
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
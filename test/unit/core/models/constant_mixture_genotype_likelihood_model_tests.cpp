@@ -0,0 +1,132 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cmath>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/indexed_haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "containers/mappable_block.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+#include "core/models/genotype/constant_mixture_genotype_likelihood_model.hpp"
+
+#include "mock/mock_reference.hpp"
+#include "mock/mock_haplotype.hpp"
+#include "mock/mock_read.hpp"
+
+namespace octopus { namespace test {
+
+using model::ConstantMixtureGenotypeLikelihoodModel;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(constant_mixture_genotype_likelihood_model)
+
+namespace {
+
+const SampleName sample {"test"};
+
+MappableBlock<Haplotype> make_haplotypes(const ReferenceGenome& reference, const std::size_t n)
+{
+    const GenomicRegion region {"1", 50, 250};
+    const std::vector<std::vector<Allele>> alleles {
+        {},
+        {Allele {GenomicRegion {"1", 120, 121}, "G"}},
+        {Allele {GenomicRegion {"1", 130, 131}, "C"}},
+        {Allele {GenomicRegion {"1", 125, 128}, ""}},
+        {Allele {GenomicRegion {"1", 120, 121}, "G"}, Allele {GenomicRegion {"1", 140, 140}, "TT"}}
+    };
+    MappableBlock<Haplotype> result {};
+    for (std::size_t i {0}; i < n; ++i) {
+        result.push_back(mock::make_haplotype(reference, region, alleles[i]));
+    }
+    return result;
+}
+
+// Reads are sampled from each of the haplotypes so that every genotype gets distinct support. The
+// tied reads all lie before the first variant, so every haplotype explains them equally well.
+ReadMap make_reads(const MappableBlock<Haplotype>& haplotypes, const std::size_t num_tied_reads = 0)
+{
+    ReadMap result {};
+    auto& reads = result[sample];
+    const std::size_t read_length {40};
+    for (std::size_t i {0}; i < haplotypes.size(); ++i) {
+        const auto& sequence = haplotypes[i].sequence();
+        for (std::size_t offset : {50, 60, 70}) {
+            const auto begin = static_cast<GenomicRegion::Position>(50 + offset);
+            reads.emplace(mock::make_read("read" + std::to_string(i) + "_" + std::to_string(offset), "1", begin,
+                                          sequence.substr(offset, read_length)));
+        }
+    }
+    const auto& sequence = haplotypes.front().sequence();
+    for (std::size_t i {0}; i < num_tied_reads; ++i) {
+        const auto offset = i % 25;
+        const auto begin = static_cast<GenomicRegion::Position>(50 + offset);
+        reads.emplace(mock::make_read("tied" + std::to_string(i), "1", begin, sequence.substr(offset, read_length)));
+    }
+    return result;
+}
+
+void check_batched_evaluation_matches_per_genotype_evaluation(const std::size_t num_haplotypes, const unsigned ploidy,
+                                                              const std::size_t num_tied_reads = 0)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotypes = make_haplotypes(reference, num_haplotypes);
+    const auto reads = make_reads(haplotypes, num_tied_reads);
+    HaplotypeLikelihoodArray likelihoods {static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    likelihoods.prime(sample);
+    const ConstantMixtureGenotypeLikelihoodModel model {likelihoods};
+    const auto indexed_haplotypes = index(haplotypes);
+    const auto genotypes = generate_all_genotypes(indexed_haplotypes, ploidy);
+    std::vector<ConstantMixtureGenotypeLikelihoodModel::LogProbability> batched {};
+    model.evaluate(genotypes, batched);
+    BOOST_REQUIRE_EQUAL(batched.size(), genotypes.size());
+    for (std::size_t i {0}; i < genotypes.size(); ++i) {
+        Genotype<Haplotype> genotype {genotypes[i].ploidy()};
+        for (const auto& haplotype : genotypes[i]) genotype.emplace(haplotype.haplotype());
+        const auto expected = model.evaluate(genotype);
+        BOOST_CHECK(std::isfinite(batched[i]));
+        BOOST_CHECK_CLOSE(batched[i], expected, 1e-6);
+        BOOST_CHECK_CLOSE(model.evaluate(genotypes[i]), expected, 1e-6);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(batched_evaluation_matches_per_genotype_evaluation_when_few_genotypes)
+{
+    // 3 diploid genotypes from 2 haplotypes is below the column threshold
+    check_batched_evaluation_matches_per_genotype_evaluation(2, 2);
+}
+
+BOOST_AUTO_TEST_CASE(batched_evaluation_matches_per_genotype_evaluation_when_many_genotypes)
+{
+    // 15 diploid genotypes from 5 haplotypes is above the column threshold
+    check_batched_evaluation_matches_per_genotype_evaluation(5, 2);
+}
+
+BOOST_AUTO_TEST_CASE(batched_evaluation_matches_per_genotype_evaluation_for_polyploid_genotypes)
+{
+    check_batched_evaluation_matches_per_genotype_evaluation(4, 3);
+}
+
+BOOST_AUTO_TEST_CASE(batched_evaluation_stays_finite_when_many_reads_tie_across_haplotypes)
+{
+    // Every tied read contributes a rescaled sum equal to the ploidy, which overflows a plain running product
+    check_batched_evaluation_matches_per_genotype_evaluation(5, 2, 3000);
+    check_batched_evaluation_matches_per_genotype_evaluation(4, 4, 3000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,118 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "containers/mappable_block.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+#include "core/models/haplotype_likelihood_array.hpp"
+
+#include "mock/mock_reference.hpp"
+#include "mock/mock_haplotype.hpp"
+#include "mock/mock_read.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_likelihood_array)
+
+namespace {
+
+const GenomicRegion::ContigName contig {"3"};
+const GenomicRegion haplotype_region {contig, 50, 1950};
+const std::vector<SampleName> samples {"sample1", "sample2"};
+
+MappableBlock<Haplotype> make_haplotypes(const ReferenceGenome& reference)
+{
+    const std::vector<std::vector<Allele>> alleles {
+        {},
+        {mock::make_snv(reference, contig, 500)},
+        {mock::make_snv(reference, contig, 1000)},
+        {mock::make_snv(reference, contig, 500), mock::make_snv(reference, contig, 1500)},
+        {Allele {GenomicRegion {contig, 700, 704}, ""}},
+        {Allele {GenomicRegion {contig, 1200, 1200}, "ACGT"}},
+        {mock::make_snv(reference, contig, 300), Allele {GenomicRegion {contig, 1800, 1803}, ""}},
+        {mock::make_snv(reference, contig, 1000), Allele {GenomicRegion {contig, 1200, 1200}, "ACGT"}}
+    };
+    MappableBlock<Haplotype> result {};
+    for (const auto& haplotype_alleles : alleles) {
+        result.push_back(mock::make_haplotype(reference, haplotype_region, haplotype_alleles));
+    }
+    return result;
+}
+
+// About 350 reads per sample, so the 8 haplotypes give enough likelihoods to populate in parallel,
+// and each sample is split over several tiles
+ReadMap make_reads(const ReferenceGenome& reference)
+{
+    ReadMap result {};
+    const GenomicRegion::Position read_length {100};
+    for (std::size_t sample_idx {0}; sample_idx < samples.size(); ++sample_idx) {
+        auto& reads = result[samples[sample_idx]];
+        for (auto begin = haplotype_region.begin() + 50 + 2 * sample_idx; begin + read_length + 50 <= haplotype_region.end(); begin += 5) {
+            const GenomicRegion region {contig, begin, begin + read_length};
+            reads.emplace(mock::make_read("read" + std::to_string(begin), contig, begin, reference.fetch_sequence(region)));
+        }
+    }
+    return result;
+}
+
+void check_equal(const HaplotypeLikelihoodArray& lhs, const HaplotypeLikelihoodArray& rhs,
+                 const MappableBlock<Haplotype>& haplotypes)
+{
+    for (const auto& sample : samples) {
+        for (const auto& haplotype : haplotypes) {
+            const auto& lhs_likelihoods = lhs(sample, haplotype);
+            const auto& rhs_likelihoods = rhs(sample, haplotype);
+            BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(lhs_likelihoods), std::cend(lhs_likelihoods),
+                                          std::cbegin(rhs_likelihoods), std::cend(rhs_likelihoods));
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(parallel_population_gives_the_same_likelihoods_as_serial_population)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotypes = make_haplotypes(reference);
+    const auto reads = make_reads(reference);
+    HaplotypeLikelihoodArray serial {HaplotypeLikelihoodModel {}, static_cast<unsigned>(haplotypes.size()), samples, ExecutionPolicy::seq};
+    HaplotypeLikelihoodArray parallel {HaplotypeLikelihoodModel {}, static_cast<unsigned>(haplotypes.size()), samples, ExecutionPolicy::par};
+    serial.populate(reads, haplotypes);
+    parallel.populate(reads, haplotypes);
+    check_equal(serial, parallel, haplotypes);
+    // The second population reads alignments memoised by the first
+    serial.populate(reads, haplotypes);
+    parallel.populate(reads, haplotypes);
+    check_equal(serial, parallel, haplotypes);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_population_gives_the_same_likelihoods_without_alignment_memoisation)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotypes = make_haplotypes(reference);
+    const auto reads = make_reads(reference);
+    HaplotypeLikelihoodArray serial {HaplotypeLikelihoodModel {}, static_cast<unsigned>(haplotypes.size()), samples,
+                                     ExecutionPolicy::seq, MemoryFootprint {0}};
+    HaplotypeLikelihoodArray parallel {HaplotypeLikelihoodModel {}, static_cast<unsigned>(haplotypes.size()), samples,
+                                       ExecutionPolicy::par, MemoryFootprint {0}};
+    serial.populate(reads, haplotypes);
+    parallel.populate(reads, haplotypes);
+    check_equal(serial, parallel, haplotypes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,4 +1,136 @@
-// Copyright (c) 2017 Daniel Cooke
+// Copyright (c) 2015-2019 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/models/haplotype_likelihood_model.hpp"
+
+#include "mock/mock_reference.hpp"
+#include "mock/mock_haplotype.hpp"
+#include "mock/mock_read.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_likelihood_model)
+
+namespace {
+
+using ReadRefVector = std::vector<std::reference_wrapper<const AlignedRead>>;
+
+const GenomicRegion haplotype_region {"1", 50, 450};
+
+// Reference reads tiling the middle of the haplotype region, well away from its ends
+std::vector<AlignedRead> make_reads(const ReferenceGenome& reference)
+{
+    std::vector<AlignedRead> result {};
+    const GenomicRegion::Position read_length {40};
+    for (GenomicRegion::Position begin {200}; begin + read_length <= 300; begin += 10) {
+        AlignedRead::Flags flags {};
+        flags.reverse_mapped = (begin / 10) % 2 == 1;
+        result.push_back(mock::make_read("read" + std::to_string(begin), "1", begin,
+                                         reference.fetch_sequence(GenomicRegion {"1", begin, begin + read_length}), flags));
+    }
+    return result;
+}
+
+ReadRefVector make_read_refs(const std::vector<AlignedRead>& reads)
+{
+    return {std::cbegin(reads), std::cend(reads)};
+}
+
+std::vector<HaplotypeLikelihoodModel::LogProbability>
+evaluate(HaplotypeLikelihoodModel& model, const Haplotype& haplotype, const ReadRefVector& reads)
+{
+    const std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions(reads.size());
+    std::vector<HaplotypeLikelihoodModel::LogProbability> result {};
+    model.reset(haplotype);
+    model.evaluate(reads, mapping_positions, result);
+    return result;
+}
+
+std::vector<HaplotypeLikelihoodModel::LogProbability>
+evaluate(HaplotypeLikelihoodModel& model, const Haplotype& haplotype, const ReadRefVector& reads,
+         HaplotypeLikelihoodModel::AlignmentMemo& memo)
+{
+    const std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions(reads.size());
+    std::vector<HaplotypeLikelihoodModel::LogProbability> result {};
+    model.reset(haplotype);
+    model.evaluate(reads, mapping_positions, result, memo, memo);
+    return result;
+}
+
+void check_equal(const std::vector<HaplotypeLikelihoodModel::LogProbability>& lhs,
+                 const std::vector<HaplotypeLikelihoodModel::LogProbability>& rhs)
+{
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs), std::cend(rhs));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(memo_keys_distinguish_reads_that_differ_in_one_base_quality_or_strand)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotype = mock::make_haplotype(reference, haplotype_region);
+    HaplotypeLikelihoodModel model {};
+    const auto reads = make_reads(reference);
+    HaplotypeLikelihoodModel::AlignmentMemo memo {};
+    evaluate(model, haplotype, make_read_refs(reads), memo);
+    const auto num_alignments = memo.size();
+    BOOST_REQUIRE_EQUAL(num_alignments, reads.size()); // one position per read without mapping positions
+    BOOST_CHECK(memo.footprint() > 0);
+    const auto& read = reads.front();
+    auto qualities = read.base_qualities();
+    qualities[20] = 10;
+    auto flags = read.flags();
+    flags.reverse_mapped = !flags.reverse_mapped;
+    auto sequence = read.sequence();
+    sequence[20] = sequence[20] == 'A' ? 'C' : 'A';
+    const std::vector<AlignedRead> changed_reads {
+        {read.name(), read.mapped_region(), read.sequence(), qualities, read.cigar(), read.mapping_quality(), read.flags(), "RG", ""},
+        {read.name(), read.mapped_region(), read.sequence(), read.base_qualities(), read.cigar(), read.mapping_quality(), flags, "RG", ""},
+        {read.name(), read.mapped_region(), sequence, read.base_qualities(), read.cigar(), read.mapping_quality(), read.flags(), "RG", ""}
+    };
+    const auto changed_read_refs = make_read_refs(changed_reads);
+    check_equal(evaluate(model, haplotype, changed_read_refs, memo), evaluate(model, haplotype, changed_read_refs));
+    BOOST_CHECK_EQUAL(memo.size(), num_alignments + changed_reads.size());
+}
+
+BOOST_AUTO_TEST_CASE(merged_memo_alignments_are_reused_and_evicted_when_unused)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotype = mock::make_haplotype(reference, haplotype_region);
+    HaplotypeLikelihoodModel model {};
+    const auto reads = make_reads(reference);
+    const auto read_refs = make_read_refs(reads);
+    HaplotypeLikelihoodModel::AlignmentMemo tile_memo {}, memo {};
+    const auto expected = evaluate(model, haplotype, read_refs, tile_memo);
+    memo.merge(std::move(tile_memo));
+    BOOST_CHECK(tile_memo.empty());
+    BOOST_REQUIRE_EQUAL(memo.size(), reads.size());
+    memo.evict_unused(); // all merged alignments were used
+    BOOST_REQUIRE_EQUAL(memo.size(), reads.size());
+    HaplotypeLikelihoodModel::AlignmentMemo new_alignments {};
+    std::vector<HaplotypeLikelihoodModel::LogProbability> result {};
+    const std::vector<HaplotypeLikelihoodModel::MappingPositionVector> mapping_positions(reads.size());
+    model.reset(haplotype);
+    model.evaluate(read_refs, mapping_positions, result, memo, new_alignments);
+    check_equal(result, expected);
+    BOOST_CHECK_EQUAL(new_alignments.size(), reads.size());
+    memo.evict_unused(); // nothing was merged since the last eviction
+    BOOST_CHECK(memo.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -1,4 +1,178 @@
-// Copyright (c) 2017 Daniel Cooke
+// Copyright (c) 2015-2019 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <cstddef>
+#include <limits>
+
+#include "basics/genomic_region.hpp"
+#include "utils/kmer_mapper.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(kmer_mapper)
+
+namespace {
+
+constexpr unsigned char K {6};
+
+// Hashes each kmer separately with the table based perfect_hash, which gives non-ACGT bases the hash of A
+KmerPerfectHashes compute_each_kmer_hash(const std::string& sequence)
+{
+    KmerPerfectHashes result {};
+    for (std::size_t i {0}; i + K <= sequence.size(); ++i) {
+        result.push_back(perfect_kmer_hash<K>(std::next(std::cbegin(sequence), i)));
+    }
+    return result;
+}
+
+// Every target offset sharing the most kmers with the query at the same relative position, ascending
+std::vector<std::size_t> brute_force_map(const KmerPerfectHashes& query, const KmerPerfectHashes& target,
+                                         const std::size_t max_mapping_positions)
+{
+    std::vector<unsigned> counts(target.size(), 0);
+    for (std::size_t query_index {0}; query_index < query.size(); ++query_index) {
+        for (std::size_t target_index {query_index}; target_index < target.size(); ++target_index) {
+            if (query[query_index] == target[target_index]) ++counts[target_index - query_index];
+        }
+    }
+    std::vector<std::size_t> result {};
+    const auto max_count = counts.empty() ? 0u : *std::max_element(std::cbegin(counts), std::cend(counts));
+    for (std::size_t begin {0}; begin < counts.size() && max_count > 0 && result.size() < max_mapping_positions; ++begin) {
+        if (counts[begin] == max_count) result.push_back(begin);
+    }
+    return result;
+}
+
+std::string fetch(const ReferenceGenome& reference, const GenomicRegion::ContigName& contig,
+                  const GenomicRegion::Position begin, const GenomicRegion::Position end)
+{
+    return reference.fetch_sequence(GenomicRegion {contig, begin, end});
+}
+
+// Reference sequence, a tandem repeat, and random sequence, each with runs of N and other non-ACGT bases
+std::vector<std::string> make_targets(const ReferenceGenome& reference)
+{
+    std::vector<std::string> result {
+        fetch(reference, "1", 0, 300),
+        fetch(reference, "4", 600, 700), // CAG repeat
+        fetch(reference, "3", 1000, 1200),
+        "ACGTA",
+        fetch(reference, "2", 50, 150) // poly-A run
+    };
+    result[2].replace(50, 10, std::string(10, 'N'));
+    result[2][120] = 'n';
+    result[2][150] = 'R';
+    std::mt19937 generator {42};
+    std::uniform_int_distribution<int> base_dist {0, 5};
+    const std::string bases {"ACGTNa"};
+    std::string random_target(400, 'A');
+    std::generate(std::begin(random_target), std::end(random_target), [&] () { return bases[base_dist(generator)]; });
+    result.push_back(std::move(random_target));
+    return result;
+}
+
+// Exact substrings, substrings with substitutions and N bases, and sequences not in the target
+std::vector<std::string> make_queries(const std::string& target)
+{
+    std::vector<std::string> result {"NNNNNNNNNN", "AAAAAAAAAAAAAAAAAAAA", "ACG"};
+    const std::size_t query_length {40};
+    for (std::size_t begin {0}; begin + query_length <= target.size(); begin += 23) {
+        auto query = target.substr(begin, query_length);
+        result.push_back(query);
+        query[query_length / 2] = query[query_length / 2] == 'T' ? 'G' : 'T';
+        result.push_back(query);
+        query.replace(5, 3, "NNN");
+        result.push_back(query);
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(computed_kmer_hashes_match_each_kmer_hash)
+{
+    const auto reference = mock::make_reference();
+    for (const auto& sequence : make_targets(reference)) {
+        const auto expected = compute_each_kmer_hash(sequence);
+        const auto actual = compute_kmer_hashes<K>(sequence);
+        BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+    }
+    BOOST_CHECK(compute_kmer_hashes<K>("ACGTA").empty());
+    BOOST_CHECK_EQUAL(compute_kmer_hashes<K>("ACGTAC").size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(kmer_hash_table_bins_hold_each_kmer_position_in_ascending_order)
+{
+    const auto reference = mock::make_reference();
+    for (const auto& target : make_targets(reference)) {
+        const auto table = make_kmer_hash_table<K>(target);
+        const auto hashes = compute_each_kmer_hash(target);
+        BOOST_REQUIRE_EQUAL(table.size, hashes.size());
+        const auto num_hashes = static_cast<KmerHashType>(num_kmers(K));
+        BOOST_REQUIRE_EQUAL(table.offsets.size(), num_hashes + 1);
+        for (KmerHashType hash {0}; hash < num_hashes; ++hash) {
+            std::vector<KmerHashTable::Index> expected {};
+            for (std::size_t i {0}; i < hashes.size(); ++i) {
+                if (hashes[i] == hash) expected.push_back(i);
+            }
+            const auto first = std::next(std::cbegin(table.positions), table.offsets[hash]);
+            const auto last = std::next(std::cbegin(table.positions), table.offsets[hash + 1]);
+            BOOST_CHECK_EQUAL_COLLECTIONS(first, last, std::cbegin(expected), std::cend(expected));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mapping_positions_match_brute_force_mapping)
+{
+    const auto reference = mock::make_reference();
+    // One table and counts vector repopulated for every target, as the haplotype likelihood array does
+    auto table = init_kmer_hash_table<K>();
+    MappedIndexCounts mapping_counts {};
+    for (const auto& target : make_targets(reference)) {
+        populate_kmer_hash_table<K>(target, table);
+        init_mapping_counts(table, mapping_counts);
+        const auto target_hashes = compute_each_kmer_hash(target);
+        const auto fresh_table = make_kmer_hash_table<K>(target);
+        for (const auto& query : make_queries(target)) {
+            const auto query_hashes = compute_kmer_hashes<K>(query);
+            for (const std::size_t max_mapping_positions : {std::size_t {1}, std::size_t {2}, std::numeric_limits<std::size_t>::max()}) {
+                const auto expected = brute_force_map(query_hashes, target_hashes, max_mapping_positions);
+                std::vector<std::size_t> actual {};
+                map_query_to_target(query_hashes, table, mapping_counts, std::back_inserter(actual), max_mapping_positions);
+                reset_mapping_counts(mapping_counts);
+                BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+            }
+            const auto actual = map_query_to_target(query_hashes, fresh_table);
+            const auto expected = brute_force_map(query_hashes, target_hashes, std::numeric_limits<std::size_t>::max());
+            BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(repeats_map_to_every_tied_position)
+{
+    const std::string target {"CAGCAGCAGCAGCAGCAGCAG"};
+    const auto actual = map_query_to_target<K>("CAGCAGCAG", target);
+    const std::vector<std::size_t> expected {0, 3, 6, 9, 12};
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+    // N hashes as A, so an N kmer maps to a poly-A target
+    const auto n_actual = map_query_to_target<K>("NNNNNN", "CCAAAAAACC");
+    BOOST_REQUIRE_EQUAL(n_actual.size(), 1u);
+    BOOST_CHECK_EQUAL(n_actual.front(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -11,6 +11,9 @@
 #include <iostream>
 
 #include "core/models/pairhmm/simd_pair_hmm_factory.hpp"
+#include "core/models/pairhmm/simd_pair_hmm_kernel.hpp"
+#include "core/models/pairhmm/simd_pair_hmm_wrapper.hpp"
+#include "core/models/pairhmm/pair_hmm.hpp"
 
 namespace octopus { namespace test {
 
@@ -713,6 +716,89 @@ BOOST_AUTO_TEST_CASE(avx2_check_alignments)
 #endif /* __AVX2__ */
 
 
+BOOST_AUTO_TEST_CASE(inter_pair_hmm_scores_match_pair_hmm)
+{
+    SSE2PairHMM<8, short> hmm;
+    SSE2InterPairHMM<8, short> inter_hmm;
+    const auto& test = band8_speed_test;
+    const std::vector<std::int8_t> gap_extend(test.target.size(), test.gap_extend);
+    const std::vector<std::int8_t> snv_priors(test.target.size(), 127);
+    const std::string snv_mask(test.target.size(), 'N');
+    std::vector<AlignmentTask> tasks {};
+    std::vector<int> expected_scores {};
+    // Tasks of different lengths so lanes finish at different steps
+    for (int target_len {static_cast<int>(test.query.size())}; target_len > 100; target_len -= 7) {
+        tasks.push_back({test.target.data(), test.query.data(), test.base_qualities.data(), target_len,
+                         snv_mask.data(), snv_priors.data(), test.gap_open.data(), gap_extend.data()});
+        expected_scores.push_back(hmm.align(test.target.data(), test.query.data(), test.base_qualities.data(),
+                                            target_len + 2 * hmm.band_size() - 1, target_len,
+                                            snv_mask.data(), snv_priors.data(), test.gap_open.data(), gap_extend.data(),
+                                            test.nuc_prior));
+    }
+    std::vector<int> scores(tasks.size());
+    inter_hmm.align(tasks.data(), tasks.size(), test.nuc_prior, scores.data());
+    BOOST_CHECK_EQUAL(scores.front(), band8_speed_expected_alignment.score);
+    BOOST_CHECK_EQUAL_COLLECTIONS(scores.cbegin(), scores.cend(), expected_scores.cbegin(), expected_scores.cend());
+}
+
+BOOST_AUTO_TEST_CASE(dispatched_pair_hmm_kernels_match_baseline_kernels)
+{
+    const auto& test = band16_speed_test;
+    const auto target_len = static_cast<int>(test.query.size());
+    const std::vector<std::int8_t> gap_extend(test.target.size(), test.gap_extend);
+    const std::vector<std::int8_t> snv_priors(test.target.size(), 127);
+    const std::string snv_mask(test.target.size(), 'N');
+    for (const auto precision : {ScorePrecision::int16, ScorePrecision::int32}) {
+        for (int band_size {8}; band_size <= 16; band_size *= 2) {
+            const auto kernel = find_pair_hmm_kernel(band_size, precision);
+            const auto baseline_kernel = hmm::simd::detail::find_sse4_1_pair_hmm_kernel(band_size, precision);
+            BOOST_REQUIRE(kernel);
+            BOOST_REQUIRE(baseline_kernel);
+            BOOST_REQUIRE_EQUAL(kernel->band_size(), baseline_kernel->band_size());
+            const auto truth_len = target_len + 2 * band_size - 1;
+            const auto truth_offset = (static_cast<int>(test.target.size()) - truth_len) / 2;
+            const auto truth = test.target.data() + truth_offset;
+            const auto score = kernel->align(truth, test.query.data(), test.base_qualities.data(), truth_len, target_len,
+                                             snv_mask.data(), snv_priors.data(), test.gap_open.data() + truth_offset,
+                                             gap_extend.data(), test.nuc_prior);
+            const auto baseline_score = baseline_kernel->align(truth, test.query.data(), test.base_qualities.data(), truth_len, target_len,
+                                                               snv_mask.data(), snv_priors.data(), test.gap_open.data() + truth_offset,
+                                                               gap_extend.data(), test.nuc_prior);
+            BOOST_CHECK_EQUAL(score, baseline_score);
+        }
+    }
+    BOOST_CHECK(!find_pair_hmm_kernel(max_pair_hmm_band_size(ScorePrecision::int16) + 1, ScorePrecision::int16));
+}
+
+BOOST_AUTO_TEST_CASE(pair_hmm_wrapper_recomputes_saturated_int16_scores)
+{
+    PairHMMWrapper short_hmm {8, ScorePrecision::int16}, int_hmm {8, ScorePrecision::int32};
+    const auto band_size = short_hmm.band_size();
+    // Every base mismatches, so the score exceeds the 16-bit range
+    const std::string target(2000, 'A');
+    const std::string truth(target.size() + 2 * band_size - 1, 'C');
+    const std::vector<std::int8_t> base_qualities(target.size(), 40);
+    const auto target_len = static_cast<int>(target.size()), truth_len = static_cast<int>(truth.size());
+    const auto int_score = int_hmm.align(truth.data(), target.data(), base_qualities.data(), truth_len, target_len, 45, 3, 4);
+    BOOST_REQUIRE_GE(int_score, find_pair_hmm_kernel(band_size, ScorePrecision::int16)->max_score());
+    BOOST_CHECK_EQUAL(short_hmm.align(truth.data(), target.data(), base_qualities.data(), truth_len, target_len, 45, 3, 4), int_score);
+    const std::vector<std::int8_t> gap_open(truth.size(), 45), gap_extend(truth.size(), 3), snv_priors(truth.size(), 127);
+    const std::string snv_mask(truth.size(), 'N');
+    const std::vector<AlignmentTask> tasks {{truth.data(), target.data(), base_qualities.data(), target_len,
+                                             snv_mask.data(), snv_priors.data(), gap_open.data(), gap_extend.data()}};
+    std::vector<int> scores {};
+    short_hmm.align(tasks, 4, scores);
+    BOOST_REQUIRE_EQUAL(scores.size(), tasks.size());
+    BOOST_CHECK_EQUAL(scores.front(), int_score);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_band_pair_hmm_uses_dispatched_kernel)
+{
+    const hmm::PairHMM<hmm::VariableGapExtendMutationModel, 32, int> hmm {};
+    BOOST_CHECK_EQUAL(hmm.band_size(), 32);
+    BOOST_CHECK_EQUAL(hmm.band_size(), find_pair_hmm_kernel(32, ScorePrecision::int32)->band_size());
+}
+
 // Speed tests
 
 
@@ -72,6 +72,55 @@ BOOST_AUTO_TEST_CASE(assembler_throws_if_reference_sequence_is_inserted_twice)
     BOOST_CHECK_THROW(assembler.insert_reference(reference), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(assembler_finds_snvs_with_short_and_long_kmers)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCATGCCATGAGTCAGTTCAGGACTGACCTAGGCATTACGGATCCAGTACGTAGCAATGCTAGCTTAGCGATCGGATCCTTAGAC"};
+    auto alt = reference;
+    alt[45] = alt[45] == 'A' ? 'C' : 'A';
+    const Assembler::BaseQualityVector base_qualities(alt.size(), 30);
+    
+    for (const unsigned kmer_size : {10u, 40u}) {
+        Assembler assembler {{kmer_size}, reference};
+        for (int i {0}; i < 5; ++i) {
+            assembler.insert_read(alt, base_qualities, Assembler::Direction::forward);
+            assembler.insert_read(alt, base_qualities, Assembler::Direction::reverse);
+        }
+        BOOST_REQUIRE(assembler.is_acyclic());
+        assembler.cleanup();
+        const auto variants = assembler.extract_variants(10, 0);
+        BOOST_REQUIRE_EQUAL(variants.size(), 1);
+        BOOST_CHECK(variants.front().begin_pos <= 45);
+        BOOST_CHECK_EQUAL(variants.front().ref.size(), variants.front().alt.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(assembler_finds_indels_on_separate_haplotypes)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCATGCCATGAGTCAGTTCAGGACTGACCTAGGCATTACGGATCCAGTACGTAGCAATGCTAGCTTAGCGATCGGATCCTTAGAC"};
+    auto insertion = reference, deletion = reference;
+    insertion.insert(30, "TTAGG");
+    deletion.erase(60, 4);
+
+    for (const unsigned kmer_size : {15u, 25u}) {
+        Assembler assembler {{kmer_size}, reference};
+        for (const auto& haplotype : {insertion, deletion}) {
+            const Assembler::BaseQualityVector base_qualities(haplotype.size(), 30);
+            for (int i {0}; i < 5; ++i) {
+                assembler.insert_read(haplotype, base_qualities, Assembler::Direction::forward);
+            }
+        }
+        assembler.prune(2);
+        BOOST_REQUIRE(assembler.is_acyclic());
+        assembler.cleanup();
+        const auto variants = assembler.extract_variants(10, 0);
+        BOOST_REQUIRE_EQUAL(variants.size(), 2);
+        BOOST_CHECK_EQUAL(variants[0].alt.size(), variants[0].ref.size() + 5);
+        BOOST_CHECK_EQUAL(variants[1].ref.size(), variants[1].alt.size() + 4);
+        BOOST_CHECK(variants[0].begin_pos <= 30);
+        BOOST_CHECK(variants[1].begin_pos <= 60);
+    }
+}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
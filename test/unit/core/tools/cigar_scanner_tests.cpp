@@ -1,27 +1,349 @@
-// Copyright (c) 2017 Daniel Cooke
+// Copyright (c) 2015-2019 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+#include <string>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <limits>
+#include <memory>
+
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "core/types/variant.hpp"
 #include "core/tools/vargen/variant_generator.hpp"
+#include "core/tools/vargen/cigar_scanner.hpp"
+
+#include "mock/mock_reference.hpp"
 
 namespace octopus { namespace test {
 
+using coretools::VariantGenerator;
+using coretools::CigarScanner;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(cigar_scanner)
+
 namespace {
-    auto make_cigar_scanner()
-    {
-        using Builder = VariantGenerator::Builder;
-        return Builder().add_generator(Builder::Generator::Alignment);
+
+const GenomicRegion::ContigName contig {"1"};
+
+using SampleReads = std::vector<std::pair<SampleName, std::vector<AlignedRead>>>;
+
+char mismatch(const char base)
+{
+    return base == 'A' ? 'C' : 'A';
+}
+
+// Copies the reference under the CIGAR, taking inserted bases from insertions in turn,
+// then substitutes the bases at the given read offsets
+AlignedRead make_read(const ReferenceGenome& reference, std::string name, const GenomicRegion::Position begin,
+                      const std::string& cigar_string, const std::vector<std::size_t>& mismatch_offsets,
+                      const std::vector<std::string>& insertions, const AlignedRead::MappingQuality mapping_quality,
+                      const bool reverse)
+{
+    const auto cigar = parse_cigar(cigar_string);
+    const GenomicRegion region {contig, begin, begin + reference_size<GenomicRegion::Size>(cigar)};
+    const auto ref_sequence = reference.fetch_sequence(region);
+    AlignedRead::NucleotideSequence sequence {};
+    std::size_t ref_index {0};
+    auto insertion_itr = std::cbegin(insertions);
+    for (const auto& op : cigar) {
+        if (is_insertion(op)) {
+            sequence += *insertion_itr++;
+        } else if (is_deletion(op)) {
+            ref_index += op.size();
+        } else {
+            sequence.append(ref_sequence, ref_index, op.size());
+            ref_index += op.size();
+        }
+    }
+    for (const auto offset : mismatch_offsets) {
+        sequence[offset] = mismatch(sequence[offset]);
     }
+    AlignedRead::BaseQualityVector qualities(sequence.size());
+    for (std::size_t i {0}; i < qualities.size(); ++i) {
+        qualities[i] = 20 + (7 * i + mapping_quality) % 20;
+    }
+    AlignedRead::Flags flags {};
+    flags.reverse_mapped = reverse;
+    return AlignedRead {std::move(name), region, std::move(sequence), std::move(qualities), cigar,
+                        mapping_quality, flags, "RG", ""};
 }
 
-BOOST_AUTO_TEST_SUITE(core)
-BOOST_AUTO_TEST_SUITE(cigar_scanner)
+// Samples are added in reverse name order, and each sample has candidates duplicated across its reads
+// and across samples, both at the edges and within reads
+SampleReads make_sample_reads(const ReferenceGenome& reference)
+{
+    SampleReads result {};
+    result.emplace_back("sample2", std::vector<AlignedRead> {
+        make_read(reference, "r1", 100, "30M", {0, 10}, {}, 60, false),
+        make_read(reference, "r2", 100, "10M2D20M", {0}, {}, 40, true),
+        make_read(reference, "r3", 104, "6M3I21M", {29}, {"ACG"}, 50, false),
+        make_read(reference, "r4", 95, "15M3I15M", {32}, {"TTT"}, 45, true)
+    });
+    result.emplace_back("sample1", std::vector<AlignedRead> {
+        make_read(reference, "r5", 100, "30M", {0, 10}, {}, 30, true),
+        make_read(reference, "r6", 90, "20M2D20M", {}, {}, 20, false),
+        make_read(reference, "r7", 110, "3I27M", {3}, {"ACG"}, 35, false)
+    });
+    return result;
+}
+
+struct ExpectedSampleObservation
+{
+    SampleName sample;
+    unsigned depth, forward_strand_depth;
+    std::vector<std::pair<unsigned, AlignedRead::MappingQuality>> observed_qualities;
+    unsigned forward_strand_support, edge_support;
+};
+
+struct ExpectedObservation
+{
+    Variant variant;
+    unsigned total_depth;
+    std::vector<ExpectedSampleObservation> sample_observations;
+};
+
+struct ReadCandidate
+{
+    Variant variant;
+    const SampleName* sample;
+    const AlignedRead* read;
+    std::size_t offset;
+};
+
+std::vector<ReadCandidate> scan(const ReferenceGenome& reference, const SampleReads& reads)
+{
+    std::vector<ReadCandidate> result {};
+    for (const auto& p : reads) {
+        for (const auto& read : p.second) {
+            auto ref_pos = mapped_begin(read);
+            std::size_t read_pos {0};
+            for (const auto& op : read.cigar()) {
+                if (is_insertion(op)) {
+                    result.push_back({Variant {contig, ref_pos, "", read.sequence().substr(read_pos, op.size())}, &p.first, &read, read_pos});
+                    read_pos += op.size();
+                } else if (is_deletion(op)) {
+                    const GenomicRegion region {contig, ref_pos, ref_pos + op.size()};
+                    result.push_back({Variant {region, reference.fetch_sequence(region), ""}, &p.first, &read, read_pos});
+                    ref_pos += op.size();
+                } else {
+                    for (std::size_t i {0}; i < op.size(); ++i, ++ref_pos, ++read_pos) {
+                        const GenomicRegion region {contig, ref_pos, ref_pos + 1};
+                        const auto ref_base = reference.fetch_sequence(region);
+                        const AlignedRead::NucleotideSequence read_base {read.sequence()[read_pos]};
+                        if (ref_base != read_base) {
+                            result.push_back({Variant {region, ref_base, read_base}, &p.first, &read, read_pos});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// The minimum number of reads covering the variant, or the bases either side of an insertion
+template <typename Predicate>
+unsigned min_depth(const Variant& variant, const SampleReads& reads, Predicate include)
+{
+    auto region = mapped_region(variant);
+    if (is_insertion(variant)) region = expand(region, 1, 1);
+    unsigned result {std::numeric_limits<unsigned>::max()};
+    for (auto pos = region.begin(); pos < region.end(); ++pos) {
+        const GenomicRegion base {contig, pos, pos + 1};
+        unsigned depth {0};
+        for (const auto& p : reads) {
+            for (const auto& read : p.second) {
+                if (include(p.first, read) && contains(read, base)) ++depth;
+            }
+        }
+        result = std::min(result, depth);
+    }
+    return result;
+}
+
+// Mirrors the previous implementation, which kept one candidate per read observation and
+// grouped observations of each unique variant by sample name.
+std::vector<ExpectedObservation> make_expected_observations(const ReferenceGenome& reference, const SampleReads& reads)
+{
+    auto candidates = scan(reference, reads);
+    std::stable_sort(std::begin(candidates), std::end(candidates),
+                     [] (const ReadCandidate& lhs, const ReadCandidate& rhs) { return lhs.variant < rhs.variant; });
+    std::vector<ExpectedObservation> result {};
+    for (auto itr = std::cbegin(candidates); itr != std::cend(candidates);) {
+        const auto& variant = itr->variant;
+        const auto next_itr = std::find_if_not(itr, std::cend(candidates), [&] (const ReadCandidate& c) { return c.variant == variant; });
+        ExpectedObservation observation {variant, min_depth(variant, reads, [] (const auto&, const auto&) { return true; }), {}};
+        std::map<SampleName, ExpectedSampleObservation> sample_observations {};
+        std::for_each(itr, next_itr, [&] (const ReadCandidate& c) {
+            auto& sample_observation = sample_observations[*c.sample];
+            sample_observation.sample = *c.sample;
+            const auto first_quality_itr = std::next(std::cbegin(c.read->base_qualities()), c.offset);
+            const auto base_quality_sum = std::accumulate(first_quality_itr, std::next(first_quality_itr, alt_sequence_size(variant)), 0u);
+            sample_observation.observed_qualities.emplace_back(base_quality_sum, c.read->mapping_quality());
+            if (is_forward_strand(*c.read)) ++sample_observation.forward_strand_support;
+            if (begins_equal(variant, *c.read) || ends_equal(variant, *c.read)) ++sample_observation.edge_support;
+        });
+        for (auto& p : sample_observations) {
+            const auto& sample = p.first;
+            auto& sample_observation = p.second;
+            const auto num_observations = static_cast<unsigned>(sample_observation.observed_qualities.size());
+            const auto sample_depth = min_depth(variant, reads, [&] (const SampleName& s, const AlignedRead&) { return s == sample; });
+            sample_observation.depth = std::max(sample_depth, num_observations);
+            sample_observation.forward_strand_depth = min_depth(variant, reads, [&] (const SampleName& s, const AlignedRead& read) {
+                return s == sample && is_forward_strand(read); });
+            std::sort(std::begin(sample_observation.observed_qualities), std::end(sample_observation.observed_qualities));
+            observation.sample_observations.push_back(std::move(sample_observation));
+        }
+        result.push_back(std::move(observation));
+        itr = next_itr;
+    }
+    return result;
+}
+
+std::vector<CigarScanner::VariantObservation> scan_observations(const ReferenceGenome& reference, const SampleReads& reads,
+                                                                const GenomicRegion& region, std::vector<Variant>& candidates)
+{
+    std::vector<CigarScanner::VariantObservation> result {};
+    CigarScanner::Options options {};
+    options.include = [&result] (CigarScanner::VariantObservation observation) {
+        result.push_back(std::move(observation));
+        return true;
+    };
+    options.misalignment_parameters = boost::none;
+    VariantGenerator generator {};
+    generator.add(std::make_unique<CigarScanner>(reference, options));
+    for (const auto& p : reads) {
+        generator.add_reads(p.first, std::cbegin(p.second), std::cend(p.second));
+    }
+    candidates = generator.generate(region);
+    return result;
+}
+
+void check_equal(const CigarScanner::VariantObservation& actual, const ExpectedObservation& expected)
+{
+    BOOST_CHECK_EQUAL(actual.variant, expected.variant);
+    BOOST_CHECK_EQUAL(actual.total_depth, expected.total_depth);
+    BOOST_REQUIRE_EQUAL(actual.sample_observations.size(), expected.sample_observations.size());
+    for (std::size_t s {0}; s < expected.sample_observations.size(); ++s) {
+        const auto& actual_sample = actual.sample_observations[s];
+        const auto& expected_sample = expected.sample_observations[s];
+        BOOST_CHECK_EQUAL(actual_sample.sample.get(), expected_sample.sample);
+        BOOST_CHECK_EQUAL(actual_sample.depth, expected_sample.depth);
+        BOOST_CHECK_EQUAL(actual_sample.forward_strand_depth, expected_sample.forward_strand_depth);
+        BOOST_CHECK_EQUAL(actual_sample.forward_strand_support, expected_sample.forward_strand_support);
+        BOOST_CHECK_EQUAL(actual_sample.edge_support, expected_sample.edge_support);
+        BOOST_REQUIRE_EQUAL(actual_sample.observed_base_qualities.size(), actual_sample.observed_mapping_qualities.size());
+        // The previous implementation did not define the order of observations within a sample
+        std::vector<std::pair<unsigned, AlignedRead::MappingQuality>> actual_qualities {};
+        for (std::size_t i {0}; i < actual_sample.observed_base_qualities.size(); ++i) {
+            actual_qualities.emplace_back(actual_sample.observed_base_qualities[i], actual_sample.observed_mapping_qualities[i]);
+        }
+        std::sort(std::begin(actual_qualities), std::end(actual_qualities));
+        BOOST_CHECK(actual_qualities == expected_sample.observed_qualities);
+    }
+}
 
+const CigarScanner::VariantObservation* find_observation(const std::vector<CigarScanner::VariantObservation>& observations, const Variant& variant)
+{
+    const auto itr = std::find_if(std::cbegin(observations), std::cend(observations),
+                                  [&] (const auto& observation) { return observation.variant == variant; });
+    return itr != std::cend(observations) ? &(*itr) : nullptr;
+}
 
+} // namespace
+
+BOOST_AUTO_TEST_CASE(observations_match_per_read_candidate_grouping)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_sample_reads(reference);
+    const GenomicRegion region {contig, 0, 500};
+    std::vector<Variant> candidates {};
+    const auto actual = scan_observations(reference, reads, region, candidates);
+    const auto expected = make_expected_observations(reference, reads);
+    BOOST_REQUIRE(!expected.empty());
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        check_equal(actual[i], expected[i]);
+    }
+    BOOST_REQUIRE_EQUAL(candidates.size(), expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        BOOST_CHECK_EQUAL(candidates[i], expected[i].variant);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_candidates_are_merged_across_reads_and_samples)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_sample_reads(reference);
+    std::vector<Variant> candidates {};
+    const auto observations = scan_observations(reference, reads, GenomicRegion {contig, 0, 500}, candidates);
+    BOOST_CHECK(std::adjacent_find(std::cbegin(candidates), std::cend(candidates)) == std::cend(candidates));
+    // Observed by the first base of r1, r2 and r5
+    const GenomicRegion snv_region {contig, 100, 101};
+    const auto snv_ref = reference.fetch_sequence(snv_region);
+    const auto snv = find_observation(observations, Variant {snv_region, snv_ref, AlignedRead::NucleotideSequence {mismatch(snv_ref.front())}});
+    BOOST_REQUIRE(snv != nullptr);
+    BOOST_REQUIRE_EQUAL(snv->sample_observations.size(), 2u);
+    BOOST_CHECK_EQUAL(snv->sample_observations[0].sample.get(), "sample1");
+    BOOST_CHECK_EQUAL(snv->sample_observations[0].observed_base_qualities.size(), 1u);
+    BOOST_CHECK_EQUAL(snv->sample_observations[0].edge_support, 1u);
+    BOOST_CHECK_EQUAL(snv->sample_observations[1].sample.get(), "sample2");
+    BOOST_CHECK_EQUAL(snv->sample_observations[1].observed_base_qualities.size(), 2u);
+    BOOST_CHECK_EQUAL(snv->sample_observations[1].forward_strand_support, 1u);
+    BOOST_CHECK_EQUAL(snv->sample_observations[1].edge_support, 2u);
+    // Observed by r3 within the read and r7 at its first base
+    const auto insertion = find_observation(observations, Variant {contig, 110, "", "ACG"});
+    BOOST_REQUIRE(insertion != nullptr);
+    BOOST_REQUIRE_EQUAL(insertion->sample_observations.size(), 2u);
+    BOOST_CHECK_EQUAL(insertion->sample_observations[0].sample.get(), "sample1");
+    BOOST_CHECK_EQUAL(insertion->sample_observations[0].edge_support, 1u);
+    BOOST_CHECK_EQUAL(insertion->sample_observations[1].sample.get(), "sample2");
+    BOOST_CHECK_EQUAL(insertion->sample_observations[1].edge_support, 0u);
+    // A different insertion at the same position is a distinct candidate
+    const auto other_insertion = find_observation(observations, Variant {contig, 110, "", "TTT"});
+    BOOST_REQUIRE(other_insertion != nullptr);
+    BOOST_REQUIRE_EQUAL(other_insertion->sample_observations.size(), 1u);
+    BOOST_CHECK_EQUAL(other_insertion->sample_observations[0].sample.get(), "sample2");
+    // Observed by r2 and r6, neither at an edge
+    const GenomicRegion deletion_region {contig, 110, 112};
+    const auto deletion = find_observation(observations, Variant {deletion_region, reference.fetch_sequence(deletion_region), ""});
+    BOOST_REQUIRE(deletion != nullptr);
+    BOOST_REQUIRE_EQUAL(deletion->sample_observations.size(), 2u);
+    for (const auto& sample_observation : deletion->sample_observations) {
+        BOOST_CHECK_EQUAL(sample_observation.observed_base_qualities.size(), 1u);
+        BOOST_CHECK_EQUAL(sample_observation.observed_base_qualities.front(), 0u);
+        BOOST_CHECK_EQUAL(sample_observation.edge_support, 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(candidates_at_the_last_base_of_a_read_are_edge_observations)
+{
+    const auto reference = mock::make_reference();
+    const auto reads = make_sample_reads(reference);
+    std::vector<Variant> candidates {};
+    const auto observations = scan_observations(reference, reads, GenomicRegion {contig, 0, 500}, candidates);
+    // r3 ends at 131 and r4 ends at 125
+    for (const GenomicRegion::Position pos : {130, 124}) {
+        const GenomicRegion snv_region {contig, pos, pos + 1};
+        const auto snv_ref = reference.fetch_sequence(snv_region);
+        const auto snv = find_observation(observations, Variant {snv_region, snv_ref, AlignedRead::NucleotideSequence {mismatch(snv_ref.front())}});
+        BOOST_REQUIRE(snv != nullptr);
+        BOOST_REQUIRE_EQUAL(snv->sample_observations.size(), 1u);
+        BOOST_CHECK_EQUAL(snv->sample_observations.front().edge_support, 1u);
+    }
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
-    
+
 } // namespace test
 } // namespace octopus
@@ -0,0 +1,175 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dag_shortest_paths.hpp>
+#include <boost/graph/reverse_graph.hpp>
+
+#include "core/tools/vargen/utils/flat_digraph.hpp"
+
+namespace octopus { namespace test {
+
+using coretools::FlatDigraph;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(flat_digraph)
+
+namespace {
+
+struct Node { std::size_t index; };
+struct Link { int weight; };
+
+using Graph  = FlatDigraph<Node, Link>;
+using Vertex = Graph::vertex_descriptor;
+using Edge   = Graph::edge_descriptor;
+
+template <typename Range>
+auto to_vector(const Range& range)
+{
+    using Value = typename std::iterator_traits<decltype(range.first)>::value_type;
+    return std::vector<Value>(range.first, range.second);
+}
+
+auto targets(const Graph& g, const Vertex v)
+{
+    return to_vector(boost::adjacent_vertices(v, g));
+}
+
+auto weights(const Graph& g)
+{
+    std::vector<int> result {};
+    for (const auto e : to_vector(boost::edges(g))) result.push_back(g[e].weight);
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(flat_digraph_keeps_vertices_and_edges_in_insertion_order)
+{
+    Graph g {};
+    const auto a = boost::add_vertex({0}, g), b = boost::add_vertex({1}, g), c = boost::add_vertex({2}, g);
+    boost::add_edge(a, c, {1}, g);
+    boost::add_edge(a, b, {2}, g);
+    boost::add_edge(b, c, {3}, g);
+    boost::add_edge(c, c, {4}, g);
+    BOOST_CHECK_EQUAL(boost::num_vertices(g), 3);
+    BOOST_CHECK_EQUAL(boost::num_edges(g), 4);
+    BOOST_CHECK((to_vector(boost::vertices(g)) == std::vector<Vertex> {a, b, c}));
+    BOOST_CHECK((targets(g, a) == std::vector<Vertex> {c, b}));
+    BOOST_CHECK((to_vector(boost::inv_adjacent_vertices(c, g)) == std::vector<Vertex> {a, b, c}));
+    BOOST_CHECK((weights(g) == std::vector<int> {1, 2, 3, 4}));
+    BOOST_CHECK_EQUAL(boost::out_degree(c, g), 1);
+    BOOST_CHECK_EQUAL(boost::in_degree(c, g), 3);
+    BOOST_CHECK_EQUAL(boost::degree(c, g), 4);
+    const auto p = boost::edge(b, c, g);
+    BOOST_REQUIRE(p.second);
+    BOOST_CHECK_EQUAL(g[p.first].weight, 3);
+    BOOST_CHECK_EQUAL(boost::source(p.first, g), b);
+    BOOST_CHECK_EQUAL(boost::target(p.first, g), c);
+    BOOST_CHECK(!boost::edge(c, a, g).second);
+}
+
+BOOST_AUTO_TEST_CASE(flat_digraph_descriptors_stay_valid_after_removals)
+{
+    Graph g {};
+    const auto a = boost::add_vertex({0}, g), b = boost::add_vertex({1}, g), c = boost::add_vertex({2}, g);
+    const auto ab = boost::add_edge(a, b, {1}, g).first;
+    boost::add_edge(b, c, {2}, g);
+    const auto ac = boost::add_edge(a, c, {3}, g).first;
+    boost::add_edge(c, c, {4}, g);
+    boost::clear_vertex(b, g);
+    boost::remove_vertex(b, g);
+    BOOST_CHECK_EQUAL(boost::num_vertices(g), 2);
+    BOOST_CHECK_EQUAL(boost::num_edges(g), 2);
+    BOOST_CHECK((to_vector(boost::vertices(g)) == std::vector<Vertex> {a, c}));
+    BOOST_CHECK((targets(g, a) == std::vector<Vertex> {c}));
+    BOOST_CHECK_EQUAL(g[ac].weight, 3);
+    BOOST_CHECK((weights(g) == std::vector<int> {3, 4}));
+    const auto d = boost::add_vertex({3}, g);
+    boost::add_edge(d, a, {5}, g);
+    boost::add_edge(a, d, {6}, g);
+    BOOST_CHECK((to_vector(boost::vertices(g)) == std::vector<Vertex> {a, c, d}));
+    BOOST_CHECK((targets(g, a) == std::vector<Vertex> {c, d}));
+    boost::remove_edge(c, c, g);
+    BOOST_CHECK_EQUAL(boost::in_degree(c, g), 1);
+    BOOST_CHECK((weights(g) == std::vector<int> {3, 5, 6}));
+    BOOST_CHECK(ab != ac);
+}
+
+BOOST_AUTO_TEST_CASE(flat_digraph_removes_edges_by_predicate)
+{
+    Graph g {};
+    const auto a = boost::add_vertex({0}, g), b = boost::add_vertex({1}, g), c = boost::add_vertex({2}, g);
+    boost::add_edge(a, b, {1}, g);
+    boost::add_edge(a, c, {2}, g);
+    boost::add_edge(b, c, {3}, g);
+    boost::add_edge(c, a, {4}, g);
+    boost::add_edge(a, a, {5}, g);
+    const auto is_odd = [&g] (Edge e) { return g[e].weight % 2 == 1; };
+    boost::remove_out_edge_if(a, is_odd, g);
+    BOOST_CHECK((weights(g) == std::vector<int> {2, 3, 4}));
+    boost::remove_in_edge_if(c, is_odd, g);
+    BOOST_CHECK((weights(g) == std::vector<int> {2, 4}));
+    boost::remove_edge_if([&g] (Edge e) { return g[e].weight > 3; }, g);
+    BOOST_CHECK((weights(g) == std::vector<int> {2}));
+    boost::clear_out_edges(a, g);
+    BOOST_CHECK_EQUAL(boost::num_edges(g), 0);
+    BOOST_CHECK_EQUAL(boost::in_degree(c, g), 0);
+}
+
+BOOST_AUTO_TEST_CASE(boost_graph_algorithms_run_on_flat_digraphs)
+{
+    // a -> b -> d, a -> c -> d, d -> e, with a removed vertex in the middle of the array. The path
+    // through c is shorter.
+    Graph g {};
+    const auto a = boost::add_vertex({0}, g), b = boost::add_vertex({1}, g), removed = boost::add_vertex({2}, g);
+    const auto c = boost::add_vertex({2}, g), d = boost::add_vertex({3}, g), e = boost::add_vertex({4}, g);
+    boost::remove_vertex(removed, g);
+    boost::add_edge(a, b, {2}, g);
+    boost::add_edge(a, c, {1}, g);
+    boost::add_edge(b, d, {1}, g);
+    boost::add_edge(c, d, {1}, g);
+    boost::add_edge(d, e, {1}, g);
+    std::unordered_map<Vertex, Vertex> predecessors {};
+    boost::dag_shortest_paths(g, a, boost::weight_map(boost::get(&Link::weight, g))
+                              .predecessor_map(boost::make_assoc_property_map(predecessors))
+                              .vertex_index_map(boost::get(&Node::index, g)));
+    BOOST_CHECK_EQUAL(predecessors.at(e), d);
+    BOOST_CHECK_EQUAL(predecessors.at(d), c);
+    BOOST_CHECK_EQUAL(predecessors.at(c), a);
+    std::vector<Vertex> discovered {};
+    auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
+                                                             std::back_inserter(discovered),
+                                                             boost::on_discover_vertex()));
+    const auto transpose = boost::make_reverse_graph(g);
+    boost::breadth_first_search(transpose, d, boost::visitor(vis).vertex_index_map(boost::get(&Node::index, transpose)));
+    BOOST_CHECK((discovered == std::vector<Vertex> {d, b, c, a}));
+    auto weight_map = boost::get(&Link::weight, g);
+    boost::put(weight_map, boost::edge(d, e, g).first, 7);
+    BOOST_CHECK_EQUAL(g[boost::edge(d, e, g).first].weight, 7);
+}
+
+BOOST_AUTO_TEST_CASE(flat_digraph_clear_removes_everything)
+{
+    Graph g {};
+    const auto a = boost::add_vertex({0}, g), b = boost::add_vertex({1}, g);
+    boost::add_edge(a, b, {1}, g);
+    g.clear();
+    BOOST_CHECK_EQUAL(boost::num_vertices(g), 0);
+    BOOST_CHECK_EQUAL(boost::num_edges(g), 0);
+    BOOST_CHECK(boost::vertices(g).first == boost::vertices(g).second);
+    BOOST_CHECK(boost::edges(g).first == boost::edges(g).second);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
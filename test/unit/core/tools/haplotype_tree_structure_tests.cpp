@@ -0,0 +1,201 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "containers/mappable_block.hpp"
+
+#include "mock/mock_reference.hpp"
+#include "mock/mock_haplotype.hpp"
+
+namespace octopus { namespace test {
+
+using coretools::HaplotypeTree;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_tree_structure)
+
+namespace {
+
+const GenomicRegion::ContigName contig {"1"};
+
+Allele make_ref_allele(const ReferenceGenome& reference, const GenomicRegion::Position begin, const GenomicRegion::Position end)
+{
+    return mock::make_reference_allele(reference, GenomicRegion {contig, begin, end});
+}
+
+Allele make_snv(const ReferenceGenome& reference, const GenomicRegion::Position position)
+{
+    return mock::make_snv(reference, contig, position);
+}
+
+// Every combination of the given alleles, one from each group
+std::vector<Haplotype> make_all_haplotypes(const ReferenceGenome& reference, const GenomicRegion& region,
+                                           const std::vector<std::vector<Allele>>& allele_groups)
+{
+    std::vector<std::vector<Allele>> combinations {{}};
+    for (const auto& group : allele_groups) {
+        std::vector<std::vector<Allele>> extended {};
+        for (const auto& combination : combinations) {
+            for (const auto& allele : group) {
+                extended.push_back(combination);
+                extended.back().push_back(allele);
+            }
+        }
+        combinations = std::move(extended);
+    }
+    std::vector<Haplotype> result {};
+    result.reserve(combinations.size());
+    for (const auto& combination : combinations) {
+        result.push_back(mock::make_haplotype(reference, region, combination));
+    }
+    return result;
+}
+
+void extend(HaplotypeTree& tree, const std::vector<std::vector<Allele>>& allele_groups)
+{
+    for (const auto& group : allele_groups) {
+        for (const auto& allele : group) tree.extend(allele);
+    }
+}
+
+void check_haplotypes(const MappableBlock<Haplotype>& actual, const std::vector<Haplotype>& expected)
+{
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    BOOST_CHECK(std::is_permutation(std::cbegin(actual), std::cend(actual), std::cbegin(expected)));
+}
+
+// A SNV, a deletion, an insertion, and another SNV, each extended as reference then alternative
+std::vector<std::vector<Allele>> make_indel_allele_groups(const ReferenceGenome& reference)
+{
+    return {
+        {make_ref_allele(reference, 100, 101), make_snv(reference, 100)},
+        {make_ref_allele(reference, 120, 124), Allele {GenomicRegion {contig, 120, 124}, ""}},
+        {make_ref_allele(reference, 140, 140), Allele {GenomicRegion {contig, 140, 140}, "TT"}},
+        {make_ref_allele(reference, 160, 161), make_snv(reference, 160)}
+    };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(extending_with_snvs_and_indels_produces_every_combination)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    BOOST_CHECK(tree.is_empty());
+    const auto groups = make_indel_allele_groups(reference);
+    extend(tree, groups);
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 16u);
+    const GenomicRegion tree_region {contig, 100, 161};
+    BOOST_CHECK_EQUAL(tree.encompassing_region(), tree_region);
+    const auto expected = make_all_haplotypes(reference, tree_region, groups);
+    check_haplotypes(tree.extract_haplotypes(), expected);
+    for (const auto& haplotype : expected) {
+        BOOST_CHECK(tree.contains(haplotype));
+        BOOST_CHECK(tree.is_unique(haplotype));
+    }
+    const GenomicRegion expanded_region {contig, 90, 170};
+    check_haplotypes(tree.extract_haplotypes(expanded_region), make_all_haplotypes(reference, expanded_region, groups));
+}
+
+BOOST_AUTO_TEST_CASE(extending_with_overlapping_alleles_branches_before_the_overlap)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    const auto ref_snv = make_ref_allele(reference, 100, 101), alt_snv = make_snv(reference, 100);
+    const Allele deletion {GenomicRegion {contig, 99, 103}, ""};
+    const auto ref_downstream = make_ref_allele(reference, 110, 111), alt_downstream = make_snv(reference, 110);
+    // The deletion overlaps both SNV alleles but is only added once
+    extend(tree, {{ref_snv, alt_snv, deletion}, {ref_downstream, alt_downstream}});
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 6u);
+    const GenomicRegion tree_region {contig, 99, 111};
+    BOOST_CHECK_EQUAL(tree.encompassing_region(), tree_region);
+    const std::vector<std::vector<Allele>> groups {{ref_snv, alt_snv, deletion}, {ref_downstream, alt_downstream}};
+    check_haplotypes(tree.extract_haplotypes(), make_all_haplotypes(reference, tree_region, groups));
+    // Haplotypes in a sub-region are extracted for every leaf, so repeat
+    const GenomicRegion downstream_region {contig, 105, 111};
+    const auto downstream_haplotypes = tree.extract_haplotypes(downstream_region);
+    BOOST_REQUIRE_EQUAL(downstream_haplotypes.size(), 6u);
+    const auto ref_downstream_haplotype = mock::make_haplotype(reference, downstream_region, {ref_downstream});
+    const auto alt_downstream_haplotype = mock::make_haplotype(reference, downstream_region, {alt_downstream});
+    BOOST_CHECK_EQUAL(std::count(std::cbegin(downstream_haplotypes), std::cend(downstream_haplotypes), ref_downstream_haplotype), 3);
+    BOOST_CHECK_EQUAL(std::count(std::cbegin(downstream_haplotypes), std::cend(downstream_haplotypes), alt_downstream_haplotype), 3);
+    BOOST_CHECK(!tree.is_unique(alt_downstream_haplotype));
+}
+
+BOOST_AUTO_TEST_CASE(pruned_haplotypes_are_removed_and_the_remaining_branches_can_be_extended)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    auto groups = make_indel_allele_groups(reference);
+    extend(tree, groups);
+    const GenomicRegion tree_region {contig, 100, 161};
+    auto expected = make_all_haplotypes(reference, tree_region, groups);
+    // Remove two haplotypes sharing a branch, and one from the other side of the tree
+    const std::vector<Haplotype> pruned {expected[0], expected[1], expected[15]};
+    for (const auto& haplotype : pruned) {
+        tree.prune_all(haplotype);
+        BOOST_CHECK(!tree.contains(haplotype));
+    }
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 13u);
+    const auto is_pruned = [&] (const Haplotype& haplotype) {
+        return std::find(std::cbegin(pruned), std::cend(pruned), haplotype) != std::cend(pruned);
+    };
+    expected.erase(std::remove_if(std::begin(expected), std::end(expected), is_pruned), std::end(expected));
+    check_haplotypes(tree.extract_haplotypes(tree_region), expected);
+    // Removed nodes are reused by the extension
+    const std::vector<Allele> new_group {make_ref_allele(reference, 180, 181), make_snv(reference, 180)};
+    extend(tree, {new_group});
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 26u);
+    const GenomicRegion extended_region {contig, 100, 181};
+    groups.push_back(new_group);
+    auto extended_expected = make_all_haplotypes(reference, extended_region, groups);
+    const auto extends_pruned = [&] (const Haplotype& haplotype) { return is_pruned(copy<Haplotype>(haplotype, tree_region)); };
+    extended_expected.erase(std::remove_if(std::begin(extended_expected), std::end(extended_expected), extends_pruned),
+                            std::end(extended_expected));
+    check_haplotypes(tree.extract_haplotypes(extended_region), extended_expected);
+}
+
+BOOST_AUTO_TEST_CASE(clearing_regions_leaves_the_haplotypes_of_the_remaining_alleles)
+{
+    const auto reference = mock::make_reference();
+    HaplotypeTree tree {contig, reference};
+    const auto groups = make_indel_allele_groups(reference);
+    // Leading alleles
+    extend(tree, groups);
+    tree.clear(GenomicRegion {contig, 90, 130});
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 4u);
+    const GenomicRegion trailing_region {contig, 140, 161};
+    check_haplotypes(tree.extract_haplotypes(), make_all_haplotypes(reference, trailing_region, {groups[2], groups[3]}));
+    // Trailing alleles
+    tree.clear();
+    BOOST_CHECK(tree.is_empty());
+    extend(tree, groups);
+    tree.clear(GenomicRegion {contig, 135, 170});
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 4u);
+    const GenomicRegion leading_region {contig, 100, 124};
+    check_haplotypes(tree.extract_haplotypes(), make_all_haplotypes(reference, leading_region, {groups[0], groups[1]}));
+    // Everything
+    tree.clear(GenomicRegion {contig, 50, 200});
+    BOOST_CHECK(tree.is_empty());
+    BOOST_CHECK_EQUAL(tree.num_haplotypes(), 0u);
+    // The cleared tree can be reused
+    extend(tree, groups);
+    check_haplotypes(tree.extract_haplotypes(), make_all_haplotypes(reference, GenomicRegion {contig, 100, 161}, groups));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <deque>
+#include <string>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
+
+#include "basics/aligned_read.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "core/tools/read_assignment_spill.hpp"
+
+#include "mock/mock_read.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(read_assignment_spill)
+
+namespace {
+
+const std::vector<SampleName> samples {"sample1", "sample2"};
+
+VcfRecord make_call(const GenomicRegion::Position pos, std::string ref, std::string alt)
+{
+    VcfRecord::Builder result {};
+    result.set_chrom("1").set_pos(pos).set_ref(std::move(ref)).set_alt(std::move(alt));
+    return result.build_once();
+}
+
+struct TempFile
+{
+    fs::path path {fs::temp_directory_path() / fs::unique_path("octopus-%%%%-%%%%.bin")};
+    ~TempFile() { fs::remove(path); }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fetch_returns_the_written_assignments_of_each_call)
+{
+    const TempFile file {};
+    ReadAssignmentSpill spill {file.path, samples};
+    const std::deque<VcfRecord> calls {make_call(100, "A", "C"), make_call(120, "G", "T"), make_call(150, "T", "A")};
+    const auto read1 = make_read_key(mock::make_read("read1", "1", 90, std::string(20, 'A')));
+    const auto read2 = make_read_key(mock::make_read("read2", "1", 95, std::string(20, 'A')));
+    ReadAssignmentSpill::RecordAssignments first {}, second {};
+    first[samples[0]] = {{read1, 1}};
+    first[samples[1]] = {{read2, 0}};
+    second[samples[1]] = {{read1, 1}, {read2, 1}};
+    spill.write(calls, {first, second, boost::none});
+    const auto fetched = spill.fetch({calls[1], calls[2], calls[0]});
+    BOOST_REQUIRE_EQUAL(fetched.size(), 3);
+    BOOST_REQUIRE(fetched[0]);
+    BOOST_CHECK(fetched[0]->at(samples[0]).empty());
+    BOOST_REQUIRE_EQUAL(fetched[0]->at(samples[1]).size(), 2);
+    BOOST_CHECK_EQUAL(fetched[0]->at(samples[1])[1].read, read2);
+    BOOST_CHECK(!fetched[1]);
+    BOOST_REQUIRE(fetched[2]);
+    BOOST_REQUIRE_EQUAL(fetched[2]->at(samples[0]).size(), 1);
+    BOOST_CHECK_EQUAL(fetched[2]->at(samples[0]).front().read, read1);
+    BOOST_CHECK_EQUAL(fetched[2]->at(samples[0]).front().allele, 1);
+    BOOST_CHECK_EQUAL(fetched[2]->at(samples[1]).front().allele, 0);
+}
+
+BOOST_AUTO_TEST_CASE(later_writes_supersede_earlier_writes_of_the_same_call)
+{
+    const TempFile file {};
+    ReadAssignmentSpill spill {file.path, samples};
+    const std::deque<VcfRecord> calls {make_call(100, "A", "C")};
+    const auto read = make_read_key(mock::make_read("read", "1", 90, std::string(20, 'A')));
+    ReadAssignmentSpill::RecordAssignments assignments {};
+    assignments[samples[0]] = {{read, 0}};
+    spill.write(calls, {assignments});
+    assignments[samples[0]] = {{read, 1}};
+    spill.write(calls, {assignments});
+    const auto fetched = spill.fetch({calls.front()});
+    BOOST_REQUIRE(fetched.front());
+    BOOST_CHECK_EQUAL(fetched.front()->at(samples[0]).front().allele, 1);
+    BOOST_CHECK(!spill.fetch({make_call(100, "A", "G")}).front());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
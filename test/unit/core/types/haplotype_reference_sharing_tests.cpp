@@ -0,0 +1,123 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "basics/genomic_region.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype)
+
+namespace {
+
+const std::vector<Allele> alleles {
+    Allele {GenomicRegion {"4", 310, 311}, "A"},
+    Allele {GenomicRegion {"4", 315, 315}, "TT"},
+    Allele {GenomicRegion {"4", 320, 323}, ""}
+};
+
+// Builds the haplotype with every reference base fetched from the reference genome
+Haplotype make_expected(const GenomicRegion& region, const std::vector<Allele>& haplotype_alleles,
+                        const ReferenceGenome& reference)
+{
+    Haplotype::Builder builder {region, reference};
+    for (const auto& allele : haplotype_alleles) {
+        if (contains(region, allele)) builder.push_back(allele);
+    }
+    return builder.build();
+}
+
+Haplotype make_from_source(const GenomicRegion& region, const std::vector<Allele>& haplotype_alleles,
+                             const Haplotype& reference_source)
+{
+    Haplotype::Builder builder {region, reference_source};
+    for (const auto& allele : haplotype_alleles) builder.push_back(allele);
+    return builder.build();
+}
+
+void check_equal(const Haplotype& actual, const Haplotype& expected)
+{
+    BOOST_CHECK(is_same_region(actual, expected));
+    BOOST_CHECK_EQUAL(actual.sequence(), expected.sequence());
+    BOOST_CHECK(actual == expected);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(expanded_haplotypes_take_reference_flanks_from_the_source_haplotype)
+{
+    const auto reference = mock::make_reference();
+    const GenomicRegion region {"4", 300, 340};
+    const auto haplotype = make_expected(region, alleles, reference);
+    for (const GenomicRegion::Size n : {1, 15, 100}) {
+        check_equal(expand(haplotype, n), make_expected(expand(region, n), alleles, reference));
+    }
+    const Haplotype reference_haplotype {region, reference};
+    check_equal(expand(reference_haplotype, 15), make_expected(expand(region, 15), {}, reference));
+}
+
+BOOST_AUTO_TEST_CASE(remapped_haplotypes_fetch_only_bases_outside_the_source_haplotype)
+{
+    const auto reference = mock::make_reference();
+    const GenomicRegion region {"4", 300, 340};
+    const auto haplotype = make_expected(region, alleles, reference);
+    // Extends left, extends both sides, overlaps the right flank only, and lies outside
+    for (const auto& remap_region : {GenomicRegion {"4", 280, 330}, GenomicRegion {"4", 280, 360},
+                                     GenomicRegion {"4", 318, 370}, GenomicRegion {"4", 400, 450}}) {
+        check_equal(remap(haplotype, remap_region), make_expected(remap_region, alleles, reference));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(copied_haplotypes_take_reference_bases_from_the_source_haplotype)
+{
+    const auto reference = mock::make_reference();
+    const auto haplotype = make_expected(GenomicRegion {"4", 300, 340}, alleles, reference);
+    for (const auto& copy_region : {GenomicRegion {"4", 300, 308}, GenomicRegion {"4", 305, 318},
+                                    GenomicRegion {"4", 325, 340}}) {
+        const auto copied = copy<Haplotype>(haplotype, copy_region);
+        BOOST_CHECK_EQUAL(copied.sequence(), haplotype.sequence(copy_region));
+        check_equal(copied, make_expected(copy_region, alleles, reference));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(builders_take_reference_bases_from_a_reference_haplotype)
+{
+    const auto reference = mock::make_reference();
+    const Haplotype reference_haplotype {GenomicRegion {"4", 290, 350}, reference};
+    // Contained in the reference haplotype, then extending past both of its ends
+    for (const auto& region : {GenomicRegion {"4", 300, 340}, GenomicRegion {"4", 270, 380}}) {
+        check_equal(make_from_source(region, alleles, reference_haplotype), make_expected(region, alleles, reference));
+    }
+    // Alleles that are not adjacent need intervening reference bases from the source
+    const std::vector<Allele> sparse_alleles {alleles.front(), Allele {GenomicRegion {"4", 345, 346}, "G"}};
+    const GenomicRegion sparse_region {"4", 300, 360};
+    check_equal(make_from_source(sparse_region, sparse_alleles, reference_haplotype),
+                make_expected(sparse_region, sparse_alleles, reference));
+}
+
+BOOST_AUTO_TEST_CASE(builders_fetch_reference_bases_under_the_alleles_of_a_source_haplotype)
+{
+    const auto reference = mock::make_reference();
+    const auto source = make_expected(GenomicRegion {"4", 300, 340}, alleles, reference);
+    // The reference bases of the new haplotype span the explicit alleles of the source
+    const std::vector<Allele> other_alleles {Allele {GenomicRegion {"4", 305, 306}, "C"}, Allele {GenomicRegion {"4", 330, 332}, "GG"}};
+    const GenomicRegion region {"4", 295, 345};
+    check_equal(make_from_source(region, other_alleles, source), make_expected(region, other_alleles, reference));
+    // A source on another contig cannot provide any bases
+    const Haplotype other_contig_source {GenomicRegion {"3", 295, 345}, reference};
+    check_equal(make_from_source(region, other_alleles, other_contig_source), make_expected(region, other_alleles, reference));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
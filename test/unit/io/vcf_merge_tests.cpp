@@ -0,0 +1,141 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "io/variant/vcf_utils.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(vcf_merge)
+
+namespace {
+
+const std::string sample {"test"};
+const std::vector<std::string> contigs {"1", "2", "3"};
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+VcfHeader make_header(const ReferenceGenome& reference, const std::vector<std::string>& header_contigs)
+{
+    VcfHeader::Builder result {};
+    result.set_file_format("VCFv4.3");
+    for (const auto& contig : header_contigs) {
+        result.add_contig(contig, {{"length", std::to_string(reference.contig_size(contig))}});
+    }
+    result.add_info("DP", "1", "Integer", "Combined depth across samples");
+    result.add_format("GT", "1", "String", "Genotype");
+    result.add_format("GQ", "1", "Integer", "Conditional genotype quality");
+    result.add_sample(sample);
+    return result.build_once();
+}
+
+std::vector<VcfRecord> make_records(const ReferenceGenome& reference, const std::string& contig)
+{
+    std::vector<VcfRecord> result {};
+    for (GenomicRegion::Position pos {10}; pos + 10 < reference.contig_size(contig) && pos < 400; pos += 15) {
+        const auto ref = reference.fetch_sequence(GenomicRegion {contig, pos - 1, pos});
+        const VcfRecord::NucleotideSequence alt {ref == "A" ? "C" : "A"};
+        VcfRecord::Builder call {};
+        call.set_chrom(contig).set_pos(pos).set_ref(ref).set_alt(alt).set_qual(pos % 100);
+        call.set_info("DP", std::to_string(pos % 40));
+        call.set_format({"GT", "GQ"});
+        call.set_genotype(sample, {ref, alt}, VcfRecord::Builder::Phasing::unphased);
+        call.set_format(sample, "GQ", static_cast<int>(pos % 50));
+        result.push_back(call.build_once());
+    }
+    return result;
+}
+
+std::vector<std::string> to_strings(const std::vector<VcfRecord>& records)
+{
+    std::vector<std::string> result {};
+    result.reserve(records.size());
+    for (const auto& record : records) {
+        std::ostringstream ss {};
+        ss << record;
+        result.push_back(ss.str());
+    }
+    return result;
+}
+
+// Writes one BCF per contig, as the caller does for its temp files, and merges them
+void check_merge_of_contig_files(const bool full_contig_dictionary)
+{
+    const auto reference = mock::make_reference();
+    const TempDirectory temp {};
+    std::vector<VcfWriter> writers {};
+    std::vector<std::string> expected {};
+    // Write in reverse to check the merge follows the given contig order
+    for (auto itr = std::crbegin(contigs); itr != std::crend(contigs); ++itr) {
+        const auto header = make_header(reference, full_contig_dictionary ? contigs : std::vector<std::string> {*itr});
+        writers.emplace_back(temp.path / (*itr + "_temp.bcf"), header);
+        for (const auto& record : make_records(reference, *itr)) {
+            writers.back() << record;
+        }
+    }
+    auto readers = writers_to_readers(std::move(writers), false);
+    const auto merged_path = temp.path / "merged.bcf";
+    {
+        VcfWriter merged {merged_path};
+        merge(readers, merged, contigs);
+    }
+    BOOST_REQUIRE(fs::exists(merged_path.string() + ".csi"));
+    const VcfReader merged {merged_path};
+    for (const auto& contig : contigs) {
+        const auto expected_contig_records = make_records(reference, contig);
+        const auto expected_contig = to_strings(expected_contig_records);
+        const auto actual_contig = to_strings(merged.fetch_records(contig));
+        BOOST_REQUIRE(!expected_contig.empty());
+        BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual_contig), std::cend(actual_contig),
+                                      std::cbegin(expected_contig), std::cend(expected_contig));
+        const auto expected_region_count = static_cast<std::size_t>(std::count_if(std::cbegin(expected_contig_records), std::cend(expected_contig_records),
+                                                                                 [] (const VcfRecord& record) { return record.pos() > 100 && record.pos() <= 200; }));
+        BOOST_CHECK_EQUAL(merged.count_records(GenomicRegion {contig, 100, 200}), expected_region_count);
+        expected.insert(std::cend(expected), std::cbegin(expected_contig), std::cend(expected_contig));
+    }
+    const auto actual = to_strings(merged.fetch_records());
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected), std::cend(expected));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(merging_contig_files_with_shared_headers_preserves_records_and_index)
+{
+    check_merge_of_contig_files(true);
+}
+
+BOOST_AUTO_TEST_CASE(merging_contig_files_with_contig_specific_headers_preserves_records_and_index)
+{
+    check_merge_of_contig_files(false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
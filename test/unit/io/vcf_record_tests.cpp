@@ -0,0 +1,197 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <limits>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_reader.hpp"
+#include "io/variant/vcf_writer.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+using Values = VcfRecord::Values;
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(vcf_record)
+
+namespace {
+
+const std::vector<std::string> samples {"sample1", "sample2"};
+
+struct TempDirectory
+{
+    TempDirectory() : path {fs::temp_directory_path() / fs::unique_path()} { fs::create_directories(path); }
+    ~TempDirectory() { fs::remove_all(path); }
+    fs::path path;
+};
+
+VcfHeader make_header()
+{
+    VcfHeader::Builder result {};
+    result.set_file_format("VCFv4.3");
+    result.add_contig("1", {{"length", "1000"}});
+    result.add_info("DP", "1", "Integer", "Combined depth across samples");
+    result.add_info("AC", "A", "Integer", "Allele count in genotypes");
+    result.add_info("MQ", "1", "Float", "RMS mapping quality");
+    result.add_info("AF", "A", "Float", "Allele frequency");
+    result.add_format("GT", "1", "String", "Genotype");
+    result.add_format("GQ", "1", "Integer", "Conditional genotype quality");
+    result.add_format("AD", ".", "Integer", "Allele depths");
+    result.add_format("PL", ".", "Float", "Genotype likelihoods");
+    for (const auto& sample : samples) result.add_sample(sample);
+    return result.build_once();
+}
+
+VcfRecord make_record()
+{
+    VcfRecord::Builder result {};
+    result.set_chrom("1").set_pos(100).set_ref("A").set_alt(std::vector<VcfRecord::NucleotideSequence> {"C", "G"}).set_qual(50);
+    result.set_info("DP", Values {std::vector<Values::IntegerType> {Values::missing_integer}});
+    result.set_info("AC", std::vector<int> {1, 2});
+    result.set_info_missing("MQ");
+    result.set_info("AF", Values {std::vector<Values::FloatType> {0.25f, Values::missing_real}});
+    result.set_format({"GT", "GQ", "AD", "PL"});
+    using Alleles = std::vector<VcfRecord::NucleotideSequence>;
+    result.set_genotype(samples[0], Alleles {"A", "C"}, VcfRecord::Builder::Phasing::unphased);
+    result.set_genotype(samples[1], Alleles {"C", "G"}, VcfRecord::Builder::Phasing::unphased);
+    result.set_format(samples[0], "GQ", 30);
+    result.set_format_missing(samples[1], "GQ");
+    // Sample values of different lengths are padded with vector-end values in the BCF record
+    result.set_format(samples[0], "AD", std::vector<int> {10, 5, 0});
+    result.set_format(samples[1], "AD", std::vector<int> {7});
+    result.set_format(samples[0], "PL", Values {std::vector<Values::FloatType> {0.5f, Values::missing_real}});
+    result.set_format(samples[1], "PL", std::vector<float> {1.5f});
+    return result.build_once();
+}
+
+void check_integers(const Values& values, const std::vector<boost::optional<Values::IntegerType>>& expected)
+{
+    BOOST_REQUIRE_EQUAL(values.size(), expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        BOOST_CHECK(get_integer(values, i) == expected[i]);
+    }
+}
+
+void check_reals(const Values& values, const std::vector<boost::optional<Values::FloatType>>& expected)
+{
+    BOOST_REQUIRE_EQUAL(values.size(), expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        BOOST_CHECK(get_real(values, i) == expected[i]);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(integer_values_convert_to_strings_and_back)
+{
+    const Values values {std::vector<Values::IntegerType> {3, Values::missing_integer, -1}};
+    BOOST_CHECK(values.type() == Values::Type::integer);
+    const std::vector<std::string> expected_strings {"3", ".", "-1"};
+    const auto strings = values.to_strings();
+    BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(strings), std::cend(strings), std::cbegin(expected_strings), std::cend(expected_strings));
+    const Values parsed {strings};
+    check_integers(parsed, {3, boost::none, -1});
+    check_reals(values, {3.0f, boost::none, -1.0f});
+}
+
+BOOST_AUTO_TEST_CASE(real_values_convert_to_strings_and_back)
+{
+    const Values values {std::vector<Values::FloatType> {0.5f, Values::missing_real, 2.0f}};
+    BOOST_CHECK(values.type() == Values::Type::real);
+    const Values parsed {values.to_strings()};
+    BOOST_CHECK(parsed.type() == Values::Type::string);
+    BOOST_CHECK_EQUAL(parsed.string(1), ".");
+    check_reals(parsed, {0.5f, boost::none, 2.0f});
+    check_integers(values, {0, boost::none, 2});
+}
+
+BOOST_AUTO_TEST_CASE(absent_values_are_missing)
+{
+    const Values empty {};
+    BOOST_CHECK(empty.is_missing(0));
+    BOOST_CHECK(!get_integer(empty));
+    BOOST_CHECK(!get_real(empty));
+    const Values one {std::vector<Values::IntegerType> {1}};
+    BOOST_CHECK(one.is_missing(1));
+    BOOST_CHECK(!get_integer(one, 1));
+    VcfRecord::Builder builder {};
+    builder.set_chrom("1").set_pos(1).set_ref("A").set_alt("C");
+    builder.set_info_missing("DP");
+    const auto record = builder.build_once();
+    BOOST_CHECK(!get_info_integer(record, "DP"));
+    BOOST_CHECK(!get_info_real(record, "MQ"));
+}
+
+BOOST_AUTO_TEST_CASE(bcf_records_round_trip_missing_and_multi_value_fields)
+{
+    const TempDirectory temp {};
+    const auto path = temp.path / "test.bcf";
+    {
+        VcfWriter writer {path, make_header()};
+        writer << make_record();
+    }
+    const VcfReader reader {path};
+    const auto records = reader.fetch_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 1u);
+    const auto& record = records.front();
+    BOOST_CHECK(!get_info_integer(record, "DP"));
+    check_integers(record.typed_info_value("AC"), {1, 2});
+    BOOST_CHECK(!get_info_real(record, "MQ"));
+    check_reals(record.typed_info_value("AF"), {0.25f, boost::none});
+    check_integers(record.typed_sample_value(samples[0], "GQ"), {30});
+    BOOST_CHECK(!get_integer(record.typed_sample_value(samples[1], "GQ")));
+    check_integers(record.typed_sample_value(samples[0], "AD"), {10, 5, 0});
+    check_integers(record.typed_sample_value(samples[1], "AD"), {7});
+    check_reals(record.typed_sample_value(samples[0], "PL"), {0.5f, boost::none});
+    check_reals(record.typed_sample_value(samples[1], "PL"), {1.5f});
+}
+
+BOOST_AUTO_TEST_CASE(only_the_missing_real_sentinel_is_missing)
+{
+    const Values values {std::vector<Values::FloatType> {Values::missing_real, std::numeric_limits<Values::FloatType>::quiet_NaN()}};
+    BOOST_CHECK(values.is_missing(0));
+    BOOST_CHECK(!values.is_missing(1));
+    const Values copied {values.reals()};
+    BOOST_CHECK(copied.is_missing(0));
+}
+
+BOOST_AUTO_TEST_CASE(missing_reals_are_written_as_missing_vcf_values)
+{
+    const TempDirectory temp {};
+    const auto path = temp.path / "test.vcf";
+    {
+        VcfWriter writer {path, make_header()};
+        writer << make_record();
+    }
+    std::ifstream file {path.string()};
+    std::string line, record_line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.front() != '#') record_line = line;
+    }
+    BOOST_REQUIRE(!record_line.empty());
+    BOOST_CHECK(record_line.find("nan") == std::string::npos);
+    BOOST_CHECK(record_line.find("AF=0.25,.") != std::string::npos);
+    BOOST_CHECK(record_line.find("0.5,.") != std::string::npos);
+    const VcfReader reader {path};
+    const auto records = reader.fetch_records();
+    BOOST_REQUIRE_EQUAL(records.size(), 1u);
+    check_reals(records.front().typed_info_value("AF"), {0.25f, boost::none});
+    check_reals(records.front().typed_sample_value(samples[0], "PL"), {0.5f, boost::none});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
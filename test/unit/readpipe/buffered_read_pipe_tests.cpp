@@ -0,0 +1,230 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include <boost/filesystem.hpp>
+
+#include "htslib/sam.h"
+
+#include "basics/genomic_region.hpp"
+#include "io/read/read_manager.hpp"
+#include "readpipe/read_pipe.hpp"
+#include "readpipe/buffered_read_pipe.hpp"
+#include "basics/packed_read_batch.hpp"
+#include "utils/input_reads_profiler.hpp"
+#include "core/calling_components.hpp"
+
+namespace octopus { namespace test {
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(readpipe)
+BOOST_AUTO_TEST_SUITE(buffered_read_pipe)
+
+namespace {
+
+constexpr GenomicRegion::Position contig_size {20'000};
+
+// Writes reads tiling a single contig to an indexed BAM in a fresh temporary directory
+fs::path make_mock_bam()
+{
+    const auto directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    const auto sam_path = directory / "mock.sam", bam_path = directory / "mock.bam";
+    {
+        std::ofstream sam {sam_path.string()};
+        sam << "@HD\tVN:1.6\tSO:coordinate\n@SQ\tSN:1\tLN:" << contig_size << "\n@RG\tID:RG\tSM:test\n";
+        std::mt19937 generator {42};
+        std::uniform_int_distribution<int> base_dist {0, 3}, step_dist {1, 20};
+        const std::string bases {"ACGT"};
+        const int read_length {50};
+        int read_idx {0};
+        for (int pos {1}; pos + read_length < static_cast<int>(contig_size); pos += step_dist(generator)) {
+            std::string sequence(read_length, 'A');
+            std::generate(std::begin(sequence), std::end(sequence), [&] () { return bases[base_dist(generator)]; });
+            sam << "read" << read_idx++ << "\t0\t1\t" << pos << "\t60\t" << read_length << "M\t*\t0\t0\t"
+                << sequence << '\t' << std::string(read_length, 'I') << "\tRG:Z:RG\n";
+        }
+    }
+    samFile* in {sam_open(sam_path.c_str(), "r")};
+    bam_hdr_t* header {sam_hdr_read(in)};
+    samFile* out {sam_open(bam_path.c_str(), "wb")};
+    BOOST_REQUIRE(sam_hdr_write(out, header) == 0);
+    bam1_t* record {bam_init1()};
+    while (sam_read1(in, header, record) >= 0) {
+        BOOST_REQUIRE(sam_write1(out, header, record) >= 0);
+    }
+    bam_destroy1(record);
+    sam_close(out);
+    bam_hdr_destroy(header);
+    sam_close(in);
+    BOOST_REQUIRE(sam_index_build(bam_path.c_str(), 0) == 0);
+    return bam_path;
+}
+
+std::vector<GenomicRegion> make_requests()
+{
+    std::vector<GenomicRegion> result {};
+    for (GenomicRegion::Position begin {0}; begin + 500 <= contig_size; begin += 700) {
+        result.emplace_back("1", begin, begin + 500);
+    }
+    return result;
+}
+
+std::vector<ReadMap> fetch_all(const ReadPipe& source, const std::vector<GenomicRegion>& hints,
+                               const std::vector<GenomicRegion>& requests, const bool prefetch,
+                               const bool wait_between_requests = true)
+{
+    BufferedReadPipe::Config config {100};
+    config.prefetch_hints = prefetch;
+    BufferedReadPipe pipe {source, config, hints};
+    std::vector<ReadMap> result {};
+    for (const auto& request : requests) {
+        // Give prefetches a chance to complete so that they are actually used
+        if (prefetch && wait_between_requests) std::this_thread::sleep_for(std::chrono::milliseconds {5});
+        result.push_back(pipe.fetch_reads(request));
+    }
+    return result;
+}
+
+void check_equal(const std::vector<ReadMap>& lhs, const std::vector<ReadMap>& rhs)
+{
+    BOOST_REQUIRE_EQUAL(lhs.size(), rhs.size());
+    for (std::size_t i {0}; i < lhs.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(lhs[i].size(), rhs[i].size());
+        for (const auto& p : lhs[i]) {
+            BOOST_REQUIRE(rhs[i].count(p.first) == 1);
+            const auto& other = rhs[i].at(p.first);
+            BOOST_REQUIRE_EQUAL(p.second.size(), other.size());
+            BOOST_CHECK(std::equal(std::cbegin(p.second), std::cend(p.second), std::cbegin(other)));
+        }
+    }
+}
+
+std::vector<ReadMap> fetch_all_unbuffered(const ReadPipe& source, const std::vector<GenomicRegion>& requests)
+{
+    std::vector<ReadMap> result {};
+    for (const auto& request : requests) {
+        result.push_back(source.fetch_reads(request));
+    }
+    return result;
+}
+
+ReadSetProfile::ReadMemoryStats make_memory_stats(const std::vector<MemoryFootprint>& footprints)
+{
+    const auto total = std::accumulate(std::cbegin(footprints), std::cend(footprints), MemoryFootprint {0});
+    const MemoryFootprint mean {total.bytes() / footprints.size()};
+    const auto minmax = std::minmax_element(std::cbegin(footprints), std::cend(footprints));
+    return {*minmax.second, *minmax.first, mean, mean, MemoryFootprint {0}};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(buffered_reads_are_the_same_as_unbuffered_reads)
+{
+    const auto bam_path = make_mock_bam();
+    {
+        const ReadManager manager {bam_path};
+        const ReadPipe source {manager, manager.samples()};
+        const auto requests = make_requests();
+        // Buffers are much smaller than the requested regions, so many buffers are fetched per contig
+        check_equal(fetch_all(source, requests, requests, false), fetch_all_unbuffered(source, requests));
+        check_equal(fetch_all(source, {}, requests, false), fetch_all_unbuffered(source, requests));
+    }
+    fs::remove_all(bam_path.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(packed_buffers_admit_more_reads_for_the_same_footprint)
+{
+    const auto bam_path = make_mock_bam();
+    {
+        const ReadManager manager {bam_path};
+        const ReadPipe source {manager, manager.samples()};
+        const auto reads = source.fetch_reads(GenomicRegion {"1", 0, contig_size});
+        std::vector<MemoryFootprint> footprints {}, packed_footprints {};
+        MemoryFootprint total_footprint {0};
+        for (const auto& p : reads) {
+            for (const auto& read : p.second) {
+                footprints.push_back(footprint(read));
+                packed_footprints.push_back(packed_footprint(read));
+                total_footprint += footprint(read);
+            }
+        }
+        BOOST_REQUIRE(!footprints.empty());
+        const auto packed_reads = pack(reads);
+        MemoryFootprint total_packed_footprint {0};
+        for (const auto& p : packed_reads) total_packed_footprint += p.second.footprint();
+        BOOST_CHECK(total_packed_footprint < total_footprint);
+        ReadSetProfile profile {};
+        profile.memory_stats = make_memory_stats(footprints);
+        profile.packed_memory_stats = make_memory_stats(packed_footprints);
+        const MemoryFootprint target_read_buffer_footprint {100'000'000};
+        BOOST_CHECK(calculate_max_num_packed_reads(target_read_buffer_footprint, profile)
+                    > calculate_max_num_reads(target_read_buffer_footprint, profile));
+        BOOST_CHECK(calculate_max_num_packed_reads(target_read_buffer_footprint, boost::none)
+                    > calculate_max_num_reads(target_read_buffer_footprint, boost::none));
+    }
+    fs::remove_all(bam_path.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(prefetching_returns_the_same_reads_for_hinted_requests)
+{
+    const auto bam_path = make_mock_bam();
+    {
+        const ReadManager manager {bam_path};
+        const ReadPipe source {manager, manager.samples()};
+        const auto requests = make_requests();
+        const auto expected = fetch_all(source, requests, requests, false);
+        BOOST_REQUIRE(std::any_of(std::cbegin(expected), std::cend(expected),
+                                  [] (const auto& reads) { return !reads.empty() && !reads.begin()->second.empty(); }));
+        check_equal(fetch_all(source, requests, requests, true), expected);
+    }
+    fs::remove_all(bam_path.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(prefetching_returns_the_same_reads_when_requests_arrive_before_prefetches_finish)
+{
+    const auto bam_path = make_mock_bam();
+    {
+        const ReadManager manager {bam_path};
+        const ReadPipe source {manager, manager.samples()};
+        const auto requests = make_requests();
+        const auto expected = fetch_all(source, requests, requests, false);
+        // Each request now finds its prefetch pending, running or done
+        check_equal(fetch_all(source, requests, requests, true, false), expected);
+    }
+    fs::remove_all(bam_path.parent_path());
+}
+
+BOOST_AUTO_TEST_CASE(prefetching_returns_the_same_reads_when_requests_do_not_follow_hints)
+{
+    const auto bam_path = make_mock_bam();
+    {
+        const ReadManager manager {bam_path};
+        const ReadPipe source {manager, manager.samples()};
+        const auto hints = make_requests();
+        auto requests = hints;
+        std::reverse(std::begin(requests), std::end(requests));
+        std::rotate(std::begin(requests), std::next(std::begin(requests), requests.size() / 2), std::end(requests));
+        const auto expected = fetch_all(source, hints, requests, false);
+        check_equal(fetch_all(source, hints, requests, true), expected);
+    }
+    fs::remove_all(bam_path.parent_path());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <string>
+#include <numeric>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+
+#include "utils/parallel_transform.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(parallel_transform_algorithm)
+
+BOOST_AUTO_TEST_CASE(parallel_transform_preserves_input_order)
+{
+    std::vector<int> values(10000);
+    std::iota(std::begin(values), std::end(values), 0);
+    std::vector<int> result {};
+    parallel_transform(std::cbegin(values), std::cend(values), std::back_inserter(result), [] (int x) { return 2 * x; });
+    BOOST_REQUIRE_EQUAL(result.size(), values.size());
+    for (std::size_t i {0}; i < values.size(); ++i) {
+        BOOST_CHECK_EQUAL(result[i], 2 * values[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_transform_can_be_nested)
+{
+    std::vector<int> values(500);
+    std::iota(std::begin(values), std::end(values), 0);
+    std::vector<int> result {};
+    parallel_transform(std::cbegin(values), std::cend(values), std::back_inserter(result), [] (int x) {
+        std::vector<int> inner(100, x), inner_result {};
+        parallel_transform(std::cbegin(inner), std::cend(inner), std::back_inserter(inner_result), [] (int y) { return y + 1; });
+        return std::accumulate(std::cbegin(inner_result), std::cend(inner_result), 0);
+    });
+    for (std::size_t i {0}; i < values.size(); ++i) {
+        BOOST_CHECK_EQUAL(result[i], 100 * (values[i] + 1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_transform_moves_from_move_iterators)
+{
+    std::vector<std::string> values(100, "a");
+    std::vector<std::string> result(values.size());
+    parallel_transform(std::make_move_iterator(std::begin(values)), std::make_move_iterator(std::end(values)),
+                       std::begin(result), [] (std::string&& s) { s += "b"; return std::move(s); });
+    for (const auto& s : result) {
+        BOOST_CHECK_EQUAL(s, "ab");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_transform_propagates_exceptions)
+{
+    std::vector<int> values(1000);
+    std::iota(std::begin(values), std::end(values), 0);
+    std::vector<int> result {};
+    const auto op = [] (int x) -> int { if (x == 500) throw std::runtime_error {"test"}; return x; };
+    BOOST_CHECK_THROW(parallel_transform(std::cbegin(values), std::cend(values), std::back_inserter(result), op), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_each_worker_gives_each_thread_its_own_worker_index)
+{
+    const std::size_t n {10000};
+    const auto num_workers = parallel_for_max_workers();
+    std::vector<std::vector<std::size_t>> worker_indices(num_workers);
+    std::atomic<bool> good_workers {true};
+    parallel_for_each_worker(n, [&] (const std::size_t worker, const std::size_t i) {
+        if (worker < num_workers) {
+            worker_indices[worker].push_back(i);
+        } else {
+            good_workers = false;
+        }
+    });
+    BOOST_REQUIRE(good_workers);
+    std::vector<std::size_t> visited {};
+    for (const auto& indices : worker_indices) {
+        visited.insert(std::cend(visited), std::cbegin(indices), std::cend(indices));
+    }
+    std::sort(std::begin(visited), std::end(visited));
+    BOOST_REQUIRE_EQUAL(visited.size(), n);
+    for (std::size_t i {0}; i < n; ++i) {
+        BOOST_CHECK_EQUAL(visited[i], i);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
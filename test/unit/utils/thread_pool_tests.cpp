@@ -0,0 +1,87 @@
+// Copyright (c) 2015-2019 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <future>
+#include <numeric>
+#include <atomic>
+#include <stdexcept>
+
+#include "utils/thread_pool.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(thread_pool)
+
+BOOST_AUTO_TEST_CASE(thread_pool_runs_all_pushed_tasks)
+{
+    ThreadPool pool {4};
+    BOOST_CHECK_EQUAL(pool.size(), 4);
+    std::vector<std::future<int>> futures {};
+    for (int i {0}; i < 1000; ++i) {
+        futures.push_back(pool.push([] (int x) { return 2 * x; }, i));
+    }
+    for (int i {0}; i < 1000; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), 2 * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_runs_tasks_pushed_from_workers)
+{
+    std::atomic<int> count {0};
+    {
+        ThreadPool pool {2};
+        std::vector<std::future<void>> outer {};
+        for (int i {0}; i < 10; ++i) {
+            outer.push_back(pool.push([&] () {
+                for (int j {0}; j < 10; ++j) {
+                    pool.push([&] () { ++count; });
+                }
+            }));
+        }
+        for (auto& f : outer) f.get();
+    }
+    BOOST_CHECK_EQUAL(count, 100);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_finishes_pending_tasks_on_destruction)
+{
+    std::atomic<int> count {0};
+    {
+        ThreadPool pool {3};
+        for (int i {0}; i < 100; ++i) {
+            pool.push([&] () { ++count; });
+        }
+    }
+    BOOST_CHECK_EQUAL(count, 100);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_propagates_exceptions)
+{
+    ThreadPool pool {2};
+    auto f = pool.push([] () -> int { throw std::runtime_error {"test"}; });
+    BOOST_CHECK_THROW(f.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(shared_thread_pool_is_the_pool_running_the_caller)
+{
+    ThreadPool pool {2};
+    auto f = pool.push([] () { return &get_shared_thread_pool(); });
+    BOOST_CHECK_EQUAL(f.get(), &pool);
+    BOOST_CHECK_NE(&get_shared_thread_pool(), &pool);
+}
+
+BOOST_AUTO_TEST_CASE(shared_thread_pool_cannot_be_resized_once_used)
+{
+    get_shared_thread_pool();
+    BOOST_CHECK_THROW(set_shared_thread_pool_size(1), std::logic_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus